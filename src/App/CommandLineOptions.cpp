@@ -0,0 +1,210 @@
+#include "CommandLineOptions.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+void printUsage(const char* programName) {
+    std::cout << "Uzycie: " << programName << " [opcje]\n"
+              << "  --telemetry <sciezka>          zapis szeregu czasowego kolonii (<sciezka>_0000.csv, ...)\n"
+              << "  --telemetry-format csv|binary  format plikow telemetrii (domyslnie csv)\n"
+              << "  --telemetry-rotate-mb <n>      rozmiar pliku, po ktorym zaczynany jest kolejny (domyslnie 64)\n"
+              << "  --ensemble <specyfikacja>      przeglad parametrow bez okna (zobacz EnsembleRunner.h)\n"
+              << "  --ensemble-output <plik>       wyniki przegladu (domyslnie ensemble_results.csv)\n"
+              << "  --ensemble-checkpoint <plik>   punkt kontrolny (domyslnie <wyniki>.checkpoint)\n"
+              << "  --ensemble-cores <n>           liczba uzywanych rdzeni (domyslnie wszystkie)\n"
+              << "  --record <plik>                nagrywa polecenia z GUI do pliku scenariusza\n"
+              << "  --play <plik>                  odtwarza scenariusz (ziarno i krok czasu z pliku)\n"
+              << "  --headless                     z --play: odtworzenie bez okna i podsumowanie\n"
+              << "  --extra-ticks <n>              z --headless: kroki po ostatnim poleceniu (domyslnie 600)\n"
+              << "  --seed <n>                     ziarno generatora symulacji\n"
+              << "  --max-individuals <n>          limit obiektow symulacji, powyzej komorki laczone w superosobniki\n"
+              << "  --memory-budget-mb <n>         limit pamieci obiektow symulacji w MB\n"
+              << "  --benchmark-kernels            sprawdza i mierzy warianty SIMD obliczen na komorkach\n"
+              << "                                 oraz zysk z porzadkowania przestrzennego kolonii\n"
+              << "  --validate-kernels             tylko sprawdza warianty SIMD z wersja skalarna (kod 1 przy roznicy)\n"
+              << "  --capture <prefiks>            zapis klatek do <prefiks>_000000.png, ...\n"
+              << "  --capture-size <SxW>           rozmiar przechwytywanych klatek (domyslnie 1920x1080)\n"
+              << "  --capture-frames <n>           liczba klatek do zapisania (domyslnie do zamkniecia okna)\n"
+              << "  --offscreen                    z --capture i --capture-frames: renderowanie bez okna\n"
+              << "  --trace <plik.json>            zapis osi czasu watkow (chrome://tracing, Perfetto) przy wyjsciu\n"
+              << "  --trace-window <s>             zapisywany odcinek czasu w sekundach (domyslnie 10, takze dla F9)\n"
+              << "  --cluster-interval <n>         wykrywanie kolonii co n krokow symulacji (domyslnie 30, 0 wylacza)\n"
+              << "  --contact-distance <d>         odleglosc, przy ktorej komorki naleza do jednej kolonii (domyslnie 0.6)\n"
+              << "  --rewind-budget-mb <n>         pamiec historii do cofania w MB (domyslnie 256, 0 wylacza)\n"
+              << "  --rewind-interval <n>          migawka historii co n krokow symulacji (domyslnie 30, 0 wylacza)\n"
+              << "  --species <plik>               rejestr gatunkow (domyslnie assets/species.txt lub wbudowane)\n"
+              << "  --shm <nazwa>                  publikuje stan kolonii w pamieci wspoldzielonej POSIX\n"
+              << "                                 (czytnik: tools/shm_reader)\n"
+              << "  --shm-capacity <n>             obiektow w migawce (domyslnie limit obiektow symulacji)\n"
+              << "  --metrics <port|unix:sciezka>  serwer metryk Prometheusa (GET /metrics) na 127.0.0.1:<port>\n"
+              << "                                 albo na gniezdzie domenowym; dziala takze z --headless\n"
+              << "  -h, --help                     wyswietla te pomoc\n";
+}
+
+bool parseCommandLine(int argc, char** argv, CommandLineOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+
+        // Opcje z wartością pobierają kolejny argument
+        auto nextValue = [&](const char*& value) {
+            if (i + 1 >= argc) {
+                std::cerr << "Brak wartosci dla opcji " << argument << std::endl;
+                return false;
+            }
+            value = argv[++i];
+            return true;
+        };
+
+        const char* value = nullptr;
+        if (argument == "-h" || argument == "--help") {
+            options.showHelp = true;
+        } else if (argument == "--telemetry") {
+            if (!nextValue(value)) return false;
+            options.telemetryPath = value;
+        } else if (argument == "--telemetry-format") {
+            if (!nextValue(value)) return false;
+            std::string format = value;
+            if (format == "csv") {
+                options.telemetryFormat = TelemetryFormat::Csv;
+            } else if (format == "binary") {
+                options.telemetryFormat = TelemetryFormat::Binary;
+            } else {
+                std::cerr << "Nieznany format telemetrii: " << format << std::endl;
+                return false;
+            }
+        } else if (argument == "--telemetry-rotate-mb") {
+            if (!nextValue(value)) return false;
+            char* end = nullptr;
+            unsigned long long megabytes = std::strtoull(value, &end, 10);
+            if (end == value || *end != '\0') {
+                std::cerr << "Niepoprawny rozmiar rotacji: " << value << std::endl;
+                return false;
+            }
+            options.telemetryRotateBytes = static_cast<uint64_t>(megabytes) * 1024 * 1024;
+        } else if (argument == "--species") {
+            if (!nextValue(value)) return false;
+            options.speciesPath = value;
+        } else if (argument == "--metrics") {
+            if (!nextValue(value)) return false;
+            options.metricsEndpoint = value;
+        } else if (argument == "--shm") {
+            if (!nextValue(value)) return false;
+            // shm_open oczekuje nazwy zaczynającej się od '/'
+            options.sharedMemoryName = (value[0] == '/') ? std::string(value) : "/" + std::string(value);
+        } else if (argument == "--ensemble") {
+            if (!nextValue(value)) return false;
+            options.ensembleSpecPath = value;
+        } else if (argument == "--ensemble-output") {
+            if (!nextValue(value)) return false;
+            options.ensembleOutputPath = value;
+        } else if (argument == "--ensemble-checkpoint") {
+            if (!nextValue(value)) return false;
+            options.ensembleCheckpointPath = value;
+        } else if (argument == "--ensemble-cores") {
+            if (!nextValue(value)) return false;
+            char* end = nullptr;
+            unsigned long cores = std::strtoul(value, &end, 10);
+            if (end == value || *end != '\0') {
+                std::cerr << "Niepoprawna liczba rdzeni: " << value << std::endl;
+                return false;
+            }
+            options.ensembleCores = static_cast<unsigned int>(cores);
+        } else if (argument == "--record") {
+            if (!nextValue(value)) return false;
+            options.recordPath = value;
+        } else if (argument == "--play") {
+            if (!nextValue(value)) return false;
+            options.playPath = value;
+        } else if (argument == "--capture") {
+            if (!nextValue(value)) return false;
+            options.capturePrefix = value;
+        } else if (argument == "--capture-size") {
+            if (!nextValue(value)) return false;
+            int width = 0;
+            int height = 0;
+            char separator = 0;
+            char trailing = 0;
+            if (std::sscanf(value, "%d%c%d%c", &width, &separator, &height, &trailing) != 3 ||
+                (separator != 'x' && separator != 'X') || width <= 0 || height <= 0) {
+                std::cerr << "Niepoprawny rozmiar przechwytywania: " << value << std::endl;
+                return false;
+            }
+            options.captureWidth = width;
+            options.captureHeight = height;
+        } else if (argument == "--trace") {
+            if (!nextValue(value)) return false;
+            options.tracePath = value;
+        } else if (argument == "--trace-window") {
+            if (!nextValue(value)) return false;
+            char* end = nullptr;
+            double seconds = std::strtod(value, &end);
+            if (end == value || *end != '\0' || seconds <= 0.0) {
+                std::cerr << "Niepoprawny odcinek sledzenia: " << value << std::endl;
+                return false;
+            }
+            options.traceWindowSeconds = seconds;
+        } else if (argument == "--contact-distance") {
+            if (!nextValue(value)) return false;
+            char* end = nullptr;
+            double distance = std::strtod(value, &end);
+            if (end == value || *end != '\0' || distance <= 0.0) {
+                std::cerr << "Niepoprawna odleglosc styku: " << value << std::endl;
+                return false;
+            }
+            options.contactDistance = static_cast<float>(distance);
+        } else if (argument == "--offscreen") {
+            options.offscreen = true;
+        } else if (argument == "--benchmark-kernels") {
+            options.benchmarkKernels = true;
+        } else if (argument == "--validate-kernels") {
+            options.validateKernels = true;
+        } else if (argument == "--headless") {
+            options.headless = true;
+        } else if (argument == "--extra-ticks" || argument == "--seed" ||
+                   argument == "--max-individuals" || argument == "--memory-budget-mb" ||
+                   argument == "--capture-frames" || argument == "--cluster-interval" ||
+                   argument == "--rewind-budget-mb" || argument == "--rewind-interval" ||
+                   argument == "--shm-capacity") {
+            if (!nextValue(value)) return false;
+            char* end = nullptr;
+            unsigned long long number = std::strtoull(value, &end, 10);
+            if (end == value || *end != '\0') {
+                std::cerr << "Niepoprawna wartosc opcji " << argument << ": " << value << std::endl;
+                return false;
+            }
+            if (argument == "--seed") {
+                options.seedSpecified = true;
+                options.seed = static_cast<uint32_t>(number);
+            } else if (argument == "--max-individuals") {
+                options.maxIndividuals = static_cast<uint64_t>(number);
+            } else if (argument == "--capture-frames") {
+                options.captureFrames = static_cast<uint64_t>(number);
+            } else if (argument == "--cluster-interval") {
+                options.clusterIntervalTicks = static_cast<uint32_t>(number);
+            } else if (argument == "--memory-budget-mb") {
+                options.memoryBudgetBytes = static_cast<uint64_t>(number) * 1024 * 1024;
+            } else if (argument == "--rewind-budget-mb") {
+                options.rewindBudgetBytes = static_cast<uint64_t>(number) * 1024 * 1024;
+            } else if (argument == "--rewind-interval") {
+                options.rewindIntervalTicks = static_cast<uint32_t>(number);
+            } else if (argument == "--shm-capacity") {
+                options.sharedMemoryCapacity = static_cast<uint64_t>(number);
+            } else {
+                options.extraTicks = static_cast<uint64_t>(number);
+            }
+        } else {
+            std::cerr << "Nieznana opcja: " << argument << std::endl;
+            return false;
+        }
+    }
+    if (options.headless && options.playPath.empty()) {
+        std::cerr << "--headless wymaga --play <plik>" << std::endl;
+        return false;
+    }
+    if (options.offscreen && (options.capturePrefix.empty() || options.captureFrames == 0)) {
+        std::cerr << "--offscreen wymaga --capture <prefiks> i --capture-frames <n>" << std::endl;
+        return false;
+    }
+    return true;
+}
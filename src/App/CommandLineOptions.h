@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "TelemetryExporter.h"
+#include "Simulation/ColonyClusters.h"
+
+// Opcje uruchomienia przekazywane w linii poleceń
+struct CommandLineOptions {
+    bool showHelp = false;
+
+    // Telemetria jest wyłączona, dopóki nie podano ścieżki
+    std::string telemetryPath;
+    TelemetryFormat telemetryFormat = TelemetryFormat::Csv;
+    uint64_t telemetryRotateBytes = 64ull * 1024 * 1024;
+
+    // Przegląd parametrów bez okna - uruchamiany zamiast symulacji interaktywnej
+    std::string ensembleSpecPath;
+    std::string ensembleOutputPath = "ensemble_results.csv";
+    std::string ensembleCheckpointPath;
+    unsigned int ensembleCores = 0;
+
+    // Nagrywanie i odtwarzanie scenariuszy (polecenia użytkownika z numerem kroku)
+    std::string recordPath;
+    std::string playPath;
+    bool headless = false;          // Odtworzenie --play bez okna
+    uint64_t extraTicks = 600;      // Kroki po ostatnim poleceniu w trybie bez okna
+    bool seedSpecified = false;
+    uint32_t seed = 0;
+
+    // Budżet populacji; 0 oznacza domyślny limit danego trybu
+    uint64_t maxIndividuals = 0;
+    uint64_t memoryBudgetBytes = 0;
+
+    // Porównanie i pomiar wariantów SIMD jąder komórkowych zamiast symulacji
+    bool benchmarkKernels = false;
+    // Samo sprawdzenie zgodności jąder SIMD, bez pomiarów (test CTest)
+    bool validateKernels = false;
+
+    // Przechwytywanie klatek do sekwencji PNG (<prefiks>_000000.png, ...)
+    std::string capturePrefix;
+    int captureWidth = 1920;
+    int captureHeight = 1080;
+    uint64_t captureFrames = 0;     // 0 = do zamknięcia okna
+    bool offscreen = false;         // Bez widocznego okna (EGL bez powierzchni albo OSMesa)
+
+    // Śledzenie osi czasu (Chrome trace-event JSON) włączone od startu i zapisywane przy wyjściu
+    std::string tracePath;
+    double traceWindowSeconds = 10.0;   // Zapisywany odcinek (także dla F9)
+
+    // Wykrywanie kolonii w trybie interaktywnym; 0 wyłącza
+    uint32_t clusterIntervalTicks = 30;
+    float contactDistance = DEFAULT_CONTACT_DISTANCE;
+
+    // Historia do cofania w trybie interaktywnym; budżet 0 lub interwał 0 ją wyłącza
+    uint64_t rewindBudgetBytes = 256ull * 1024 * 1024;
+    uint32_t rewindIntervalTicks = 30;
+
+    // Plik rejestru gatunków; pusty - assets/species.txt, a bez niego gatunki wbudowane
+    std::string speciesPath;
+
+    // Publikacja stanu kolonii w pamięci współdzielonej; pusta nazwa ją wyłącza
+    std::string sharedMemoryName;
+    uint64_t sharedMemoryCapacity = 0; // 0 = limit obiektów z budżetu populacji
+
+    // Serwer metryk: port TCP na 127.0.0.1 albo "unix:<ścieżka>"; pusty - wyłączony
+    std::string metricsEndpoint;
+};
+
+// Zwraca false (po wypisaniu komunikatu), gdy argumenty są niepoprawne
+bool parseCommandLine(int argc, char** argv, CommandLineOptions& options);
+void printUsage(const char* programName);
@@ -0,0 +1,411 @@
+#include "EnsembleRunner.h"
+
+#include "Simulation/Colony.h"
+#include "Simulation/SpeciesRegistry.h"
+#include "Utils/Hash.h"
+#include "Utils/MemoryTracker.h"
+#include "Utils/ThreadAffinity.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+// Liczba początkowych bakterii przypadająca na jeden wątek instancji
+const int CELLS_PER_THREAD = 25000;
+// Górna granica wątków jednej instancji - dalej zysk z równoległości jest znikomy
+const unsigned int MAX_THREADS_PER_RUN = 8;
+const char* const CHECKPOINT_HEADER = "PDENS";
+
+static std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+// Lista wartości: "a, b, c" lub zakresy "od..do[:krok]" (krok domyślnie 1)
+static bool parseValueList(const std::string& text, std::vector<double>& values) {
+    values.clear();
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        item = trim(item);
+        if (item.empty()) continue;
+        size_t rangePosition = item.find("..");
+        try {
+            if (rangePosition == std::string::npos) {
+                values.push_back(std::stod(item));
+                continue;
+            }
+            std::string rest = item.substr(rangePosition + 2);
+            size_t stepPosition = rest.find(':');
+            double from = std::stod(item.substr(0, rangePosition));
+            double to = std::stod(rest.substr(0, stepPosition));
+            double step = (stepPosition == std::string::npos) ? 1.0 : std::stod(rest.substr(stepPosition + 1));
+            if (step <= 0.0 || to < from) return false;
+            // Tolerancja, aby zakresy ułamkowe zawierały wartość końcową
+            for (int i = 0; from + i * step <= to + step * 1e-6; ++i) {
+                values.push_back(from + i * step);
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    return !values.empty();
+}
+
+static bool parseInoculationShape(const std::string& text, InoculationShape& shape) {
+    const char* names[INOCULATION_SHAPE_COUNT] = {"blob", "lawn", "streak", "grid"};
+    for (int i = 0; i < INOCULATION_SHAPE_COUNT; ++i) {
+        if (text == names[i]) {
+            shape = static_cast<InoculationShape>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Punkty "x y" po przecinku
+static bool parsePointList(const std::string& text, std::vector<glm::vec2>& points) {
+    points.clear();
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        std::stringstream pair(item);
+        glm::vec2 point;
+        std::string rest;
+        if (!(pair >> point.x >> point.y) || (pair >> rest)) return false;
+        points.push_back(point);
+    }
+    return !points.empty();
+}
+
+bool loadSweepSpec(const std::string& path, SweepSpec& spec, std::string& specText) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "ERROR::ENSEMBLE::Could not open sweep spec: " << path << std::endl;
+        return false;
+    }
+    std::stringstream content;
+    content << file.rdbuf();
+    specText = content.str();
+
+    std::stringstream lines(specText);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line)) {
+        ++lineNumber;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            std::cerr << "ERROR::ENSEMBLE::" << path << ":" << lineNumber << ": expected 'key = value'" << std::endl;
+            return false;
+        }
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+
+        bool valid = true;
+        std::vector<double> values;
+        if (key == "type") {
+            valid = getSpeciesRegistry().find(value, spec.bacteriaType);
+        } else if (key == "pattern") {
+            valid = parseInoculationShape(value, spec.inoculation.shape);
+        } else if (key == "streak") {
+            valid = parsePointList(value, spec.inoculation.points);
+        } else if (!parseValueList(value, values)) {
+            valid = false;
+        } else if (key == "seeds") {
+            spec.seeds.clear();
+            for (double v : values) spec.seeds.push_back(static_cast<uint32_t>(v));
+        } else if (key == "strength") {
+            spec.strengths.assign(values.begin(), values.end());
+        } else if (key == "radius") {
+            spec.radii.assign(values.begin(), values.end());
+        } else if (key == "initial_count") {
+            spec.initialCounts.clear();
+            for (double v : values) spec.initialCounts.push_back(static_cast<int>(v));
+        } else if (key == "duration") {
+            spec.duration = static_cast<float>(values.front());
+        } else if (key == "timestep") {
+            spec.timeStep = static_cast<float>(values.front());
+        } else if (key == "dose_time") {
+            spec.doseTime = static_cast<float>(values.front());
+        } else if (key == "spread") {
+            spec.inoculation.size = static_cast<float>(values.front());
+        } else {
+            std::cerr << "ERROR::ENSEMBLE::" << path << ":" << lineNumber << ": unknown key '" << key << "'" << std::endl;
+            return false;
+        }
+        if (!valid) {
+            std::cerr << "ERROR::ENSEMBLE::" << path << ":" << lineNumber << ": invalid value for '" << key << "'" << std::endl;
+            return false;
+        }
+    }
+    if (spec.timeStep <= 0.0f || spec.duration <= 0.0f) {
+        std::cerr << "ERROR::ENSEMBLE::duration and timestep must be positive" << std::endl;
+        return false;
+    }
+    // Dawka po końcu symulacji nigdy nie zostałaby podana, a przeżywalność wyszłaby zerowa
+    if (spec.doseTime < 0.0f || spec.doseTime >= spec.duration) {
+        std::cerr << "ERROR::ENSEMBLE::dose_time must be in [0, duration)" << std::endl;
+        return false;
+    }
+    for (int initialCount : spec.initialCounts) {
+        if (initialCount <= 0) {
+            std::cerr << "ERROR::ENSEMBLE::initial_count must be positive (got " << initialCount << ")" << std::endl;
+            return false;
+        }
+    }
+    if (spec.inoculation.shape == InoculationShape::Streak && spec.inoculation.points.size() < 2) {
+        std::cerr << "ERROR::ENSEMBLE::pattern 'streak' needs at least two 'streak' points" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+EnsembleRunner::EnsembleRunner(const EnsembleConfig& config)
+    : config(config), coreBudget(0), finishedThisSession(0), totalPending(0) {
+    if (this->config.checkpointPath.empty()) {
+        this->config.checkpointPath = this->config.outputPath + ".checkpoint";
+    }
+}
+
+int EnsembleRunner::run() {
+    std::string specText;
+    if (!loadSweepSpec(config.specPath, spec, specText)) return -1;
+    // Kolumny wyników zależą od rejestru gatunków - inny rejestr to inny przebieg
+    uint64_t hash = fnv1a64(specText);
+    const SpeciesRegistry& registry = getSpeciesRegistry();
+    for (size_t species = 0; species < registry.size(); ++species) {
+        hash = fnv1a64(registry.get(static_cast<SpeciesId>(species)).name + "\n", hash);
+    }
+    specHash = hashToHex(hash);
+
+    unsigned int logicalCores = getLogicalCoreCount();
+    coreBudget = (config.coreBudget == 0) ? logicalCores : std::min(config.coreBudget, logicalCores);
+    for (unsigned int core = 0; core < coreBudget; ++core) freeCores.push_back(core);
+
+    bool resume = loadCheckpoint();
+    if (!openOutputs(resume)) return -1;
+
+    std::vector<EnsembleRun> runs = buildRuns();
+    std::vector<EnsembleRun> pending;
+    for (const EnsembleRun& run : runs) {
+        if (!completedRuns.count(run.index)) pending.push_back(run);
+    }
+    // Największe kolonie najpierw - małe wypełniają potem wolne rdzenie
+    std::stable_sort(pending.begin(), pending.end(),
+                     [](const EnsembleRun& a, const EnsembleRun& b) { return a.initialCount > b.initialCount; });
+    totalPending = pending.size();
+
+    std::cout << "INFO::ENSEMBLE::" << runs.size() << " runs in sweep, " << completedRuns.size()
+              << " already completed, " << pending.size() << " to run on " << coreBudget << " cores" << std::endl;
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Stała liczba wątków pobiera instancje po kolei; kolejna instancja startuje dopiero,
+    // gdy zwolni się tyle rdzeni, ile potrzebuje, więc kolejność z sortowania jest zachowana
+    size_t nextRun = 0;
+    auto worker = [this, &pending, &nextRun] {
+        for (;;) {
+            EnsembleRun run;
+            std::vector<unsigned int> cores;
+            {
+                std::unique_lock<std::mutex> lock(coreMutex);
+                coreReleased.wait(lock, [&] {
+                    return nextRun >= pending.size() || freeCores.size() >= chooseThreadCount(pending[nextRun]);
+                });
+                if (nextRun >= pending.size()) return;
+                run = pending[nextRun++];
+                unsigned int threadCount = chooseThreadCount(run);
+                cores.assign(freeCores.end() - threadCount, freeCores.end());
+                freeCores.resize(freeCores.size() - threadCount);
+            }
+
+            pinCurrentThreadToCore(cores.front());
+            EnsembleResult result = executeRun(run, cores);
+            recordResult(result);
+
+            std::lock_guard<std::mutex> lock(coreMutex);
+            freeCores.insert(freeCores.end(), cores.begin(), cores.end());
+            coreReleased.notify_all();
+        }
+    };
+    // Każda instancja zajmuje co najmniej jeden rdzeń - więcej wątków nie miałoby co robić
+    const size_t workerCount = std::min<size_t>(coreBudget, pending.size());
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "INFO::ENSEMBLE::Finished " << finishedThisSession << " runs in " << elapsed << " s, results in " << config.outputPath << std::endl;
+    // Kolonie są już zwolnione - istotne są wartości szczytowe
+    printMemoryReport(std::cout);
+    return 0;
+}
+
+// Punkt kontrolny: nagłówek z hashem specyfikacji, potem numery ukończonych instancji
+bool EnsembleRunner::loadCheckpoint() {
+    std::ifstream file(config.checkpointPath);
+    if (!file.is_open()) return false;
+
+    std::string header, hash;
+    file >> header >> hash;
+    if (header != CHECKPOINT_HEADER || hash != specHash) {
+        std::cout << "INFO::ENSEMBLE::Checkpoint belongs to a different sweep spec, starting from scratch" << std::endl;
+        return false;
+    }
+    uint32_t index;
+    while (file >> index) {
+        completedRuns.insert(index);
+    }
+    return true;
+}
+
+// Nagłówek CSV - kolumny gatunków pochodzą z rejestru
+static std::string buildOutputHeader() {
+    std::string header = "run,seed,strength,radius,initial_count,threads,population_at_dose,final_population,";
+    const SpeciesRegistry& registry = getSpeciesRegistry();
+    for (size_t species = 0; species < registry.size(); ++species) {
+        header += registry.getColumnName(static_cast<SpeciesId>(species)) + ",";
+    }
+    header += "births,deaths,mean_health,survival,colonies,largest_colony,wall_seconds";
+    return header;
+}
+
+bool EnsembleRunner::openOutputs(bool resume) {
+    const std::string header = buildOutputHeader();
+    if (resume) {
+        // Wyniki ukończonych instancji są tylko w CSV - bez niego punkt kontrolny jest bezużyteczny
+        std::ifstream existing(config.outputPath);
+        std::string existingHeader;
+        if (!existing.is_open() || !std::getline(existing, existingHeader) || trim(existingHeader).empty()) {
+            std::cout << "INFO::ENSEMBLE::" << config.outputPath << " is missing or empty, ignoring the checkpoint and starting from scratch" << std::endl;
+            completedRuns.clear();
+            resume = false;
+        } else if (trim(existingHeader) != header) {
+            std::cerr << "ERROR::ENSEMBLE::" << config.outputPath << " has different columns than the current species registry, "
+                      << "remove it and " << config.checkpointPath << " to start over" << std::endl;
+            return false;
+        }
+    }
+
+    std::ios::openmode mode = resume ? (std::ios::out | std::ios::app) : (std::ios::out | std::ios::trunc);
+    output.open(config.outputPath, mode);
+    checkpoint.open(config.checkpointPath, mode);
+    if (!output.is_open() || !checkpoint.is_open()) {
+        std::cerr << "ERROR::ENSEMBLE::Could not open output or checkpoint file" << std::endl;
+        return false;
+    }
+    if (!resume) {
+        output << header << "\n";
+        output.flush();
+        checkpoint << CHECKPOINT_HEADER << " " << specHash << "\n";
+        checkpoint.flush();
+    }
+    return true;
+}
+
+std::vector<EnsembleRun> EnsembleRunner::buildRuns() const {
+    std::vector<EnsembleRun> runs;
+    uint32_t index = 0;
+    for (int initialCount : spec.initialCounts) {
+        for (float strength : spec.strengths) {
+            for (float radius : spec.radii) {
+                for (uint32_t seed : spec.seeds) {
+                    runs.push_back({index++, seed, strength, radius, initialCount});
+                }
+            }
+        }
+    }
+    return runs;
+}
+
+unsigned int EnsembleRunner::chooseThreadCount(const EnsembleRun& run) const {
+    unsigned int wanted = static_cast<unsigned int>((run.initialCount + CELLS_PER_THREAD - 1) / CELLS_PER_THREAD);
+    return std::clamp(wanted, 1u, std::min(coreBudget, MAX_THREADS_PER_RUN));
+}
+
+EnsembleResult EnsembleRunner::executeRun(const EnsembleRun& run, const std::vector<unsigned int>& cores) const {
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Wątek instancji to pierwszy rdzeń, pula kolonii dostaje pozostałe
+    std::vector<unsigned int> workerCores(cores.begin() + 1, cores.end());
+    Colony colony(run.seed, workerCores.size(), workerCores);
+    colony.inoculate(spec.bacteriaType, spec.inoculation, static_cast<uint64_t>(run.initialCount));
+
+    EnsembleResult result;
+    result.run = run;
+    result.threadCount = static_cast<unsigned int>(cores.size());
+    result.populationAtDose = 0;
+
+    int stepCount = static_cast<int>(std::ceil(spec.duration / spec.timeStep));
+    // Pierwszy krok zaczynający się nie wcześniej niż dose_time; dose_time < duration (loadSweepSpec),
+    // a ostatni krok przyjmuje dawkę wypadającą już w jego trakcie
+    int doseStep = std::min(static_cast<int>(std::ceil(spec.doseTime / spec.timeStep)), stepCount - 1);
+    for (int step = 0; step < stepCount; ++step) {
+        if (step == doseStep) {
+            result.populationAtDose = colony.getStats().total;
+            colony.applyAntibiotic(glm::vec2(0.0f), run.strength, run.radius);
+        }
+        colony.update(spec.timeStep);
+    }
+
+    result.finalStats = colony.getStats();
+    colony.detectClusters();
+    const ColonyClusterReport& clusters = colony.getClusterReport();
+    result.finalColonyCount = clusters.clusterCount;
+    result.largestColonyCells = clusters.largest.empty() ? 0 : clusters.largest.front().cellCount;
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+// Wiersz wyników zapisujemy przed wpisem do punktu kontrolnego - po awarii instancja
+// może najwyżej pojawić się w wynikach dwukrotnie (z identycznym wynikiem), nigdy zniknąć
+void EnsembleRunner::recordResult(const EnsembleResult& result) {
+    const ColonyStatsSnapshot& stats = result.finalStats;
+    double survival = result.populationAtDose > 0
+        ? static_cast<double>(stats.total) / static_cast<double>(result.populationAtDose) : 0.0;
+
+    // Liczności gatunków to zmienna liczba kolumn w środku wiersza
+    char line[512];
+    std::string row;
+    std::snprintf(line, sizeof(line), "%u,%u,%.6g,%.6g,%d,%u,%llu,%llu,",
+                  result.run.index, result.run.seed, result.run.strength, result.run.radius, result.run.initialCount,
+                  result.threadCount,
+                  static_cast<unsigned long long>(result.populationAtDose),
+                  static_cast<unsigned long long>(stats.total));
+    row += line;
+    const size_t speciesCount = getSpeciesRegistry().size();
+    for (size_t species = 0; species < speciesCount; ++species) {
+        std::snprintf(line, sizeof(line), "%llu,", static_cast<unsigned long long>(stats.typeCounts[species]));
+        row += line;
+    }
+    std::snprintf(line, sizeof(line), "%llu,%llu,%.6f,%.6f,%llu,%llu,%.3f\n",
+                  static_cast<unsigned long long>(stats.totalBirths), static_cast<unsigned long long>(stats.totalDeaths),
+                  stats.meanHealth, survival,
+                  static_cast<unsigned long long>(result.finalColonyCount),
+                  static_cast<unsigned long long>(result.largestColonyCells), result.wallSeconds);
+    row += line;
+
+    std::lock_guard<std::mutex> lock(outputMutex);
+    output << row;
+    output.flush();
+    checkpoint << result.run.index << "\n";
+    checkpoint.flush();
+
+    ++finishedThisSession;
+    std::cout << "INFO::ENSEMBLE::[" << finishedThisSession << "/" << totalPending << "] run " << result.run.index
+              << " (seed " << result.run.seed << ", " << result.threadCount << " threads) done in " << result.wallSeconds << " s" << std::endl;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Simulation/IBacteria.h"
+#include "Simulation/ColonyStats.h"
+#include "Simulation/InoculationPattern.h"
+
+// Specyfikacja przeglądu parametrów - iloczyn kartezjański list wartości.
+// Plik tekstowy "klucz = wartości", wartości po przecinku lub zakres "od..do[:krok]", '#' to komentarz:
+//   seeds = 1..100
+//   strength = 0.2, 0.4, 0.6
+//   radius = 10..50:10
+//   initial_count = 100, 5000
+//   type = Cocci           # nazwa gatunku z rejestru
+//   duration = 30        # sekundy symulacji
+//   timestep = 0.016
+//   dose_time = 5        # chwila podania antybiotyku (w środku szalki)
+//   pattern = blob       # kształt zaszczepienia: blob, lawn, streak, grid (wokół środka szalki)
+//   spread = 2           # rozmiar wzoru: odchylenie, promień murawy lub odstęp siatki
+//   streak = -40 0, 0 20, 40 0   # wierzchołki łamanej dla pattern = streak
+struct SweepSpec {
+    std::vector<uint32_t> seeds{1};
+    std::vector<float> strengths{0.5f};
+    std::vector<float> radii{50.0f};
+    std::vector<int> initialCounts{100};
+    SpeciesId bacteriaType = 0; // Pierwszy gatunek rejestru
+    float duration = 30.0f;
+    float timeStep = 1.0f / 60.0f;
+    float doseTime = 5.0f;
+    InoculationPattern inoculation;
+};
+
+bool loadSweepSpec(const std::string& path, SweepSpec& spec, std::string& specText);
+
+struct EnsembleConfig {
+    std::string specPath;
+    std::string outputPath = "ensemble_results.csv";
+    std::string checkpointPath; // Domyślnie <outputPath>.checkpoint
+    unsigned int coreBudget = 0; // 0 = wszystkie rdzenie logiczne
+};
+
+// Jedna instancja przeglądu
+struct EnsembleRun {
+    uint32_t index;
+    uint32_t seed;
+    float strength;
+    float radius;
+    int initialCount;
+};
+
+struct EnsembleResult {
+    EnsembleRun run;
+    unsigned int threadCount;
+    uint64_t populationAtDose;
+    ColonyStatsSnapshot finalStats;
+    uint64_t finalColonyCount;      // Kolonie (skupiska stykających się komórek) po ostatnim kroku
+    uint64_t largestColonyCells;
+    double wallSeconds;
+};
+
+// Uruchamia wiele niezależnych kolonii bez okna. Rdzenie są przydzielane jak sloty:
+// małe kolonie dostają jeden rdzeń i przechodzą przez niego jedna po drugiej,
+// duże - kilka rdzeni (wątek kolonii i jej pula), wszystkie przypięte do przydzielonych rdzeni.
+// Wyniki trafiają strumieniowo do jednego CSV, a ukończone instancje do pliku punktu kontrolnego,
+// dzięki czemu przerwany przegląd można wznowić tym samym poleceniem.
+class EnsembleRunner {
+public:
+    explicit EnsembleRunner(const EnsembleConfig& config);
+
+    // Zwraca kod wyjścia procesu
+    int run();
+
+private:
+    bool loadCheckpoint();
+    bool openOutputs(bool resume);
+    std::vector<EnsembleRun> buildRuns() const;
+    unsigned int chooseThreadCount(const EnsembleRun& run) const;
+    EnsembleResult executeRun(const EnsembleRun& run, const std::vector<unsigned int>& cores) const;
+    void recordResult(const EnsembleResult& result);
+
+    EnsembleConfig config;
+    SweepSpec spec;
+    std::string specHash;
+    unsigned int coreBudget;
+
+    std::set<uint32_t> completedRuns;
+
+    std::mutex outputMutex;
+    std::ofstream output;
+    std::ofstream checkpoint;
+    size_t finishedThisSession;
+    size_t totalPending;
+
+    std::mutex coreMutex;
+    std::condition_variable coreReleased;
+    std::vector<unsigned int> freeCores;
+};
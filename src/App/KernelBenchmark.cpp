@@ -0,0 +1,235 @@
+#include "KernelBenchmark.h"
+
+#include "Simulation/CellKernels.h"
+#include "Simulation/Colony.h"
+#include "Simulation/SpeciesRegistry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Największa dopuszczalna różnica względem wersji skalarnej
+const float KERNEL_TOLERANCE = 1e-5f;
+// Minimalny czas pomiaru jednego jądra - krótsze pomiary są powtarzane
+const double MIN_MEASURE_SECONDS = 0.2;
+// Pomiar lokalności: kolonia wyhodowana z kilkuset zaszczepień rozrzuconych po szalce
+const int LOCALITY_INOCULATIONS = 256;
+const int LOCALITY_CELLS_PER_INOCULATION = 16;
+const int LOCALITY_MAX_TICKS = 5000;
+// Antybiotyk o znikomej sile - przebieg dotyka komórek w zasięgu, prawie ich nie zabijając
+const float LOCALITY_ANTIBIOTIC_STRENGTH = 1e-4f;
+const float LOCALITY_ANTIBIOTIC_RADIUS = 20.0f;
+// Parametry wywołań jąder w sprawdzeniu i pomiarze
+const float KERNEL_CENTER_X = 10.0f;
+const float KERNEL_CENTER_Y = -5.0f;
+const float KERNEL_STRENGTH = 0.8f;
+const float KERNEL_RADIUS = 60.0f;
+const float KERNEL_DELTA_TIME = 1.0f / 60.0f;
+const int KERNEL_COUNT = 4;
+const char* const KERNEL_NAMES[KERNEL_COUNT] = {"antibioticFalloff", "applyDamage", "decrementTimers", "countAlive"};
+
+namespace {
+
+// Losowe dane komórek: pozycje na szalce, część martwych, odporność także poza [0, 0.95]
+struct KernelInput {
+    std::vector<float> x, y, health, resistance, intensity, timer;
+
+    explicit KernelInput(size_t count) : x(count), y(count), health(count), resistance(count), intensity(count), timer(count) {
+        std::mt19937 rng(12345);
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        for (size_t i = 0; i < count; ++i) {
+            x[i] = position(rng);
+            y[i] = position(rng);
+            health[i] = unit(rng) < 0.1f ? 0.0f : 1.2f * unit(rng);
+            resistance[i] = 1.2f * unit(rng) - 0.1f;
+            intensity[i] = unit(rng);
+            timer[i] = 12.0f * unit(rng);
+        }
+    }
+};
+
+// Wyniki jednego przebiegu wszystkich jąder na danych wejściowych
+struct KernelOutput {
+    std::vector<float> falloff, health, timer;
+    size_t alive = 0;
+};
+
+KernelOutput runKernels(const CellKernelTable& kernels, const KernelInput& input) {
+    const size_t count = input.x.size();
+    KernelOutput output;
+    output.falloff.resize(count);
+    output.health = input.health;
+    output.timer = input.timer;
+    kernels.antibioticFalloff(input.x.data(), input.y.data(), count, KERNEL_CENTER_X, KERNEL_CENTER_Y, KERNEL_STRENGTH, KERNEL_RADIUS, output.falloff.data());
+    kernels.applyDamage(output.health.data(), input.resistance.data(), input.intensity.data(), count);
+    kernels.decrementTimers(output.timer.data(), input.health.data(), count, KERNEL_DELTA_TIME);
+    output.alive = kernels.countAlive(input.health.data(), count);
+    return output;
+}
+
+float maxDifference(const std::vector<float>& a, const std::vector<float>& b) {
+    float difference = 0.0f;
+    for (size_t i = 0; i < a.size(); ++i) difference = std::max(difference, std::fabs(a[i] - b[i]));
+    return difference;
+}
+
+// Największe odchylenie każdego jądra od wyników referencyjnych, w kolejności KERNEL_NAMES
+void kernelErrors(const KernelOutput& output, const KernelOutput& reference, float errors[KERNEL_COUNT]) {
+    errors[0] = maxDifference(output.falloff, reference.falloff);
+    errors[1] = maxDifference(output.health, reference.health);
+    errors[2] = maxDifference(output.timer, reference.timer);
+    errors[3] = static_cast<float>(output.alive > reference.alive ? output.alive - reference.alive : reference.alive - output.alive);
+}
+
+// Średni czas jednego wywołania w nanosekundach na komórkę
+double measure(size_t count, const std::function<void()>& body) {
+    using Clock = std::chrono::steady_clock;
+    size_t iterations = 0;
+    auto start = Clock::now();
+    double elapsed = 0.0;
+    do {
+        body();
+        ++iterations;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < MIN_MEASURE_SECONDS);
+    return elapsed * 1e9 / (static_cast<double>(iterations) * static_cast<double>(count));
+}
+
+// Zysk z porządkowania przestrzennego: kolonia rośnie bez porządkowania (potomstwo dopisywane
+// na końcu listy), potem te same przebiegi przestrzenne przed i po uporządkowaniu wzdłuż krzywej Mortona
+void runLocalityBenchmark(size_t cellCount) {
+    Colony colony(12345);
+    SpatialOrderSettings disabled;
+    disabled.fragmentationThreshold = 0.0f;
+    colony.setSpatialOrderSettings(disabled);
+    PopulationBudget budget;
+    budget.maxIndividuals = 2 * cellCount;
+    budget.maxMemoryBytes = 2 * cellCount * PopulationGovernor::estimateBytesPerIndividual();
+    colony.setPopulationBudget(budget);
+
+    std::mt19937 rng(54321);
+    std::uniform_real_distribution<float> position(-150.0f, 150.0f);
+    for (int i = 0; i < LOCALITY_INOCULATIONS; ++i) {
+        colony.inoculate(static_cast<SpeciesId>(i % getSpeciesRegistry().size()), glm::vec2(position(rng), position(rng)),
+                         LOCALITY_CELLS_PER_INOCULATION, 1.0f);
+    }
+    for (int tick = 0; tick < LOCALITY_MAX_TICKS && colony.size() < cellCount; ++tick) {
+        colony.update(1.0f);
+    }
+    const size_t count = colony.size();
+
+    // Środki antybiotyku w stałej kolejności, by oba pomiary dotykały tych samych komórek
+    std::vector<glm::vec2> centers(64);
+    for (glm::vec2& center : centers) center = glm::vec2(position(rng), position(rng));
+    size_t nextCenter = 0;
+    auto antibioticPass = [&] {
+        colony.applyAntibiotic(centers[nextCenter++ % centers.size()], LOCALITY_ANTIBIOTIC_STRENGTH, LOCALITY_ANTIBIOTIC_RADIUS);
+    };
+    auto clusterPass = [&] { colony.detectClusters(); };
+
+    const float fragmentationBefore = colony.getFragmentation();
+    nextCenter = 0;
+    const double antibioticBefore = measure(count, antibioticPass);
+    const double clustersBefore = measure(count, clusterPass);
+
+    colony.reorderNow();
+    const SpatialOrderStats& orderStats = colony.getSpatialOrderStats();
+    nextCenter = 0;
+    const double antibioticAfter = measure(count, antibioticPass);
+    const double clustersAfter = measure(count, clusterPass);
+
+    std::cout << "INFO::KERNELS::Spatial order on " << count << " cells: fragmentation " << fragmentationBefore
+              << " -> " << colony.getFragmentation() << ", reorder " << orderStats.lastReorderMilliseconds << " ms" << std::endl;
+    std::printf("%-20s %12s %12s %9s\n", "pass", "unordered", "morton", "speedup");
+    std::printf("%-20s %12.3f %12.3f %8.2fx\n", "applyAntibiotic", antibioticBefore, antibioticAfter, antibioticBefore / antibioticAfter);
+    std::printf("%-20s %12.3f %12.3f %8.2fx\n", "detectClusters", clustersBefore, clustersAfter, clustersBefore / clustersAfter);
+}
+
+} // namespace
+
+int validateCellKernels(size_t cellCount) {
+    const KernelInput input(cellCount | 1);
+    const KernelOutput reference = runKernels(*getCellKernelsForIsa(CellKernelIsa::Scalar), input);
+
+    bool allMatch = true;
+    for (int isaIndex = 0; isaIndex < CELL_KERNEL_ISA_COUNT; ++isaIndex) {
+        const CellKernelIsa isa = static_cast<CellKernelIsa>(isaIndex);
+        const CellKernelTable* kernels = getCellKernelsForIsa(isa);
+        if (!kernels) {
+            std::cout << "INFO::KERNELS::" << getCellKernelIsaName(isa) << " unsupported on this CPU, skipped" << std::endl;
+            continue;
+        }
+        float errors[KERNEL_COUNT];
+        kernelErrors(runKernels(*kernels, input), reference, errors);
+        for (int kernel = 0; kernel < KERNEL_COUNT; ++kernel) {
+            if (errors[kernel] <= KERNEL_TOLERANCE) continue;
+            allMatch = false;
+            std::cerr << "ERROR::KERNELS::" << KERNEL_NAMES[kernel] << " (" << getCellKernelIsaName(isa)
+                      << ") differs from the scalar reference by " << errors[kernel] << std::endl;
+        }
+        std::cout << "INFO::KERNELS::" << getCellKernelIsaName(isa) << " checked" << std::endl;
+    }
+    return allMatch ? 0 : 1;
+}
+
+int runKernelBenchmark(size_t cellCount) {
+    // Nieparzysta liczba komórek, żeby sprawdzić także obsługę końcówki tablicy
+    const size_t count = cellCount | 1;
+    const KernelInput input(count);
+    const KernelOutput reference = runKernels(*getCellKernelsForIsa(CellKernelIsa::Scalar), input);
+
+    std::cout << "INFO::KERNELS::" << count << " cells, runtime selection: " << getCellKernelIsaName(getCellKernels().isa) << std::endl;
+    std::printf("%-20s %-8s %10s %9s %10s\n", "kernel", "isa", "ns/cell", "speedup", "max error");
+
+    double scalarTimes[KERNEL_COUNT] = {0.0, 0.0, 0.0, 0.0};
+    bool allMatch = true;
+    for (int isaIndex = 0; isaIndex < CELL_KERNEL_ISA_COUNT; ++isaIndex) {
+        const CellKernelIsa isa = static_cast<CellKernelIsa>(isaIndex);
+        const CellKernelTable* kernels = getCellKernelsForIsa(isa);
+        if (!kernels) {
+            std::printf("%-20s %-8s %10s\n", "*", getCellKernelIsaName(isa), "unsupported");
+            continue;
+        }
+
+        KernelOutput output = runKernels(*kernels, input);
+        float errors[KERNEL_COUNT];
+        kernelErrors(output, reference, errors);
+
+        // Pomiary na kopiach roboczych - zdrowie odtwarzane przed każdym przebiegiem byłoby głównym kosztem,
+        // więc obrażenia liczone są wielokrotnie na tej samej tablicy (po kilku przebiegach większość jest martwa)
+        std::vector<float> workHealth = input.health, workTimer = input.timer;
+        size_t aliveSink = 0;
+        const double times[KERNEL_COUNT] = {
+            measure(count, [&] { kernels->antibioticFalloff(input.x.data(), input.y.data(), count, KERNEL_CENTER_X, KERNEL_CENTER_Y,
+                                                            KERNEL_STRENGTH, KERNEL_RADIUS, output.falloff.data()); }),
+            measure(count, [&] { std::copy(input.health.begin(), input.health.end(), workHealth.begin());
+                                 kernels->applyDamage(workHealth.data(), input.resistance.data(), input.intensity.data(), count); }),
+            measure(count, [&] { kernels->decrementTimers(workTimer.data(), input.health.data(), count, KERNEL_DELTA_TIME); }),
+            measure(count, [&] { aliveSink += kernels->countAlive(input.health.data(), count); })
+        };
+        (void)aliveSink;
+
+        const char* kernelNames[KERNEL_COUNT] = {"antibioticFalloff", "applyDamage (+copy)", "decrementTimers", "countAlive"};
+        for (int kernel = 0; kernel < KERNEL_COUNT; ++kernel) {
+            if (isa == CellKernelIsa::Scalar) scalarTimes[kernel] = times[kernel];
+            const bool match = errors[kernel] <= KERNEL_TOLERANCE;
+            allMatch = allMatch && match;
+            std::printf("%-20s %-8s %10.3f %8.2fx %10.2g%s\n", kernelNames[kernel], getCellKernelIsaName(isa), times[kernel],
+                        scalarTimes[kernel] / times[kernel], static_cast<double>(errors[kernel]), match ? "" : "  MISMATCH");
+        }
+    }
+
+    if (!allMatch) {
+        std::cerr << "ERROR::KERNELS::Vector kernels differ from the scalar reference" << std::endl;
+        return 1;
+    }
+
+    runLocalityBenchmark(cellCount);
+    return 0;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+// Porównanie wariantów jąder komórkowych (CellKernels) z wersją skalarną na losowych danych:
+// najpierw sprawdzenie zgodności wyników w granicach tolerancji, potem czas na komórkę
+// i przyspieszenie. Na koniec czas przebiegów przestrzennych kolonii przed i po jej uporządkowaniu
+// wzdłuż krzywej Mortona. Zwraca kod wyjścia procesu - niezerowy, gdy którykolwiek wariant odbiega.
+int runKernelBenchmark(size_t cellCount);
+
+// Samo sprawdzenie zgodności wariantów obsługiwanych przez procesor, bez pomiarów i bez
+// interakcji (--validate-kernels, test CTest). Zwraca 1, gdy którekolwiek jądro odbiega od skalarnego.
+int validateCellKernels(size_t cellCount);
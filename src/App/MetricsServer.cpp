@@ -0,0 +1,401 @@
+#include "MetricsServer.h"
+
+#include "Simulation/Colony.h"
+#include "Utils/MemoryTracker.h"
+#include "Utils/Trace.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#if defined(_WIN32)
+#define METRICS_WINSOCK 1
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define METRICS_POSIX 1
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#if defined(METRICS_POSIX) || defined(METRICS_WINSOCK)
+#define METRICS_SOCKETS 1
+#endif
+
+// Co tyle ms wątek serwera sprawdza, czy ma się zakończyć
+const int METRICS_POLL_MILLISECONDS = 200;
+// Ograniczenie nagłówków żądania - dłuższe są odrzucane
+const size_t MAX_METRICS_REQUEST_BYTES = 8192;
+const int METRICS_RECEIVE_TIMEOUT_SECONDS = 2;
+
+namespace {
+    // Wartość etykiety w formacie Prometheusa: \, " i znak nowej linii poprzedzone \.
+    std::string escapeLabel(const std::string& value) {
+        std::string escaped;
+        for (char c : value) {
+            if (c == '\\' || c == '"') {
+                escaped += '\\';
+                escaped += c;
+            } else if (c == '\n') {
+                escaped += "\\n";
+            } else {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    void writeHeader(std::ostringstream& out, const char* name, const char* type, const char* help) {
+        out << "# HELP " << name << ' ' << help << '\n' << "# TYPE " << name << ' ' << type << '\n';
+    }
+
+#ifdef METRICS_WINSOCK
+    const MetricsSocketHandle INVALID_METRICS_SOCKET = INVALID_SOCKET;
+
+    void closeSocket(MetricsSocketHandle socketHandle) {
+        closesocket(socketHandle);
+    }
+
+    std::string socketErrorText() {
+        return "Winsock error " + std::to_string(WSAGetLastError());
+    }
+#elif defined(METRICS_POSIX)
+    const MetricsSocketHandle INVALID_METRICS_SOCKET = -1;
+
+    void closeSocket(MetricsSocketHandle socketHandle) {
+        close(socketHandle);
+    }
+
+    std::string socketErrorText() {
+        return std::strerror(errno);
+    }
+#endif
+
+    template <typename T>
+    void writeMetric(std::ostringstream& out, const char* name, const char* type, const char* help, T value) {
+        writeHeader(out, name, type, help);
+        out << name << ' ' << value << '\n';
+    }
+}
+
+LiveMetrics::LiveMetrics() {
+    for (std::atomic<uint64_t>& count : speciesPopulation) count.store(0, std::memory_order_relaxed);
+    for (std::atomic<float>& frameTime : frameTimes) frameTime.store(0.0f, std::memory_order_relaxed);
+}
+
+void LiveMetrics::publishColony(const Colony& colony) {
+    const ColonyStatsSnapshot& stats = colony.getStats();
+    tick.store(colony.getTick(), std::memory_order_relaxed);
+    simulationTime.store(colony.getSimulationTime(), std::memory_order_relaxed);
+    population.store(stats.total, std::memory_order_relaxed);
+    simulationObjects.store(colony.size(), std::memory_order_relaxed);
+    objectLimit.store(colony.getPopulationGovernor().getIndividualLimit(), std::memory_order_relaxed);
+    births.store(stats.totalBirths, std::memory_order_relaxed);
+    deaths.store(stats.totalDeaths, std::memory_order_relaxed);
+    meanHealth.store(stats.meanHealth, std::memory_order_relaxed);
+    for (size_t species = 0; species < MAX_SPECIES; ++species) {
+        speciesPopulation[species].store(stats.typeCounts[species], std::memory_order_relaxed);
+    }
+    const ColonyClusterReport& clusters = colony.getClusterReport();
+    colonies.store(clusters.clusterCount, std::memory_order_relaxed);
+    largestColony.store(clusters.largest.empty() ? 0 : clusters.largest.front().cellCount, std::memory_order_relaxed);
+}
+
+void LiveMetrics::recordFrame(float seconds) {
+    // Jedyny zapisujący to wątek główny - wystarczy odczyt i zapis zamiast operacji atomowej RMW
+    const uint64_t index = frameCount.load(std::memory_order_relaxed);
+    frameTimes[index % METRICS_FRAME_TIME_SAMPLES].store(seconds, std::memory_order_relaxed);
+    frameTimeSum.store(frameTimeSum.load(std::memory_order_relaxed) + seconds, std::memory_order_relaxed);
+    frameCount.store(index + 1, std::memory_order_release);
+}
+
+MetricsServer::MetricsServer(const LiveMetrics& metrics, const MetricsServerConfig& config)
+    : metrics(metrics), config(config), listenSocket(static_cast<MetricsSocketHandle>(-1)), networkStarted(false),
+      running(false), scrapeCount(0) {
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start() {
+#ifdef METRICS_SOCKETS
+    const std::string unixPrefix = "unix:";
+    const bool unixEndpoint = config.endpoint.compare(0, unixPrefix.size(), unixPrefix) == 0;
+#ifdef METRICS_WINSOCK
+    if (unixEndpoint) {
+        std::cerr << "ERROR::METRICS::unix: endpoints need POSIX sockets, use a TCP port on this platform" << std::endl;
+        return false;
+    }
+    WSADATA winsockData;
+    if (WSAStartup(MAKEWORD(2, 2), &winsockData) != 0) {
+        std::cerr << "ERROR::METRICS::Could not initialize Winsock" << std::endl;
+        return false;
+    }
+    networkStarted = true;
+#else
+    if (unixEndpoint) {
+        unixSocketPath = config.endpoint.substr(unixPrefix.size());
+        sockaddr_un address{};
+        if (unixSocketPath.empty() || unixSocketPath.size() >= sizeof(address.sun_path)) {
+            std::cerr << "ERROR::METRICS::Invalid unix socket path: " << unixSocketPath << std::endl;
+            return false;
+        }
+        // Gniazdo po poprzednim uruchomieniu blokowałoby bind; usuwane jest wyłącznie gniazdo,
+        // żeby pomyłka w ścieżce nie skasowała zwykłego pliku
+        struct stat existing;
+        if (lstat(unixSocketPath.c_str(), &existing) == 0) {
+            if (!S_ISSOCK(existing.st_mode)) {
+                std::cerr << "ERROR::METRICS::Refusing to replace " << unixSocketPath << ": path exists and is not a socket" << std::endl;
+                unixSocketPath.clear();
+                return false;
+            }
+            unlink(unixSocketPath.c_str());
+        }
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, unixSocketPath.c_str(), sizeof(address.sun_path) - 1);
+        listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenSocket == INVALID_METRICS_SOCKET || bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            std::cerr << "ERROR::METRICS::Could not bind " << config.endpoint << ": " << socketErrorText() << std::endl;
+            // Ścieżka nie należy do tego serwera - stop() nie może jej usunąć
+            unixSocketPath.clear();
+            stop();
+            return false;
+        }
+    } else
+#endif
+    {
+        char* end = nullptr;
+        unsigned long port = std::strtoul(config.endpoint.c_str(), &end, 10);
+        if (config.endpoint.empty() || *end != '\0' || port == 0 || port > 65535) {
+            std::cerr << "ERROR::METRICS::Invalid metrics endpoint (expected port or unix:<path>): " << config.endpoint << std::endl;
+            stop();
+            return false;
+        }
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        // Tylko lokalnie - metryki nie są uwierzytelniane
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+#ifndef METRICS_WINSOCK
+        // Na Windows SO_REUSEADDR pozwoliłby przejąć port zajęty przez inny proces
+        int reuse = 1;
+        if (listenSocket != INVALID_METRICS_SOCKET) setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+#endif
+        if (listenSocket == INVALID_METRICS_SOCKET || bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            std::cerr << "ERROR::METRICS::Could not bind 127.0.0.1:" << port << ": " << socketErrorText() << std::endl;
+            stop();
+            return false;
+        }
+    }
+    if (listen(listenSocket, 8) != 0) {
+        std::cerr << "ERROR::METRICS::Could not listen on " << config.endpoint << ": " << socketErrorText() << std::endl;
+        stop();
+        return false;
+    }
+
+    running.store(true);
+    serverThread = std::thread(&MetricsServer::serveLoop, this);
+    std::cout << "INFO::METRICS::Serving Prometheus metrics on "
+              << (unixSocketPath.empty() ? "http://127.0.0.1:" + config.endpoint + "/metrics" : config.endpoint) << std::endl;
+    return true;
+#else
+    std::cerr << "ERROR::METRICS::Metrics server needs POSIX sockets or Winsock, not available on this platform" << std::endl;
+    return false;
+#endif
+}
+
+void MetricsServer::stop() {
+#ifdef METRICS_SOCKETS
+    running.store(false);
+    if (serverThread.joinable()) serverThread.join();
+    if (listenSocket != INVALID_METRICS_SOCKET) {
+        closeSocket(listenSocket);
+        listenSocket = INVALID_METRICS_SOCKET;
+#ifdef METRICS_POSIX
+        if (!unixSocketPath.empty()) unlink(unixSocketPath.c_str());
+#endif
+    }
+#endif
+#ifdef METRICS_WINSOCK
+    if (networkStarted) WSACleanup();
+#endif
+    networkStarted = false;
+}
+
+void MetricsServer::serveLoop() {
+#ifdef METRICS_SOCKETS
+    setTraceThreadName("metrics server");
+    while (running.load(std::memory_order_relaxed)) {
+#ifdef METRICS_WINSOCK
+        WSAPOLLFD listening{listenSocket, POLLRDNORM, 0};
+        if (WSAPoll(&listening, 1, METRICS_POLL_MILLISECONDS) <= 0) continue;
+#else
+        pollfd listening{listenSocket, POLLIN, 0};
+        if (poll(&listening, 1, METRICS_POLL_MILLISECONDS) <= 0) continue;
+#endif
+        MetricsSocketHandle connection = accept(listenSocket, nullptr, nullptr);
+        if (connection == INVALID_METRICS_SOCKET) continue;
+        handleConnection(connection);
+        closeSocket(connection);
+    }
+#endif
+}
+
+void MetricsServer::handleConnection(MetricsSocketHandle connection) {
+#ifdef METRICS_SOCKETS
+    TRACE_SCOPE("metrics", "MetricsServer::scrape");
+    // Klient, który nie wyśle żądania, nie może zatrzymać serwera na dłużej
+#ifdef METRICS_WINSOCK
+    DWORD timeout = METRICS_RECEIVE_TIMEOUT_SECONDS * 1000;
+    setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+#else
+    timeval timeout{METRICS_RECEIVE_TIMEOUT_SECONDS, 0};
+    setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+#endif
+
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_METRICS_REQUEST_BYTES) {
+        auto received = recv(connection, buffer, static_cast<int>(sizeof(buffer)), 0);
+        if (received <= 0) break;
+        request.append(buffer, static_cast<size_t>(received));
+    }
+
+    std::istringstream requestLine(request.substr(0, request.find("\r\n")));
+    std::string method, target;
+    requestLine >> method >> target;
+    target = target.substr(0, target.find('?'));
+
+    std::string status = "200 OK";
+    std::string body;
+    if (method != "GET") {
+        status = "405 Method Not Allowed";
+        body = "Only GET is supported\n";
+    } else if (target != "/metrics" && target != "/") {
+        status = "404 Not Found";
+        body = "Metrics are served at /metrics\n";
+    } else {
+        body = buildResponseBody();
+        scrapeCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::ostringstream response;
+    response << "HTTP/1.1 " << status << "\r\n"
+             << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+    const std::string bytes = response.str();
+
+#ifdef MSG_NOSIGNAL
+    const int sendFlags = MSG_NOSIGNAL; // Rozłączony klient nie może zakończyć procesu sygnałem SIGPIPE
+#else
+    const int sendFlags = 0;
+#endif
+    size_t sent = 0;
+    while (sent < bytes.size()) {
+        // Odpowiedź ma kilkadziesiąt KB, więc mieści się w int wymaganym przez Winsock
+        auto written = send(connection, bytes.data() + sent, static_cast<int>(bytes.size() - sent), sendFlags);
+        if (written <= 0) break;
+        sent += static_cast<size_t>(written);
+    }
+#else
+    (void)connection;
+#endif
+}
+
+std::string MetricsServer::buildResponseBody() const {
+    const auto relaxed = std::memory_order_relaxed;
+    std::ostringstream out;
+
+    writeMetric(out, "petridish_ticks_total", "counter", "Simulation steps since start.", metrics.tick.load(relaxed));
+    writeMetric(out, "petridish_simulation_time_seconds", "gauge", "Simulated time.", metrics.simulationTime.load(relaxed));
+    writeMetric(out, "petridish_tick_rate", "gauge", "Achieved simulation steps per wall-clock second (moving average).",
+                metrics.ticksPerSecond.load(relaxed));
+    writeMetric(out, "petridish_time_warp", "gauge", "Requested simulation speed-up.", metrics.timeWarp.load(relaxed));
+
+    writeMetric(out, "petridish_population", "gauge", "Living cells, super-individuals counted by multiplicity.",
+                metrics.population.load(relaxed));
+    writeHeader(out, "petridish_population_by_species", "gauge", "Living cells per species.");
+    const SpeciesRegistry& registry = getSpeciesRegistry();
+    for (size_t species = 0; species < registry.size(); ++species) {
+        out << "petridish_population_by_species{species=\"" << escapeLabel(registry.get(static_cast<SpeciesId>(species)).name)
+            << "\"} " << metrics.speciesPopulation[species].load(relaxed) << '\n';
+    }
+    writeMetric(out, "petridish_simulation_objects", "gauge", "Cell objects in the simulation.", metrics.simulationObjects.load(relaxed));
+    writeMetric(out, "petridish_simulation_object_limit", "gauge", "Object limit from the population budget.",
+                metrics.objectLimit.load(relaxed));
+    writeMetric(out, "petridish_births_total", "counter", "Cell divisions since start.", metrics.births.load(relaxed));
+    writeMetric(out, "petridish_deaths_total", "counter", "Cell deaths since start.", metrics.deaths.load(relaxed));
+    writeMetric(out, "petridish_mean_health", "gauge", "Mean cell health.", metrics.meanHealth.load(relaxed));
+    writeMetric(out, "petridish_colonies", "gauge", "Colonies found by the last cluster detection.", metrics.colonies.load(relaxed));
+    writeMetric(out, "petridish_largest_colony_cells", "gauge", "Cells in the largest colony.", metrics.largestColony.load(relaxed));
+
+    // Percentyle z ostatnich próbek; próbka nadpisana w trakcie kopiowania to najwyżej jedna nowsza klatka
+    const uint64_t frameCount = metrics.frameCount.load(std::memory_order_acquire);
+    const size_t sampleCount = static_cast<size_t>(std::min<uint64_t>(frameCount, METRICS_FRAME_TIME_SAMPLES));
+    std::vector<float> frameTimes(sampleCount);
+    for (size_t i = 0; i < sampleCount; ++i) frameTimes[i] = metrics.frameTimes[i].load(relaxed);
+    std::sort(frameTimes.begin(), frameTimes.end());
+    writeHeader(out, "petridish_frame_time_seconds", "summary", "Wall-clock frame time, quantiles over recent frames.");
+    const double quantiles[] = {0.5, 0.9, 0.99};
+    for (double quantile : quantiles) {
+        out << "petridish_frame_time_seconds{quantile=\"" << quantile << "\"} ";
+        if (sampleCount == 0) {
+            out << "NaN\n";
+        } else {
+            size_t index = std::min(sampleCount - 1, static_cast<size_t>(quantile * static_cast<double>(sampleCount)));
+            out << frameTimes[index] << '\n';
+        }
+    }
+    out << "petridish_frame_time_seconds_sum " << metrics.frameTimeSum.load(relaxed) << '\n'
+        << "petridish_frame_time_seconds_count " << frameCount << '\n';
+
+    // Liczniki pamięci są atomowe z założenia (MemoryTracker) - odczyt nie zatrzymuje alokacji
+    const MemoryReport memory = getMemoryReport();
+    struct MemoryColumn {
+        const char* name;
+        const char* type;
+        const char* help;
+        uint64_t MemoryTagStats::*field;
+    };
+    const MemoryColumn memoryColumns[] = {
+        {"petridish_memory_live_bytes", "gauge", "Live bytes per subsystem.", &MemoryTagStats::liveBytes},
+        {"petridish_memory_peak_bytes", "gauge", "Peak live bytes per subsystem.", &MemoryTagStats::peakBytes},
+        {"petridish_memory_live_allocations", "gauge", "Live allocations per subsystem.", &MemoryTagStats::liveAllocations},
+        {"petridish_memory_allocations_total", "counter", "Allocations per subsystem since start.", &MemoryTagStats::totalAllocations},
+    };
+    for (const MemoryColumn& column : memoryColumns) {
+        writeHeader(out, column.name, column.type, column.help);
+        for (size_t tag = 0; tag < MEMORY_TAG_COUNT; ++tag) {
+            out << column.name << "{subsystem=\"" << getMemoryTagName(static_cast<MemoryTag>(tag)) << "\"} "
+                << memory.tags[tag].*column.field << '\n';
+        }
+    }
+
+    writeHeader(out, "petridish_queue_depth", "gauge", "Items waiting in internal queues.");
+    out << "petridish_queue_depth{queue=\"commands\"} " << metrics.pendingCommands.load(relaxed) << '\n'
+        << "petridish_queue_depth{queue=\"telemetry\"} " << metrics.telemetryQueueDepth.load(relaxed) << '\n'
+        << "petridish_queue_depth{queue=\"capture\"} " << metrics.captureQueueDepth.load(relaxed) << '\n';
+    writeMetric(out, "petridish_telemetry_dropped_total", "counter", "Telemetry records dropped because the exporter fell behind.",
+                metrics.telemetryDropped.load(relaxed));
+    writeMetric(out, "petridish_metrics_scrapes_total", "counter", "Metrics requests served.", scrapeCount.load(relaxed));
+    return out.str();
+}
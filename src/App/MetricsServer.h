@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "Simulation/SpeciesRegistry.h"
+
+class Colony;
+
+#ifdef _WIN32
+using MetricsSocketHandle = uintptr_t; // SOCKET z Winsock - bez dołączania winsock2.h w nagłówku
+#else
+using MetricsSocketHandle = int;
+#endif
+
+// Liczba zapamiętanych czasów klatek, z których liczone są percentyle
+const size_t METRICS_FRAME_TIME_SAMPLES = 1024;
+
+// Liczniki publikowane przez wątek główny i odczytywane przez serwer metryk.
+// Wszystkie pola są atomowe - zapytanie nie dotyka kolonii ani renderera, a publikacja
+// to kilkadziesiąt zapisów bez synchronizacji (relaxed). Pomiar może łączyć wartości
+// z sąsiednich klatek, co przy odpytywaniu co kilka sekund nie ma znaczenia.
+struct LiveMetrics {
+    // Symulacja
+    std::atomic<uint64_t> tick{0};
+    std::atomic<double> simulationTime{0.0};
+    std::atomic<float> ticksPerSecond{0.0f};   // Średnia krocząca osiągniętych kroków na sekundę
+    std::atomic<float> timeWarp{1.0f};         // Żądane przyspieszenie czasu
+    std::atomic<uint64_t> population{0};       // Komórki z krotnością
+    std::atomic<uint64_t> simulationObjects{0};
+    std::atomic<uint64_t> objectLimit{0};
+    std::atomic<uint64_t> births{0};
+    std::atomic<uint64_t> deaths{0};
+    std::atomic<float> meanHealth{0.0f};
+    std::atomic<uint64_t> speciesPopulation[MAX_SPECIES];
+    std::atomic<uint64_t> colonies{0};
+    std::atomic<uint64_t> largestColony{0};
+
+    // Czasy klatek: pierścień ostatnich próbek oraz suma i liczba od startu
+    std::atomic<float> frameTimes[METRICS_FRAME_TIME_SAMPLES];
+    std::atomic<uint64_t> frameCount{0};
+    std::atomic<double> frameTimeSum{0.0};
+
+    // Kolejki
+    std::atomic<uint64_t> pendingCommands{0};
+    std::atomic<uint64_t> telemetryQueueDepth{0};
+    std::atomic<uint64_t> telemetryDropped{0};
+    std::atomic<uint64_t> captureQueueDepth{0};  // Klatki odczytane z GPU, a jeszcze nie zapisane
+
+    LiveMetrics();
+
+    // Wątek główny: stan kolonii po krokach symulacji
+    void publishColony(const Colony& colony);
+    // Wątek główny: czas całej klatki w sekundach
+    void recordFrame(float seconds);
+};
+
+struct MetricsServerConfig {
+    // Port TCP na 127.0.0.1 albo "unix:<ścieżka>" dla gniazda domenowego (tylko POSIX)
+    std::string endpoint;
+};
+
+// Serwer metryk w formacie tekstowym Prometheusa (GET /metrics) na osobnym wątku.
+// Obsługuje jedno połączenie naraz; odpowiedź składana jest wyłącznie z LiveMetrics
+// i liczników pamięci. Port TCP działa z gniazdami POSIX i z Winsock; gniazdo domenowe
+// tylko na POSIX, a na systemach bez żadnego z nich start() zwraca false.
+class MetricsServer {
+public:
+    MetricsServer(const LiveMetrics& metrics, const MetricsServerConfig& config);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    bool start();
+    void stop();
+
+    uint64_t getScrapeCount() const { return scrapeCount.load(std::memory_order_relaxed); }
+
+private:
+    void serveLoop();
+    void handleConnection(MetricsSocketHandle connection);
+    std::string buildResponseBody() const;
+
+    const LiveMetrics& metrics;
+    MetricsServerConfig config;
+    std::string unixSocketPath;
+    MetricsSocketHandle listenSocket;
+    bool networkStarted; // Winsock wymaga WSAStartup/WSACleanup wokół użycia gniazd
+
+    std::thread serverThread;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> scrapeCount;
+};
@@ -0,0 +1,73 @@
+#include "OffscreenContext.h"
+
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+
+#if defined(GLFW_PLATFORM_NULL) && defined(GLFW_EGL_CONTEXT_API) && defined(GLFW_OSMESA_CONTEXT_API)
+namespace {
+
+// Próba utworzenia kontekstu danego API na niewidocznym oknie 1x1
+bool probeContextApi(int contextApi) {
+    glfwDefaultWindowHints();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, contextApi);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+    GLFWwindow* probe = glfwCreateWindow(1, 1, "", nullptr, nullptr);
+    if (!probe) return false;
+    glfwDestroyWindow(probe);
+    return true;
+}
+
+} // namespace
+#endif
+
+bool initOffscreenGlfw() {
+#if defined(GLFW_PLATFORM_NULL) && defined(GLFW_EGL_CONTEXT_API) && defined(GLFW_OSMESA_CONTEXT_API)
+    // Nagłówki mogą pochodzić z 3.4, a dołączona biblioteka ze starszej wersji
+    int major = 0, minor = 0, revision = 0;
+    glfwGetVersion(&major, &minor, &revision);
+    if (major < 3 || (major == 3 && minor < 4)) {
+        std::cerr << "ERROR::CAPTURE::Offscreen capture requires GLFW >= 3.4, linked library is "
+                  << major << "." << minor << "." << revision << std::endl;
+        return false;
+    }
+
+    glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    if (!glfwInit()) {
+        const char* description = nullptr;
+        glfwGetError(&description);
+        std::cerr << "ERROR::OFFSCREEN::GLFW_INIT_FAILED " << (description ? description : "") << std::endl;
+        return false;
+    }
+
+    const char* contextName = nullptr;
+    int contextApi = 0;
+    if (probeContextApi(GLFW_EGL_CONTEXT_API)) {
+        contextApi = GLFW_EGL_CONTEXT_API;
+        contextName = "EGL";
+    } else if (probeContextApi(GLFW_OSMESA_CONTEXT_API)) {
+        contextApi = GLFW_OSMESA_CONTEXT_API;
+        contextName = "OSMesa";
+    }
+    // Na platformie "null" kontekst natywny nie istnieje - bez EGL i OSMesa nie ma czym renderować
+    if (contextApi == 0) {
+        std::cerr << "ERROR::CAPTURE::Offscreen capture needs an EGL or OSMesa context, neither is available" << std::endl;
+        glfwTerminate();
+        return false;
+    }
+
+    glfwDefaultWindowHints();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, contextApi);
+    std::cout << "INFO::OFFSCREEN::CONTEXT_API " << contextName << std::endl;
+    return true;
+#else
+    // Starsze GLFW nie ma platformy "null" - ukryte okno wymagałoby serwera okien,
+    // więc zamiast po cichu je tworzyć przerywamy z czytelnym błędem
+    std::cerr << "ERROR::CAPTURE::Offscreen capture requires GLFW >= 3.4 (built against "
+              << GLFW_VERSION_MAJOR << "." << GLFW_VERSION_MINOR << "." << GLFW_VERSION_REVISION << ")" << std::endl;
+    return false;
+#endif
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+// Inicjalizacja GLFW dla renderowania bez widocznego okna (--offscreen).
+// Z GLFW 3.4 wybierana jest platforma "null" (bez serwera okien), a kontekst tworzony
+// przez EGL bez powierzchni albo - gdy EGL jest niedostępny - programowy OSMesa.
+// Ze starszym GLFW albo bez EGL i OSMesa zwraca false z komunikatem ERROR::CAPTURE::.
+// Zastępuje glfwInit(); po sukcesie podpowiedzi okna są ustawione dla Renderera.
+bool initOffscreenGlfw();
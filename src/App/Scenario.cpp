@@ -0,0 +1,260 @@
+#include "Scenario.h"
+
+#include "MetricsServer.h"
+#include "Simulation/Colony.h"
+#include "Simulation/SpeciesRegistry.h"
+#include "Utils/MemoryTracker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+
+const char SCENARIO_MAGIC[4] = {'P', 'D', 'S', 'C'};
+// Wersja 2: kształt zaszczepienia i łamana posiewu w AddBacteria
+// Wersja 3: budżet populacji w nagłówku
+const uint32_t SCENARIO_VERSION = 3;
+// Ograniczenie łamanej przy odczycie - chroni przed uszkodzonym licznikiem
+const uint64_t MAX_SCENARIO_STREAK_POINTS = 4096;
+
+static void writeVarint(std::ofstream& file, uint64_t value) {
+    while (value >= 0x80) {
+        file.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    file.put(static_cast<char>(value));
+}
+
+template <typename T>
+static void writeValue(std::ofstream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Odczyt z bufora pliku z kontrolą końca danych
+class ScenarioReader {
+public:
+    explicit ScenarioReader(const std::vector<char>& data) : data(data), position(0) {}
+
+    bool atEnd() const { return position >= data.size(); }
+
+    bool readVarint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (position >= data.size()) return false;
+            uint8_t byte = static_cast<uint8_t>(data[position++]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    template <typename T>
+    bool readValue(T& value) {
+        if (data.size() - position < sizeof(T)) return false;
+        std::copy(data.begin() + position, data.begin() + position + sizeof(T), reinterpret_cast<char*>(&value));
+        position += sizeof(T);
+        return true;
+    }
+
+private:
+    const std::vector<char>& data;
+    size_t position;
+};
+
+void applyScenarioCommand(Colony& colony, const ScenarioCommand& command) {
+    switch (command.type) {
+        case ScenarioCommandType::AddBacteria: {
+            InoculationPattern pattern;
+            pattern.shape = command.shape;
+            pattern.center = command.position;
+            pattern.size = command.spread;
+            pattern.points = command.points;
+            colony.inoculate(command.bacteriaType, pattern, command.count);
+            break;
+        }
+        case ScenarioCommandType::ApplyAntibiotic:
+            colony.applyAntibiotic(command.position, command.strength, command.radius);
+            break;
+    }
+}
+
+bool ScenarioRecorder::open(const std::string& path, const ScenarioHeader& header) {
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "ERROR::SCENARIO::Could not open scenario file for writing: " << path << std::endl;
+        return false;
+    }
+    file.write(SCENARIO_MAGIC, sizeof(SCENARIO_MAGIC));
+    writeValue(file, SCENARIO_VERSION);
+    writeValue(file, header.seed);
+    writeValue(file, header.timeStep);
+    writeValue(file, static_cast<uint64_t>(header.budget.maxIndividuals));
+    writeValue(file, static_cast<uint64_t>(header.budget.maxMemoryBytes));
+    lastTick = 0;
+    std::cout << "INFO::SCENARIO::Recording to " << path << " (seed " << header.seed << ")" << std::endl;
+    return true;
+}
+
+void ScenarioRecorder::record(const ScenarioCommand& command) {
+    if (!file.is_open()) return;
+
+    writeVarint(file, command.tick - lastTick);
+    lastTick = command.tick;
+    file.put(static_cast<char>(command.type));
+    writeValue(file, command.position.x);
+    writeValue(file, command.position.y);
+    if (command.type == ScenarioCommandType::AddBacteria) {
+        static_assert(MAX_SPECIES <= 256, "Gatunek zapisywany jest w scenariuszu na jednym bajcie");
+        file.put(static_cast<char>(command.bacteriaType));
+        file.put(static_cast<char>(command.shape));
+        writeVarint(file, command.count);
+        writeValue(file, command.spread);
+        if (command.shape == InoculationShape::Streak) {
+            writeVarint(file, command.points.size());
+            for (const glm::vec2& point : command.points) {
+                writeValue(file, point.x);
+                writeValue(file, point.y);
+            }
+        }
+    } else {
+        writeValue(file, command.strength);
+        writeValue(file, command.radius);
+    }
+    // Sesja może skończyć się awarią - każde polecenie od razu trafia na dysk
+    file.flush();
+}
+
+void ScenarioRecorder::close() {
+    if (file.is_open()) file.close();
+}
+
+bool ScenarioPlayer::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "ERROR::SCENARIO::Could not open scenario file: " << path << std::endl;
+        return false;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    ScenarioReader reader(data);
+
+    char magic[4];
+    uint32_t version = 0;
+    uint64_t maxIndividuals = 0;
+    uint64_t maxMemoryBytes = 0;
+    bool headerValid = reader.readValue(magic) && std::equal(magic, magic + 4, SCENARIO_MAGIC) &&
+                       reader.readValue(version) && version == SCENARIO_VERSION &&
+                       reader.readValue(header.seed) && reader.readValue(header.timeStep) && header.timeStep > 0.0f &&
+                       reader.readValue(maxIndividuals) && reader.readValue(maxMemoryBytes) &&
+                       maxIndividuals > 0 && maxMemoryBytes > 0;
+    if (!headerValid) {
+        std::cerr << "ERROR::SCENARIO::Invalid scenario header: " << path << std::endl;
+        return false;
+    }
+
+    header.budget.maxIndividuals = static_cast<size_t>(maxIndividuals);
+    header.budget.maxMemoryBytes = static_cast<size_t>(maxMemoryBytes);
+
+    commands.clear();
+    nextCommand = 0;
+    uint64_t tick = 0;
+    while (!reader.atEnd()) {
+        ScenarioCommand command;
+        uint64_t tickDelta = 0;
+        uint8_t type = 0;
+        bool valid = reader.readVarint(tickDelta) && reader.readValue(type) &&
+                     reader.readValue(command.position.x) && reader.readValue(command.position.y);
+        if (valid && type == static_cast<uint8_t>(ScenarioCommandType::AddBacteria)) {
+            uint8_t bacteriaType = 0;
+            uint8_t shape = 0;
+            uint64_t count = 0;
+            // Gatunek to indeks w rejestrze - scenariusz odtwarza się z tym samym plikiem gatunków
+            valid = reader.readValue(bacteriaType) && bacteriaType < getSpeciesRegistry().size() &&
+                    reader.readValue(shape) && shape < INOCULATION_SHAPE_COUNT &&
+                    reader.readVarint(count) && count <= UINT32_MAX && reader.readValue(command.spread);
+            command.bacteriaType = static_cast<SpeciesId>(bacteriaType);
+            command.shape = static_cast<InoculationShape>(shape);
+            command.count = static_cast<uint32_t>(count);
+            uint64_t pointCount = 0;
+            if (valid && command.shape == InoculationShape::Streak) {
+                valid = reader.readVarint(pointCount) && pointCount <= MAX_SCENARIO_STREAK_POINTS;
+            }
+            for (uint64_t i = 0; valid && i < pointCount; ++i) {
+                glm::vec2 point;
+                valid = reader.readValue(point.x) && reader.readValue(point.y);
+                command.points.push_back(point);
+            }
+        } else if (valid && type == static_cast<uint8_t>(ScenarioCommandType::ApplyAntibiotic)) {
+            valid = reader.readValue(command.strength) && reader.readValue(command.radius);
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            // Ucięty ogon (np. po awarii w trakcie nagrywania) - odtwarzamy to, co jest kompletne
+            std::cerr << "WARNING::SCENARIO::Truncated or corrupt command after " << commands.size() << " commands in " << path << std::endl;
+            break;
+        }
+        tick += tickDelta;
+        command.tick = tick;
+        command.type = static_cast<ScenarioCommandType>(type);
+        commands.push_back(command);
+    }
+    std::cout << "INFO::SCENARIO::Loaded " << commands.size() << " commands from " << path
+              << " (seed " << header.seed << ", last tick " << getLastTick()
+              << ", budget " << header.budget.maxIndividuals << " objects)" << std::endl;
+    return true;
+}
+
+bool ScenarioPlayer::nextCommandForTick(uint64_t tick, ScenarioCommand& command) {
+    if (nextCommand >= commands.size() || commands[nextCommand].tick > tick) return false;
+    command = commands[nextCommand++];
+    return true;
+}
+
+int runHeadlessScenario(const std::string& path, uint64_t extraTicks, LiveMetrics* metrics) {
+    ScenarioPlayer player;
+    if (!player.load(path)) return -1;
+
+    const ScenarioHeader& header = player.getHeader();
+    Colony colony(header.seed);
+    colony.setPopulationBudget(header.budget);
+    uint64_t tickCount = player.getLastTick() + extraTicks;
+
+    auto startTime = std::chrono::steady_clock::now();
+    auto lastTickTime = startTime;
+    for (uint64_t tick = 0; tick < tickCount; ++tick) {
+        ScenarioCommand command;
+        while (player.nextCommandForTick(tick, command)) {
+            applyScenarioCommand(colony, command);
+        }
+        colony.update(header.timeStep);
+        if (metrics) {
+            // Bez okna "klatką" jest jeden krok symulacji
+            auto now = std::chrono::steady_clock::now();
+            metrics->recordFrame(std::chrono::duration<float>(now - lastTickTime).count());
+            lastTickTime = now;
+            double seconds = std::chrono::duration<double>(now - startTime).count();
+            metrics->ticksPerSecond.store(seconds > 0.0 ? static_cast<float>((tick + 1) / seconds) : 0.0f, std::memory_order_relaxed);
+            metrics->publishColony(colony);
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    const ColonyStatsSnapshot& stats = colony.getStats();
+    std::cout << "INFO::SCENARIO::Replayed " << tickCount << " ticks in " << elapsed << " s ("
+              << (elapsed > 0.0 ? static_cast<double>(tickCount) / elapsed : 0.0) << " ticks/s)" << std::endl;
+    std::cout << "INFO::SCENARIO::Final population " << stats.total << ", births " << stats.totalBirths
+              << ", deaths " << stats.totalDeaths << ", mean health " << stats.meanHealth
+              << " (" << colony.size() << " simulation objects)" << std::endl;
+    colony.detectClusters();
+    const ColonyClusterReport& clusters = colony.getClusterReport();
+    std::cout << "INFO::SCENARIO::Colonies " << clusters.clusterCount << " (contact distance " << clusters.contactDistance
+              << ", detected in " << clusters.detectionMilliseconds << " ms)" << std::endl;
+    for (size_t i = 0; i < std::min<size_t>(clusters.largest.size(), 5); ++i) {
+        const ColonyCluster& cluster = clusters.largest[i];
+        std::cout << "INFO::SCENARIO::  colony " << i << ": " << cluster.cellCount << " cells at ("
+                  << cluster.centroid.x << ", " << cluster.centroid.y << ")" << std::endl;
+    }
+    // Pamięć po ostatnim kroku, z kolonią wciąż w pamięci
+    printMemoryReport(std::cout);
+    return 0;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Simulation/IBacteria.h"
+#include "Simulation/InoculationPattern.h"
+#include "Simulation/PopulationGovernor.h"
+
+class Colony;
+struct LiveMetrics;
+
+enum class ScenarioCommandType : uint8_t {
+    AddBacteria = 0,
+    ApplyAntibiotic = 1
+};
+
+// Polecenie użytkownika w przestrzeni świata, stosowane na początku kroku o numerze tick
+struct ScenarioCommand {
+    uint64_t tick = 0;
+    ScenarioCommandType type = ScenarioCommandType::AddBacteria;
+    glm::vec2 position{0.0f, 0.0f};
+
+    // AddBacteria - position to środek wzoru, spread jego rozmiar (InoculationPattern::size)
+    SpeciesId bacteriaType = 0;
+    InoculationShape shape = InoculationShape::Blob;
+    uint32_t count = 0;
+    float spread = 0.0f;
+    std::vector<glm::vec2> points; // Łamana posiewu
+
+    // ApplyAntibiotic
+    float strength = 0.0f;
+    float radius = 0.0f;
+};
+
+// Nagłówek pliku scenariusza - ziarno, krok czasu i budżet populacji wystarczają do odtworzenia
+// sesji (łączenie w superosobniki zależy od budżetu)
+struct ScenarioHeader {
+    uint32_t seed = 0;
+    float timeStep = 1.0f / 60.0f;
+    PopulationBudget budget;
+};
+
+void applyScenarioCommand(Colony& colony, const ScenarioCommand& command);
+
+// Zapis poleceń do pliku: nagłówek "PDSC", potem polecenia z numerem kroku zapisanym
+// jako przyrost w kodowaniu varint (większość poleceń zajmuje kilkanaście bajtów)
+class ScenarioRecorder {
+public:
+    bool open(const std::string& path, const ScenarioHeader& header);
+    void record(const ScenarioCommand& command);
+    void close();
+    bool isRecording() const { return file.is_open(); }
+
+private:
+    std::ofstream file;
+    uint64_t lastTick = 0;
+};
+
+// Odtwarzanie zapisanego scenariusza krok po kroku
+class ScenarioPlayer {
+public:
+    bool load(const std::string& path);
+
+    const ScenarioHeader& getHeader() const { return header; }
+    bool isFinished() const { return nextCommand >= commands.size(); }
+    uint64_t getLastTick() const { return commands.empty() ? 0 : commands.back().tick; }
+
+    // Zwraca kolejne polecenie przypisane do danego kroku (false, gdy brak)
+    bool nextCommandForTick(uint64_t tick, ScenarioCommand& command);
+
+private:
+    ScenarioHeader header;
+    std::vector<ScenarioCommand> commands;
+    size_t nextCommand = 0;
+};
+
+// Odtworzenie scenariusza bez okna: extraTicks kroków po ostatnim poleceniu, potem podsumowanie.
+// Budżet populacji pochodzi z nagłówka, tak jak przy odtwarzaniu w oknie. Zwraca kod wyjścia procesu.
+int runHeadlessScenario(const std::string& path, uint64_t extraTicks, LiveMetrics* metrics = nullptr);
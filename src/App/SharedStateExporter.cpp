@@ -0,0 +1,187 @@
+#include "SharedStateExporter.h"
+
+#include "Simulation/Colony.h"
+#include "Utils/Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SHARED_STATE_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Najmniejszy fragment kopiowania równoległego - poniżej narzut wątków przeważa
+const size_t MIN_CELLS_PER_COPY_CHUNK = 16384;
+
+namespace {
+    size_t alignUp(size_t value) {
+        return (value + PETRI_SHM_ALIGNMENT - 1) / PETRI_SHM_ALIGNMENT * PETRI_SHM_ALIGNMENT;
+    }
+
+    template <typename T>
+    T* slotArray(char* slotBase, uint64_t offset) {
+        return reinterpret_cast<T*>(slotBase + offset);
+    }
+}
+
+SharedStateExporter::SharedStateExporter(const SharedStateExporterConfig& config)
+    : config(config), region(nullptr), regionBytes(0), header(nullptr), publishCount(0),
+      lastPublishedTick(0), hasPublished(false), truncationReported(false) {
+}
+
+SharedStateExporter::~SharedStateExporter() {
+    stop();
+}
+
+bool SharedStateExporter::start(const Colony& colony) {
+#ifdef SHARED_STATE_POSIX
+    const size_t capacity = std::max<size_t>(
+        config.capacity > 0 ? config.capacity : colony.getPopulationGovernor().getIndividualLimit(), 1);
+
+    // Tablice od najszerszego typu; każda zaczyna się na granicy linii pamięci podręcznej
+    size_t slotBytes = alignUp(sizeof(PetriShmSlotHeader));
+    const uint64_t multiplicityOffset = slotBytes;
+    slotBytes = alignUp(slotBytes + capacity * sizeof(uint64_t));
+    const uint64_t cellIdOffset = slotBytes;
+    slotBytes = alignUp(slotBytes + capacity * sizeof(uint64_t));
+    const uint64_t positionXOffset = slotBytes;
+    slotBytes = alignUp(slotBytes + capacity * sizeof(float));
+    const uint64_t positionYOffset = slotBytes;
+    slotBytes = alignUp(slotBytes + capacity * sizeof(float));
+    const uint64_t healthOffset = slotBytes;
+    slotBytes = alignUp(slotBytes + capacity * sizeof(float));
+    const uint64_t speciesOffset = slotBytes;
+    slotBytes = alignUp(slotBytes + capacity * sizeof(uint16_t));
+    const size_t firstSlotOffset = alignUp(sizeof(PetriShmHeader));
+    regionBytes = firstSlotOffset + slotBytes * PETRI_SHM_SLOT_COUNT;
+
+    // Region po przerwanym uruchomieniu mógłby mieć inny rozmiar - zawsze tworzymy nowy
+    shm_unlink(config.name.c_str());
+    int descriptor = shm_open(config.name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (descriptor < 0) {
+        std::cerr << "ERROR::SHM::Could not create shared memory " << config.name << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(descriptor, static_cast<off_t>(regionBytes)) != 0) {
+        std::cerr << "ERROR::SHM::Could not resize shared memory " << config.name << ": " << std::strerror(errno) << std::endl;
+        close(descriptor);
+        shm_unlink(config.name.c_str());
+        return false;
+    }
+    void* mapping = mmap(nullptr, regionBytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "ERROR::SHM::Could not map shared memory " << config.name << ": " << std::strerror(errno) << std::endl;
+        shm_unlink(config.name.c_str());
+        return false;
+    }
+
+    // ftruncate wypełnia region zerami - sekwencje slotów startują od 0
+    region = mapping;
+    header = static_cast<PetriShmHeader*>(region);
+    header->version = PETRI_SHM_VERSION;
+    header->regionBytes = regionBytes;
+    header->capacity = capacity;
+    for (size_t slot = 0; slot < PETRI_SHM_SLOT_COUNT; ++slot) {
+        header->slotOffsets[slot] = firstSlotOffset + slot * slotBytes;
+    }
+    header->multiplicityOffset = multiplicityOffset;
+    header->cellIdOffset = cellIdOffset;
+    header->positionXOffset = positionXOffset;
+    header->positionYOffset = positionYOffset;
+    header->healthOffset = healthOffset;
+    header->speciesOffset = speciesOffset;
+    header->latestSlot = PETRI_SHM_NO_SLOT;
+    // Sygnatura na końcu - czytnik, który ją zobaczy, widzi też resztę nagłówka
+    __atomic_store_n(&header->magic, PETRI_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    publishCount = 0;
+    hasPublished = false;
+    truncationReported = false;
+    std::cout << "INFO::SHM::Publishing colony state to " << config.name << " (" << capacity << " cells per slot, "
+              << regionBytes / (1024 * 1024) << " MB)" << std::endl;
+    return true;
+#else
+    (void)colony;
+    std::cerr << "ERROR::SHM::Shared memory export needs POSIX shm_open, not available on this platform" << std::endl;
+    return false;
+#endif
+}
+
+void SharedStateExporter::stop() {
+#ifdef SHARED_STATE_POSIX
+    if (!region) return;
+    munmap(region, regionBytes);
+    shm_unlink(config.name.c_str());
+    std::cout << "INFO::SHM::Published " << publishCount << " snapshots to " << config.name << std::endl;
+#endif
+    region = nullptr;
+    header = nullptr;
+}
+
+void SharedStateExporter::publish(const Colony& colony) {
+#ifdef SHARED_STATE_POSIX
+    if (!header) return;
+    if (hasPublished && colony.getTick() == lastPublishedTick) return;
+    TRACE_SCOPE("frame", "SharedStateExporter::publish");
+
+    const CellList& cells = colony.getBacteria();
+    const size_t count = std::min<size_t>(cells.size(), header->capacity);
+    if (count < cells.size() && !truncationReported) {
+        std::cerr << "WARNING::SHM::Colony has " << cells.size() << " objects, publishing the first " << count << std::endl;
+        truncationReported = true;
+    }
+
+    // Zapis do slotu, którego nie wskazuje latestSlot - czytelnicy najnowszej migawki mają
+    // na odczyt cały okres do kolejnej publikacji
+    const size_t slotIndex = hasPublished ? (header->latestSlot + 1) % PETRI_SHM_SLOT_COUNT : 0;
+    char* slotBase = static_cast<char*>(region) + header->slotOffsets[slotIndex];
+    PetriShmSlotHeader* slot = reinterpret_cast<PetriShmSlotHeader*>(slotBase);
+    const uint64_t sequence = slot->sequence;
+    __atomic_store_n(&slot->sequence, sequence + 1, __ATOMIC_RELAXED);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    uint64_t* multiplicity = slotArray<uint64_t>(slotBase, header->multiplicityOffset);
+    uint64_t* cellIds = slotArray<uint64_t>(slotBase, header->cellIdOffset);
+    float* positionX = slotArray<float>(slotBase, header->positionXOffset);
+    float* positionY = slotArray<float>(slotBase, header->positionYOffset);
+    float* health = slotArray<float>(slotBase, header->healthOffset);
+    uint16_t* species = slotArray<uint16_t>(slotBase, header->speciesOffset);
+    auto copyRange = [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const IBacteria& cell = *cells[i];
+            const glm::vec4 position = cell.getPos();
+            multiplicity[i] = cell.getMultiplicity();
+            cellIds[i] = cell.getCellId();
+            positionX[i] = position.x;
+            positionY[i] = position.y;
+            health[i] = cell.getHealth();
+            species[i] = cell.getSpecies();
+        }
+    };
+    if (ThreadPool* pool = colony.getWorkerPool()) {
+        pool->parallelFor(count, MIN_CELLS_PER_COPY_CHUNK, copyRange);
+    } else {
+        copyRange(0, 0, count);
+    }
+    slot->tick = colony.getTick();
+    slot->simulationTime = colony.getSimulationTime();
+    slot->cellCount = count;
+    slot->totalCells = colony.getStats().total;
+    slot->colonyObjects = cells.size();
+
+    __atomic_store_n(&slot->sequence, sequence + 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&header->latestSlot, static_cast<uint64_t>(slotIndex), __ATOMIC_RELEASE);
+    __atomic_store_n(&header->publishCount, ++publishCount, __ATOMIC_RELEASE);
+    lastPublishedTick = colony.getTick();
+    hasPublished = true;
+#else
+    (void)colony;
+#endif
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "SharedStateLayout.h"
+
+class Colony;
+
+struct SharedStateExporterConfig {
+    std::string name = "/petridish"; // Nazwa obiektu shm_open
+    size_t capacity = 0;             // Obiektów na slot; 0 = limit obiektów z budżetu populacji
+};
+
+// Publikacja bieżącego stanu kolonii w pamięci współdzielonej POSIX (układ w SharedStateLayout.h).
+// Zapis nie czeka na czytelników - czytnik sam wykrywa migawkę nadpisaną w trakcie odczytu.
+// Na systemach bez shm_open start() zwraca false.
+class SharedStateExporter {
+public:
+    explicit SharedStateExporter(const SharedStateExporterConfig& config);
+    ~SharedStateExporter();
+
+    SharedStateExporter(const SharedStateExporter&) = delete;
+    SharedStateExporter& operator=(const SharedStateExporter&) = delete;
+
+    bool start(const Colony& colony);
+    // Usuwa region - czytelnicy z otwartym mapowaniem widzą ostatnią migawkę
+    void stop();
+
+    // Kopia kolonii do wolnego slotu; pomijana, gdy od poprzedniej nie minął żaden krok
+    void publish(const Colony& colony);
+
+    uint64_t getPublishCount() const { return publishCount; }
+
+private:
+    SharedStateExporterConfig config;
+    void* region;
+    size_t regionBytes;
+    PetriShmHeader* header;
+    uint64_t publishCount;
+    uint64_t lastPublishedTick;
+    bool hasPublished;
+    bool truncationReported;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+/* Układ pamięci współdzielonej ze stanem kolonii (--shm). Nagłówek jest wspólny dla eksportera
+   i biblioteki czytnika w tools/shm_reader, dlatego zawiera wyłącznie typy języka C.
+
+   Region: PetriShmHeader, a po nim dwa sloty. Slot to PetriShmSlotHeader i tablice komórek
+   (przesunięcia w nagłówku, każda wyrównana do PETRI_SHM_ALIGNMENT). Eksporter zapisuje sloty
+   na zmianę, więc czytnik ma cały okres publikacji na odczyt najnowszego. Licznik sequence
+   slotu jest nieparzysty w trakcie zapisu; czytnik porównuje go przed i po odczycie. */
+
+#include <stdint.h>
+
+#define PETRI_SHM_MAGIC 0x4D485350u /* "PSHM" */
+#define PETRI_SHM_VERSION 1u
+#define PETRI_SHM_SLOT_COUNT 2
+#define PETRI_SHM_ALIGNMENT 64
+/* latestSlot przed pierwszą publikacją */
+#define PETRI_SHM_NO_SLOT UINT64_MAX
+
+typedef struct PetriShmSlotHeader {
+    uint64_t sequence;
+    uint64_t tick;
+    double simulationTime;
+    uint64_t cellCount;     /* Obiektów w slocie */
+    uint64_t totalCells;    /* Komórek z krotnością - superosobnik liczy się wielokrotnie */
+    uint64_t colonyObjects; /* Obiektów w kolonii; więcej niż cellCount, gdy zabrakło pojemności */
+    uint64_t reserved[2];
+} PetriShmSlotHeader;
+
+typedef struct PetriShmHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t regionBytes;
+    uint64_t capacity; /* Maksymalna liczba obiektów w slocie */
+    uint64_t slotOffsets[PETRI_SHM_SLOT_COUNT];
+    /* Przesunięcia tablic względem początku slotu */
+    uint64_t multiplicityOffset; /* uint64_t */
+    uint64_t cellIdOffset;       /* uint64_t - stały identyfikator komórki */
+    uint64_t positionXOffset;    /* float */
+    uint64_t positionYOffset;    /* float */
+    uint64_t healthOffset;       /* float */
+    uint64_t speciesOffset;      /* uint16_t - indeks w rejestrze gatunków */
+    uint64_t latestSlot;         /* Ostatnio opublikowany slot albo PETRI_SHM_NO_SLOT */
+    uint64_t publishCount;
+} PetriShmHeader;
@@ -0,0 +1,229 @@
+#include "TelemetryExporter.h"
+
+#include "Simulation/SpeciesRegistry.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+// Nagłówek pliku kolumnowego: "PDTL", wersja, liczba kolumn, opisy kolumn
+const char TELEMETRY_BINARY_MAGIC[4] = {'P', 'D', 'T', 'L'};
+const uint32_t TELEMETRY_BINARY_VERSION = 1;
+// Maksymalna liczba rekordów w bloku kolumnowym i czas, po którym zapisujemy niepełny blok
+const size_t COLUMNAR_BLOCK_RECORDS = 1024;
+const auto COLUMNAR_BLOCK_MAX_AGE = std::chrono::seconds(1);
+// Przerwa wątku eksportera, gdy kanał jest pusty
+const auto EXPORTER_IDLE_SLEEP = std::chrono::milliseconds(20);
+
+// Kolumny pliku: stałe pola rekordu, liczności kolejnych gatunków z rejestru, reszta pól
+static std::vector<TelemetryColumn> buildTelemetryColumns() {
+    std::vector<TelemetryColumn> columns = {
+        {"tick", COLUMN_U64},
+        {"time", COLUMN_F64},
+        {"population", COLUMN_U32},
+    };
+    const SpeciesRegistry& registry = getSpeciesRegistry();
+    for (size_t species = 0; species < registry.size(); ++species) {
+        columns.push_back({registry.getColumnName(static_cast<SpeciesId>(species)), COLUMN_U32});
+    }
+    columns.insert(columns.end(), {
+        {"births", COLUMN_U32},
+        {"kills", COLUMN_U32},
+        {"mean_health", COLUMN_F32},
+        {"colonies", COLUMN_U32},
+        {"largest_colony", COLUMN_U32},
+    });
+    return columns;
+}
+
+TelemetryExporter::TelemetryExporter(TelemetryChannel& channel, const TelemetryExporterConfig& config)
+    : channel(channel), config(config), columns(buildTelemetryColumns()),
+      speciesCount(getSpeciesRegistry().size()), fileBytes(0), fileIndex(-1),
+      running(false), writtenCount(0), reportedDroppedCount(0) {
+    columnarBlock.reserve(COLUMNAR_BLOCK_RECORDS);
+}
+
+TelemetryExporter::~TelemetryExporter() {
+    stop();
+}
+
+bool TelemetryExporter::start() {
+    if (running) return true;
+    if (!openNextFile()) return false;
+
+    lastBlockFlush = std::chrono::steady_clock::now();
+    running = true;
+    exportThread = std::thread(&TelemetryExporter::exportLoop, this);
+    return true;
+}
+
+void TelemetryExporter::stop() {
+    if (!running) return;
+    running = false;
+    if (exportThread.joinable()) exportThread.join();
+
+    // Wątek już nie działa - dopisujemy resztę kanału i zamykamy plik
+    drainChannel();
+    flushColumnarBlock();
+    reportDroppedRecords();
+    closeFile();
+    std::cout << "INFO::TELEMETRY::Exported " << getWrittenCount() << " records, dropped " << channel.getDroppedCount() << std::endl;
+}
+
+void TelemetryExporter::exportLoop() {
+    while (running.load(std::memory_order_relaxed)) {
+        bool receivedAny = drainChannel();
+
+        if (config.format == TelemetryFormat::Binary && !columnarBlock.empty() &&
+            std::chrono::steady_clock::now() - lastBlockFlush >= COLUMNAR_BLOCK_MAX_AGE) {
+            flushColumnarBlock();
+        }
+        reportDroppedRecords();
+
+        if (!receivedAny) {
+            std::this_thread::sleep_for(EXPORTER_IDLE_SLEEP);
+        }
+    }
+}
+
+// Odbiera wszystkie rekordy dostępne w kanale; zwraca true, jeśli był choć jeden
+bool TelemetryExporter::drainChannel() {
+    bool receivedAny = false;
+    TelemetryRecord record;
+    while (channel.consume(record)) {
+        receivedAny = true;
+        if (config.format == TelemetryFormat::Csv) {
+            writeCsvRecord(record);
+            rotateIfNeeded();
+        } else {
+            columnarBlock.push_back(record);
+            if (columnarBlock.size() >= COLUMNAR_BLOCK_RECORDS) {
+                flushColumnarBlock();
+            }
+        }
+        writtenCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    return receivedAny;
+}
+
+bool TelemetryExporter::openNextFile() {
+    closeFile();
+    ++fileIndex;
+
+    std::filesystem::path basePath(config.basePath);
+    if (basePath.has_parent_path()) {
+        std::error_code ec;
+        std::filesystem::create_directories(basePath.parent_path(), ec);
+    }
+
+    char suffix[16];
+    std::snprintf(suffix, sizeof(suffix), "_%04d", fileIndex);
+    std::string path = config.basePath + suffix + (config.format == TelemetryFormat::Csv ? ".csv" : ".tlm");
+
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "ERROR::TELEMETRY::Could not open telemetry file: " << path << std::endl;
+        return false;
+    }
+    fileBytes = 0;
+
+    if (config.format == TelemetryFormat::Csv) {
+        std::string header;
+        for (size_t i = 0; i < columns.size(); ++i) {
+            header += columns[i].name;
+            header += (i + 1 < columns.size()) ? ',' : '\n';
+        }
+        file << header;
+        fileBytes += header.size();
+    } else {
+        file.write(TELEMETRY_BINARY_MAGIC, sizeof(TELEMETRY_BINARY_MAGIC));
+        file.write(reinterpret_cast<const char*>(&TELEMETRY_BINARY_VERSION), sizeof(TELEMETRY_BINARY_VERSION));
+        const uint32_t columnCount = static_cast<uint32_t>(columns.size());
+        file.write(reinterpret_cast<const char*>(&columnCount), sizeof(columnCount));
+        fileBytes += sizeof(TELEMETRY_BINARY_MAGIC) + 2 * sizeof(uint32_t);
+        for (const TelemetryColumn& column : columns) {
+            uint8_t type = column.type;
+            uint8_t nameLength = static_cast<uint8_t>(std::min<size_t>(column.name.size(), 255));
+            file.write(reinterpret_cast<const char*>(&type), 1);
+            file.write(reinterpret_cast<const char*>(&nameLength), 1);
+            file.write(column.name.data(), nameLength);
+            fileBytes += 2 + nameLength;
+        }
+    }
+    std::cout << "INFO::TELEMETRY::Writing telemetry to " << path << std::endl;
+    return true;
+}
+
+void TelemetryExporter::closeFile() {
+    if (file.is_open()) {
+        file.flush();
+        file.close();
+    }
+}
+
+void TelemetryExporter::rotateIfNeeded() {
+    if (config.rotateBytes > 0 && fileBytes >= config.rotateBytes) {
+        openNextFile();
+    }
+}
+
+void TelemetryExporter::writeCsvRecord(const TelemetryRecord& record) {
+    if (!file.is_open()) return;
+    char line[1024];
+    int length = std::snprintf(line, sizeof(line), "%llu,%.6f,%u,",
+                               static_cast<unsigned long long>(record.tick), record.simulationTime, record.population);
+    for (size_t species = 0; species < speciesCount; ++species) {
+        length += std::snprintf(line + length, sizeof(line) - length, "%u,", record.typeCounts[species]);
+    }
+    length += std::snprintf(line + length, sizeof(line) - length, "%u,%u,%.6f,%u,%u\n",
+                            record.births, record.kills, record.meanHealth, record.colonyCount, record.largestColony);
+    if (length <= 0 || length >= static_cast<int>(sizeof(line))) return;
+    file.write(line, length);
+    fileBytes += static_cast<uint64_t>(length);
+}
+
+// Blok kolumnowy: liczba wierszy, a potem każda kolumna jako ciągła tablica wartości
+void TelemetryExporter::flushColumnarBlock() {
+    lastBlockFlush = std::chrono::steady_clock::now();
+    if (columnarBlock.empty() || !file.is_open()) {
+        columnarBlock.clear();
+        return;
+    }
+
+    uint32_t rowCount = static_cast<uint32_t>(columnarBlock.size());
+    file.write(reinterpret_cast<const char*>(&rowCount), sizeof(rowCount));
+    uint64_t blockBytes = sizeof(rowCount);
+
+    auto writeColumn = [&](auto selector) {
+        for (const TelemetryRecord& record : columnarBlock) {
+            auto value = selector(record);
+            file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+            blockBytes += sizeof(value);
+        }
+    };
+    writeColumn([](const TelemetryRecord& r) { return r.tick; });
+    writeColumn([](const TelemetryRecord& r) { return r.simulationTime; });
+    writeColumn([](const TelemetryRecord& r) { return r.population; });
+    for (size_t species = 0; species < speciesCount; ++species) {
+        writeColumn([species](const TelemetryRecord& r) { return r.typeCounts[species]; });
+    }
+    writeColumn([](const TelemetryRecord& r) { return r.births; });
+    writeColumn([](const TelemetryRecord& r) { return r.kills; });
+    writeColumn([](const TelemetryRecord& r) { return r.meanHealth; });
+    writeColumn([](const TelemetryRecord& r) { return r.colonyCount; });
+    writeColumn([](const TelemetryRecord& r) { return r.largestColony; });
+
+    fileBytes += blockBytes;
+    columnarBlock.clear();
+    rotateIfNeeded();
+}
+
+void TelemetryExporter::reportDroppedRecords() {
+    uint64_t dropped = channel.getDroppedCount();
+    if (dropped > reportedDroppedCount) {
+        std::cerr << "WARNING::TELEMETRY::Exporter fell behind, dropped " << (dropped - reportedDroppedCount)
+                  << " records (" << dropped << " total)" << std::endl;
+        reportedDroppedCount = dropped;
+    }
+}
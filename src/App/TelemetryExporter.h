@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Simulation/Telemetry.h"
+
+enum class TelemetryFormat {
+    Csv,
+    Binary // Kolumnowy: bloki rekordów, w bloku kolejne kolumny ciągiem
+};
+
+// Typy kolumn zapisywane w nagłówku pliku kolumnowego
+enum TelemetryColumnType : uint8_t {
+    COLUMN_U64 = 0,
+    COLUMN_F64 = 1,
+    COLUMN_U32 = 2,
+    COLUMN_F32 = 3
+};
+
+struct TelemetryColumn {
+    std::string name;
+    TelemetryColumnType type;
+};
+
+struct TelemetryExporterConfig {
+    std::string basePath = "telemetry/telemetry"; // Pliki: <basePath>_0000.csv, <basePath>_0001.csv, ...
+    TelemetryFormat format = TelemetryFormat::Csv;
+    uint64_t rotateBytes = 64ull * 1024 * 1024;   // Po przekroczeniu rozmiaru otwierany jest kolejny plik
+};
+
+// Wątek w tle opróżniający kanał telemetrii do plików z rotacją.
+// Gdy kanał odrzuca rekordy (eksporter nie nadąża), liczba pominiętych jest raportowana w logu.
+class TelemetryExporter {
+public:
+    TelemetryExporter(TelemetryChannel& channel, const TelemetryExporterConfig& config);
+    ~TelemetryExporter();
+
+    TelemetryExporter(const TelemetryExporter&) = delete;
+    TelemetryExporter& operator=(const TelemetryExporter&) = delete;
+
+    bool start();
+    // Zatrzymuje wątek po zapisaniu rekordów, które już są w kanale
+    void stop();
+
+    uint64_t getWrittenCount() const { return writtenCount.load(std::memory_order_relaxed); }
+
+private:
+    void exportLoop();
+    bool drainChannel();
+    bool openNextFile();
+    void closeFile();
+    void rotateIfNeeded();
+    void writeCsvRecord(const TelemetryRecord& record);
+    void flushColumnarBlock();
+    void reportDroppedRecords();
+
+    TelemetryChannel& channel;
+    TelemetryExporterConfig config;
+    // Opis kolumn ustalany przy utworzeniu - zależy od liczby gatunków w rejestrze
+    std::vector<TelemetryColumn> columns;
+    size_t speciesCount;
+
+    std::ofstream file;
+    uint64_t fileBytes;
+    int fileIndex;
+
+    std::vector<TelemetryRecord> columnarBlock;
+    std::chrono::steady_clock::time_point lastBlockFlush;
+
+    std::thread exportThread;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> writtenCount;
+    uint64_t reportedDroppedCount;
+};
@@ -0,0 +1,384 @@
+#include "ColonyOutlines.h"
+
+#include "Utils/Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+    // Węzeł kafla z sąsiednią kolumną i wierszem (ostatnie oczka kafla sięgają do sąsiadów)
+    const int LOCAL_NODES = OUTLINE_TILE_NODES + 1;
+    // Krawędzie oczek kafla: najpierw poziome (LOCAL_NODES wierszy), potem pionowe
+    const int HORIZONTAL_EDGES = LOCAL_NODES * OUTLINE_TILE_NODES;
+    const int EDGE_COUNT = 2 * HORIZONTAL_EDGES;
+    // Gęstość poniżej tej wartości to resztki po odejmowaniu - kafel uznajemy za pusty
+    const float EMPTY_DENSITY = 1e-4f;
+    // Zmienione zakresy oddalone o najwyżej tyle wierzchołków wysyłane są jednym wywołaniem
+    const uint32_t RANGE_MERGE_GAP = 256;
+
+    // Przedział kafla z zapasem na wzrost konturów bez przenoszenia
+    uint32_t slotCapacity(size_t vertexCount) {
+        return static_cast<uint32_t>(vertexCount + vertexCount / 2);
+    }
+
+    // Odcinki marching squares jako pary krawędzi oczka (0 dół, 1 prawo, 2 góra, 3 lewo).
+    // Bity przypadku: 1 lewy dolny, 2 prawy dolny, 4 prawy górny, 8 lewy górny węzeł.
+    // Przypadki siodłowe 5 i 10 mają tu wariant rozdzielony; połączony wybiera średnia węzłów.
+    const int8_t SEGMENT_TABLE[16][4] = {
+        {-1, -1, -1, -1}, {3, 0, -1, -1}, {0, 1, -1, -1}, {3, 1, -1, -1},
+        {1, 2, -1, -1},   {3, 0, 1, 2},   {0, 2, -1, -1}, {3, 2, -1, -1},
+        {2, 3, -1, -1},   {0, 2, -1, -1}, {0, 1, 2, 3},   {1, 2, -1, -1},
+        {1, 3, -1, -1},   {0, 1, -1, -1}, {3, 0, -1, -1}, {-1, -1, -1, -1},
+    };
+    const int8_t SADDLE_JOINED[16][4] = {
+        {}, {}, {}, {}, {}, {0, 1, 2, 3}, {}, {}, {}, {}, {3, 0, 1, 2}, {}, {}, {}, {}, {},
+    };
+
+    int floorDiv(int value, int divisor) {
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+
+    float distanceToSegment(const glm::vec2& point, const glm::vec2& a, const glm::vec2& b) {
+        glm::vec2 ab = b - a;
+        float lengthSquared = glm::dot(ab, ab);
+        if (lengthSquared <= 0.0f) return glm::length(point - a);
+        float t = std::clamp(glm::dot(point - a, ab) / lengthSquared, 0.0f, 1.0f);
+        return glm::length(point - (a + t * ab));
+    }
+
+    // Ramer-Douglas-Peucker na przedziale [first, last] (końce muszą być już oznaczone w keep)
+    void simplifyRange(const std::vector<glm::vec2>& points, size_t first, size_t last, std::vector<uint8_t>& keep) {
+        std::vector<std::pair<size_t, size_t>> pending;
+        pending.push_back({first, last});
+        while (!pending.empty()) {
+            auto [begin, end] = pending.back();
+            pending.pop_back();
+            float farthestDistance = 0.0f;
+            size_t farthest = begin;
+            for (size_t i = begin + 1; i < end; ++i) {
+                float distance = distanceToSegment(points[i], points[begin], points[end]);
+                if (distance > farthestDistance) {
+                    farthestDistance = distance;
+                    farthest = i;
+                }
+            }
+            if (farthestDistance > OUTLINE_SIMPLIFY_TOLERANCE) {
+                keep[farthest] = 1;
+                pending.push_back({begin, farthest});
+                pending.push_back({farthest, end});
+            }
+        }
+    }
+}
+
+uint64_t ColonyOutlines::tileKey(int32_t tileX, int32_t tileY) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(tileX)) << 32) | static_cast<uint32_t>(tileY);
+}
+
+ColonyOutlines::Tile& ColonyOutlines::getOrCreateTile(int32_t tileX, int32_t tileY) {
+    auto inserted = tiles.try_emplace(tileKey(tileX, tileY));
+    Tile& tile = inserted.first->second;
+    if (inserted.second) {
+        tile.tileX = tileX;
+        tile.tileY = tileY;
+    }
+    return tile;
+}
+
+const ColonyOutlines::Tile* ColonyOutlines::findTile(int32_t tileX, int32_t tileY) const {
+    auto it = tiles.find(tileKey(tileX, tileY));
+    return it != tiles.end() ? &it->second : nullptr;
+}
+
+// Jądro namiotowe o promieniu dwóch węzłów. Zmieniony węzeł z zerową kolumną lub wierszem
+// kafla należy też do ostatnich oczek sąsiada z lewej / z dołu - ten też musi przeliczyć kontury.
+void ColonyOutlines::splat(float x, float y, float weight) {
+    const float gridX = x / OUTLINE_GRID_SPACING;
+    const float gridY = y / OUTLINE_GRID_SPACING;
+    const int baseX = static_cast<int>(std::floor(gridX)) - 1;
+    const int baseY = static_cast<int>(std::floor(gridY)) - 1;
+    for (int nodeY = baseY; nodeY < baseY + 4; ++nodeY) {
+        const float weightY = 1.0f - std::abs(static_cast<float>(nodeY) - gridY) * 0.5f;
+        if (weightY <= 0.0f) continue;
+        for (int nodeX = baseX; nodeX < baseX + 4; ++nodeX) {
+            const float weightX = 1.0f - std::abs(static_cast<float>(nodeX) - gridX) * 0.5f;
+            if (weightX <= 0.0f) continue;
+
+            const int tileX = floorDiv(nodeX, OUTLINE_TILE_NODES);
+            const int tileY = floorDiv(nodeY, OUTLINE_TILE_NODES);
+            const int localX = nodeX - tileX * OUTLINE_TILE_NODES;
+            const int localY = nodeY - tileY * OUTLINE_TILE_NODES;
+            Tile& tile = getOrCreateTile(tileX, tileY);
+            tile.density[localY * OUTLINE_TILE_NODES + localX] += weight * weightX * weightY;
+            tile.dirty = true;
+            if (localX == 0) getOrCreateTile(tileX - 1, tileY).dirty = true;
+            if (localY == 0) getOrCreateTile(tileX, tileY - 1).dirty = true;
+            if (localX == 0 && localY == 0) getOrCreateTile(tileX - 1, tileY - 1).dirty = true;
+        }
+    }
+}
+
+void ColonyOutlines::applyChanges(const PopulationChangeList& changes) {
+    for (const PopulationChange& change : changes) {
+        splat(change.x, change.y, static_cast<float>(change.weight));
+    }
+}
+
+void ColonyOutlines::rebuild(const CellList& cells) {
+    TRACE_SCOPE("render", "ColonyOutlines::rebuild");
+    tiles.clear();
+    geometryChanged = true;
+    for (const std::unique_ptr<IBacteria>& cell : cells) {
+        if (!cell || !cell->isAlive()) continue;
+        glm::vec4 position = cell->getPos();
+        splat(position.x, position.y, static_cast<float>(cell->getMultiplicity()));
+    }
+}
+
+void ColonyOutlines::extractTile(Tile& tile) const {
+    tile.vertices.clear();
+    tile.strips.clear();
+
+    // Węzły kafla z kolumną sąsiada z prawej, wierszem sąsiada z góry i ich narożnikiem
+    float nodes[LOCAL_NODES * LOCAL_NODES];
+    float maxDensity = 0.0f;
+    for (int y = 0; y < OUTLINE_TILE_NODES; ++y) {
+        for (int x = 0; x < OUTLINE_TILE_NODES; ++x) {
+            float value = tile.density[y * OUTLINE_TILE_NODES + x];
+            nodes[y * LOCAL_NODES + x] = value;
+            maxDensity = std::max(maxDensity, value);
+        }
+    }
+    const Tile* right = findTile(tile.tileX + 1, tile.tileY);
+    const Tile* top = findTile(tile.tileX, tile.tileY + 1);
+    const Tile* corner = findTile(tile.tileX + 1, tile.tileY + 1);
+    for (int i = 0; i < OUTLINE_TILE_NODES; ++i) {
+        nodes[i * LOCAL_NODES + OUTLINE_TILE_NODES] = right ? right->density[i * OUTLINE_TILE_NODES] : 0.0f;
+        nodes[OUTLINE_TILE_NODES * LOCAL_NODES + i] = top ? top->density[i] : 0.0f;
+    }
+    nodes[LOCAL_NODES * LOCAL_NODES - 1] = corner ? corner->density[0] : 0.0f;
+
+    // Odcinki konturu jako pary krawędzi; każda krawędź należy do najwyżej dwóch odcinków
+    std::vector<std::array<int, 2>> segments;
+    std::vector<int> edgeSegments(EDGE_COUNT * 2, -1);
+    auto attach = [&](int edge, int segment) {
+        int* slot = &edgeSegments[edge * 2];
+        slot[slot[0] < 0 ? 0 : 1] = segment;
+    };
+    for (int y = 0; y < OUTLINE_TILE_NODES; ++y) {
+        for (int x = 0; x < OUTLINE_TILE_NODES; ++x) {
+            const float bottomLeft = nodes[y * LOCAL_NODES + x];
+            const float bottomRight = nodes[y * LOCAL_NODES + x + 1];
+            const float topRight = nodes[(y + 1) * LOCAL_NODES + x + 1];
+            const float topLeft = nodes[(y + 1) * LOCAL_NODES + x];
+            const int caseIndex = (bottomLeft >= OUTLINE_ISO_DENSITY ? 1 : 0) | (bottomRight >= OUTLINE_ISO_DENSITY ? 2 : 0) |
+                                  (topRight >= OUTLINE_ISO_DENSITY ? 4 : 0) | (topLeft >= OUTLINE_ISO_DENSITY ? 8 : 0);
+            if (caseIndex == 0 || caseIndex == 15) continue;
+
+            const int8_t* pairs = SEGMENT_TABLE[caseIndex];
+            if ((caseIndex == 5 || caseIndex == 10) &&
+                0.25f * (bottomLeft + bottomRight + topRight + topLeft) >= OUTLINE_ISO_DENSITY) {
+                pairs = SADDLE_JOINED[caseIndex];
+            }
+            const int cellEdges[4] = {
+                y * OUTLINE_TILE_NODES + x,                         // dół
+                HORIZONTAL_EDGES + y * LOCAL_NODES + x + 1,         // prawo
+                (y + 1) * OUTLINE_TILE_NODES + x,                   // góra
+                HORIZONTAL_EDGES + y * LOCAL_NODES + x,             // lewo
+            };
+            for (int p = 0; p < 4 && pairs[p] >= 0; p += 2) {
+                const int segment = static_cast<int>(segments.size());
+                segments.push_back({cellEdges[pairs[p]], cellEdges[pairs[p + 1]]});
+                attach(cellEdges[pairs[p]], segment);
+                attach(cellEdges[pairs[p + 1]], segment);
+            }
+        }
+    }
+
+    // Punkt przecięcia na krawędzi - z globalnego indeksu węzła, aby sąsiednie kafle
+    // wyznaczyły dokładnie ten sam punkt na wspólnej krawędzi
+    auto edgePoint = [&](int edge) {
+        int x, y, stepX, stepY;
+        if (edge < HORIZONTAL_EDGES) {
+            x = edge % OUTLINE_TILE_NODES;
+            y = edge / OUTLINE_TILE_NODES;
+            stepX = 1;
+            stepY = 0;
+        } else {
+            x = (edge - HORIZONTAL_EDGES) % LOCAL_NODES;
+            y = (edge - HORIZONTAL_EDGES) / LOCAL_NODES;
+            stepX = 0;
+            stepY = 1;
+        }
+        const float from = nodes[y * LOCAL_NODES + x];
+        const float to = nodes[(y + stepY) * LOCAL_NODES + x + stepX];
+        const float t = (OUTLINE_ISO_DENSITY - from) / (to - from);
+        const float globalX = static_cast<float>(tile.tileX * OUTLINE_TILE_NODES + x);
+        const float globalY = static_cast<float>(tile.tileY * OUTLINE_TILE_NODES + y);
+        return glm::vec2((globalX + t * stepX) * OUTLINE_GRID_SPACING, (globalY + t * stepY) * OUTLINE_GRID_SPACING);
+    };
+
+    // Łączenie odcinków w łamane: najpierw otwarte (kończą się na brzegu kafla), potem pętle
+    std::vector<uint8_t> used(segments.size(), 0);
+    std::vector<glm::vec2> points;
+    std::vector<uint8_t> keep;
+    auto walk = [&](int segment, int edge) {
+        const int startEdge = edge;
+        points.clear();
+        points.push_back(edgePoint(edge));
+        while (segment >= 0 && !used[segment]) {
+            used[segment] = 1;
+            edge = segments[segment][0] == edge ? segments[segment][1] : segments[segment][0];
+            points.push_back(edgePoint(edge));
+            const int* slot = &edgeSegments[edge * 2];
+            segment = slot[0] == segment ? slot[1] : slot[0];
+        }
+        if (points.size() < 2) return;
+
+        keep.assign(points.size(), 0);
+        keep.front() = 1;
+        keep.back() = 1;
+        if (edge == startEdge && points.size() > 3) {
+            // Pętla: dzielimy ją w punkcie najdalszym od początku
+            size_t farthest = 1;
+            for (size_t i = 2; i + 1 < points.size(); ++i) {
+                if (glm::length(points[i] - points[0]) > glm::length(points[farthest] - points[0])) farthest = i;
+            }
+            keep[farthest] = 1;
+            simplifyRange(points, 0, farthest, keep);
+            simplifyRange(points, farthest, points.size() - 1, keep);
+        } else {
+            simplifyRange(points, 0, points.size() - 1, keep);
+        }
+
+        OutlineStrip strip;
+        strip.first = static_cast<uint32_t>(tile.vertices.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (keep[i]) tile.vertices.push_back(points[i]);
+        }
+        strip.count = static_cast<uint32_t>(tile.vertices.size()) - strip.first;
+        tile.strips.push_back(strip);
+    };
+    for (size_t s = 0; s < segments.size(); ++s) {
+        if (used[s]) continue;
+        for (int end = 0; end < 2; ++end) {
+            const int edge = segments[s][end];
+            const int* slot = &edgeSegments[edge * 2];
+            if ((slot[0] == static_cast<int>(s) ? slot[1] : slot[0]) < 0) {
+                walk(static_cast<int>(s), edge);
+                break;
+            }
+        }
+    }
+    for (size_t s = 0; s < segments.size(); ++s) {
+        if (!used[s]) walk(static_cast<int>(s), segments[s][0]);
+    }
+
+    tile.empty = maxDensity < EMPTY_DENSITY && tile.strips.empty();
+}
+
+// Kafel, którego kontury nie mieszczą się w przedziale, dostaje nowy na końcu tablicy
+void ColonyOutlines::placeTileVertices(Tile& tile) {
+    if (tile.vertices.size() > tile.vertexCapacity) {
+        wastedVertices += tile.vertexCapacity;
+        tile.vertexOffset = static_cast<uint32_t>(vertices.size());
+        tile.vertexCapacity = slotCapacity(tile.vertices.size());
+        vertices.resize(vertices.size() + tile.vertexCapacity);
+    }
+    std::copy(tile.vertices.begin(), tile.vertices.end(), vertices.begin() + tile.vertexOffset);
+    if (!tile.vertices.empty()) {
+        changedRanges.push_back({tile.vertexOffset, static_cast<uint32_t>(tile.vertices.size())});
+    }
+}
+
+void ColonyOutlines::layoutVertices() {
+    vertices.clear();
+    changedRanges.clear();
+    wastedVertices = 0;
+    for (auto& entry : tiles) {
+        Tile& tile = entry.second;
+        tile.vertexOffset = static_cast<uint32_t>(vertices.size());
+        tile.vertexCapacity = slotCapacity(tile.vertices.size());
+        vertices.insert(vertices.end(), tile.vertices.begin(), tile.vertices.end());
+        vertices.resize(tile.vertexOffset + tile.vertexCapacity);
+    }
+    changedRanges.push_back({0, static_cast<uint32_t>(vertices.size())});
+}
+
+bool ColonyOutlines::extract(ThreadPool* pool) {
+    TRACE_SCOPE("render", "ColonyOutlines::extract");
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<Tile*> dirtyTiles;
+    for (auto& entry : tiles) {
+        if (entry.second.dirty) dirtyTiles.push_back(&entry.second);
+    }
+    stats.extractedTiles = dirtyTiles.size();
+    if (dirtyTiles.empty() && !geometryChanged) {
+        stats.changedVertices = 0;
+        stats.extractMilliseconds = 0.0;
+        return false;
+    }
+
+    // Kafle czytają gęstość sąsiadów, a zapisują wyłącznie własne kontury
+    auto extractRange = [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) extractTile(*dirtyTiles[i]);
+    };
+    if (pool) {
+        pool->parallelFor(dirtyTiles.size(), 1, extractRange);
+    } else if (!dirtyTiles.empty()) {
+        extractRange(0, 0, dirtyTiles.size());
+    }
+
+    // Puste kafle usuwamy - brakujący kafel sąsiedzi traktują jak zerową gęstość
+    changedRanges.clear();
+    for (Tile* tile : dirtyTiles) {
+        tile->dirty = false;
+        if (tile->empty) {
+            wastedVertices += tile->vertexCapacity;
+            tiles.erase(tileKey(tile->tileX, tile->tileY));
+        } else if (!geometryChanged) {
+            placeTileVertices(*tile);
+        }
+    }
+    // Po przebudowie albo gdy porzucone przedziały zajmują połowę tablicy - nowy, zwarty układ
+    if (geometryChanged || wastedVertices * 2 > vertices.size()) {
+        layoutVertices();
+    } else {
+        std::sort(changedRanges.begin(), changedRanges.end(),
+                  [](const OutlineVertexRange& a, const OutlineVertexRange& b) { return a.first < b.first; });
+        size_t merged = 0;
+        for (size_t i = 1; i < changedRanges.size(); ++i) {
+            OutlineVertexRange& last = changedRanges[merged];
+            const OutlineVertexRange& next = changedRanges[i];
+            if (next.first <= last.first + last.count + RANGE_MERGE_GAP) {
+                last.count = std::max(last.count, next.first + next.count - last.first);
+            } else {
+                changedRanges[++merged] = next;
+            }
+        }
+        if (!changedRanges.empty()) changedRanges.resize(merged + 1);
+    }
+
+    // Łamane przepisywane są w całości - to kilka bajtów na łamaną, wierzchołki zostają na miejscu
+    strips.clear();
+    size_t usedVertices = 0;
+    for (const auto& entry : tiles) {
+        const Tile& tile = entry.second;
+        for (const OutlineStrip& strip : tile.strips) {
+            strips.push_back({strip.first + tile.vertexOffset, strip.count});
+        }
+        usedVertices += tile.vertices.size();
+    }
+    ++generation;
+    geometryChanged = false;
+
+    stats.tiles = tiles.size();
+    stats.strips = strips.size();
+    stats.vertices = usedVertices;
+    stats.changedVertices = 0;
+    for (const OutlineVertexRange& range : changedRanges) stats.changedVertices += range.count;
+    stats.extractMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    return true;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Simulation/IBacteria.h"
+#include "Simulation/PopulationChanges.h"
+#include "Utils/MemoryTracker.h"
+#include "Utils/ThreadPool.h"
+
+// Odstęp węzłów siatki gęstości (jednostki świata) i bok kafla w węzłach
+const float OUTLINE_GRID_SPACING = 0.5f;
+const int OUTLINE_TILE_NODES = 32;
+// Gęstość na brzegu kolonii. Komórka rozkładana jest jądrem namiotowym o promieniu dwóch
+// węzłów, więc samotna komórka daje kontur o promieniu około jednego odstępu siatki.
+const float OUTLINE_ISO_DENSITY = 0.25f;
+// Tolerancja upraszczania łamanych (Ramer-Douglas-Peucker) w jednostkach świata
+const float OUTLINE_SIMPLIFY_TOLERANCE = 0.1f;
+
+// Łamana w tablicy wierzchołków konturów (zamknięte powtarzają pierwszy wierzchołek na końcu)
+struct OutlineStrip {
+    uint32_t first;
+    uint32_t count;
+};
+
+// Zakres tablicy wierzchołków do ponownego wysłania na GPU
+struct OutlineVertexRange {
+    uint32_t first;
+    uint32_t count;
+};
+
+struct ColonyOutlineStats {
+    size_t tiles = 0;
+    size_t extractedTiles = 0;   // Kafle przeliczone w ostatniej ekstrakcji
+    size_t strips = 0;
+    size_t vertices = 0;
+    size_t changedVertices = 0;  // Wierzchołki do wysłania po ostatniej ekstrakcji (wszystkie przy nowym układzie)
+    double extractMilliseconds = 0.0;
+};
+
+// Kontury kolonii do widoku z daleka. Gęstość komórek trzymana jest w rzadkiej siatce
+// kafli i aktualizowana przyrostowo z dziennika zmian populacji; kontury (marching squares
+// + upraszczanie) liczone są ponownie tylko dla kafli, których gęstość się zmieniła.
+// Każdy kafel ma w tablicy wierzchołków własny przedział z zapasem, więc przeliczony kafel
+// nadpisuje tylko swój fragment, a na GPU trafiają wyłącznie zmienione zakresy.
+class ColonyOutlines {
+public:
+    // Zmiany populacji od ostatniego wywołania
+    void applyChanges(const PopulationChangeList& changes);
+    // Gęstość od zera z bieżącej listy komórek (po łączeniu w superosobniki)
+    void rebuild(const CellList& cells);
+    // Kontury zmienionych kafli (równolegle na puli, jeśli podana); true, gdy geometria się zmieniła
+    bool extract(ThreadPool* pool);
+
+    // Geometria wszystkich kafli w jednej tablicy - numer generacji rośnie przy każdej zmianie.
+    // Zmienione zakresy opisują różnicę względem poprzedniej generacji (po nowym układzie
+    // jest to cała tablica); kto pominął generację, musi wysłać całą tablicę.
+    const TrackedVector<glm::vec2, MemoryTag::RendererCpu>& getVertices() const { return vertices; }
+    const TrackedVector<OutlineStrip, MemoryTag::RendererCpu>& getStrips() const { return strips; }
+    const TrackedVector<OutlineVertexRange, MemoryTag::RendererCpu>& getChangedRanges() const { return changedRanges; }
+    uint64_t getGeneration() const { return generation; }
+    const ColonyOutlineStats& getStats() const { return stats; }
+
+private:
+    static constexpr int TILE_AREA = OUTLINE_TILE_NODES * OUTLINE_TILE_NODES;
+
+    struct Tile {
+        int32_t tileX = 0;
+        int32_t tileY = 0;
+        std::array<float, TILE_AREA> density{};
+        bool dirty = true;
+        bool empty = false;   // Brak gęstości i konturów po ostatniej ekstrakcji
+        TrackedVector<glm::vec2, MemoryTag::RendererCpu> vertices;
+        TrackedVector<OutlineStrip, MemoryTag::RendererCpu> strips;   // first względem vertices kafla
+        // Przedział kafla we wspólnej tablicy wierzchołków
+        uint32_t vertexOffset = 0;
+        uint32_t vertexCapacity = 0;
+    };
+
+    static uint64_t tileKey(int32_t tileX, int32_t tileY);
+    Tile& getOrCreateTile(int32_t tileX, int32_t tileY);
+    const Tile* findTile(int32_t tileX, int32_t tileY) const;
+    void splat(float x, float y, float weight);
+    void extractTile(Tile& tile) const;
+    void placeTileVertices(Tile& tile);
+    void layoutVertices();
+
+    std::unordered_map<uint64_t, Tile> tiles;
+    TrackedVector<glm::vec2, MemoryTag::RendererCpu> vertices;
+    TrackedVector<OutlineStrip, MemoryTag::RendererCpu> strips;
+    TrackedVector<OutlineVertexRange, MemoryTag::RendererCpu> changedRanges;
+    size_t wastedVertices = 0;   // Przedziały porzucone przez przeniesione i usunięte kafle
+    uint64_t generation = 0;
+    bool geometryChanged = false;
+    ColonyOutlineStats stats;
+};
@@ -0,0 +1,186 @@
+#include "FrameCapture.h"
+
+#include "GpuMemory.h"
+#include "Utils/PngWriter.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// Bufory odczytu w pierścieniu - odczyt sprzed dwóch klatek jest zwykle gotowy
+const size_t PIXEL_PACK_SLOT_COUNT = 3;
+// Bufory klatek oczekujących na zakodowanie, na wątek kodera
+const size_t FRAME_BUFFERS_PER_ENCODER = 2;
+// Najdłuższe oczekiwanie na fence przy pełnym pierścieniu (ns)
+const GLuint64 FENCE_WAIT_TIMEOUT_NS = 1000000000ull;
+// Waga nowego pomiaru w średniej kroczącej kosztu przechwytywania
+const float CAPTURE_TIME_SMOOTHING = 0.05f;
+
+FrameCapture::FrameCapture()
+    : width(0), height(0), frameBytes(0), fencesAvailable(false),
+      nextSlot(0), nextFrameIndex(0), frameBuffersInFlight(0), maxFrameBuffers(0),
+      writtenFrames(0), failedWrites(0) {}
+
+FrameCapture::~FrameCapture() {
+    finish();
+    destroyBuffers();
+}
+
+bool FrameCapture::init(int captureWidth, int captureHeight, const std::string& prefix, size_t encoderThreads) {
+    if (captureWidth <= 0 || captureHeight <= 0 || encoderThreads == 0) return false;
+
+    width = captureWidth;
+    height = captureHeight;
+    frameBytes = static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+    outputPrefix = prefix;
+    // Fence'y to GL 3.2 / ARB_sync; bez nich mapowanie po prostu czeka przy ponownym użyciu bufora
+    fencesAvailable = GLEW_VERSION_3_2 || GLEW_ARB_sync;
+
+    slots.resize(PIXEL_PACK_SLOT_COUNT);
+    for (PixelPackSlot& slot : slots) {
+        glGenBuffers(1, &slot.buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(frameBytes), nullptr, GL_STREAM_READ);
+        trackGpuObject(GpuObjectKind::Buffer, slot.buffer, frameBytes);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    encoders = std::make_unique<ThreadPool>(encoderThreads);
+    maxFrameBuffers = encoderThreads * FRAME_BUFFERS_PER_ENCODER;
+    return true;
+}
+
+void FrameCapture::destroyBuffers() {
+    for (PixelPackSlot& slot : slots) {
+        if (slot.fence) glDeleteSync(slot.fence);
+        untrackGpuObject(GpuObjectKind::Buffer, slot.buffer);
+        if (slot.buffer != 0) glDeleteBuffers(1, &slot.buffer);
+    }
+    slots.clear();
+}
+
+void FrameCapture::captureFrame(GLuint framebuffer) {
+    if (!isActive()) return;
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Odbiór gotowych odczytów bez czekania, od najstarszego
+    for (size_t offset = 1; offset < slots.size(); ++offset) {
+        collectSlot(slots[(nextSlot + offset) % slots.size()], false);
+    }
+    PixelPackSlot& slot = slots[nextSlot];
+    if (slot.pending && !collectSlot(slot, false)) {
+        if (fencesAvailable) ++stats.fenceStalls;
+        collectSlot(slot, true);
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glReadBuffer(framebuffer != 0 ? GL_COLOR_ATTACHMENT0 : GL_BACK);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    if (fencesAvailable) {
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    slot.pending = true;
+    slot.frameIndex = nextFrameIndex++;
+    nextSlot = (nextSlot + 1) % slots.size();
+    ++stats.capturedFrames;
+
+    float elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    stats.averageCaptureMs += CAPTURE_TIME_SMOOTHING * (elapsedMs - stats.averageCaptureMs);
+    if (elapsedMs > stats.maxCaptureMs) stats.maxCaptureMs = elapsedMs;
+}
+
+bool FrameCapture::collectSlot(PixelPackSlot& slot, bool wait) {
+    if (!slot.pending) return true;
+
+    if (slot.fence) {
+        GLenum result = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? FENCE_WAIT_TIMEOUT_NS : 0);
+        if (result == GL_TIMEOUT_EXPIRED && !wait) return false;
+        if (result == GL_WAIT_FAILED || result == GL_TIMEOUT_EXPIRED) {
+            std::cerr << "ERROR::FRAME_CAPTURE::Fence wait failed for frame " << slot.frameIndex << std::endl;
+        }
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+    } else if (!wait) {
+        // Bez fence'ów nie wiemy, czy odczyt się zakończył - bufor odbierany przy ponownym użyciu
+        return false;
+    }
+
+    FrameBuffer frame = acquireFrameBuffer();
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(frameBytes), GL_MAP_READ_BIT);
+    bool mapped = pixels != nullptr;
+    if (mapped) {
+        std::memcpy(frame->data(), pixels, frameBytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.pending = false;
+
+    if (!mapped) {
+        std::cerr << "ERROR::FRAME_CAPTURE::Could not map pixel buffer for frame " << slot.frameIndex << std::endl;
+        failedWrites.fetch_add(1, std::memory_order_relaxed);
+        releaseFrameBuffer(frame);
+        return true;
+    }
+
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), "_%06llu.png", static_cast<unsigned long long>(slot.frameIndex));
+    std::string path = outputPrefix + suffix;
+    encoders->submit([this, frame, path]() {
+        if (writePngRgba(path, width, height, frame->data(), true)) {
+            writtenFrames.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            failedWrites.fetch_add(1, std::memory_order_relaxed);
+        }
+        releaseFrameBuffer(frame);
+    });
+    return true;
+}
+
+FrameCapture::FrameBuffer FrameCapture::acquireFrameBuffer() {
+    std::unique_lock<std::mutex> lock(frameBufferMutex);
+    if (frameBuffersInFlight >= maxFrameBuffers) {
+        ++stats.encoderStalls;
+        frameBufferCondition.wait(lock, [this] { return frameBuffersInFlight < maxFrameBuffers; });
+    }
+    ++frameBuffersInFlight;
+    if (!freeFrameBuffers.empty()) {
+        FrameBuffer buffer = freeFrameBuffers.back();
+        freeFrameBuffers.pop_back();
+        return buffer;
+    }
+    return std::make_shared<std::vector<uint8_t>>(frameBytes);
+}
+
+void FrameCapture::releaseFrameBuffer(const FrameBuffer& buffer) {
+    {
+        std::lock_guard<std::mutex> lock(frameBufferMutex);
+        freeFrameBuffers.push_back(buffer);
+        --frameBuffersInFlight;
+    }
+    frameBufferCondition.notify_all();
+}
+
+void FrameCapture::finish() {
+    if (!isActive()) return;
+
+    // Odbiór w kolejności zlecania, potem oczekiwanie na koderów
+    for (size_t offset = 0; offset < slots.size(); ++offset) {
+        collectSlot(slots[(nextSlot + offset) % slots.size()], true);
+    }
+    std::unique_lock<std::mutex> lock(frameBufferMutex);
+    frameBufferCondition.wait(lock, [this] { return frameBuffersInFlight == 0; });
+}
+
+FrameCaptureStats FrameCapture::getStats() const {
+    FrameCaptureStats result = stats;
+    result.writtenFrames = writtenFrames.load(std::memory_order_relaxed);
+    result.failedWrites = failedWrites.load(std::memory_order_relaxed);
+    return result;
+}
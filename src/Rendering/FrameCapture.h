@@ -0,0 +1,85 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Utils/ThreadPool.h"
+
+// Liczniki przechwytywania klatek - wyświetlane w profilerze i wypisywane po zakończeniu
+struct FrameCaptureStats {
+    uint64_t capturedFrames = 0;  // Klatki odczytane z GPU
+    uint64_t writtenFrames = 0;   // Klatki zapisane na dysk
+    uint64_t failedWrites = 0;
+    uint64_t fenceStalls = 0;     // Oczekiwania na GPU przy pełnym pierścieniu buforów
+    uint64_t encoderStalls = 0;   // Oczekiwania na koder (wszystkie bufory klatek zajęte)
+    float averageCaptureMs = 0.0f; // Koszt captureFrame na wątku renderowania (średnia krocząca)
+    float maxCaptureMs = 0.0f;
+};
+
+// Asynchroniczny odczyt klatek do sekwencji PNG.
+// glReadPixels trafia do jednego z pierścienia buforów GL_PIXEL_PACK_BUFFER i zwraca od razu;
+// bufor mapowany jest dopiero, gdy jego fence zostanie zasygnalizowany (zwykle klatkę lub dwie
+// później). Skopiowane piksele koduje do PNG pula wątków, więc wątek renderowania nie czeka
+// ani na GPU, ani na dysk, dopóki kodery nadążają.
+class FrameCapture {
+public:
+    FrameCapture();
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // Pliki: outputPrefix_000000.png, outputPrefix_000001.png, ...
+    bool init(int width, int height, const std::string& outputPrefix, size_t encoderThreads);
+    // Zleca odczyt koloru z framebuffera (GL_COLOR_ATTACHMENT0) i odbiera gotowe wcześniejsze odczyty
+    void captureFrame(GLuint framebuffer);
+    // Odbiera wszystkie zaległe odczyty i czeka na zapis plików
+    void finish();
+
+    bool isActive() const { return width > 0; }
+    FrameCaptureStats getStats() const;
+
+private:
+    struct PixelPackSlot {
+        GLuint buffer = 0;
+        GLsync fence = nullptr;
+        bool pending = false;
+        uint64_t frameIndex = 0;
+    };
+
+    using FrameBuffer = std::shared_ptr<std::vector<uint8_t>>;
+
+    // Mapuje bufor i przekazuje klatkę koderom; bez wait wraca, jeśli GPU jeszcze nie skończył
+    bool collectSlot(PixelPackSlot& slot, bool wait);
+    FrameBuffer acquireFrameBuffer();
+    void releaseFrameBuffer(const FrameBuffer& buffer);
+    void destroyBuffers();
+
+    int width;
+    int height;
+    size_t frameBytes;
+    std::string outputPrefix;
+    bool fencesAvailable;
+
+    std::vector<PixelPackSlot> slots;
+    size_t nextSlot;
+    uint64_t nextFrameIndex;
+
+    std::unique_ptr<ThreadPool> encoders;
+    std::mutex frameBufferMutex;
+    std::condition_variable frameBufferCondition;
+    std::vector<FrameBuffer> freeFrameBuffers;
+    size_t frameBuffersInFlight;
+    size_t maxFrameBuffers;
+
+    std::atomic<uint64_t> writtenFrames;
+    std::atomic<uint64_t> failedWrites;
+    FrameCaptureStats stats;
+};
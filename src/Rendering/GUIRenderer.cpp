@@ -2,20 +2,111 @@
 #include "imgui_impl_glfw.h"    
 #include "imgui_impl_opengl3.h" 
 
+#include <algorithm>
+#include <cfloat>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+    // Liczba kolonii wypisywanych w tabeli
+    const size_t LISTED_CLUSTER_COUNT = 10;
+
+    // Etykiety podsystemów w kolejności MemoryTag
+    const char* const MEMORY_TAG_LABELS[MEMORY_TAG_COUNT] = {
+        "Komorki", "Obrysy komorek", "Lista kolonii", "Bufory kroku", "Historia",
+        "Renderer (CPU)", "Bufory GPU", "Tekstury GPU", "Zasoby", "GUI"
+    };
+
+    // ImGui nie podaje rozmiaru przy zwalnianiu - zapisujemy go w nagłówku przed blokiem
+    const size_t GUI_ALLOCATION_HEADER = alignof(std::max_align_t);
+
+    void* guiAllocate(size_t size, void*) {
+        unsigned char* block = static_cast<unsigned char*>(std::malloc(size + GUI_ALLOCATION_HEADER));
+        if (!block) return nullptr;
+        *reinterpret_cast<size_t*>(block) = size;
+        trackAllocation(MemoryTag::Gui, size);
+        return block + GUI_ALLOCATION_HEADER;
+    }
+
+    void guiFree(void* pointer, void*) {
+        if (!pointer) return;
+        unsigned char* block = static_cast<unsigned char*>(pointer) - GUI_ALLOCATION_HEADER;
+        trackFree(MemoryTag::Gui, *reinterpret_cast<size_t*>(block));
+        std::free(block);
+    }
+
+    void formatBytes(char* buffer, size_t bufferSize, uint64_t bytes) {
+        if (bytes >= 1024ull * 1024) {
+            std::snprintf(buffer, bufferSize, "%.1f MB", static_cast<double>(bytes) / (1024.0 * 1024.0));
+        } else if (bytes >= 1024) {
+            std::snprintf(buffer, bufferSize, "%.1f KB", static_cast<double>(bytes) / 1024.0);
+        } else {
+            std::snprintf(buffer, bufferSize, "%llu B", static_cast<unsigned long long>(bytes));
+        }
+    }
+}
+
 // Constructor
 GUIRenderer::GUIRenderer()
     : antibioticStrength(0.5f),       
       antibioticRadius(50.0f),        
       addBacteriaCount(100),          
-      selectedBacteriaType(BacteriaType::Cocci),
+      selectedBacteriaType(0),
+      inoculationShapeIndex(static_cast<int>(InoculationShape::Blob)),
+      inoculationSize(2.0f),
+      lightRange(100.0f),
       currentMouseScreenPos(0,0),
       isWaitingForBacteriaPlacement(false),
       isWaitingForAntibioticPlacement(false),
-      currentBacteriaCountDisplay(0),
-      lightRange(100.0f) {}
+      populationObjectsDisplay(0), populationLimitDisplay(0),
+      telemetryActive(false), telemetryWrittenDisplay(0), telemetryDroppedDisplay(0),
+      timeWarp(1.0f), achievedTimeWarpDisplay(1.0f), simulationBehindDisplay(false),
+      historyAvailable(false), historyBudgetDisplay(0), historyTimeStep(0.0f),
+      historyScrubIndex(0), historyScrubbing(false) {}
+
+void GUIRenderer::setColonyStats(const ColonyStatsSnapshot& stats) {
+    colonyStatsDisplay = stats;
+}
+
+void GUIRenderer::setPopulationUsage(size_t objects, size_t limit) {
+    populationObjectsDisplay = objects;
+    populationLimitDisplay = limit;
+}
+
+void GUIRenderer::setTelemetryCounters(uint64_t written, uint64_t dropped) {
+    telemetryActive = true;
+    telemetryWrittenDisplay = written;
+    telemetryDroppedDisplay = dropped;
+}
 
-void GUIRenderer::setBacteriaCount(size_t count) {
-    currentBacteriaCountDisplay = count;
+void GUIRenderer::setTimeWarpStatus(float achieved, bool behind) {
+    achievedTimeWarpDisplay = achieved;
+    simulationBehindDisplay = behind;
+}
+
+void GUIRenderer::setRenderStats(const RenderStats& stats) {
+    renderStatsDisplay = stats;
+}
+
+void GUIRenderer::setMemoryReport(const MemoryReport& report) {
+    memoryReportDisplay = report;
+}
+
+void GUIRenderer::setClusterReport(const ColonyClusterReport& report) {
+    clusterReportDisplay = report;
+}
+
+void GUIRenderer::setHistoryStatus(bool available, const ColonyHistory& history, float timeStep) {
+    historyAvailable = available;
+    history.getTicks(historyTicksDisplay);
+    historyStatsDisplay = history.getStats();
+    historyBudgetDisplay = history.getSettings().memoryBudgetBytes;
+    historyTimeStep = timeStep;
+}
+
+void GUIRenderer::installAllocatorHooks() {
+    ImGui::SetAllocatorFunctions(guiAllocate, guiFree, nullptr);
 }
 
 void GUIRenderer::render(const glm::vec2& viewOffset, float zoomLevel, int windowHeight, bool is3DView) { 
@@ -41,22 +132,251 @@ void GUIRenderer::render(const glm::vec2& viewOffset, float zoomLevel, int windo
     ImGui::Separator();
 
     // --- Liczba bakterii ---
-    ImGui::Text("Liczba bakterii: %zu", currentBacteriaCountDisplay);
+    ImGui::Text("Liczba bakterii: %llu", static_cast<unsigned long long>(colonyStatsDisplay.total));
+    ImGui::Text("Obiekty symulacji: %llu / %llu", static_cast<unsigned long long>(populationObjectsDisplay),
+                static_cast<unsigned long long>(populationLimitDisplay));
+    ImGui::Separator();
+
+    // --- Przyspieszenie czasu symulacji ---
+    if (ImGui::SliderFloat("Przyspieszenie", &timeWarp, 1.0f, 1000.0f, "%.0fx", ImGuiSliderFlags_Logarithmic | ImGuiSliderFlags_AlwaysClamp)) {
+        if (onTimeWarpChanged) {
+            onTimeWarpChanged(timeWarp);
+        }
+    }
+    if (simulationBehindDisplay) {
+        ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "Osiagniete: %.0fx (symulacja nie nadaza)", achievedTimeWarpDisplay);
+    } else {
+        ImGui::Text("Osiagniete: %.0fx", achievedTimeWarpDisplay);
+    }
+
+    // --- Statystyki kolonii (utrzymywane przyrostowo przez symulację) ---
+    if (ImGui::CollapsingHeader("Statystyki kolonii")) {
+        const SpeciesRegistry& registry = getSpeciesRegistry();
+        for (size_t i = 0; i < registry.size(); ++i) {
+            ImGui::Text("  %s: %llu", registry.get(static_cast<SpeciesId>(i)).name.c_str(),
+                        static_cast<unsigned long long>(colonyStatsDisplay.typeCounts[i]));
+        }
+        ImGui::Text("Zdrowie: srednio %.2f (p10 %.2f, p50 %.2f, p90 %.2f)", colonyStatsDisplay.meanHealth,
+                    colonyStatsDisplay.healthP10, colonyStatsDisplay.healthP50, colonyStatsDisplay.healthP90);
+        ImGui::Text("Odpornosc: srednio %.2f", colonyStatsDisplay.meanResistance);
+        ImGui::Text("Podzialy: %.1f/s, zgony: %.1f/s", colonyStatsDisplay.birthsPerSecond, colonyStatsDisplay.deathsPerSecond);
+
+        float healthHistogram[HEALTH_HISTOGRAM_BINS];
+        for (int i = 0; i < HEALTH_HISTOGRAM_BINS; ++i) healthHistogram[i] = static_cast<float>(colonyStatsDisplay.healthHistogram[i]);
+        ImGui::PlotHistogram("Zdrowie", healthHistogram, HEALTH_HISTOGRAM_BINS, 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 50));
+
+        float resistanceHistogram[RESISTANCE_HISTOGRAM_BINS];
+        for (int i = 0; i < RESISTANCE_HISTOGRAM_BINS; ++i) resistanceHistogram[i] = static_cast<float>(colonyStatsDisplay.resistanceHistogram[i]);
+        ImGui::PlotHistogram("Odpornosc", resistanceHistogram, RESISTANCE_HISTOGRAM_BINS, 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 50));
+
+        if (telemetryActive) {
+            ImGui::Text("Telemetria: zapisano %llu, pominieto %llu",
+                        static_cast<unsigned long long>(telemetryWrittenDisplay),
+                        static_cast<unsigned long long>(telemetryDroppedDisplay));
+        }
+    }
+    ImGui::Separator();
+
+    // --- Profiler renderowania (poprzednia klatka) ---
+    if (ImGui::CollapsingHeader("Profiler")) {
+        ImGui::Text("Wywolania rysowania: %u (polecen: %u)", renderStatsDisplay.drawCalls, renderStatsDisplay.submittedCommands);
+        ImGui::Text("Zmiany stanu: %u", renderStatsDisplay.stateChanges);
+        ImGui::Text("  programy: %u, VAO: %u, tekstury: %u, przebiegi: %u",
+                    renderStatsDisplay.programBinds, renderStatsDisplay.vaoBinds,
+                    renderStatsDisplay.textureBinds, renderStatsDisplay.passStateChanges);
+        ImGui::Text("Pominiete powiazania: %u", renderStatsDisplay.skippedBinds);
+
+        // Porównanie wzoru proceduralnego z wypieczonym (czas GPU przebiegu kolonii)
+        if (renderStatsDisplay.bakedPatternsAvailable) {
+            bool bakedPatterns = renderStatsDisplay.bakedPatternsEnabled;
+            if (ImGui::Checkbox("Wypieczone wzory bakterii", &bakedPatterns) && onBakedPatternsToggled) {
+                onBakedPatternsToggled(bakedPatterns);
+            }
+        } else {
+            ImGui::TextDisabled("Wypieczone wzory niedostepne");
+        }
+        ImGui::Text("Kolonia GPU: proceduralne %.3f ms, wypieczone %.3f ms",
+                    renderStatsDisplay.proceduralPatternGpuMs, renderStatsDisplay.bakedPatternGpuMs);
+
+        // Impostory SDF (jeden kwadrat na bakterię) zamiast wachlarza trójkątów z obrysu
+        bool impostors = renderStatsDisplay.impostorsEnabled;
+        if (ImGui::Checkbox("Impostory SDF", &impostors) && onImpostorsToggled) {
+            onImpostorsToggled(impostors);
+        }
+
+        if (renderStatsDisplay.captureActive) {
+            ImGui::Text("Przechwytywanie: %.3f ms (maks. %.3f ms)", renderStatsDisplay.captureMs, renderStatsDisplay.captureMaxMs);
+            ImGui::Text("  klatki: %llu, zapisane: %llu, oczekiwania: fence %llu, koder %llu",
+                        static_cast<unsigned long long>(renderStatsDisplay.capturedFrames),
+                        static_cast<unsigned long long>(renderStatsDisplay.writtenFrames),
+                        static_cast<unsigned long long>(renderStatsDisplay.captureFenceStalls),
+                        static_cast<unsigned long long>(renderStatsDisplay.captureEncoderStalls));
+        }
+    }
+    ImGui::Separator();
+
+    // --- Kolonie: skupiska stykających się komórek ---
+    if (ImGui::CollapsingHeader("Kolonie")) {
+        // Kontury kolonii przy małym zoomie - przeliczane tylko w kaflach z narodzinami lub zgonami
+        bool outlines = renderStatsDisplay.colonyOutlinesEnabled;
+        if (ImGui::Checkbox("Kontury przy malym zoomie", &outlines) && onColonyOutlinesToggled) {
+            onColonyOutlinesToggled(outlines);
+        }
+        if (renderStatsDisplay.colonyOutlinesDrawn) {
+            ImGui::Text("Kontury: %u lamanych, %u wierzcholkow", renderStatsDisplay.outlineStrips, renderStatsDisplay.outlineVertices);
+            ImGui::Text("  kafle: %u, przeliczone: %u (%.3f ms), wyslane wierzcholki: %u", renderStatsDisplay.outlineTiles,
+                        renderStatsDisplay.outlineExtractedTiles, renderStatsDisplay.outlineExtractMs,
+                        renderStatsDisplay.outlineChangedVertices);
+        }
+        if (!clusterReportDisplay.valid) {
+            ImGui::TextDisabled("Wykrywanie kolonii wylaczone");
+        } else {
+            ImGui::Text("Kolonie: %llu (krok %llu, %.2f ms)",
+                        static_cast<unsigned long long>(clusterReportDisplay.clusterCount),
+                        static_cast<unsigned long long>(clusterReportDisplay.tick),
+                        clusterReportDisplay.detectionMilliseconds);
+            ImGui::Text("Odleglosc styku: %.2f", clusterReportDisplay.contactDistance);
+            size_t listed = std::min(clusterReportDisplay.largest.size(), LISTED_CLUSTER_COUNT);
+            // Przy dziesiątkach gatunków kolumna na gatunek byłaby nieczytelna - pokazujemy dominujący
+            if (listed > 0 && ImGui::BeginTable("clusters", 4)) {
+                const SpeciesRegistry& registry = getSpeciesRegistry();
+                ImGui::TableSetupColumn("Komorki");
+                ImGui::TableSetupColumn("Obiekty");
+                ImGui::TableSetupColumn("Srodek");
+                ImGui::TableSetupColumn("Dominujacy gatunek");
+                ImGui::TableHeadersRow();
+                for (size_t i = 0; i < listed; ++i) {
+                    const ColonyCluster& cluster = clusterReportDisplay.largest[i];
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%llu", static_cast<unsigned long long>(cluster.cellCount));
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%u", cluster.objectCount);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.1f, %.1f", cluster.centroid.x, cluster.centroid.y);
+                    size_t dominant = 0;
+                    for (size_t species = 1; species < registry.size(); ++species) {
+                        if (cluster.typeCounts[species] > cluster.typeCounts[dominant]) dominant = species;
+                    }
+                    ImGui::TableNextColumn();
+                    if (dominant < registry.size() && cluster.cellCount > 0) {
+                        ImGui::Text("%s (%.0f%%)", registry.get(static_cast<SpeciesId>(dominant)).name.c_str(),
+                                    100.0 * static_cast<double>(cluster.typeCounts[dominant]) / static_cast<double>(cluster.cellCount));
+                    }
+                }
+                ImGui::EndTable();
+            }
+        }
+    }
+    ImGui::Separator();
+
+    // --- Historia: przewijanie do zachowanych migawek kolonii ---
+    const bool wasScrubbing = historyScrubbing;
+    historyScrubbing = false;
+    if (ImGui::CollapsingHeader("Historia")) {
+        if (!historyAvailable) {
+            ImGui::TextDisabled("Cofanie wylaczone");
+        } else if (historyTicksDisplay.empty()) {
+            ImGui::TextDisabled("Brak migawek");
+        } else {
+            // Poza przeciąganiem suwak stoi na najnowszej migawce
+            const int last = static_cast<int>(historyTicksDisplay.size()) - 1;
+            int index = wasScrubbing ? std::min(historyScrubIndex, last) : last;
+            const uint64_t tick = historyTicksDisplay[index];
+            char label[64];
+            std::snprintf(label, sizeof(label), "krok %llu (%.1f s)", static_cast<unsigned long long>(tick),
+                          static_cast<double>(tick) * historyTimeStep);
+            if (ImGui::SliderInt("Cofnij do", &index, 0, last, label, ImGuiSliderFlags_AlwaysClamp) && onRewindRequested) {
+                onRewindRequested(historyTicksDisplay[index]);
+            }
+            historyScrubbing = ImGui::IsItemActive();
+            historyScrubIndex = index;
+
+            char retained[32];
+            char budget[32];
+            formatBytes(retained, sizeof(retained), historyStatsDisplay.retainedBytes);
+            formatBytes(budget, sizeof(budget), historyBudgetDisplay);
+            ImGui::Text("Migawki: %llu, pamiec %s / %s", static_cast<unsigned long long>(historyStatsDisplay.snapshots),
+                        retained, budget);
+            ImGui::Text("Ostatnia: %.2f ms, fragmenty wspoldzielone %.0f%%, latki %.0f%%",
+                        historyStatsDisplay.lastCaptureMilliseconds, historyStatsDisplay.lastSharedFraction * 100.0f,
+                        historyStatsDisplay.lastPatchedFraction * 100.0f);
+        }
+    }
+    ImGui::Separator();
+
+    // --- Pamięć według podsystemów (GPU: rozmiary zapisane przy tworzeniu obiektów) ---
+    if (ImGui::CollapsingHeader("Pamiec")) {
+        char total[32];
+        formatBytes(total, sizeof(total), memoryReportDisplay.getTotalLiveBytes());
+        ImGui::Text("Razem: %s", total);
+        if (ImGui::BeginTable("memory", 4)) {
+            ImGui::TableSetupColumn("Podsystem");
+            ImGui::TableSetupColumn("Teraz");
+            ImGui::TableSetupColumn("Szczyt");
+            ImGui::TableSetupColumn("Alokacje");
+            ImGui::TableHeadersRow();
+            for (size_t i = 0; i < MEMORY_TAG_COUNT; ++i) {
+                const MemoryTagStats& tag = memoryReportDisplay.tags[i];
+                char live[32];
+                char peak[32];
+                formatBytes(live, sizeof(live), tag.liveBytes);
+                formatBytes(peak, sizeof(peak), tag.peakBytes);
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(MEMORY_TAG_LABELS[i]);
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(live);
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(peak);
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu / %llu", static_cast<unsigned long long>(tag.liveAllocations),
+                            static_cast<unsigned long long>(tag.totalAllocations));
+            }
+            ImGui::EndTable();
+        }
+    }
     ImGui::Separator();
 
     if (!is3DView){
         // --- Sekcja dodawania bakterii---
         ImGui::Text("Dodaj bakterie:");
-        const char* bacteriaTypeNames[] = {"Cocci", "Diplococcus", "Staphylococci", "Bacillus"};
-        static int currentBacteriaTypeIndex = static_cast<int>(selectedBacteriaType);
-        if (ImGui::Combo("Typ", &currentBacteriaTypeIndex, bacteriaTypeNames, IM_ARRAYSIZE(bacteriaTypeNames))) {
-            selectedBacteriaType = static_cast<BacteriaType>(currentBacteriaTypeIndex);
+        const SpeciesRegistry& registry = getSpeciesRegistry();
+        if (selectedBacteriaType >= registry.size()) selectedBacteriaType = 0;
+        const char* selectedName = registry.get(selectedBacteriaType).name.c_str();
+        if (ImGui::BeginCombo("Gatunek", selectedName)) {
+            for (size_t i = 0; i < registry.size(); ++i) {
+                const SpeciesId species = static_cast<SpeciesId>(i);
+                if (ImGui::Selectable(registry.get(species).name.c_str(), species == selectedBacteriaType)) {
+                    selectedBacteriaType = species;
+                }
+            }
+            ImGui::EndCombo();
+        }
+        ImGui::SliderInt("Liczba", &addBacteriaCount, 1, 1000000, "%d", ImGuiSliderFlags_Logarithmic);
+        const char* shapeNames[INOCULATION_SHAPE_COUNT] = {"Kropla", "Murawa", "Posiew", "Siatka"};
+        if (ImGui::Combo("Wzor", &inoculationShapeIndex, shapeNames, INOCULATION_SHAPE_COUNT)) {
+            streakScreenPoints.clear();
         }
-        ImGui::SliderInt("Liczba", &addBacteriaCount, 1, 500);
+        const InoculationShape shape = static_cast<InoculationShape>(inoculationShapeIndex);
+        const char* sizeLabel = (shape == InoculationShape::Lawn) ? "Promien" : (shape == InoculationShape::Grid) ? "Odstep" : "Rozrzut";
+        ImGui::SliderFloat(sizeLabel, &inoculationSize, 0.5f, 200.0f, "%.1f", ImGuiSliderFlags_Logarithmic);
 
         if (isWaitingForBacteriaPlacement) {
-            ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "Kliknij na ekran, aby dodac bakterię %s.", bacteriaTypeNames[currentBacteriaTypeIndex]);
+            if (shape == InoculationShape::Streak) {
+                ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "Klikaj kolejne punkty posiewu (%d).", static_cast<int>(streakScreenPoints.size()));
+                if (streakScreenPoints.size() >= 2 && ImGui::Button("Posiej")) {
+                    if (onAddBacteria) {
+                        onAddBacteria(selectedBacteriaType, shape, addBacteriaCount, inoculationSize, streakScreenPoints);
+                    }
+                    streakScreenPoints.clear();
+                    isWaitingForBacteriaPlacement = false;
+                }
+            } else {
+                ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "Kliknij na ekran, aby dodac bakterię %s.", selectedName);
+            }
             if (ImGui::Button("Anuluj dodawanie")) {
+                streakScreenPoints.clear();
                 isWaitingForBacteriaPlacement = false;
             }
         } else {
@@ -67,10 +387,15 @@ void GUIRenderer::render(const glm::vec2& viewOffset, float zoomLevel, int windo
         }
 
         if (isWaitingForBacteriaPlacement && ImGui::IsMouseClicked(0) && !ImGui::GetIO().WantCaptureMouse) {
-            if (onAddBacteria) {
-                onAddBacteria(selectedBacteriaType, addBacteriaCount, static_cast<int>(currentMouseScreenPos.x), static_cast<int>(currentMouseScreenPos.y));
+            if (shape == InoculationShape::Streak) {
+                // Posiew kończy przycisk - kliknięcia tylko dokładają wierzchołki
+                streakScreenPoints.push_back(currentMouseScreenPos);
+            } else {
+                if (onAddBacteria) {
+                    onAddBacteria(selectedBacteriaType, shape, addBacteriaCount, inoculationSize, {currentMouseScreenPos});
+                }
+                isWaitingForBacteriaPlacement = false;
             }
-            isWaitingForBacteriaPlacement = false;
         }
         ImGui::Separator();
 
@@ -88,6 +413,7 @@ void GUIRenderer::render(const glm::vec2& viewOffset, float zoomLevel, int windo
             if (ImGui::Button("Aplikuj antybiotyk")) {
                 isWaitingForAntibioticPlacement = true;
                 isWaitingForBacteriaPlacement = false; 
+                streakScreenPoints.clear();
             }
         }
 
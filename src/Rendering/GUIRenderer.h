@@ -1,30 +1,82 @@
 #pragma once
 
 #include <functional>
+#include <vector>
 #include "imgui.h"
 #include "../Simulation/IBacteria.h" 
+#include "../Simulation/ColonyStats.h"
+#include "../Simulation/ColonyClusters.h"
+#include "../Simulation/ColonyHistory.h"
+#include "../Simulation/SpeciesRegistry.h"
+#include "../Simulation/InoculationPattern.h"
+#include "RenderStats.h"
+#include "../Utils/MemoryTracker.h"
 
 class GUIRenderer {
 private:
     float antibioticStrength;
     float antibioticRadius;
     int addBacteriaCount; 
-    BacteriaType selectedBacteriaType;
+    SpeciesId selectedBacteriaType;
+    int inoculationShapeIndex;
+    float inoculationSize;
+    std::vector<ImVec2> streakScreenPoints; // Kliknięte wierzchołki posiewu
     float lightRange;
 
     ImVec2 currentMouseScreenPos; 
     bool isWaitingForBacteriaPlacement;
     bool isWaitingForAntibioticPlacement;
-    size_t currentBacteriaCountDisplay;
+    ColonyStatsSnapshot colonyStatsDisplay;
+    size_t populationObjectsDisplay;
+    size_t populationLimitDisplay;
+    bool telemetryActive;
+    uint64_t telemetryWrittenDisplay;
+    uint64_t telemetryDroppedDisplay;
+    RenderStats renderStatsDisplay;
+    float timeWarp;
+    float achievedTimeWarpDisplay;
+    bool simulationBehindDisplay;
+    MemoryReport memoryReportDisplay;
+    ColonyClusterReport clusterReportDisplay;
+    bool historyAvailable;
+    std::vector<uint64_t> historyTicksDisplay;
+    ColonyHistoryStats historyStatsDisplay;
+    size_t historyBudgetDisplay;
+    float historyTimeStep;
+    int historyScrubIndex;
+    bool historyScrubbing;
 
 public:
     GUIRenderer();
 
-    std::function<void(BacteriaType type, int count, int screenX, int screenY)> onAddBacteria;
+    // Punkty w pikselach okna: środek wzoru albo wierzchołki łamanej posiewu
+    std::function<void(SpeciesId type, InoculationShape shape, int count, float size, const std::vector<ImVec2>& screenPoints)> onAddBacteria;
     std::function<void(float strength, float radius, int screenX, int screenY)> onApplyAntibiotic;
     std::function<void(float range)> onLightRangeChanged; 
+    std::function<void(bool enabled)> onBakedPatternsToggled;
+    std::function<void(bool enabled)> onImpostorsToggled;
+    std::function<void(bool enabled)> onColonyOutlinesToggled;
+    std::function<void(float warp)> onTimeWarpChanged;
+    // Przywrócenie kolonii do migawki z danego kroku (wybranego suwakiem historii)
+    std::function<void(uint64_t tick)> onRewindRequested;
 
     void render(const glm::vec2& viewOffset, float zoomLevel, int windowHeight, bool is3DView); 
-    void setBacteriaCount(size_t count);
+    void setColonyStats(const ColonyStatsSnapshot& stats);
+    void setTelemetryCounters(uint64_t written, uint64_t dropped);
+    // Liczba obiektów symulacji (superosobnik to jeden obiekt) i ich limit z budżetu
+    void setPopulationUsage(size_t objects, size_t limit);
+    void setRenderStats(const RenderStats& stats);
+    // Osiągnięte przyspieszenie czasu i czy symulacja nie nadąża za żądanym
+    void setTimeWarpStatus(float achieved, bool behind);
+    void setMemoryReport(const MemoryReport& report);
+    // Ostatni raport wykrywania kolonii (liczba, rozmiary, środki i skład)
+    void setClusterReport(const ColonyClusterReport& report);
+    // Zachowane migawki historii i ich koszt; available == false, gdy cofanie jest wyłączone
+    void setHistoryStatus(bool available, const ColonyHistory& history, float timeStep);
+    // Suwak historii jest przeciągany - symulacja czeka, by nie porzucić przewijanych migawek
+    bool isScrubbingHistory() const { return historyScrubbing; }
+
+    // Alokacje ImGui liczone w MemoryTag::Gui - wywoływane przed ImGui::CreateContext
+    static void installAllocatorHooks();
 
 };
@@ -0,0 +1,42 @@
+#include "GpuMemory.h"
+
+#include "Utils/MemoryTracker.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+    // Identyfikatory GL są unikalne tylko w obrębie rodzaju obiektu
+    std::unordered_map<GLuint, size_t> trackedObjects[3];
+    std::mutex trackedObjectsMutex;
+
+    MemoryTag tagForKind(GpuObjectKind kind) {
+        return kind == GpuObjectKind::Buffer ? MemoryTag::GpuBuffers : MemoryTag::GpuTextures;
+    }
+}
+
+void trackGpuObject(GpuObjectKind kind, GLuint object, size_t bytes) {
+    if (object == 0) return;
+    std::lock_guard<std::mutex> lock(trackedObjectsMutex);
+    std::unordered_map<GLuint, size_t>& objects = trackedObjects[static_cast<size_t>(kind)];
+    auto existing = objects.find(object);
+    if (existing != objects.end()) {
+        // Osierocenie magazynu o tym samym rozmiarze (StreamBuffer) nie zmienia zajętości
+        if (existing->second == bytes) return;
+        trackFree(tagForKind(kind), existing->second);
+        existing->second = bytes;
+    } else {
+        objects.emplace(object, bytes);
+    }
+    trackAllocation(tagForKind(kind), bytes);
+}
+
+void untrackGpuObject(GpuObjectKind kind, GLuint object) {
+    if (object == 0) return;
+    std::lock_guard<std::mutex> lock(trackedObjectsMutex);
+    std::unordered_map<GLuint, size_t>& objects = trackedObjects[static_cast<size_t>(kind)];
+    auto existing = objects.find(object);
+    if (existing == objects.end()) return;
+    trackFree(tagForKind(kind), existing->second);
+    objects.erase(existing);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+
+// Pamięć obiektów GL zapisywana przy tworzeniu (glBufferData, glTexImage*, glRenderbufferStorage),
+// bo OpenGL nie udostępnia rozmiaru zajętej pamięci. Bufory liczą się do MemoryTag::GpuBuffers,
+// tekstury i renderbuffery do MemoryTag::GpuTextures. Wywoływane na wątku z kontekstem GL.
+enum class GpuObjectKind {
+    Buffer,
+    Texture,
+    Renderbuffer
+};
+
+// Ponowne wywołanie dla tego samego obiektu zastępuje poprzedni rozmiar (realokacja magazynu)
+void trackGpuObject(GpuObjectKind kind, GLuint object, size_t bytes);
+// Wywoływane przed glDelete*; obiekty nieśledzone są pomijane
+void untrackGpuObject(GpuObjectKind kind, GLuint object);
@@ -3,12 +3,12 @@
 #include <sstream>
 #include <iostream> 
 
-bool ModelLoader::loadOBJ(const char* path, std::vector<Vertex>& out_vertices) {
-    std::vector<glm::vec3> temp_positions;
-    std::vector<glm::vec2> temp_texcoords;
-    std::vector<glm::vec3> temp_normals;
+bool ModelLoader::loadOBJ(const char* path, VertexList& out_vertices) {
+    TrackedVector<glm::vec3, MemoryTag::Assets> temp_positions;
+    TrackedVector<glm::vec2, MemoryTag::Assets> temp_texcoords;
+    TrackedVector<glm::vec3, MemoryTag::Assets> temp_normals;
 
-    std::vector<unsigned int> positionIndices, uvIndices, normalIndices;
+    TrackedVector<unsigned int, MemoryTag::Assets> positionIndices, uvIndices, normalIndices;
 
     std::ifstream file(path);
     if (!file.is_open()) {
@@ -6,13 +6,18 @@
 #include <vector> 
 #include <iostream>
 
+#include "Utils/MemoryTracker.h"
+
 struct Vertex {
     glm::vec3 Position;
     glm::vec3 Normal;
     glm::vec2 TexCoords;
 };
 
+// Wierzchołki modelu przed wysłaniem do GPU
+using VertexList = TrackedVector<Vertex, MemoryTag::Assets>;
+
 class ModelLoader {
 public:
-    bool loadOBJ(const char* path, std::vector<Vertex>& out_vertices);
+    bool loadOBJ(const char* path, VertexList& out_vertices);
 };
\ No newline at end of file
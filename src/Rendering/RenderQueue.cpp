@@ -0,0 +1,146 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+uint32_t RenderQueue::quantizeDepth(float depth01, bool backToFront) {
+    float clamped = std::min(std::max(depth01, 0.0f), 1.0f);
+    uint32_t depth = static_cast<uint32_t>(clamped * static_cast<float>(MAX_DEPTH));
+    return backToFront ? (MAX_DEPTH - depth) : depth;
+}
+
+uint64_t RenderQueue::makeSortKey(RenderPass pass, GLuint program, GLuint vao, GLuint texture, uint32_t depth) {
+    // Nazwy obiektów GL to małe liczby nadawane kolejno, więc młodsze bity wystarczają do grupowania.
+    // Ewentualna kolizja pogarsza tylko grupowanie - wykonanie korzysta z pełnych nazw.
+    return (static_cast<uint64_t>(pass) & 0xF) << 60
+         | (static_cast<uint64_t>(program) & 0xFF) << 52
+         | (static_cast<uint64_t>(vao) & 0xFFF) << 40
+         | (static_cast<uint64_t>(texture) & 0xFFF) << 28
+         | (static_cast<uint64_t>(depth) & MAX_DEPTH);
+}
+
+RenderPass RenderQueue::getPass(uint64_t sortKey) {
+    return static_cast<RenderPass>(sortKey >> 60);
+}
+
+void RenderQueue::reserve(size_t count) {
+    commands.reserve(count);
+}
+
+void RenderQueue::submit(const DrawCommand& command) {
+    commands.push_back(command);
+}
+
+void RenderQueue::clear() {
+    commands.clear();
+}
+
+void RenderQueue::sort() {
+    const size_t n = commands.size();
+    if (n < 2) return;
+    scratch.resize(n);
+
+    DrawCommand* source = commands.data();
+    DrawCommand* destination = scratch.data();
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t histogram[256] = {};
+        for (size_t i = 0; i < n; ++i) {
+            ++histogram[(source[i].sortKey >> shift) & 0xFF];
+        }
+        // Jeśli wszystkie klucze mają ten sam bajt, przebieg niczego nie zmieni
+        if (histogram[(source[0].sortKey >> shift) & 0xFF] == n) continue;
+
+        size_t offset = 0;
+        for (size_t& bucket : histogram) {
+            size_t bucketSize = bucket;
+            bucket = offset;
+            offset += bucketSize;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            destination[histogram[(source[i].sortKey >> shift) & 0xFF]++] = source[i];
+        }
+        std::swap(source, destination);
+    }
+
+    if (source != commands.data()) {
+        std::copy(source, source + n, commands.data());
+    }
+}
+
+void GLStateCache::reset() {
+    currentProgram = 0;
+    currentVAO = 0;
+    currentTexture = 0;
+    passStateValid = false;
+}
+
+void GLStateCache::bindProgram(GLuint program) {
+    if (program == currentProgram) { ++stats.skippedBinds; return; }
+    glUseProgram(program);
+    currentProgram = program;
+    ++stats.programBinds;
+    ++stats.stateChanges;
+}
+
+void GLStateCache::bindVertexArray(GLuint vao) {
+    if (vao == currentVAO) { ++stats.skippedBinds; return; }
+    glBindVertexArray(vao);
+    currentVAO = vao;
+    ++stats.vaoBinds;
+    ++stats.stateChanges;
+}
+
+void GLStateCache::bindTexture2D(GLuint texture) {
+    if (texture == currentTexture) { ++stats.skippedBinds; return; }
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    currentTexture = texture;
+    ++stats.textureBinds;
+    ++stats.stateChanges;
+}
+
+void GLStateCache::applyPassState(const PassState& state) {
+    if (passStateValid && state.blend == currentPassState.blend &&
+        state.depthWrite == currentPassState.depthWrite &&
+        state.cullBackFaces == currentPassState.cullBackFaces &&
+        state.oitAccumulation == currentPassState.oitAccumulation) {
+        ++stats.skippedBinds;
+        return;
+    }
+
+    if (!passStateValid || state.blend != currentPassState.blend || state.oitAccumulation != currentPassState.oitAccumulation) {
+        if (state.blend) {
+            glEnable(GL_BLEND);
+            if (state.oitAccumulation) {
+                // Akumulacja: suma ważonych kolorów; revealage: iloczyn (1 - alpha)
+                if (GLEW_VERSION_4_0) {
+                    glBlendFunci(0, GL_ONE, GL_ONE);
+                    glBlendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+                } else {
+                    glBlendFunciARB(0, GL_ONE, GL_ONE);
+                    glBlendFunciARB(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+                }
+            } else {
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            }
+        } else {
+            glDisable(GL_BLEND);
+        }
+    }
+    if (!passStateValid || state.depthWrite != currentPassState.depthWrite) {
+        glDepthMask(state.depthWrite ? GL_TRUE : GL_FALSE);
+    }
+    if (!passStateValid || state.cullBackFaces != currentPassState.cullBackFaces) {
+        if (state.cullBackFaces) {
+            glEnable(GL_CULL_FACE);
+            glCullFace(GL_BACK);
+        } else {
+            glDisable(GL_CULL_FACE);
+        }
+    }
+
+    currentPassState = state;
+    passStateValid = true;
+    ++stats.passStateChanges;
+    ++stats.stateChanges;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <vector>
+
+#include "RenderStats.h"
+#include "Utils/MemoryTracker.h"
+
+// Przebiegi renderowania w kolejności wykonywania.
+// Agar jest tłem, po nim idą przezroczyste przebiegi (w trybie OIT kolejność między nimi jest dowolna).
+enum class RenderPass : uint8_t {
+    Agar = 0,
+    DishBase,
+    Lid,
+    Colony,
+    ColonyOutline,
+    AntibioticOverlay,
+    Count
+};
+
+// Zwarty rekord pojedynczego wywołania rysowania.
+// Parametry specyficzne dla obiektu (macierze, kolor, dane bakterii) leżą w osobnych tablicach
+// Renderera, a rekord wskazuje na nie przez payloadIndex.
+struct DrawCommand {
+    uint64_t sortKey;
+    GLuint program;
+    GLuint vao;
+    GLuint texture;
+    GLenum primitive;
+    GLint first;            // Pierwszy wierzchołek lub, dla indexed, pierwszy indeks
+    GLsizei count;
+    uint32_t payloadIndex;
+    // Rysowanie z bufora indeksów VAO (GL_UNSIGNED_INT), indeksy przesunięte o baseVertex
+    GLint baseVertex = 0;
+    bool indexed = false;
+};
+
+using DrawCommandList = TrackedVector<DrawCommand, MemoryTag::RendererCpu>;
+
+// Kolejka poleceń rysowania sortowana 64-bitowym kluczem:
+// [przebieg:4][program:8][VAO:12][tekstura:12][głębokość:28]
+class RenderQueue {
+public:
+    static constexpr int DEPTH_BITS = 28;
+    static constexpr uint32_t MAX_DEPTH = (1u << DEPTH_BITS) - 1;
+
+    // Kwantyzuje głębokość z zakresu [0, 1]. Dla przebiegów z blendingiem odwracamy kolejność
+    // (od tyłu do przodu), dla pozostałych sortujemy od przodu, co pomaga wczesnemu testowi głębi.
+    static uint32_t quantizeDepth(float depth01, bool backToFront);
+    static uint64_t makeSortKey(RenderPass pass, GLuint program, GLuint vao, GLuint texture, uint32_t depth);
+    static RenderPass getPass(uint64_t sortKey);
+
+    void reserve(size_t count);
+    void submit(const DrawCommand& command);
+    void clear();
+
+    // Sortowanie pozycyjne (radix sort LSD, 8 bitów na przebieg)
+    void sort();
+
+    const DrawCommandList& getCommands() const { return commands; }
+    size_t size() const { return commands.size(); }
+
+private:
+    DrawCommandList commands;
+    DrawCommandList scratch;
+};
+
+// Stan przebiegu, przełączany tylko przy zmianie przebiegu
+struct PassState {
+    bool blend;
+    bool depthWrite;
+    bool cullBackFaces;
+    bool oitAccumulation; // Funkcje mieszania osobne dla bufora akumulacji i revealage
+};
+
+// Pamięć podręczna stanu GL - pomija powiązania, które nic by nie zmieniły
+class GLStateCache {
+public:
+    void reset();
+    void bindProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    void bindTexture2D(GLuint texture);
+    void applyPassState(const PassState& state);
+    void countDraw() { ++stats.drawCalls; }
+
+    const RenderStats& getStats() const { return stats; }
+    void resetStats() { stats = RenderStats(); }
+
+private:
+    GLuint currentProgram = 0;
+    GLuint currentVAO = 0;
+    GLuint currentTexture = 0;
+    bool passStateValid = false;
+    PassState currentPassState{false, true, false, false};
+    RenderStats stats;
+};
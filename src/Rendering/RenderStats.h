@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+// Liczniki jednej klatki renderowania - wyświetlane w profilerze GUI
+struct RenderStats {
+    uint32_t drawCalls = 0;
+    uint32_t submittedCommands = 0;
+    uint32_t stateChanges = 0;   // Suma wszystkich poniższych zmian stanu
+    uint32_t programBinds = 0;
+    uint32_t vaoBinds = 0;
+    uint32_t textureBinds = 0;
+    uint32_t passStateChanges = 0;
+    uint32_t skippedBinds = 0;   // Powiązania pominięte przez cache stanu
+
+    // Czas GPU przebiegu kolonii dla obu trybów wzoru (ms, średnia krocząca; 0 = brak pomiaru)
+    float proceduralPatternGpuMs = 0.0f;
+    float bakedPatternGpuMs = 0.0f;
+    bool bakedPatternsAvailable = false;
+    bool bakedPatternsEnabled = false;
+    bool impostorsEnabled = false;
+
+    // Kontury kolonii w widoku z daleka (zamiast pojedynczych bakterii)
+    bool colonyOutlinesEnabled = false;
+    bool colonyOutlinesDrawn = false;
+    uint32_t outlineTiles = 0;
+    uint32_t outlineExtractedTiles = 0;   // Kafle przeliczone w tej klatce
+    uint32_t outlineStrips = 0;
+    uint32_t outlineVertices = 0;
+    uint32_t outlineChangedVertices = 0;  // Wierzchołki wysłane na GPU w tej klatce
+    float outlineExtractMs = 0.0f;
+
+    // Przechwytywanie klatek do PNG (koszt na wątku renderowania i oczekiwania)
+    bool captureActive = false;
+    float captureMs = 0.0f;
+    float captureMaxMs = 0.0f;
+    uint64_t capturedFrames = 0;
+    uint64_t writtenFrames = 0;
+    uint64_t captureFenceStalls = 0;
+    uint64_t captureEncoderStalls = 0;
+};
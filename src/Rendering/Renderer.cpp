@@ -1,56 +1,110 @@
 #include "Renderer.h"
+#include "GpuMemory.h"
+#include "Utils/Trace.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-// Próg zoomu decydujący o przełączeniu między widokiem makro (punkty) a mikro (modele bakterii)
+// Nazwy przebiegów na osi czasu śledzenia (kolejność jak w RenderPass)
+const char* const RENDER_PASS_TRACE_NAMES[static_cast<size_t>(RenderPass::Count)] = {
+    "pass:Agar", "pass:DishBase", "pass:Lid", "pass:Colony", "pass:ColonyOutline", "pass:AntibioticOverlay"
+};
+
+// Próg zoomu decydujący o przełączeniu między widokiem makro (kontury kolonii) a mikro (modele bakterii)
 const float MICROSCOPIC_VIEW_THRESHOLD = 1.5f; 
+// Kontury leżą na wysokości zaszczepionych komórek, żeby nie zasłaniał ich agar
+const float COLONY_OUTLINE_Z = 1.85f;
+const glm::vec4 COLONY_OUTLINE_COLOR(0.1f, 0.15f, 0.1f, 0.9f);
 // Współczynnik skalowania modeli bakterii w widoku mikro
 const float BACTERIA_MODEL_SCALE_FACTOR = 0.5f; 
+// Superosobnik rysowany jest z polem rosnącym z krotnością, ale nie większym niż ten mnożnik skali
+const float MAX_AGGREGATE_SCALE = 3.0f;
+
+// Wypiekane wzory bakterii: liczba faz animacji (okres 2*PI), rozdzielczość warstwy
+// i zasięg lokalnych współrzędnych obrysu. Wartości trafiają do shaderów jako definicje.
+const int PATTERN_PHASES = 32;
+const int PATTERN_LAYER_SIZE = 128;
+const float PATTERN_EXTENT = 1.6f;
+// Połowa boku kwadratu impostora w lokalnych współrzędnych obrysu - największy obrys
+// sięga 1.6, reszta to margines na antyaliasing krawędzi
+const float IMPOSTOR_EXTENT = 1.7f;
+// Waga nowego pomiaru w średniej kroczącej czasu GPU
+const float GPU_TIMER_SMOOTHING = 0.1f;
 
 Renderer::Renderer(int width, int height)
     : window(nullptr), windowWidth(width), windowHeight(height), successfullyInitialized(false),
+      currentViewProjectionMatrix(1.0f),
+      oitEnabled(false), oitFramebuffer(0), oitAccumulationTexture(0), oitRevealageTexture(0),
+      oitCompositeProgramID(0), fullscreenTriangleVAO(0),
+      bacteriaPatternTexture(0), bakedPatternsEnabled(false),
+      colonyTimerQueries{}, colonyTimerPending{}, colonyTimerBaked{}, colonyTimerIndex(0),
+      colonyGpuMilliseconds{0.0f, 0.0f},
+      bacteriaAtlasVAO(0), bacteriaAtlasVBO(0), bacteriaAtlasEBO(0),
+      bacteriaImpostorVAO(0), bacteriaImpostorVBO(0), impostorsEnabled(false),
+      colonyOutlineVAO(0), colonyOutlineGeneration(0), colonyOutlinesEnabled(false), colonyOutlinesDrawn(false),
+      agarTextureID(0),
+      sceneFramebuffer(0), sceneColorTexture(0), sceneDepthRenderbuffer(0),
+      sceneTargetWidth(0), sceneTargetHeight(0), presentSceneFrames(false),
       lightPosWorld(0.0f, 0.0f, 50.0f), 
       lightColor(1.5f, 1.5f, 1.5f),         
       ambientColor(0.5f, 0.5f, 0.5f), 
-      lightRange(200.0f),  
-      agarTextureID(0){
+      lightRange(200.0f) {
 
     successfullyInitialized = initOpenGL(width, height);
     if (successfullyInitialized) {
+        // Bufor bloku FrameUniforms - wspólny dla wszystkich shaderów
+        frameUniformBuffer.create(GL_UNIFORM_BUFFER, sizeof(FrameUniforms));
+        glGenVertexArrays(1, &fullscreenTriangleVAO);
+
         // Inicjalizacja shaderów po pomyślnym utworzeniu kontekstu OpenGL
         initBacteriaShader();
         setupBacteriaGeometry();
+        bakeBacteriaPatterns();
 
         initAntibioticShader();
         setupAntibioticGeometry();
+        setupColonyOutlineGeometry();
+        setColonyOutlinesEnabled(true);
 
         initPetriDishShader();
         setupPetriDishGeometry(); 
+
+        initOitTargets();
+
+        // Zapytania czasu GPU (GL 3.3 lub ARB_timer_query) - bez nich profiler pomija pomiar kolonii
+        if (GLEW_VERSION_3_3 || GLEW_ARB_timer_query) {
+            glGenQueries(COLONY_TIMER_QUERY_COUNT, colonyTimerQueries);
+        }
         
-        agarTextureID = TextureLoader::loadTexture("assets/textures/Leather024_1K-JPG_Color.jpg");
+        // Tekstura ładuje się w tle - do czasu jej wysłania agar używa placeholdera 1x1
+        agarTextureID = textureLoader.loadTexture("assets/textures/Leather024_1K-JPG_Color.jpg");
         if (agarTextureID == 0) std::cerr << "Błąd załadowania tekstury szalki." << std::endl;
     }
 }
 
 Renderer::~Renderer() {
     // Czyszczenie zasobów VAO i VBO dla bakterii
-    for (auto const& [type, vaoID] : bacteriaVAOs) {
-        if (vaoID != 0) glDeleteVertexArrays(1, &vaoID);
-    }
-    bacteriaVAOs.clear();
+    if (bacteriaAtlasVAO != 0) glDeleteVertexArrays(1, &bacteriaAtlasVAO);
+    untrackGpuObject(GpuObjectKind::Buffer, bacteriaAtlasVBO);
+    if (bacteriaAtlasVBO != 0) glDeleteBuffers(1, &bacteriaAtlasVBO);
+    untrackGpuObject(GpuObjectKind::Buffer, bacteriaAtlasEBO);
+    if (bacteriaAtlasEBO != 0) glDeleteBuffers(1, &bacteriaAtlasEBO);
 
-    for (auto const& [type, vboID] : bacteriaVBOs_vertexLocalPosition) { 
-        if (vboID != 0) glDeleteBuffers(1, &vboID);
-    }
-    bacteriaVBOs_vertexLocalPosition.clear(); 
-    bacteriaVertexCounts.clear(); 
+    if (bacteriaImpostorVAO != 0) glDeleteVertexArrays(1, &bacteriaImpostorVAO);
+    untrackGpuObject(GpuObjectKind::Buffer, bacteriaImpostorVBO);
+    if (bacteriaImpostorVBO != 0) glDeleteBuffers(1, &bacteriaImpostorVBO);
 
     // Czyszczenie zasobów
     if (antibioticCircleVAO != 0) glDeleteVertexArrays(1, &antibioticCircleVAO);
+    untrackGpuObject(GpuObjectKind::Buffer, antibioticCircleVBO_vertexPosition);
     if (antibioticCircleVBO_vertexPosition != 0) glDeleteBuffers(1, &antibioticCircleVBO_vertexPosition);
+    if (colonyOutlineVAO != 0) glDeleteVertexArrays(1, &colonyOutlineVAO);
+    colonyOutlineBuffer.destroy();
 
+    untrackGpuObject(GpuObjectKind::Buffer, dishBaseVBO);
+    untrackGpuObject(GpuObjectKind::Buffer, dishLidVBO);
+    untrackGpuObject(GpuObjectKind::Buffer, agarVBO);
     if (dishBaseVAO != 0) glDeleteVertexArrays(1, &dishBaseVAO);
     if (dishBaseVBO != 0) glDeleteBuffers(1, &dishBaseVBO);
     if (dishLidVAO != 0) glDeleteVertexArrays(1, &dishLidVAO);
@@ -63,9 +117,19 @@ Renderer::~Renderer() {
     }
 
     if (agarTextureID != 0) {
+        untrackGpuObject(GpuObjectKind::Texture, agarTextureID);
         glDeleteTextures(1, &agarTextureID);
     }
 
+    frameUniformBuffer.destroy();
+
+    destroyOitTargets();
+    untrackGpuObject(GpuObjectKind::Texture, bacteriaPatternTexture);
+    if (fullscreenTriangleVAO != 0) glDeleteVertexArrays(1, &fullscreenTriangleVAO);
+    if (bacteriaPatternTexture != 0) glDeleteTextures(1, &bacteriaPatternTexture);
+    if (colonyTimerQueries[0] != 0) glDeleteQueries(COLONY_TIMER_QUERY_COUNT, colonyTimerQueries);
+    destroySceneTargets();
+
     if (window) {
         glfwDestroyWindow(window);
     }
@@ -93,6 +157,10 @@ bool Renderer::initOpenGL(int width, int height) {
 
     // Inicjalizacja GLEW
     GLenum err = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // Kontekst EGL (renderowanie bez okna) nie ma wyświetlacza GLX, funkcje GL są jednak załadowane
+    if (err == GLEW_ERROR_NO_GLX_DISPLAY) err = GLEW_OK;
+#endif
     if (err != GLEW_OK) {
         std::cerr << "Błąd: Nie udało się zainicjalizować GLEW w Rendererze: " << glewGetErrorString(err) << std::endl;
         glfwDestroyWindow(window);
@@ -127,135 +195,468 @@ GLFWwindow* Renderer::getWindow() const {
 }
 
 void Renderer::beginFrame() {
+    // Podmiana placeholderów na tekstury zdekodowane w tle
+    textureLoader.processPendingUploads();
+
+    // Framebuffer sceny podąża za rozmiarem okna; przechwytywanie ma stały rozmiar wyjścia
+    if (sceneFramebuffer != 0 && !frameCapture.isActive()) {
+        int framebufferWidth = 0, framebufferHeight = 0;
+        glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+        if (framebufferWidth > 0 && framebufferHeight > 0 &&
+            (framebufferWidth != sceneTargetWidth || framebufferHeight != sceneTargetHeight)) {
+            windowWidth = framebufferWidth;
+            windowHeight = framebufferHeight;
+            ensureSceneTargets(windowWidth, windowHeight);
+            glViewport(0, 0, windowWidth, windowHeight);
+        }
+    }
+
     // Czyszczenie bufora koloru i głębi na początku każdej klatki
+    glBindFramebuffer(GL_FRAMEBUFFER, sceneFramebuffer);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
+void Renderer::updateFrameUniforms(const glm::mat4& viewProjectionMatrix, const glm::mat4& viewMatrix) {
+    FrameUniforms frameUniforms;
+    frameUniforms.viewProjectionMatrix = viewProjectionMatrix;
+    frameUniforms.lightPositionWorld = lightPosWorld;
+    frameUniforms.lightRange = lightRange;
+    frameUniforms.lightColor = lightColor;
+    frameUniforms.time = static_cast<float>(glfwGetTime());
+    frameUniforms.ambientColor = ambientColor;
+    frameUniforms.padding0 = 0.0f;
+    frameUniforms.cameraPositionWorld = glm::vec3(glm::inverse(viewMatrix)[3]);
+    frameUniforms.padding1 = 0.0f;
+
+    currentViewProjectionMatrix = viewProjectionMatrix;
+    frameUniformBuffer.upload(&frameUniforms, sizeof(FrameUniforms));
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORMS_BINDING, frameUniformBuffer.getID());
+}
+
+// Framebuffer sceny (RGBA8 + głębia) - wspólny dla przechwytywania i OIT, który dołącza jego głębię.
+// Przy zmianie rozmiaru tworzony od nowa razem z buforami OIT.
+bool Renderer::ensureSceneTargets(int width, int height) {
+    if (sceneFramebuffer != 0 && width == sceneTargetWidth && height == sceneTargetHeight) return true;
+    destroySceneTargets();
+
+    glGenTextures(1, &sceneColorTexture);
+    glBindTexture(GL_TEXTURE_2D, sceneColorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    trackGpuObject(GpuObjectKind::Texture, sceneColorTexture, static_cast<size_t>(width) * height * 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenRenderbuffers(1, &sceneDepthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, sceneDepthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    // 24-bitowa głębia zajmuje w praktyce 4 bajty na piksel
+    trackGpuObject(GpuObjectKind::Renderbuffer, sceneDepthRenderbuffer, static_cast<size_t>(width) * height * 4);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &sceneFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, sceneFramebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, sceneColorTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, sceneDepthRenderbuffer);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Renderer: Framebuffer sceny niekompletny (0x" << std::hex << status << std::dec << ")." << std::endl;
+        destroySceneTargets();
+        return false;
+    }
+    sceneTargetWidth = width;
+    sceneTargetHeight = height;
+
+    // Bez widocznego okna (tryb bez ekranu) nie ma dokąd kopiować sceny
+    presentSceneFrames = window && glfwGetWindowAttrib(window, GLFW_VISIBLE);
+
+    // Bufory OIT muszą mieć rozmiar sceny i wskazywać na jej aktualną głębię
+    if (oitEnabled && !createOitTargets()) {
+        oitEnabled = false;
+        std::cout << "Renderer: OIT wyłączone po zmianie rozmiaru sceny, przezroczystość rysowana zwykłym blendingiem." << std::endl;
+    }
+    return true;
+}
+
+void Renderer::destroySceneTargets() {
+    untrackGpuObject(GpuObjectKind::Texture, sceneColorTexture);
+    untrackGpuObject(GpuObjectKind::Renderbuffer, sceneDepthRenderbuffer);
+    if (sceneFramebuffer != 0) glDeleteFramebuffers(1, &sceneFramebuffer);
+    if (sceneColorTexture != 0) glDeleteTextures(1, &sceneColorTexture);
+    if (sceneDepthRenderbuffer != 0) glDeleteRenderbuffers(1, &sceneDepthRenderbuffer);
+    sceneFramebuffer = 0;
+    sceneColorTexture = 0;
+    sceneDepthRenderbuffer = 0;
+    sceneTargetWidth = 0;
+    sceneTargetHeight = 0;
+}
+
+bool Renderer::enableCapture(const std::string& outputPrefix, size_t encoderThreads) {
+    if (!ensureSceneTargets(windowWidth, windowHeight)) {
+        std::cerr << "Renderer: Nie udało się utworzyć framebuffera przechwytywania." << std::endl;
+        return false;
+    }
+
+    if (!frameCapture.init(windowWidth, windowHeight, outputPrefix, encoderThreads)) {
+        std::cerr << "Renderer: Nie udało się uruchomić przechwytywania klatek." << std::endl;
+        return false;
+    }
+
+    // Przechwytywanie nie czeka na odświeżanie ekranu
+    glfwSwapInterval(0);
+    std::cout << "Renderer: Przechwytywanie klatek " << windowWidth << "x" << windowHeight << " do " << outputPrefix << "_*.png" << std::endl;
+    return true;
+}
+
+void Renderer::captureFrame() {
+    if (sceneFramebuffer == 0) return;
+    TRACE_SCOPE("render", "Renderer::captureFrame");
+
+    const bool capturing = frameCapture.isActive();
+    if (capturing) frameCapture.captureFrame(sceneFramebuffer);
+
+    if (presentSceneFrames) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, sceneFramebuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, windowWidth, windowHeight, 0, 0, windowWidth, windowHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+    // GUI rysowane jest już poza sceną
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!capturing) return;
+
+    FrameCaptureStats captureStats = frameCapture.getStats();
+    frameStats.captureActive = true;
+    frameStats.captureMs = captureStats.averageCaptureMs;
+    frameStats.captureMaxMs = captureStats.maxCaptureMs;
+    frameStats.capturedFrames = captureStats.capturedFrames;
+    frameStats.writtenFrames = captureStats.writtenFrames;
+    frameStats.captureFenceStalls = captureStats.fenceStalls;
+    frameStats.captureEncoderStalls = captureStats.encoderStalls;
+}
+
+void Renderer::finishCapture() {
+    frameCapture.finish();
+}
+
 void Renderer::endFrame() {
+    TRACE_SCOPE("render", "Renderer::endFrame");
     if (window) 
         glfwSwapBuffers(window); // Zamiana buforów przedni z tylnym
 }
 
-// Renderowanie pojedynczej bakterii
-void Renderer::renderBacteria(IBacteria& bacteria, float zoomLevel, const glm::mat4& viewProjectionMatrix) {
+// Dodanie pojedynczej bakterii do kolejki renderowania
+void Renderer::renderBacteria(IBacteria& bacteria, float zoomLevel) {
     if (!bacteria.isAlive()) return;
 
     glm::vec4 posVec4 = bacteria.getPos();
-    BacteriaType type = bacteria.getBacteriaType();
-    glm::vec3 bacteriaColor;
-
-    switch (type) {
-        case BacteriaType::Cocci: bacteriaColor = glm::vec3(0.9f, 0.4f, 0.4f); break;
-        case BacteriaType::Diplococcus: bacteriaColor = glm::vec3(0.4f, 0.9f, 0.4f); break;
-        case BacteriaType::Staphylococci: bacteriaColor = glm::vec3(0.4f, 0.4f, 0.9f); break;
-        case BacteriaType::Bacillus: bacteriaColor = glm::vec3(0.8f, 0.6f, 0.2f); break;
-        default: bacteriaColor = glm::vec3(0.7f, 0.7f, 0.7f); break;
-    }
-
-        // Widok mikro: renderowanie pełnego modelu bakterii
-        if (bacteriaShaderProgramID == 0 || bacteriaVAOs.find(type) == bacteriaVAOs.end()) return;
-
-        shaderManager.useShaderProgram(bacteriaShaderProgramID);
-
-        // Ustawianie uniformów dla shadera bakterii
-        glUniformMatrix4fv(bacteria_u_viewProjectionMatrix_loc, 1, GL_FALSE, glm::value_ptr(viewProjectionMatrix));
-        glUniform3f(bacteria_u_instanceWorldPosition_loc, posVec4.x, posVec4.y, posVec4.z); 
-        glUniform1f(bacteria_u_instanceScale_loc, BACTERIA_MODEL_SCALE_FACTOR);
-        glUniform1i(bacteria_u_bacteriaType_loc, static_cast<int>(type)); 
-        glUniform1f(bacteria_u_bacteriaHealth_loc, bacteria.getHealth()); 
-        glUniform1f(bacteria_u_time_loc, static_cast<float>(glfwGetTime()));
-
-        // Uniformy oświetlenia
-        glUniform3fv(bacteria_u_lightPositionWorld_loc, 1, glm::value_ptr(lightPosWorld));
-        glUniform3fv(bacteria_u_lightColor_loc, 1, glm::value_ptr(lightColor));
-        glUniform3fv(bacteria_u_ambientColor_loc, 1, glm::value_ptr(ambientColor));
-        
-        glm::vec3 cameraPosWorld(viewProjectionMatrix[3][0], viewProjectionMatrix[3][1], 100.0f); 
-        glUniform3fv(bacteria_u_cameraPositionWorld_loc, 1, glm::value_ptr(cameraPosWorld));
-        glUniform1f(bacteria_u_lightRange_loc, lightRange);
-
-        // Renderowanie geometrii bakterii
-        auto vao_it = bacteriaVAOs.find(type);
-        if (vao_it != bacteriaVAOs.end() && bacteriaVertexCounts.count(type) && bacteriaVertexCounts.at(type) > 0) {
-            glBindVertexArray(vao_it->second);
-            glDrawArrays(GL_TRIANGLE_FAN, 0, bacteriaVertexCounts.at(type));
-            glBindVertexArray(0);
-        }
+    SpeciesId type = bacteria.getSpecies();
+
+    // Widok mikro: renderowanie pełnego modelu bakterii
+    const BacteriaProgram& program = getActiveBacteriaProgram();
+    if (program.programID == 0) return;
+    if (type >= speciesIndexCounts.size()) return;
+    GLuint vao = 0;
+    GLenum primitive = GL_TRIANGLE_STRIP;
+    GLint first = 0;
+    GLsizei count = 4;
+    GLint baseVertex = 0;
+    bool indexed = false;
+    if (impostorsEnabled) {
+        vao = bacteriaImpostorVAO;
+    } else {
+        // Wszystkie gatunki w jednym atlasie - różnią się tylko przesunięciami
+        if (bacteriaAtlasVAO == 0 || speciesIndexCounts[type] <= 0) return;
+        vao = bacteriaAtlasVAO;
+        primitive = GL_TRIANGLES;
+        first = speciesFirstIndices[type];
+        count = speciesIndexCounts[type];
+        baseVertex = speciesBaseVertices[type];
+        indexed = true;
+    }
 
-    shaderManager.useShaderProgram(0); 
+    // W trybie OIT kolejność rysowania nie ma znaczenia - sortujemy wyłącznie po stanie.
+    // Bez OIT bakterie rysujemy bez blendingu, więc od przodu do tyłu (wczesny test głębi).
+    uint32_t depthKey = 0;
+    if (!oitEnabled) {
+        glm::vec4 clipPosition = currentViewProjectionMatrix * glm::vec4(posVec4.x, posVec4.y, posVec4.z, 1.0f);
+        float depth01 = (clipPosition.w != 0.0f) ? (clipPosition.z / clipPosition.w) * 0.5f + 0.5f : 0.0f;
+        depthKey = RenderQueue::quantizeDepth(depth01, false);
+    }
+
+    DrawCommand command;
+    command.sortKey = RenderQueue::makeSortKey(RenderPass::Colony, program.programID, vao, 0, depthKey);
+    command.program = program.programID;
+    command.vao = vao;
+    command.texture = 0;
+    command.primitive = primitive;
+    command.first = first;
+    command.count = count;
+    command.baseVertex = baseVertex;
+    command.indexed = indexed;
+    command.payloadIndex = static_cast<uint32_t>(bacteriaDrawParameters.size());
+
+    float aggregateScale = std::min(std::sqrt(static_cast<float>(bacteria.getMultiplicity())), MAX_AGGREGATE_SCALE);
+    bacteriaDrawParameters.push_back({glm::vec4(posVec4.x, posVec4.y, posVec4.z, bacteria.getHealth()), type,
+                                      BACTERIA_MODEL_SCALE_FACTOR * aggregateScale});
+    renderQueue.submit(command);
 }
 
-// Renderowanie całej kolonii bakterii
-void Renderer::renderColony(const std::vector<std::unique_ptr<IBacteria>>& allBacteria, float zoomLevel, const glm::mat4& viewProjectionMatrix) {
-    for (auto it = allBacteria.rbegin(); it != allBacteria.rend(); ++it) {
-        const std::unique_ptr<IBacteria>& bacteriaPtr = *it;
+// Dodanie całej kolonii bakterii do kolejki renderowania
+void Renderer::renderColony(const CellList& allBacteria, float zoomLevel) {
+    TRACE_SCOPE("render", "Renderer::renderColony");
+    renderQueue.reserve(renderQueue.size() + allBacteria.size());
+    bacteriaDrawParameters.reserve(bacteriaDrawParameters.size() + allBacteria.size());
+    const size_t firstCommand = renderQueue.size();
+    const size_t firstParameter = bacteriaDrawParameters.size();
+    for (const std::unique_ptr<IBacteria>& bacteriaPtr : allBacteria) {
         if (bacteriaPtr) { 
-            renderBacteria(*bacteriaPtr, zoomLevel, viewProjectionMatrix);
+            renderBacteria(*bacteriaPtr, zoomLevel);
         }
     }
+
+    // Kopia listy (indeksy parametrów względem początku kolonii) na potrzeby resubmitColony
+    const DrawCommandList& commands = renderQueue.getCommands();
+    cachedColonyCommands.assign(commands.begin() + firstCommand, commands.end());
+    for (DrawCommand& command : cachedColonyCommands) {
+        command.payloadIndex -= static_cast<uint32_t>(firstParameter);
+    }
+    cachedColonyParameters.assign(bacteriaDrawParameters.begin() + firstParameter, bacteriaDrawParameters.end());
+}
+
+void Renderer::resubmitColony() {
+    const uint32_t firstParameter = static_cast<uint32_t>(bacteriaDrawParameters.size());
+    renderQueue.reserve(renderQueue.size() + cachedColonyCommands.size());
+    bacteriaDrawParameters.insert(bacteriaDrawParameters.end(), cachedColonyParameters.begin(), cachedColonyParameters.end());
+
+    // Program z listy mógł zostać wyłączony (np. przełączenie OIT) - wtedy kolonia czeka na pełne odświeżenie
+    const GLuint activeProgram = getActiveBacteriaProgram().programID;
+    for (DrawCommand command : cachedColonyCommands) {
+        if (command.program != activeProgram) continue;
+        command.payloadIndex += firstParameter;
+        renderQueue.submit(command);
+    }
 }
 
-// Inicjalizacja shadera bakterii
+// Inicjalizacja shadera bakterii - wszystkie kombinacje wariantów
 void Renderer::initBacteriaShader() {
-    bacteriaShaderProgramID = shaderManager.loadShaderProgram("bacteriaShader", "shaders/bacteria.vert", "shaders/bacteria.frag");
+    for (int variant = 0; variant < BACTERIA_VARIANT_COUNT; ++variant) {
+        std::string name = "bacteriaShader";
+        std::vector<std::string> defines;
+        if (variant & BACTERIA_VARIANT_BAKED_PATTERN) {
+            name += "Baked";
+            defines.push_back("PATTERN_TEXTURE");
+            defines.push_back("PATTERN_PHASES " + std::to_string(PATTERN_PHASES));
+            defines.push_back("PATTERN_EXTENT " + std::to_string(PATTERN_EXTENT));
+        }
+        if (variant & BACTERIA_VARIANT_IMPOSTOR) {
+            name += "Impostor";
+            defines.push_back("IMPOSTOR");
+        }
+        if (variant & BACTERIA_VARIANT_OIT) {
+            name += "OIT";
+            defines.push_back("OIT_PASS");
+        }
+        bacteriaPrograms[variant] = loadBacteriaProgram(name, defines);
+    }
+}
 
-    if (bacteriaShaderProgramID == 0) {
-        std::cerr << "Renderer: Błąd ładowania programu shadera bakterii! Renderowanie może nie działać poprawnie." << std::endl;
-        return;
+BacteriaProgram Renderer::loadBacteriaProgram(const std::string& name, const std::vector<std::string>& defines) {
+    BacteriaProgram program;
+    program.programID = shaderManager.loadShaderProgram(name, "shaders/bacteria.vert", "shaders/bacteria.frag", defines);
+
+    if (program.programID == 0) {
+        std::cerr << "Renderer: Błąd ładowania programu shadera bakterii " << name << "! Renderowanie może nie działać poprawnie." << std::endl;
+        return program;
     }
 
+    shaderManager.bindUniformBlock(program.programID, "FrameUniforms", FRAME_UNIFORMS_BINDING);
+
     // Pobieranie lokalizacji uniformów z shadera bakterii
-    bacteria_u_viewProjectionMatrix_loc = shaderManager.getUniformLocation(bacteriaShaderProgramID, "u_viewProjectionMatrix");
-    bacteria_u_instanceWorldPosition_loc = shaderManager.getUniformLocation(bacteriaShaderProgramID, "u_instanceWorldPosition");
-    bacteria_u_instanceScale_loc = shaderManager.getUniformLocation(bacteriaShaderProgramID, "u_instanceScale");
-    bacteria_u_bacteriaType_loc = shaderManager.getUniformLocation(bacteriaShaderProgramID, "u_bacteriaType");
-    bacteria_u_bacteriaHealth_loc = shaderManager.getUniformLocation(bacteriaShaderProgramID, "u_bacteriaHealth");
-    bacteria_u_time_loc = shaderManager.getUniformLocation(bacteriaShaderProgramID, "u_time");
+    program.u_instanceWorldPosition_loc = shaderManager.getUniformLocation(program.programID, "u_instanceWorldPosition");
+    program.u_instanceScale_loc = shaderManager.getUniformLocation(program.programID, "u_instanceScale");
+    program.u_bacteriaPattern_loc = shaderManager.getUniformLocation(program.programID, "u_bacteriaPattern");
+    program.u_bacteriaColor_loc = shaderManager.getUniformLocation(program.programID, "u_bacteriaColor");
+    program.u_bacteriaHealth_loc = shaderManager.getUniformLocation(program.programID, "u_bacteriaHealth");
+
+    // Tablica wzorów zawsze leży na stałej jednostce - sampler ustawiamy raz
+    GLint patternSamplerLoc = shaderManager.getUniformLocation(program.programID, "u_patternTexture");
+    if (patternSamplerLoc != -1) {
+        shaderManager.useShaderProgram(program.programID);
+        glUniform1i(patternSamplerLoc, PATTERN_TEXTURE_UNIT);
+        shaderManager.useShaderProgram(0);
+    }
+    return program;
+}
 
-    bacteria_u_lightPositionWorld_loc = shaderManager.getUniformLocation(bacteriaShaderProgramID, "u_lightPositionWorld");
-    bacteria_u_lightColor_loc = shaderManager.getUniformLocation(bacteriaShaderProgramID, "u_lightColor");
-    bacteria_u_ambientColor_loc = shaderManager.getUniformLocation(bacteriaShaderProgramID, "u_ambientColor");
-    bacteria_u_cameraPositionWorld_loc = shaderManager.getUniformLocation(bacteriaShaderProgramID, "u_cameraPositionWorld");
-    bacteria_u_lightRange_loc = shaderManager.getUniformLocation(bacteriaShaderProgramID, "u_lightRange");
+const BacteriaProgram& Renderer::getBacteriaProgram(GLuint programID) const {
+    for (const BacteriaProgram& program : bacteriaPrograms) {
+        if (program.programID == programID) return program;
+    }
+    return bacteriaPrograms[0];
+}
 
+const BacteriaProgram& Renderer::getActiveBacteriaProgram() const {
+    int variant = 0;
+    if (oitEnabled) variant |= BACTERIA_VARIANT_OIT;
+    if (bakedPatternsEnabled) variant |= BACTERIA_VARIANT_BAKED_PATTERN;
+    if (impostorsEnabled) variant |= BACTERIA_VARIANT_IMPOSTOR;
+    return bacteriaPrograms[variant];
+}
+
+// Wypieczenie animowanych wzorów wszystkich typów do tablicy tekstur (R16F, typy x fazy).
+// Shader wypiekający to bacteria.frag z BAKE_PATTERN, więc wzór ma jedno źródło.
+void Renderer::bakeBacteriaPatterns() {
+    const std::vector<std::string> bakeDefines = {
+        "BAKE_PATTERN",
+        "PATTERN_EXTENT " + std::to_string(PATTERN_EXTENT)
+    };
+    GLuint bakeProgramID = shaderManager.loadShaderProgram("bacteriaPatternBake", "shaders/pattern_bake.vert", "shaders/bacteria.frag", bakeDefines);
+    bool variantsLoaded = true;
+    for (int variant = 0; variant < BACTERIA_VARIANT_COUNT; ++variant) {
+        if ((variant & BACTERIA_VARIANT_BAKED_PATTERN) && bacteriaPrograms[variant].programID == 0) variantsLoaded = false;
+    }
+    if (bakeProgramID == 0 || !variantsLoaded) {
+        std::cerr << "Renderer: Nie można wypiec wzorów bakterii - zostaje wzór proceduralny." << std::endl;
+        return;
+    }
+
+    const int layerCount = SPECIES_PATTERN_COUNT * PATTERN_PHASES;
+    glGenTextures(1, &bacteriaPatternTexture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, bacteriaPatternTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R16F, PATTERN_LAYER_SIZE, PATTERN_LAYER_SIZE, layerCount, 0, GL_RED, GL_HALF_FLOAT, nullptr);
+    // R16F z pełnym łańcuchem mipmap (+1/3)
+    trackGpuObject(GpuObjectKind::Texture, bacteriaPatternTexture,
+                   static_cast<size_t>(PATTERN_LAYER_SIZE) * PATTERN_LAYER_SIZE * layerCount * 2 * 4 / 3);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    GLuint bakeFramebuffer = 0;
+    glGenFramebuffers(1, &bakeFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, bakeFramebuffer);
+    glViewport(0, 0, PATTERN_LAYER_SIZE, PATTERN_LAYER_SIZE);
+    glDisable(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+
+    shaderManager.useShaderProgram(bakeProgramID);
+    GLint bakeTypeLoc = shaderManager.getUniformLocation(bakeProgramID, "u_bakeType");
+    GLint bakeTimeLoc = shaderManager.getUniformLocation(bakeProgramID, "u_bakeTime");
+    glBindVertexArray(fullscreenTriangleVAO);
+
+    bool complete = true;
+    for (int type = 0; type < SPECIES_PATTERN_COUNT && complete; ++type) {
+        for (int phase = 0; phase < PATTERN_PHASES; ++phase) {
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, bacteriaPatternTexture, 0, type * PATTERN_PHASES + phase);
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+                complete = false;
+                break;
+            }
+            glUniform1i(bakeTypeLoc, type);
+            glUniform1f(bakeTimeLoc, 2.0f * static_cast<float>(M_PI) * static_cast<float>(phase) / static_cast<float>(PATTERN_PHASES));
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+        }
+    }
+
+    glBindVertexArray(0);
+    shaderManager.useShaderProgram(0);
+    glBindFramebuffer(GL_FRAMEBUFFER, sceneFramebuffer);
+    glDeleteFramebuffers(1, &bakeFramebuffer);
+    glViewport(0, 0, windowWidth, windowHeight);
+    setupInitialProcedures();
+
+    if (!complete) {
+        std::cerr << "Renderer: Framebuffer wypiekania wzorów niekompletny - zostaje wzór proceduralny." << std::endl;
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        untrackGpuObject(GpuObjectKind::Texture, bacteriaPatternTexture);
+        glDeleteTextures(1, &bacteriaPatternTexture);
+        bacteriaPatternTexture = 0;
+        return;
+    }
+
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    std::cout << "Renderer: Wypieczono wzory bakterii (" << layerCount << " warstw " << PATTERN_LAYER_SIZE << "x" << PATTERN_LAYER_SIZE << ")." << std::endl;
+}
+
+void Renderer::setBakedPatternsEnabled(bool enabled) {
+    bakedPatternsEnabled = enabled && bacteriaPatternTexture != 0;
+}
+
+// Odczyt najstarszego zapytania czasu GPU, o ile wynik jest już gotowy (bez blokowania potoku)
+void Renderer::collectColonyTimer() {
+    GLuint query = colonyTimerQueries[colonyTimerIndex];
+    if (query == 0 || !colonyTimerPending[colonyTimerIndex]) return;
+
+    GLint available = 0;
+    glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return;
+
+    GLuint64 elapsedNanoseconds = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsedNanoseconds);
+    colonyTimerPending[colonyTimerIndex] = false;
+
+    float milliseconds = static_cast<float>(elapsedNanoseconds) / 1.0e6f;
+    float& average = colonyGpuMilliseconds[colonyTimerBaked[colonyTimerIndex] ? 1 : 0];
+    average = (average == 0.0f) ? milliseconds : average + (milliseconds - average) * GPU_TIMER_SMOOTHING;
 }
 
 // Ustawienie geometrii bakterii
 void Renderer::setupBacteriaGeometry() {
-    bacteriaShaderProgramID = shaderManager.getShaderProgram("bacteriaShader"); 
+    GLuint bacteriaShaderProgramID = bacteriaPrograms[0].programID; 
     if (bacteriaShaderProgramID == 0) {
         std::cerr << "Renderer: Nie można ustawić geometrii bakterii, program shadera niezaładowany." << std::endl;
         return;
     }
 
-    for (int i = 0; i <= static_cast<int>(BacteriaType::Bacillus); ++i) { 
-        BacteriaType type = static_cast<BacteriaType>(i);
-        BacteriaStats stats = getStatsForType(type); 
-
-        if (stats.circuit.empty()) {
-            std::cout << "Renderer: Obwód dla typu bakterii " << i << " jest pusty." << std::endl;
+    // Atlas geometrii: obrysy wszystkich gatunków w jednym VBO, trójkąty w jednym EBO.
+    // Indeksy są lokalne dla obrysu (wachlarz od pierwszego wierzchołka), a przesunięcia gatunku
+    // trafiają do polecenia rysowania - wszystkie gatunki rysowane są z jednego VAO.
+    const SpeciesRegistry& registry = getSpeciesRegistry();
+    const size_t speciesCount = registry.size();
+    speciesFirstIndices.assign(speciesCount, 0);
+    speciesIndexCounts.assign(speciesCount, 0);
+    speciesBaseVertices.assign(speciesCount, 0);
+    speciesColors.assign(speciesCount, glm::vec3(0.7f));
+    speciesPatterns.assign(speciesCount, 0);
+
+    std::vector<glm::vec2> vertices;
+    std::vector<GLuint> indices;
+    for (size_t species = 0; species < speciesCount; ++species) {
+        const SpeciesDefinition& definition = registry.get(static_cast<SpeciesId>(species));
+        speciesColors[species] = definition.color;
+        speciesPatterns[species] = static_cast<int>(definition.pattern);
+
+        const BacteriaCircuit& circuit = definition.stats.circuit;
+        if (circuit.size() < 3) {
+            std::cout << "Renderer: Obwód gatunku " << definition.name << " ma mniej niż 3 wierzchołki." << std::endl;
             continue;
         }
-
-        std::vector<glm::vec2> vertices;
-        for (const auto& p : stats.circuit) {
+        speciesBaseVertices[species] = static_cast<GLint>(vertices.size());
+        speciesFirstIndices[species] = static_cast<GLint>(indices.size());
+        for (const auto& p : circuit) {
             vertices.push_back(glm::vec2(p.first, p.second));
         }
-        
-        if (vertices.empty()) { 
-             std::cout << "Renderer: Dane wierzchołków dla typu bakterii " << i << " są puste po przetworzeniu obwodu." << std::endl;
-            continue;
+        for (GLuint i = 1; i + 1 < circuit.size(); ++i) {
+            indices.insert(indices.end(), {0u, i, i + 1});
         }
-        bacteriaVertexCounts[type] = static_cast<int>(vertices.size());
-
-        GLuint vao_id, vbo_pos_id;
-        glGenVertexArrays(1, &vao_id);
-        glGenBuffers(1, &vbo_pos_id);
+        speciesIndexCounts[species] = static_cast<GLsizei>(indices.size()) - speciesFirstIndices[species];
+    }
 
-        glBindVertexArray(vao_id);
+    if (!vertices.empty()) {
+        glGenVertexArrays(1, &bacteriaAtlasVAO);
+        glGenBuffers(1, &bacteriaAtlasVBO);
+        glGenBuffers(1, &bacteriaAtlasEBO);
+        glBindVertexArray(bacteriaAtlasVAO);
 
-        glBindBuffer(GL_ARRAY_BUFFER, vbo_pos_id);
+        glBindBuffer(GL_ARRAY_BUFFER, bacteriaAtlasVBO);
         glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec2), vertices.data(), GL_STATIC_DRAW);
+        trackGpuObject(GpuObjectKind::Buffer, bacteriaAtlasVBO, vertices.size() * sizeof(glm::vec2));
+        // Wiązanie EBO jest częścią stanu VAO
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bacteriaAtlasEBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+        trackGpuObject(GpuObjectKind::Buffer, bacteriaAtlasEBO, indices.size() * sizeof(GLuint));
 
         GLint posAttribLoc = glGetAttribLocation(bacteriaShaderProgramID, "a_vertexLocalPosition");
         if (posAttribLoc != -1) {
@@ -265,15 +666,41 @@ void Renderer::setupBacteriaGeometry() {
              std::cerr << "Renderer: Atrybut a_vertexLocalPosition nie znaleziony w bacteriaShader podczas ustawiania geometrii." << std::endl;
         }
 
-        bacteriaVAOs[type] = vao_id;
-        bacteriaVBOs_vertexLocalPosition[type] = vbo_pos_id; 
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+    // Wspólny kwadrat impostorów rysowany jako GL_TRIANGLE_STRIP
+    const glm::vec2 impostorCorners[4] = {
+        {-IMPOSTOR_EXTENT, -IMPOSTOR_EXTENT}, {IMPOSTOR_EXTENT, -IMPOSTOR_EXTENT},
+        {-IMPOSTOR_EXTENT, IMPOSTOR_EXTENT}, {IMPOSTOR_EXTENT, IMPOSTOR_EXTENT}
+    };
+    glGenVertexArrays(1, &bacteriaImpostorVAO);
+    glGenBuffers(1, &bacteriaImpostorVBO);
+    glBindVertexArray(bacteriaImpostorVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, bacteriaImpostorVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(impostorCorners), impostorCorners, GL_STATIC_DRAW);
+    trackGpuObject(GpuObjectKind::Buffer, bacteriaImpostorVBO, sizeof(impostorCorners));
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0); // a_vertexLocalPosition
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0); 
-        glBindVertexArray(0);            
+    // Impostory są domyślne, o ile skompilowały się wszystkie ich warianty
+    bool impostorVariantsLoaded = true;
+    for (int variant = 0; variant < BACTERIA_VARIANT_COUNT; ++variant) {
+        if ((variant & BACTERIA_VARIANT_IMPOSTOR) && bacteriaPrograms[variant].programID == 0) impostorVariantsLoaded = false;
     }
+    impostorsEnabled = impostorVariantsLoaded;
+
      std::cout << "Renderer: Ustawienie geometrii bakterii zakończone." << std::endl;
 }
 
+void Renderer::setImpostorsEnabled(bool enabled) {
+    impostorsEnabled = enabled && bacteriaImpostorVAO != 0 && bacteriaPrograms[BACTERIA_VARIANT_IMPOSTOR].programID != 0;
+}
+
 // Dodawanie efektu antybiotyku
 void Renderer::addAntibioticEffect(const glm::vec2& worldPos, float strength, float radius, float lifetime) {
     activeAntibiotics.push_back({worldPos, strength, radius, 0.0f, lifetime});
@@ -294,17 +721,10 @@ void Renderer::updateAntibioticEffects(float deltaTime) {
     );
 }
 
-// Renderowanie efektów antybiotyków
-void Renderer::renderAntibioticEffects(const glm::mat4& viewProjectionMatrix) {
+// Dodanie efektów antybiotyków do kolejki renderowania
+void Renderer::renderAntibioticEffects() {
     if (antibioticShaderProgramID == 0 || antibioticCircleVAO == 0) return;
 
-    shaderManager.useShaderProgram(antibioticShaderProgramID);
-    glUniformMatrix4fv(antibiotic_u_viewProjectionMatrix_loc, 1, GL_FALSE, glm::value_ptr(viewProjectionMatrix));
-
-    glEnable(GL_BLEND); // Włączenie blendingu dla efektu przezroczystości
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glBindVertexArray(antibioticCircleVAO);
-
     for (const auto& antibiotic : activeAntibiotics) {
         float effectProgress = antibiotic.timeApplied / antibiotic.maxLifetime;
         float currentRadius = antibiotic.radius * (1.0f - effectProgress); // Efekt kurczenia się
@@ -315,14 +735,11 @@ void Renderer::renderAntibioticEffects(const glm::mat4& viewProjectionMatrix) {
         glm::mat4 modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(antibiotic.worldPosition, 0.0f));
         modelMatrix = glm::scale(modelMatrix, glm::vec3(currentRadius, currentRadius, 1.0f));
 
-        glUniformMatrix4fv(antibiotic_u_modelMatrix_loc, 1, GL_FALSE, glm::value_ptr(modelMatrix));
-        glUniform4f(antibiotic_u_effectColor_loc, 0.5f, 0.7f, 1.0f, alpha); // Kolor z przezroczystością
-
-        glDrawArrays(GL_TRIANGLE_FAN, 0, antibioticCircleVertexCount);
+        // Efekty nakładają się z blendingiem - zachowujemy kolejność, starsze rysujemy najpierw
+        submitMeshDraw(RenderPass::AntibioticOverlay, antibioticShaderProgramID, antibioticCircleVAO, 0,
+                       GL_TRIANGLE_FAN, antibioticCircleVertexCount, 1.0f - effectProgress,
+                       {modelMatrix, glm::mat3(1.0f), glm::vec4(0.5f, 0.7f, 1.0f, alpha)}); // Kolor z przezroczystością
     }
-    glBindVertexArray(0);
-    glDisable(GL_BLEND); 
-    shaderManager.useShaderProgram(0);
 }
 
 // Inicjalizacja shadera antybiotyków
@@ -332,8 +749,8 @@ void Renderer::initAntibioticShader() {
         std::cerr << "Renderer: Błąd ładowania programu shadera antybiotyków!" << std::endl;
         return;
     }
+    shaderManager.bindUniformBlock(antibioticShaderProgramID, "FrameUniforms", FRAME_UNIFORMS_BINDING);
     antibiotic_u_modelMatrix_loc = shaderManager.getUniformLocation(antibioticShaderProgramID, "u_modelMatrix");
-    antibiotic_u_viewProjectionMatrix_loc = shaderManager.getUniformLocation(antibioticShaderProgramID, "u_viewProjectionMatrix");
     antibiotic_u_effectColor_loc = shaderManager.getUniformLocation(antibioticShaderProgramID, "u_effectColor");
 }
 
@@ -355,6 +772,7 @@ void Renderer::setupAntibioticGeometry() {
     glBindVertexArray(antibioticCircleVAO);
     glBindBuffer(GL_ARRAY_BUFFER, antibioticCircleVBO_vertexPosition); 
     glBufferData(GL_ARRAY_BUFFER, circleVertices.size() * sizeof(glm::vec2), circleVertices.data(), GL_STATIC_DRAW);
+    trackGpuObject(GpuObjectKind::Buffer, antibioticCircleVBO_vertexPosition, circleVertices.size() * sizeof(glm::vec2));
 
     GLint posAttribLoc = glGetAttribLocation(antibioticShaderProgramID, "a_vertexPosition");
     if (posAttribLoc != -1) {
@@ -368,26 +786,209 @@ void Renderer::setupAntibioticGeometry() {
     glBindVertexArray(0);
 }
 
+// Bufor wierzchołków konturów kolonii - ten sam układ co koło antybiotyku (vec2 na płaszczyźnie)
+void Renderer::setupColonyOutlineGeometry() {
+    if (antibioticShaderProgramID == 0) return;
+    GLint posAttribLoc = glGetAttribLocation(antibioticShaderProgramID, "a_vertexPosition");
+    if (posAttribLoc == -1) {
+        std::cerr << "Renderer: Atrybut a_vertexPosition nie znaleziony - kontury kolonii niedostępne." << std::endl;
+        return;
+    }
+
+    colonyOutlineBuffer.create(GL_ARRAY_BUFFER, 4096 * sizeof(glm::vec2));
+    glGenVertexArrays(1, &colonyOutlineVAO);
+    glBindVertexArray(colonyOutlineVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, colonyOutlineBuffer.getID());
+    glVertexAttribPointer(posAttribLoc, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+    glEnableVertexAttribArray(posAttribLoc);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void Renderer::setColonyOutlinesEnabled(bool enabled) {
+    colonyOutlinesEnabled = enabled && colonyOutlineVAO != 0;
+}
+
+bool Renderer::usesColonyOutlines(float zoomLevel) const {
+    return colonyOutlinesEnabled && zoomLevel < MICROSCOPIC_VIEW_THRESHOLD;
+}
+
+// Dodanie konturów kolonii do kolejki - jedna łamana na polecenie
+void Renderer::renderColonyOutlines(const ColonyOutlines& outlines) {
+    TRACE_SCOPE("render", "Renderer::renderColonyOutlines");
+    if (!colonyOutlinesEnabled) return;
+    colonyOutlinesDrawn = true;
+    colonyOutlineStats = outlines.getStats();
+
+    if (outlines.getGeneration() != colonyOutlineGeneration) {
+        const auto& vertices = outlines.getVertices();
+        // Kolejna generacja: tylko przedziały przeliczonych kafli; pominięta generacja albo
+        // tablica większa od bufora - całość
+        bool uploaded = outlines.getGeneration() == colonyOutlineGeneration + 1 &&
+                        vertices.size() * sizeof(glm::vec2) <= colonyOutlineBuffer.getCapacity();
+        for (const OutlineVertexRange& range : outlines.getChangedRanges()) {
+            if (!uploaded) break;
+            uploaded = colonyOutlineBuffer.update(range.first * sizeof(glm::vec2), vertices.data() + range.first,
+                                                  range.count * sizeof(glm::vec2));
+        }
+        if (!uploaded) colonyOutlineBuffer.upload(vertices.data(), vertices.size() * sizeof(glm::vec2));
+        colonyOutlineGeneration = outlines.getGeneration();
+    }
+
+    const auto& strips = outlines.getStrips();
+    if (strips.empty()) return;
+    renderQueue.reserve(renderQueue.size() + strips.size());
+    const uint32_t payloadIndex = static_cast<uint32_t>(meshDrawParameters.size());
+    meshDrawParameters.push_back({glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, COLONY_OUTLINE_Z)),
+                                  glm::mat3(1.0f), COLONY_OUTLINE_COLOR});
+
+    DrawCommand command;
+    command.sortKey = RenderQueue::makeSortKey(RenderPass::ColonyOutline, antibioticShaderProgramID, colonyOutlineVAO, 0, 0);
+    command.program = antibioticShaderProgramID;
+    command.vao = colonyOutlineVAO;
+    command.texture = 0;
+    command.primitive = GL_LINE_STRIP;
+    command.payloadIndex = payloadIndex;
+    for (const OutlineStrip& strip : strips) {
+        command.first = static_cast<GLint>(strip.first);
+        command.count = static_cast<GLsizei>(strip.count);
+        renderQueue.submit(command);
+    }
+}
+
 // Inicjalizacja shadera dla wzsystkich elementów szalki
 void Renderer::initPetriDishShader() {
-    petriDishShaderProgramID = shaderManager.loadShaderProgram("petriDishShader", "shaders/petridish.vert", "shaders/petridish.frag");
-    if (petriDishShaderProgramID == 0) {
-        std::cerr << "Renderer: Błąd ładowania programu shadera dla szalki!" << std::endl;
+    petriDishProgram = loadPetriDishProgram("petriDishShader", {});
+    petriDishOitProgram = loadPetriDishProgram("petriDishShaderOIT", {"OIT_PASS"});
+}
+
+PetriDishProgram Renderer::loadPetriDishProgram(const std::string& name, const std::vector<std::string>& defines) {
+    PetriDishProgram program;
+    program.programID = shaderManager.loadShaderProgram(name, "shaders/petridish.vert", "shaders/petridish.frag", defines);
+    if (program.programID == 0) {
+        std::cerr << "Renderer: Błąd ładowania programu shadera dla szalki " << name << "!" << std::endl;
+        return program;
+    }
+    shaderManager.bindUniformBlock(program.programID, "FrameUniforms", FRAME_UNIFORMS_BINDING);
+    program.u_modelMatrix_loc = shaderManager.getUniformLocation(program.programID, "u_modelMatrix");
+    program.u_normalMatrix_loc = shaderManager.getUniformLocation(program.programID, "u_normalMatrix");
+    program.u_objectColor_loc = shaderManager.getUniformLocation(program.programID, "u_objectColor");
+    program.u_objectAlpha_loc = shaderManager.getUniformLocation(program.programID, "u_objectAlpha");
+    program.u_textureSampler_loc = shaderManager.getUniformLocation(program.programID, "uTextureSampler");
+
+    // Sampler zawsze czyta z jednostki 0 - ustawiamy go raz zamiast przy każdym rysowaniu
+    shaderManager.useShaderProgram(program.programID);
+    glUniform1i(program.u_textureSampler_loc, 0);
+    shaderManager.useShaderProgram(0);
+    return program;
+}
+
+const PetriDishProgram& Renderer::getPetriDishProgram(GLuint programID) const {
+    return (programID == petriDishOitProgram.programID) ? petriDishOitProgram : petriDishProgram;
+}
+
+// Przebieg OIT: program składania oraz bufory akumulacji (RGBA16F) i revealage (R8)
+void Renderer::initOitTargets() {
+    // glBlendFunci (osobne mieszanie dla każdego bufora) wymaga GL 4.0 lub ARB_draw_buffers_blend
+    if (!(GLEW_VERSION_4_0 || GLEW_ARB_draw_buffers_blend) ||
+        bacteriaPrograms[BACTERIA_VARIANT_OIT].programID == 0 || petriDishOitProgram.programID == 0) {
+        std::cout << "Renderer: OIT niedostępne, przezroczystość rysowana zwykłym blendingiem." << std::endl;
+        return;
+    }
+
+    oitCompositeProgramID = shaderManager.loadShaderProgram("oitCompositeShader", "shaders/oit_composite.vert", "shaders/oit_composite.frag");
+    if (oitCompositeProgramID == 0) {
+        std::cerr << "Renderer: Błąd ładowania programu składania OIT!" << std::endl;
         return;
     }
-    petri_u_modelMatrix_loc = shaderManager.getUniformLocation(petriDishShaderProgramID, "u_modelMatrix");
-    petri_u_viewProjectionMatrix_loc = shaderManager.getUniformLocation(petriDishShaderProgramID, "u_viewProjectionMatrix");
-    petri_u_normalMatrix_loc = shaderManager.getUniformLocation(petriDishShaderProgramID, "u_normalMatrix");
-    petri_u_objectColor_loc = shaderManager.getUniformLocation(petriDishShaderProgramID, "u_objectColor");
-    petri_u_objectAlpha_loc = shaderManager.getUniformLocation(petriDishShaderProgramID, "u_objectAlpha");
-    
-    petri_u_lightPosWorld_loc = shaderManager.getUniformLocation(petriDishShaderProgramID, "u_lightPosWorld");
-    petri_u_lightColor_loc = shaderManager.getUniformLocation(petriDishShaderProgramID, "u_lightColor");
-    petri_u_ambientColor_loc = shaderManager.getUniformLocation(petriDishShaderProgramID, "u_ambientColor");
-    petri_u_cameraPositionWorld_loc = shaderManager.getUniformLocation(petriDishShaderProgramID, "u_cameraPositionWorld");
-    petri_u_lightRange_loc = shaderManager.getUniformLocation(petriDishShaderProgramID, "u_lightRange");
-    petri_u_textureSampler_loc = shaderManager.getUniformLocation(petriDishShaderProgramID, "uTextureSampler");
+    shaderManager.useShaderProgram(oitCompositeProgramID);
+    glUniform1i(shaderManager.getUniformLocation(oitCompositeProgramID, "u_accumulationTexture"), 0);
+    glUniform1i(shaderManager.getUniformLocation(oitCompositeProgramID, "u_revealageTexture"), 1);
+    shaderManager.useShaderProgram(0);
+
+    // Przezroczyste przebiegi testują głębię sceny, więc scena rysowana jest do własnego framebuffera
+    if (!ensureSceneTargets(windowWidth, windowHeight) || !createOitTargets()) return;
 
+    oitEnabled = true;
+    std::cout << "Renderer: Włączono przezroczystość niezależną od kolejności (OIT)." << std::endl;
+}
+
+// Bufory akumulacji i revealage w rozmiarze sceny; głębia sceny dołączona tylko do testu
+// (przezroczyste przebiegi nie zapisują głębi), więc warstwy za nieprzezroczystą geometrią są odrzucane
+bool Renderer::createOitTargets() {
+    destroyOitTargets();
+
+    auto createTarget = [this](GLuint& texture, GLint internalFormat, GLenum format, GLenum type, size_t bytesPerPixel) {
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, sceneTargetWidth, sceneTargetHeight, 0, format, type, nullptr);
+        trackGpuObject(GpuObjectKind::Texture, texture, static_cast<size_t>(sceneTargetWidth) * sceneTargetHeight * bytesPerPixel);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    };
+    createTarget(oitAccumulationTexture, GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT, 8);
+    createTarget(oitRevealageTexture, GL_R8, GL_RED, GL_UNSIGNED_BYTE, 1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &oitFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, oitFramebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, oitAccumulationTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, oitRevealageTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, sceneDepthRenderbuffer);
+    const GLenum drawBuffers[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glDrawBuffers(2, drawBuffers);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, sceneFramebuffer);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Renderer: Framebuffer OIT niekompletny (0x" << std::hex << status << std::dec << ")." << std::endl;
+        destroyOitTargets();
+        return false;
+    }
+    return true;
+}
+
+void Renderer::destroyOitTargets() {
+    untrackGpuObject(GpuObjectKind::Texture, oitAccumulationTexture);
+    untrackGpuObject(GpuObjectKind::Texture, oitRevealageTexture);
+    if (oitFramebuffer != 0) glDeleteFramebuffers(1, &oitFramebuffer);
+    if (oitAccumulationTexture != 0) glDeleteTextures(1, &oitAccumulationTexture);
+    if (oitRevealageTexture != 0) glDeleteTextures(1, &oitRevealageTexture);
+    oitFramebuffer = 0;
+    oitAccumulationTexture = 0;
+    oitRevealageTexture = 0;
+}
+
+// Wejście do przezroczystych przebiegów: czyszczenie buforów akumulacji
+void Renderer::beginOitAccumulation() {
+    glBindFramebuffer(GL_FRAMEBUFFER, oitFramebuffer);
+    const GLfloat clearAccumulation[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    const GLfloat clearRevealage[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    glClearBufferfv(GL_COLOR, 0, clearAccumulation);
+    glClearBufferfv(GL_COLOR, 1, clearRevealage);
+}
+
+// Złożenie przezroczystych warstw na framebuffer sceny
+void Renderer::compositeOit() {
+    glBindFramebuffer(GL_FRAMEBUFFER, sceneFramebuffer);
+    stateCache.applyPassState({true, false, false, false});
+    // Pełnoekranowy trójkąt nie może być odrzucany przez głębię sceny
+    glDisable(GL_DEPTH_TEST);
+    stateCache.bindProgram(oitCompositeProgramID);
+    stateCache.bindVertexArray(fullscreenTriangleVAO);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, oitRevealageTexture);
+    stateCache.bindTexture2D(oitAccumulationTexture);
+
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    stateCache.countDraw();
+    glEnable(GL_DEPTH_TEST);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
 }
 
 // Przekazanie geometrii  obiektów z Blendera do VAO i VBO
@@ -397,50 +998,25 @@ void Renderer::setupPetriDishGeometry() {
     setupMeshGeometry("assets/models/agar.obj", agarVAO, agarVBO, agarVertexCount);
 }
 
-// Renderowanie szalki: przekazanie uniformów do shadera, kolor, oteksturowanie, transparentnosc
-void Renderer::renderPetriDish(const glm::mat4& viewProjectionMatrix, const glm::mat4& viewMatrix) {
-    if (petriDishShaderProgramID == 0) return;
-
-    shaderManager.useShaderProgram(petriDishShaderProgramID);
-
-    // Uniformy dla wszystkich części szalki 
-    glm::vec3 cameraPosForShader = glm::vec3(glm::inverse(viewMatrix)[3]);
+// Dodanie szalki do kolejki renderowania: kolor, oteksturowanie, transparentnosc
+void Renderer::renderPetriDish() {
+    TRACE_SCOPE("render", "Renderer::renderPetriDish");
+    if (petriDishProgram.programID == 0) return;
 
-    glUniform3fv(petri_u_lightPosWorld_loc, 1, glm::value_ptr(lightPosWorld));
-    glUniform3fv(petri_u_lightColor_loc, 1, glm::value_ptr(lightColor));
-    glUniform3fv(petri_u_ambientColor_loc, 1, glm::value_ptr(ambientColor));
-    glUniform3fv(petri_u_cameraPositionWorld_loc, 1, glm::value_ptr(cameraPosForShader));
-    glUniform1f(petri_u_lightRange_loc, lightRange); 
-    
-    glUniformMatrix4fv(petri_u_viewProjectionMatrix_loc, 1, GL_FALSE, glm::value_ptr(viewProjectionMatrix));
-
-    // Renderowanie przezroczystych części szalki
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDepthMask(GL_FALSE); // Wyłącz zapis do bufora głębi dla przezroczystych obiektów
-    glEnable(GL_CULL_FACE); // Włącz odrzucanie ścian
-    glCullFace(GL_BACK);    // Odrzucaj tylne ściany
+    // Szkło podstawy i przykrywki idzie przez OIT, agar jest tłem rysowanym zwykłym blendingiem
+    GLuint glassProgramID = oitEnabled ? petriDishOitProgram.programID : petriDishProgram.programID;
 
+    // Kamera i oświetlenie pochodzą z bloku FrameUniforms, stan blendingu ustawia przebieg kolejki
     // Renderowanie podstawy szalki
     if (dishBaseVAO != 0 && dishBaseVertexCount > 0) {
         glm::mat4 modelMatrix = glm::mat4(1.0f); 
         modelMatrix = glm::scale(modelMatrix, glm::vec3(10.0f)); 
         modelMatrix = glm::rotate(modelMatrix, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
         glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelMatrix)));
-        
-        glUniformMatrix4fv(petri_u_modelMatrix_loc, 1, GL_FALSE, glm::value_ptr(modelMatrix));
-        glUniformMatrix3fv(petri_u_normalMatrix_loc, 1, GL_FALSE, glm::value_ptr(normalMatrix));
-        
-        glUniform3f(petri_u_objectColor_loc, 0.85f, 0.9f, 0.95f); // Kolor szkła
-        glUniform1f(petri_u_objectAlpha_loc, 0.15);            // Alpha szkła
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, 0); 
-        glUniform1i(petri_u_textureSampler_loc, 0);
-
-        glBindVertexArray(dishBaseVAO);
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(dishBaseVertexCount));
-        
+        submitMeshDraw(RenderPass::DishBase, glassProgramID, dishBaseVAO, 0,
+                       GL_TRIANGLES, static_cast<GLsizei>(dishBaseVertexCount), 0.0f,
+                       {modelMatrix, normalMatrix, glm::vec4(0.85f, 0.9f, 0.95f, 0.15f)}); // Kolor i alpha szkła
     }
 
     // Renderowanie agaru 
@@ -451,18 +1027,9 @@ void Renderer::renderPetriDish(const glm::mat4& viewProjectionMatrix, const glm:
         modelMatrix = glm::rotate(modelMatrix, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
         glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelMatrix)));
 
-        glUniformMatrix4fv(petri_u_modelMatrix_loc, 1, GL_FALSE, glm::value_ptr(modelMatrix));
-        glUniformMatrix3fv(petri_u_normalMatrix_loc, 1, GL_FALSE, glm::value_ptr(normalMatrix));
-
-        glUniform3f(petri_u_objectColor_loc, 1.0f, 1.0f, 1.0f);
-        glUniform1f(petri_u_objectAlpha_loc, 0.9f); 
-
-        glActiveTexture(GL_TEXTURE0); 
-        glBindTexture(GL_TEXTURE_2D, agarTextureID);
-        glUniform1i(petri_u_textureSampler_loc, 0); 
-
-        glBindVertexArray(agarVAO);
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(agarVertexCount));
+        submitMeshDraw(RenderPass::Agar, petriDishProgram.programID, agarVAO, agarTextureID,
+                       GL_TRIANGLES, static_cast<GLsizei>(agarVertexCount), 0.0f,
+                       {modelMatrix, normalMatrix, glm::vec4(1.0f, 1.0f, 1.0f, 0.9f)});
     }
 
     // Renderowanie przykrywki szalki
@@ -472,31 +1039,194 @@ void Renderer::renderPetriDish(const glm::mat4& viewProjectionMatrix, const glm:
         modelMatrix = glm::rotate(modelMatrix, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));       
         glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelMatrix)));
 
-        glUniformMatrix4fv(petri_u_modelMatrix_loc, 1, GL_FALSE, glm::value_ptr(modelMatrix));
-        glUniformMatrix3fv(petri_u_normalMatrix_loc, 1, GL_FALSE, glm::value_ptr(normalMatrix));
+        submitMeshDraw(RenderPass::Lid, glassProgramID, dishLidVAO, 0,
+                       GL_TRIANGLES, static_cast<GLsizei>(dishLidVertexCount), 0.0f,
+                       {modelMatrix, normalMatrix, glm::vec4(0.85f, 0.9f, 0.95f, 0.15f)}); // Kolor i alpha szkła
+    }
+}
 
-        glUniform3f(petri_u_objectColor_loc, 0.85f, 0.9f, 0.95f); // Kolor szkła
-        glUniform1f(petri_u_objectAlpha_loc, 0.15f);            // Alpha szkła
-        
+void Renderer::submitMeshDraw(RenderPass pass, GLuint program, GLuint vao, GLuint texture, GLenum primitive,
+                              GLsizei vertexCount, float depth01, const MeshDrawParameters& parameters) {
+    DrawCommand command;
+    command.sortKey = RenderQueue::makeSortKey(pass, program, vao, texture, RenderQueue::quantizeDepth(depth01, false));
+    command.program = program;
+    command.vao = vao;
+    command.texture = texture;
+    command.primitive = primitive;
+    command.first = 0;
+    command.count = vertexCount;
+    command.payloadIndex = static_cast<uint32_t>(meshDrawParameters.size());
+
+    meshDrawParameters.push_back(parameters);
+    renderQueue.submit(command);
+}
+
+// Stan GL każdego przebiegu
+PassState Renderer::getPassState(RenderPass pass) const {
+    switch (pass) {
+        case RenderPass::Agar:
+            return {true, false, true, false};
+        case RenderPass::DishBase:
+        case RenderPass::Lid:
+            // Przezroczyste szkło: blending, bez zapisu głębi, odrzucanie tylnych ścian
+            return {true, false, true, oitEnabled};
+        case RenderPass::Colony:
+            // Bez OIT kolonia jest rysowana jak dotąd: bez blendingu, z zapisem głębi
+            return oitEnabled ? PassState{true, false, false, true} : PassState{false, true, false, false};
+        case RenderPass::ColonyOutline:
+            return {true, false, false, false};
+        case RenderPass::AntibioticOverlay:
+            return {true, true, false, false};
+        default:
+            return {false, true, false, false};
+    }
+}
+
+// Posortowanie kolejki i wykonanie wszystkich poleceń przez cache stanu
+void Renderer::executeRenderQueue() {
+    TRACE_SCOPE("render", "Renderer::executeRenderQueue");
+    {
+        TRACE_SCOPE("render", "RenderQueue::sort");
+        renderQueue.sort();
+    }
+    // Przebiegi na osi czasu to czas zgłaszania poleceń na CPU, nie wykonania na GPU
+    const bool tracePasses = isTraceEnabled();
+
+    stateCache.reset();
+    stateCache.resetStats();
+
+    collectColonyTimer();
+    GLuint colonyTimerQuery = colonyTimerQueries[colonyTimerIndex];
+    bool colonyTimerActive = false;
+
+    if (bakedPatternsEnabled) {
+        glActiveTexture(GL_TEXTURE0 + PATTERN_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, bacteriaPatternTexture);
         glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, 0); 
-        glUniform1i(petri_u_textureSampler_loc, 0);
+    }
+
+    RenderPass currentPass = RenderPass::Count;
+    bool accumulatingOit = false;
+    for (const DrawCommand& command : renderQueue.getCommands()) {
+        RenderPass pass = RenderQueue::getPass(command.sortKey);
+        if (pass != currentPass) {
+            // Pomiar obejmuje wyłącznie rysowanie kolonii, bez składania OIT
+            if (colonyTimerActive) {
+                glEndQuery(GL_TIME_ELAPSED);
+                colonyTimerActive = false;
+            }
+            if (tracePasses) {
+                if (currentPass != RenderPass::Count) {
+                    traceRecord(TracePhase::End, "render", RENDER_PASS_TRACE_NAMES[static_cast<size_t>(currentPass)]);
+                }
+                traceRecord(TracePhase::Begin, "render", RENDER_PASS_TRACE_NAMES[static_cast<size_t>(pass)]);
+            }
+            PassState passState = getPassState(pass);
+            // Przejścia między grupą przebiegów OIT a zwykłymi przebiegami
+            if (passState.oitAccumulation && !accumulatingOit) {
+                beginOitAccumulation();
+                accumulatingOit = true;
+            } else if (!passState.oitAccumulation && accumulatingOit) {
+                compositeOit();
+                accumulatingOit = false;
+            }
+            stateCache.applyPassState(passState);
+            currentPass = pass;
+
+            if (pass == RenderPass::Colony && colonyTimerQuery != 0) {
+                glBeginQuery(GL_TIME_ELAPSED, colonyTimerQuery);
+                colonyTimerActive = true;
+                colonyTimerPending[colonyTimerIndex] = true;
+                colonyTimerBaked[colonyTimerIndex] = bakedPatternsEnabled;
+            }
+        }
+
+        stateCache.bindProgram(command.program);
+        stateCache.bindVertexArray(command.vao);
+
+        if (pass == RenderPass::Colony) {
+            const BacteriaProgram& program = getBacteriaProgram(command.program);
+            const BacteriaDrawParameters& parameters = bacteriaDrawParameters[command.payloadIndex];
+            glUniform3f(program.u_instanceWorldPosition_loc, parameters.positionHealth.x, parameters.positionHealth.y, parameters.positionHealth.z);
+            glUniform1f(program.u_instanceScale_loc, parameters.scale);
+            glUniform1i(program.u_bacteriaPattern_loc, speciesPatterns[parameters.species]);
+            glUniform3fv(program.u_bacteriaColor_loc, 1, glm::value_ptr(speciesColors[parameters.species]));
+            glUniform1f(program.u_bacteriaHealth_loc, parameters.positionHealth.w);
+        } else if (pass == RenderPass::AntibioticOverlay || pass == RenderPass::ColonyOutline) {
+            const MeshDrawParameters& parameters = meshDrawParameters[command.payloadIndex];
+            glUniformMatrix4fv(antibiotic_u_modelMatrix_loc, 1, GL_FALSE, glm::value_ptr(parameters.modelMatrix));
+            glUniform4fv(antibiotic_u_effectColor_loc, 1, glm::value_ptr(parameters.color));
+        } else {
+            const PetriDishProgram& program = getPetriDishProgram(command.program);
+            const MeshDrawParameters& parameters = meshDrawParameters[command.payloadIndex];
+            stateCache.bindTexture2D(command.texture);
+            glUniformMatrix4fv(program.u_modelMatrix_loc, 1, GL_FALSE, glm::value_ptr(parameters.modelMatrix));
+            glUniformMatrix3fv(program.u_normalMatrix_loc, 1, GL_FALSE, glm::value_ptr(parameters.normalMatrix));
+            glUniform3f(program.u_objectColor_loc, parameters.color.x, parameters.color.y, parameters.color.z);
+            glUniform1f(program.u_objectAlpha_loc, parameters.color.w);
+        }
 
-        glBindVertexArray(dishLidVAO);
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(dishLidVertexCount));
+        if (command.indexed) {
+            glDrawElementsBaseVertex(command.primitive, command.count, GL_UNSIGNED_INT,
+                                     reinterpret_cast<void*>(static_cast<uintptr_t>(command.first) * sizeof(GLuint)),
+                                     command.baseVertex);
+        } else {
+            glDrawArrays(command.primitive, command.first, command.count);
+        }
+        stateCache.countDraw();
+    }
+    if (colonyTimerActive) {
+        glEndQuery(GL_TIME_ELAPSED);
+    }
+    colonyTimerIndex = (colonyTimerIndex + 1) % COLONY_TIMER_QUERY_COUNT;
+    if (accumulatingOit) {
+        compositeOit();
+    }
+    if (tracePasses && currentPass != RenderPass::Count) {
+        traceRecord(TracePhase::End, "render", RENDER_PASS_TRACE_NAMES[static_cast<size_t>(currentPass)]);
     }
 
-    // koniec renderowanie przezroczystych części szalki
-    glDisable(GL_CULL_FACE); // Wyłączanie  odrzucania ścian
-    glDepthMask(GL_TRUE);    // Przywrocenie zapisu do bufora głębi
-    glDisable(GL_BLEND);   
+    // Przywrócenie stanu oczekiwanego przez resztę klatki (ImGui)
     glBindVertexArray(0);
-    shaderManager.useShaderProgram(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    if (bakedPatternsEnabled) {
+        glActiveTexture(GL_TEXTURE0 + PATTERN_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        glActiveTexture(GL_TEXTURE0);
+    }
+    glUseProgram(0);
+    glDisable(GL_CULL_FACE);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+
+    frameStats = stateCache.getStats();
+    frameStats.submittedCommands = static_cast<uint32_t>(renderQueue.size());
+    frameStats.proceduralPatternGpuMs = colonyGpuMilliseconds[0];
+    frameStats.bakedPatternGpuMs = colonyGpuMilliseconds[1];
+    frameStats.bakedPatternsAvailable = bacteriaPatternTexture != 0;
+    frameStats.bakedPatternsEnabled = bakedPatternsEnabled;
+    frameStats.impostorsEnabled = impostorsEnabled;
+    frameStats.colonyOutlinesEnabled = colonyOutlinesEnabled;
+    frameStats.colonyOutlinesDrawn = colonyOutlinesDrawn;
+    if (colonyOutlinesDrawn) {
+        frameStats.outlineTiles = static_cast<uint32_t>(colonyOutlineStats.tiles);
+        frameStats.outlineExtractedTiles = static_cast<uint32_t>(colonyOutlineStats.extractedTiles);
+        frameStats.outlineStrips = static_cast<uint32_t>(colonyOutlineStats.strips);
+        frameStats.outlineVertices = static_cast<uint32_t>(colonyOutlineStats.vertices);
+        frameStats.outlineChangedVertices = static_cast<uint32_t>(colonyOutlineStats.changedVertices);
+        frameStats.outlineExtractMs = static_cast<float>(colonyOutlineStats.extractMilliseconds);
+    }
+    colonyOutlinesDrawn = false;
+    TRACE_COUNTER("render", "draw calls", frameStats.drawCalls);
+
+    renderQueue.clear();
+    meshDrawParameters.clear();
+    bacteriaDrawParameters.clear();
 }
 
 // Ustalanie siatki modelu
 void Renderer::setupMeshGeometry(const char* modelPath, GLuint& vao, GLuint& vbo, size_t& vertexCount) {
-    std::vector<Vertex> vertices;
+    VertexList vertices;
     if (!modelLoader.loadOBJ(modelPath, vertices) || vertices.empty()) {
         std::cerr << "Renderer: Nie udało się załadować modelu lub model jest pusty: " << modelPath << std::endl;
         vao = 0; vbo = 0; vertexCount = 0;
@@ -510,6 +1240,7 @@ void Renderer::setupMeshGeometry(const char* modelPath, GLuint& vao, GLuint& vbo
     glBindVertexArray(vao);
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+    trackGpuObject(GpuObjectKind::Buffer, vbo, vertices.size() * sizeof(Vertex));
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Position));
     glEnableVertexAttribArray(0);
@@ -10,14 +10,82 @@
 #include <iostream> 
 #include <map> 
 #include <cmath>
+#include <string>
+#include <algorithm>
 
 #include "Simulation/IBacteria.h" 
 #include "Simulation/AntibioticEffect.h"
 #include "ShaderManager.h"
 #include "Simulation/BacteriaStatsProvider.h" 
 #include "Simulation/BacteriaStats.h" 
+#include "Simulation/SpeciesRegistry.h"
 #include "ModelLoader.h"
 #include "TextureLoader.h"
+#include "StreamBuffer.h"
+#include "RenderQueue.h"
+#include "RenderStats.h"
+#include "FrameCapture.h"
+#include "ColonyOutlines.h"
+
+// Punkt wiązania bloku uniformów FrameUniforms we wszystkich programach
+const GLuint FRAME_UNIFORMS_BINDING = 0;
+// Jednostka tekstury z wypieczoną tablicą wzorów bakterii (0 i 1 zajmuje szalka i składanie OIT)
+const GLuint PATTERN_TEXTURE_UNIT = 2;
+
+// Globalny stan klatki (kamera + oświetlenie) w układzie std140.
+// Musi odpowiadać blokowi FrameUniforms w shaderach.
+struct FrameUniforms {
+    glm::mat4 viewProjectionMatrix;
+    glm::vec3 lightPositionWorld;
+    float lightRange;
+    glm::vec3 lightColor;
+    float time;
+    glm::vec3 ambientColor;
+    float padding0;
+    glm::vec3 cameraPositionWorld;
+    float padding1;
+};
+static_assert(sizeof(FrameUniforms) == 128, "FrameUniforms musi mieć układ std140");
+
+// Parametry rysowania siatki (szalka, agar, przykrywka, efekt antybiotyku)
+struct MeshDrawParameters {
+    glm::mat4 modelMatrix;
+    glm::mat3 normalMatrix;
+    glm::vec4 color; // rgb = kolor obiektu, a = przezroczystość
+};
+
+// Parametry rysowania pojedynczej bakterii
+struct BacteriaDrawParameters {
+    glm::vec4 positionHealth; // xyz = pozycja w świecie, w = zdrowie
+    SpeciesId species;
+    float scale;              // Skala modelu - superosobniki są większe
+};
+
+// Warianty programu bakterii - bity indeksu w tablicy Renderer::bacteriaPrograms
+const int BACTERIA_VARIANT_OIT = 1;             // Przebieg OIT
+const int BACTERIA_VARIANT_BAKED_PATTERN = 2;   // Wzór z wypieczonej tablicy tekstur
+const int BACTERIA_VARIANT_IMPOSTOR = 4;        // Kwadrat z kształtem z funkcji odległości
+const int BACTERIA_VARIANT_COUNT = 8;
+
+// Program bakterii wraz z lokalizacjami uniformów (jeden na wariant shadera)
+struct BacteriaProgram {
+    GLuint programID = 0;
+    GLint u_instanceWorldPosition_loc = -1;
+    GLint u_instanceScale_loc = -1;
+    GLint u_bacteriaPattern_loc = -1;
+    GLint u_bacteriaColor_loc = -1;
+    GLint u_bacteriaHealth_loc = -1;
+};
+
+// Program szalki wraz z lokalizacjami uniformów (jeden na wariant shadera)
+struct PetriDishProgram {
+    GLuint programID = 0;
+    GLint u_modelMatrix_loc = -1;
+    GLint u_normalMatrix_loc = -1;
+    GLint u_objectColor_loc = -1;
+    GLint u_objectAlpha_loc = -1;
+    GLint u_textureSampler_loc = -1;
+};
 
 class Renderer {
 private:
@@ -27,59 +95,110 @@ private:
     GLFWwindow* window;
     ShaderManager shaderManager;
     ModelLoader modelLoader;
+    TextureLoader textureLoader;
 
     int windowWidth;
     int windowHeight;
     bool successfullyInitialized; 
 
-    std::vector<AntibioticEffect> activeAntibiotics; 
+    TrackedVector<AntibioticEffect, MemoryTag::RendererCpu> activeAntibiotics; 
 
     // ID programów shaderowych
-    GLuint bacteriaShaderProgramID;
     GLuint antibioticShaderProgramID;
 
-    // Lokalizacje uniformów dla shadera bakterii (widok mikro)
-    GLint bacteria_u_viewProjectionMatrix_loc;
-    GLint bacteria_u_instanceWorldPosition_loc;
-    GLint bacteria_u_instanceScale_loc;
-    GLint bacteria_u_bacteriaType_loc;     
-    GLint bacteria_u_bacteriaHealth_loc;    
-    GLint bacteria_u_time_loc;
-
-    // Lokalizacje uniformów dla oświetlenia w shaderze bakterii
-    GLint bacteria_u_lightPositionWorld_loc;
-    GLint bacteria_u_lightColor_loc;
-    GLint bacteria_u_ambientColor_loc;
-    GLint bacteria_u_cameraPositionWorld_loc; 
-    GLint bacteria_u_lightRange_loc;
+    // Bufor uniformów z globalnym stanem klatki, wspólny dla wszystkich programów
+    StreamBuffer frameUniformBuffer;
+    glm::mat4 currentViewProjectionMatrix;
+
+    // Kolejka poleceń rysowania - przebiegi zgłaszają rekordy, a executeRenderQueue je sortuje i wykonuje
+    RenderQueue renderQueue;
+    GLStateCache stateCache;
+    TrackedVector<MeshDrawParameters, MemoryTag::RendererCpu> meshDrawParameters;
+    TrackedVector<BacteriaDrawParameters, MemoryTag::RendererCpu> bacteriaDrawParameters;
+    // Lista rysowania kolonii z ostatniego renderColony - ponownie zgłaszana przez resubmitColony
+    DrawCommandList cachedColonyCommands;
+    TrackedVector<BacteriaDrawParameters, MemoryTag::RendererCpu> cachedColonyParameters;
+    RenderStats frameStats;
+
+    void submitMeshDraw(RenderPass pass, GLuint program, GLuint vao, GLuint texture, GLenum primitive,
+                        GLsizei vertexCount, float depth01, const MeshDrawParameters& parameters);
+    PassState getPassState(RenderPass pass) const;
+
+    // Przezroczystość niezależna od kolejności (weighted blended OIT) dla bakterii, szalki i przykrywki.
+    // Przezroczyste przebiegi trafiają do bufora akumulacji i bufora "revealage", a następnie
+    // są składane jednym pełnoekranowym trójkątem - bez sortowania obiektów na CPU.
+    bool oitEnabled;
+    GLuint oitFramebuffer;
+    GLuint oitAccumulationTexture;
+    GLuint oitRevealageTexture;
+    GLuint oitCompositeProgramID;
+    void initOitTargets();
+    bool createOitTargets();
+    void destroyOitTargets();
+    void beginOitAccumulation();
+    void compositeOit();
+
+    // Pusty VAO do pełnoekranowych trójkątów generowanych w shaderze (składanie OIT, wypiekanie wzorów)
+    GLuint fullscreenTriangleVAO;
+
+    // Programy bakterii (widok mikro) dla każdej kombinacji wariantów BACTERIA_VARIANT_*:
+    // zwykły lub OIT, wzór proceduralny lub wypieczony, obrys z wachlarza lub impostor
+    BacteriaProgram bacteriaPrograms[BACTERIA_VARIANT_COUNT];
+    BacteriaProgram loadBacteriaProgram(const std::string& name, const std::vector<std::string>& defines);
+    const BacteriaProgram& getBacteriaProgram(GLuint programID) const;
+    const BacteriaProgram& getActiveBacteriaProgram() const;
+
+    // Wzory powierzchni bakterii wypieczone przy starcie: warstwa = typ * fazy + faza animacji.
+    // Shader wykonuje wtedy jeden odczyt tekstury zamiast szumu i łańcucha warunków na fragment.
+    GLuint bacteriaPatternTexture;
+    bool bakedPatternsEnabled;
+    void bakeBacteriaPatterns();
+
+    // Pomiar czasu GPU przebiegu kolonii (GL_TIME_ELAPSED) - pierścień zapytań, aby nie czekać na wynik
+    static const int COLONY_TIMER_QUERY_COUNT = 3;
+    GLuint colonyTimerQueries[COLONY_TIMER_QUERY_COUNT];
+    bool colonyTimerPending[COLONY_TIMER_QUERY_COUNT];
+    bool colonyTimerBaked[COLONY_TIMER_QUERY_COUNT];
+    int colonyTimerIndex;
+    float colonyGpuMilliseconds[2]; // Średnia krocząca: [0] wzór proceduralny, [1] wypieczony
+    void collectColonyTimer();
 
     // Lokalizacje uniformów dla shadera antybiotyków
     GLint antibiotic_u_modelMatrix_loc;
-    GLint antibiotic_u_viewProjectionMatrix_loc;
     GLint antibiotic_u_effectColor_loc;
 
-    // Geometria Bakterii (VAO/VBO) 
-    std::map<BacteriaType, GLuint> bacteriaVAOs;         
-    std::map<BacteriaType, GLuint> bacteriaVBOs_vertexLocalPosition; 
-    std::map<BacteriaType, int> bacteriaVertexCounts; 
+    // Atlas geometrii bakterii: jeden VAO z obrysami wszystkich gatunków.
+    // Przesunięcia i parametry gatunków w gęstych tablicach indeksowanych SpeciesId.
+    GLuint bacteriaAtlasVAO, bacteriaAtlasVBO, bacteriaAtlasEBO;
+    std::vector<GLint> speciesFirstIndices;
+    std::vector<GLsizei> speciesIndexCounts;
+    std::vector<GLint> speciesBaseVertices;
+    std::vector<glm::vec3> speciesColors;
+    std::vector<int> speciesPatterns;
+
+    // Impostory: jeden wspólny kwadrat (4 wierzchołki) dla wszystkich gatunków, kształt liczy shader
+    // ze stylu gatunku (własne obrysy z rejestru przybliża najbliższy styl)
+    GLuint bacteriaImpostorVAO, bacteriaImpostorVBO;
+    bool impostorsEnabled;
 
     // Geometria dla punktów (widok makro) i antybiotyków
     GLuint antibioticCircleVAO, antibioticCircleVBO_vertexPosition; 
     int antibioticCircleVertexCount;
 
-    // Lokalizacje uniformów dla szalki
-    GLuint petriDishShaderProgramID;
-    GLint petri_u_modelMatrix_loc;
-    GLint petri_u_viewProjectionMatrix_loc;
-    GLint petri_u_normalMatrix_loc;
-    GLint petri_u_objectColor_loc;
-    GLint petri_u_objectAlpha_loc;
-    GLint petri_u_lightPosWorld_loc;  
-    GLint petri_u_lightColor_loc;
-    GLint petri_u_ambientColor_loc;
-    GLint petri_u_cameraPositionWorld_loc;
-    GLint petri_u_lightRange_loc;
-    GLint petri_u_textureSampler_loc; 
+    // Kontury kolonii (widok makro) rysowane programem antybiotyków jako łamane.
+    // Wierzchołki wysyłane są tylko wtedy, gdy zmieni się generacja konturów.
+    GLuint colonyOutlineVAO;
+    StreamBuffer colonyOutlineBuffer;
+    uint64_t colonyOutlineGeneration;
+    bool colonyOutlinesEnabled;
+    bool colonyOutlinesDrawn;
+    ColonyOutlineStats colonyOutlineStats;
+
+    // Programy szalki: zwykły (agar) i do przebiegu OIT (szkło podstawy i przykrywki)
+    PetriDishProgram petriDishProgram;
+    PetriDishProgram petriDishOitProgram;
+    PetriDishProgram loadPetriDishProgram(const std::string& name, const std::vector<std::string>& defines);
+    const PetriDishProgram& getPetriDishProgram(GLuint programID) const;
 
     // Geometria dla poszczególnych części szalki
     GLuint dishBaseVAO, dishBaseVBO;
@@ -93,6 +212,17 @@ private:
     GLuint agarTextureID;
 
     // Właściwości światła
+    // Przechwytywanie i OIT: scena rysowana jest do własnego framebuffera (RGBA8 + głębia) w rozmiarze
+    // renderera, odczytywana asynchronicznie i kopiowana do okna, jeśli to jest widoczne
+    GLuint sceneFramebuffer;   // 0 = domyślny framebuffer okna
+    GLuint sceneColorTexture;
+    GLuint sceneDepthRenderbuffer;
+    int sceneTargetWidth, sceneTargetHeight;
+    bool presentSceneFrames;
+    bool ensureSceneTargets(int width, int height);
+    void destroySceneTargets();
+    FrameCapture frameCapture;
+
     glm::vec3 lightPosWorld;
     glm::vec3 lightColor;
     glm::vec3 ambientColor;
@@ -108,18 +238,54 @@ public:
     void beginFrame();
     void endFrame();
 
+    // Tryb przechwytywania klatek do sekwencji PNG (outputPrefix_NNNNNN.png)
+    bool enableCapture(const std::string& outputPrefix, size_t encoderThreads);
+    // Odczyt gotowej sceny i skopiowanie jej do okna - wywoływany po executeRenderQueue, przed rysowaniem GUI
+    void captureFrame();
+    // Zapis zaległych klatek; wymaga aktywnego kontekstu OpenGL
+    void finishCapture();
+    bool isCapturing() const { return frameCapture.isActive(); }
+    FrameCaptureStats getCaptureStats() const { return frameCapture.getStats(); }
+
+    // Jednorazowa na klatkę aktualizacja bloku FrameUniforms (kamera, światło, czas)
+    void updateFrameUniforms(const glm::mat4& viewProjectionMatrix, const glm::mat4& viewMatrix);
+
+    // Funkcje render* jedynie zgłaszają polecenia do kolejki; rysowanie odbywa się tutaj
+    void executeRenderQueue();
+    const RenderStats& getFrameStats() const { return frameStats; }
+    bool isOitEnabled() const { return oitEnabled; }
+
+    // Przełączanie między proceduralnym a wypieczonym wzorem bakterii (porównanie jakości i kosztu)
+    void setBakedPatternsEnabled(bool enabled);
+    bool areBakedPatternsEnabled() const { return bakedPatternsEnabled; }
+
+    // Przełączanie między impostorami SDF a wachlarzem trójkątów z obrysu typu
+    void setImpostorsEnabled(bool enabled);
+    bool areImpostorsEnabled() const { return impostorsEnabled; }
+
     // *** Bakterie ***
-    void renderBacteria(IBacteria& bacteria, float zoomLevel, const glm::mat4& viewProjectionMatrix);
-    void renderColony(const std::vector<std::unique_ptr<IBacteria>>& allBacteria, float zoomLevel, const glm::mat4& viewProjectionMatrix);
+    void renderBacteria(IBacteria& bacteria, float zoomLevel);
+    void renderColony(const CellList& allBacteria, float zoomLevel);
+    // Ponowne zgłoszenie kolonii z ostatniego renderColony bez przeglądania bakterii -
+    // dla klatek, w których czas procesora idzie na nadrabianie symulacji
+    void resubmitColony();
 
     void initBacteriaShader();
     void setupBacteriaGeometry();
 
+    // *** Kontury kolonii ***
+    void setColonyOutlinesEnabled(bool enabled);
+    bool areColonyOutlinesEnabled() const { return colonyOutlinesEnabled; }
+    // Czy przy danym zoomie kolonia rysowana jest konturami zamiast pojedynczych bakterii
+    bool usesColonyOutlines(float zoomLevel) const;
+    void renderColonyOutlines(const ColonyOutlines& outlines);
+    void setupColonyOutlineGeometry();
+
     // *******************
     // *** Antybiotyki ***/
     void addAntibioticEffect(const glm::vec2& worldPos, float strength, float radius, float lifetime = 2.0f);
     void updateAntibioticEffects(float deltaTime);
-    void renderAntibioticEffects(const glm::mat4& viewProjectionMatrix);
+    void renderAntibioticEffects();
     
     void initAntibioticShader();
     void setupAntibioticGeometry();
@@ -137,7 +303,7 @@ public:
     // *** Szalka i agar *** /
     void initPetriDishShader();
     void setupPetriDishGeometry(); 
-    void renderPetriDish(const glm::mat4& viewProjectionMatrix, const glm::mat4& viewMatrix);
+    void renderPetriDish();
 
     void setupMeshGeometry(const char* modelPath, GLuint& vao, GLuint& vbo, size_t& vertexCount);
 
@@ -2,8 +2,31 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <chrono>
+#include <filesystem>
 
-ShaderManager::ShaderManager() {}
+#include "Utils/Hash.h"
+
+namespace {
+    const char* SHADER_CACHE_DIRECTORY = "cache/shaders";
+    const uint32_t PROGRAM_CACHE_MAGIC = 0x42504450; // "PDPB"
+    const uint32_t PROGRAM_CACHE_VERSION = 1;
+
+    struct ProgramCacheHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t cacheKey;
+        uint32_t binaryFormat;
+        uint32_t binaryLength;
+        double compileMilliseconds; // Czas kompilacji ze źródeł - do raportowania zaoszczędzonego czasu
+    };
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+ShaderManager::ShaderManager() : binaryCacheSupport(-1) {}
 
 ShaderManager::~ShaderManager() {
     for (auto const& [name, programID] : shaderPrograms) {
@@ -26,6 +49,26 @@ std::string ShaderManager::loadShaderSourceFromFile(const char* filePath) {
     return shaderStream.str();
 }
 
+std::string ShaderManager::injectDefines(const std::string& source, const std::vector<std::string>& defines) {
+    if (defines.empty()) return source;
+
+    std::string defineBlock;
+    for (const auto& define : defines) {
+        defineBlock += "#define " + define + "\n";
+    }
+
+    // #version musi pozostać pierwszą dyrektywą w pliku
+    size_t insertPosition = 0;
+    size_t versionPosition = source.find("#version");
+    if (versionPosition != std::string::npos) {
+        size_t lineEnd = source.find('\n', versionPosition);
+        insertPosition = (lineEnd == std::string::npos) ? source.size() : lineEnd + 1;
+    }
+    std::string result = source;
+    result.insert(insertPosition, defineBlock);
+    return result;
+}
+
 GLuint ShaderManager::compileShader(GLenum type, const char* source, const std::string& shaderNameForLogging) {
     GLuint shader = glCreateShader(type);
     glShaderSource(shader, 1, &source, NULL);
@@ -72,7 +115,8 @@ bool ShaderManager::linkProgram(GLuint programID, GLuint vertexShaderID, GLuint
     return true;
 }
 
-GLuint ShaderManager::loadShaderProgram(const std::string& name, const char* vertexPath, const char* fragmentPath) {
+GLuint ShaderManager::loadShaderProgram(const std::string& name, const char* vertexPath, const char* fragmentPath,
+                                        const std::vector<std::string>& defines) {
     if (shaderPrograms.count(name)) {
         return shaderPrograms[name];
     }
@@ -84,6 +128,22 @@ GLuint ShaderManager::loadShaderProgram(const std::string& name, const char* ver
         return 0;
     }
 
+    vertexCode = injectDefines(vertexCode, defines);
+    fragmentCode = injectDefines(fragmentCode, defines);
+
+    uint64_t cacheKey = 0;
+    if (isBinaryCacheSupported()) {
+        cacheKey = computeBinaryCacheKey(vertexCode, fragmentCode);
+        GLuint cachedProgramID = loadProgramFromBinaryCache(name, cacheKey);
+        if (cachedProgramID != 0) {
+            shaderPrograms[name] = cachedProgramID;
+            std::cout << "INFO::SHADER_MANAGER::Loaded shader program '" << name << "' with ID: " << cachedProgramID << std::endl;
+            return cachedProgramID;
+        }
+    }
+
+    auto compileStart = std::chrono::steady_clock::now();
+
     GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexCode.c_str(), name + "_VS");
     GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentCode.c_str(), name + "_FS");
 
@@ -94,11 +154,22 @@ GLuint ShaderManager::loadShaderProgram(const std::string& name, const char* ver
     }
 
     GLuint programID = glCreateProgram();
+    if (binaryCacheSupport == 1) {
+        // Bez tej podpowiedzi część sterowników nie udostępnia binarki po linkowaniu
+        glProgramParameteri(programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     if (!linkProgram(programID, vertexShader, fragmentShader)) {
         glDeleteProgram(programID); 
         return 0;
     }
 
+    if (binaryCacheSupport == 1) {
+        double compileMilliseconds = millisecondsSince(compileStart);
+        std::cout << "INFO::SHADER_MANAGER::Program binary cache miss for '" << name
+                  << "', compiled from source in " << compileMilliseconds << " ms" << std::endl;
+        saveProgramToBinaryCache(name, programID, cacheKey, compileMilliseconds);
+    }
+
     shaderPrograms[name] = programID;
     std::cout << "INFO::SHADER_MANAGER::Loaded shader program '" << name << "' with ID: " << programID << std::endl;
     return programID;
@@ -134,4 +205,147 @@ GLint ShaderManager::getUniformLocation(GLuint programID, const char* uniformNam
 GLint ShaderManager::getUniformLocation(const std::string& programName, const char* uniformName) {
     GLuint programID = getShaderProgram(programName);
     return getUniformLocation(programID, uniformName);
-}
\ No newline at end of file
+}
+
+bool ShaderManager::bindUniformBlock(GLuint programID, const char* blockName, GLuint bindingPoint) {
+    if (programID == 0) return false;
+    GLuint blockIndex = glGetUniformBlockIndex(programID, blockName);
+    if (blockIndex == GL_INVALID_INDEX) {
+        std::cerr << "ERROR::SHADER_MANAGER::Uniform block '" << blockName << "' not found in program " << programID << std::endl;
+        return false;
+    }
+    glUniformBlockBinding(programID, blockIndex, bindingPoint);
+    return true;
+}
+
+bool ShaderManager::isBinaryCacheSupported() {
+    if (binaryCacheSupport != -1) {
+        return binaryCacheSupport == 1;
+    }
+
+    binaryCacheSupport = 0;
+    if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary) {
+        GLint formatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        if (formatCount > 0) {
+            binaryCacheSupport = 1;
+        }
+    }
+
+    if (binaryCacheSupport == 1) {
+        const char* vendor = reinterpret_cast<const char*>(glGetString(GL_VENDOR));
+        const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+        const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+        driverIdentity = std::string(vendor ? vendor : "") + "|" + (renderer ? renderer : "") + "|" + (version ? version : "");
+
+        std::error_code ec;
+        std::filesystem::create_directories(SHADER_CACHE_DIRECTORY, ec);
+    } else {
+        std::cout << "INFO::SHADER_MANAGER::Program binaries not supported by driver, shader cache disabled" << std::endl;
+    }
+    return binaryCacheSupport == 1;
+}
+
+uint64_t ShaderManager::computeBinaryCacheKey(const std::string& vertexCode, const std::string& fragmentCode) {
+    uint64_t key = fnv1a64(vertexCode);
+    key = fnv1a64("\0", 1, key);
+    key = fnv1a64(fragmentCode, key);
+    key = fnv1a64("\0", 1, key);
+    key = fnv1a64(driverIdentity, key);
+    return key;
+}
+
+std::string ShaderManager::getBinaryCachePath(const std::string& name) const {
+    return std::string(SHADER_CACHE_DIRECTORY) + "/" + name + ".bin";
+}
+
+GLuint ShaderManager::loadProgramFromBinaryCache(const std::string& name, uint64_t cacheKey) {
+    auto loadStart = std::chrono::steady_clock::now();
+
+    std::ifstream file(getBinaryCachePath(name), std::ios::binary);
+    if (!file.is_open()) {
+        return 0;
+    }
+
+    ProgramCacheHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != PROGRAM_CACHE_MAGIC || header.version != PROGRAM_CACHE_VERSION) {
+        std::cout << "INFO::SHADER_MANAGER::Program binary cache entry for '" << name << "' is invalid, recompiling" << std::endl;
+        return 0;
+    }
+    if (header.cacheKey != cacheKey) {
+        std::cout << "INFO::SHADER_MANAGER::Program binary cache entry for '" << name
+                  << "' is stale (source or driver changed), recompiling" << std::endl;
+        return 0;
+    }
+
+    // Długość z nagłówka musi zmieścić się w pozostałej części pliku - uszkodzony wpis
+    // nie może wymusić ogromnej alokacji ani podać sterownikowi niepełnej binarki
+    const std::streamoff dataStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::streamoff remaining = file.tellg() - dataStart;
+    file.seekg(dataStart);
+    if (dataStart < 0 || header.binaryLength == 0 || static_cast<std::streamoff>(header.binaryLength) > remaining) {
+        std::cout << "INFO::SHADER_MANAGER::Program binary cache entry for '" << name << "' is truncated, recompiling" << std::endl;
+        return 0;
+    }
+
+    std::vector<char> binary(header.binaryLength);
+    if (!file.read(binary.data(), static_cast<std::streamsize>(binary.size()))) {
+        std::cout << "INFO::SHADER_MANAGER::Program binary cache entry for '" << name << "' is truncated, recompiling" << std::endl;
+        return 0;
+    }
+
+    GLuint programID = glCreateProgram();
+    glProgramBinary(programID, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    // Sterownik może odrzucić binarkę (np. po aktualizacji) - wtedy kompilujemy ze źródeł
+    GLint success = GL_FALSE;
+    glGetProgramiv(programID, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(programID);
+        std::cout << "INFO::SHADER_MANAGER::Program binary for '" << name << "' rejected by driver, recompiling" << std::endl;
+        return 0;
+    }
+
+    double loadMilliseconds = millisecondsSince(loadStart);
+    std::cout << "INFO::SHADER_MANAGER::Program binary cache hit for '" << name << "' (loaded in "
+              << loadMilliseconds << " ms, saved ~" << (header.compileMilliseconds - loadMilliseconds) << " ms)" << std::endl;
+    return programID;
+}
+
+void ShaderManager::saveProgramToBinaryCache(const std::string& name, GLuint programID, uint64_t cacheKey, double compileMilliseconds) {
+    GLint binaryLength = 0;
+    glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (binaryLength <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(binaryLength);
+    GLenum binaryFormat = 0;
+    GLsizei writtenLength = 0;
+    glGetProgramBinary(programID, binaryLength, &writtenLength, &binaryFormat, binary.data());
+    if (writtenLength <= 0) {
+        return;
+    }
+
+    std::string cachePath = getBinaryCachePath(name);
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "WARNING::SHADER_MANAGER::Could not write program binary cache: " << cachePath << std::endl;
+            return;
+        }
+        ProgramCacheHeader header{PROGRAM_CACHE_MAGIC, PROGRAM_CACHE_VERSION, cacheKey,
+                                  static_cast<uint32_t>(binaryFormat), static_cast<uint32_t>(writtenLength), compileMilliseconds};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), writtenLength);
+        if (!file) {
+            std::cerr << "WARNING::SHADER_MANAGER::Could not write program binary cache: " << cachePath << std::endl;
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cachePath, ec);
+}
@@ -4,6 +4,7 @@
 #include <string>
 #include <map>
 #include <vector> 
+#include <cstdint>
 
 class ShaderManager {
 public:
@@ -11,8 +12,11 @@ public:
     ~ShaderManager();
 
     // Wczytuje shadery z plików, kompiluje, linkuje i przechowuje pod daną nazwą.
+    // Jeśli sterownik to wspiera, program jest odtwarzany z binarnego cache'u na dysku.
+    // defines są wstawiane jako "#define X" zaraz po dyrektywie #version (warianty tego samego shadera).
     // Zwraca ID programu shaderowego lub 0 w przypadku błędu.
-    GLuint loadShaderProgram(const std::string& name, const char* vertexPath, const char* fragmentPath);
+    GLuint loadShaderProgram(const std::string& name, const char* vertexPath, const char* fragmentPath,
+                             const std::vector<std::string>& defines = {});
 
     // Pobiera ID zapisanego programu shaderowego. Zwraca 0 jeśli nie znaleziono.
     GLuint getShaderProgram(const std::string& name) const;
@@ -26,10 +30,26 @@ public:
     GLint getUniformLocation(GLuint programID, const char* uniformName);
     GLint getUniformLocation(const std::string& programName, const char* uniformName);
 
+    // Przypina blok uniformów programu do danego punktu wiązania (GLSL 330 nie ma layout(binding))
+    bool bindUniformBlock(GLuint programID, const char* blockName, GLuint bindingPoint);
+
 private:
     std::string loadShaderSourceFromFile(const char* filePath);
+    static std::string injectDefines(const std::string& source, const std::vector<std::string>& defines);
     GLuint compileShader(GLenum type, const char* source, const std::string& shaderNameForLogging = "");
     bool linkProgram(GLuint programID, GLuint vertexShaderID, GLuint fragmentShaderID);
 
+    // Cache binarnych programów (glGetProgramBinary/glProgramBinary).
+    // Klucz to hash źródeł shaderów oraz napisów GL_VENDOR/GL_RENDERER/GL_VERSION,
+    // więc zmiana shadera lub sterownika unieważnia wpis i wymusza kompilację ze źródeł.
+    bool isBinaryCacheSupported();
+    uint64_t computeBinaryCacheKey(const std::string& vertexCode, const std::string& fragmentCode);
+    std::string getBinaryCachePath(const std::string& name) const;
+    GLuint loadProgramFromBinaryCache(const std::string& name, uint64_t cacheKey);
+    void saveProgramToBinaryCache(const std::string& name, GLuint programID, uint64_t cacheKey, double compileMilliseconds);
+
     std::map<std::string, GLuint> shaderPrograms;
+
+    int binaryCacheSupport; // -1 = jeszcze nie sprawdzono
+    std::string driverIdentity;
 };
\ No newline at end of file
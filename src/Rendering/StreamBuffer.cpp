@@ -0,0 +1,65 @@
+#include "StreamBuffer.h"
+#include "GpuMemory.h"
+
+#include <cstring>
+#include <iostream>
+
+StreamBuffer::StreamBuffer() : target(GL_ARRAY_BUFFER), bufferID(0), capacity(0) {}
+
+StreamBuffer::~StreamBuffer() {
+    destroy();
+}
+
+void StreamBuffer::create(GLenum bufferTarget, size_t initialCapacity) {
+    destroy();
+    target = bufferTarget;
+    capacity = initialCapacity;
+
+    glGenBuffers(1, &bufferID);
+    glBindBuffer(target, bufferID);
+    glBufferData(target, capacity, nullptr, GL_STREAM_DRAW);
+    trackGpuObject(GpuObjectKind::Buffer, bufferID, capacity);
+    glBindBuffer(target, 0);
+}
+
+void StreamBuffer::destroy() {
+    if (bufferID != 0) {
+        untrackGpuObject(GpuObjectKind::Buffer, bufferID);
+        glDeleteBuffers(1, &bufferID);
+        bufferID = 0;
+    }
+    capacity = 0;
+}
+
+void StreamBuffer::upload(const void* data, size_t size) {
+    if (bufferID == 0 || size == 0) return;
+
+    glBindBuffer(target, bufferID);
+    if (size > capacity) {
+        // Zapas, żeby rosnąca kolonia nie realokowała bufora co klatkę
+        capacity = size + size / 2;
+    }
+    // Osierocenie poprzedniej zawartości
+    glBufferData(target, capacity, nullptr, GL_STREAM_DRAW);
+    trackGpuObject(GpuObjectKind::Buffer, bufferID, capacity);
+
+    void* mapped = glMapBufferRange(target, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (mapped) {
+        std::memcpy(mapped, data, size);
+        glUnmapBuffer(target);
+    } else {
+        std::cerr << "StreamBuffer: Nie udało się zmapować bufora, wysyłanie przez glBufferSubData." << std::endl;
+        glBufferSubData(target, 0, size, data);
+    }
+    glBindBuffer(target, 0);
+}
+
+bool StreamBuffer::update(size_t offset, const void* data, size_t size) {
+    if (bufferID == 0 || offset + size > capacity) return false;
+    if (size == 0) return true;
+
+    glBindBuffer(target, bufferID);
+    glBufferSubData(target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+    glBindBuffer(target, 0);
+    return true;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+
+// Bufor GL przeznaczony do danych wysyłanych co klatkę.
+// Każde upload() osiera poprzednią zawartość (glBufferData z nullptr + mapowanie z INVALIDATE),
+// więc CPU nie czeka, aż GPU skończy czytać dane z poprzedniej klatki.
+class StreamBuffer {
+public:
+    StreamBuffer();
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    void create(GLenum target, size_t initialCapacity);
+    void destroy();
+
+    // Wysyła dane do bufora; powiększa go, jeśli się nie mieszczą
+    void upload(const void* data, size_t size);
+    // Nadpisuje fragment bez osierocania reszty; false, gdy wykracza poza pojemność
+    bool update(size_t offset, const void* data, size_t size);
+
+    GLuint getID() const { return bufferID; }
+    size_t getCapacity() const { return capacity; }
+
+private:
+    GLenum target;
+    GLuint bufferID;
+    size_t capacity;
+};
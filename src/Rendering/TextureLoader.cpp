@@ -1,44 +1,304 @@
 #define STB_IMAGE_IMPLEMENTATION 
 #include "stb_image.h"     
 #include "TextureLoader.h" 
+#include "Utils/Hash.h"
+#include "GpuMemory.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+const char* TextureLoader::CACHE_DIRECTORY = "cache/textures";
+
+namespace {
+    // Nagłówek pliku z łańcuchem mipmap w cache'u
+    const uint32_t MIP_CACHE_MAGIC = 0x434D4450; // "PDMC"
+    const uint32_t MIP_CACHE_VERSION = 1;
+    // Największy bok tekstury przyjmowany z pamięci podręcznej - ogranicza rozmiar łańcucha
+    const int32_t MAX_CACHED_TEXTURE_SIZE = 16384;
+
+    struct MipCacheHeader {
+        uint32_t magic;
+        uint32_t version;
+        int32_t channels;
+        int32_t levelCount;
+    };
+
+    GLenum formatForChannels(int channels) {
+        if (channels == 1) return GL_RED;
+        if (channels == 4) return GL_RGBA;
+        return GL_RGB;
+    }
+}
+
+TextureLoader::TextureLoader(size_t workerCount) : pendingCount(0), workers(workerCount) {}
+
+TextureLoader::~TextureLoader() {}
 
 GLuint TextureLoader::loadTexture(const char* filename) {
     GLuint textureID;
     glGenTextures(1, &textureID);
+    if (textureID == 0) {
+        std::cerr << "ERROR::TEXTURE_LOADER::Failed to create texture object for: " << filename << std::endl;
+        return 0;
+    }
     glBindTexture(GL_TEXTURE_2D, textureID);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    // Placeholder nie ma mipmap, więc do czasu wysłania danych filtrujemy bez nich
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    int width, height, nrChannels;
-
-    stbi_set_flip_vertically_on_load(true); 
-    unsigned char *data = stbi_load(filename, &width, &height, &nrChannels, 0);
-    
-    if (data) {
-        GLenum format = GL_RGB;
-        if (nrChannels == 1)
-            format = GL_RED;
-        else if (nrChannels == 3)
-            format = GL_RGB;
-        else if (nrChannels == 4)
-            format = GL_RGBA;
-
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        std::cout << "INFO::TEXTURE_LOADER::Loaded texture: " << filename << std::endl;
+    // Placeholder 1x1 w neutralnym szarym kolorze
+    const unsigned char placeholder[4] = {128, 128, 128, 255};
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+    trackGpuObject(GpuObjectKind::Texture, textureID, sizeof(placeholder));
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        ++pendingCount;
+    }
+
+    std::string path(filename);
+    workers.submit([this, textureID, path]() {
+        auto texture = std::make_unique<DecodedTexture>();
+        texture->textureID = textureID;
+        texture->filename = path;
+        decodeTexture(*texture);
+
+        std::lock_guard<std::mutex> lock(completedMutex);
+        completedTextures.push_back(std::move(texture));
+    });
+
+    return textureID;
+}
+
+void TextureLoader::processPendingUploads() {
+    std::vector<std::unique_ptr<DecodedTexture>> ready;
+    {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        if (completedTextures.empty()) return;
+        ready.swap(completedTextures);
+        pendingCount -= ready.size();
+    }
+
+    for (const auto& texture : ready) {
+        if (texture->failed) {
+            // Tekstura zostaje z placeholderem
+            continue;
+        }
+        uploadTexture(*texture);
+    }
+}
+
+size_t TextureLoader::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(completedMutex);
+    return pendingCount;
+}
+
+// Wykonywane na wątku roboczym: cache na dysku albo dekodowanie JPEG + generowanie mipmap
+void TextureLoader::decodeTexture(DecodedTexture& texture) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::ifstream file(texture.filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "ERROR::TEXTURE_LOADER::Failed to load texture: " << texture.filename << std::endl;
+        texture.failed = true;
+        return;
+    }
+    TrackedVector<unsigned char, MemoryTag::Assets> fileBytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    // Klucz cache'u: zawartość pliku źródłowego + wersja formatu (zmiana formatu unieważnia wpisy)
+    uint64_t sourceHash = fnv1a64(fileBytes.data(), fileBytes.size());
+    sourceHash = fnv1a64(&MIP_CACHE_VERSION, sizeof(MIP_CACHE_VERSION), sourceHash);
+    std::string cachePath = std::string(CACHE_DIRECTORY) + "/" + hashToHex(sourceHash) + ".mip";
+
+    if (readCachedMipChain(cachePath, texture)) {
+        texture.fromCache = true;
     } else {
-        std::cerr << "ERROR::TEXTURE_LOADER::Failed to load texture: " << filename << std::endl;
-        std::cerr << "STB_IMAGE Error: " << stbi_failure_reason() << std::endl;
-        stbi_image_free(data); 
-        glDeleteTextures(1, &textureID); 
-        return 0;
+        int width, height, nrChannels;
+        stbi_set_flip_vertically_on_load_thread(true);
+        unsigned char* data = stbi_load_from_memory(fileBytes.data(), static_cast<int>(fileBytes.size()),
+                                                    &width, &height, &nrChannels, 0);
+        if (!data) {
+            std::cerr << "ERROR::TEXTURE_LOADER::Failed to load texture: " << texture.filename << std::endl;
+            std::cerr << "STB_IMAGE Error: " << stbi_failure_reason() << std::endl;
+            texture.failed = true;
+            return;
+        }
+        texture.channels = nrChannels;
+        buildMipChain(data, width, height, texture);
+        stbi_image_free(data);
+
+        writeCachedMipChain(cachePath, texture);
     }
-    
-    stbi_image_free(data);
+
+    texture.decodeMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+// Generowanie łańcucha mipmap filtrem pudełkowym 2x2 (odpowiednik glGenerateMipmap na CPU)
+void TextureLoader::buildMipChain(const unsigned char* base, int width, int height, DecodedTexture& texture) {
+    const int channels = texture.channels;
+
+    size_t totalSize = 0;
+    for (int w = width, h = height; ; w = std::max(1, w / 2), h = std::max(1, h / 2)) {
+        size_t levelSize = static_cast<size_t>(w) * h * channels;
+        texture.levels.push_back({w, h, totalSize, levelSize});
+        totalSize += levelSize;
+        if (w == 1 && h == 1) break;
+    }
+
+    texture.pixels.resize(totalSize);
+    std::memcpy(texture.pixels.data(), base, texture.levels[0].size);
+
+    for (size_t level = 1; level < texture.levels.size(); ++level) {
+        const MipLevel& src = texture.levels[level - 1];
+        const MipLevel& dst = texture.levels[level];
+        const unsigned char* srcPixels = texture.pixels.data() + src.offset;
+        unsigned char* dstPixels = texture.pixels.data() + dst.offset;
+
+        for (int y = 0; y < dst.height; ++y) {
+            int y0 = std::min(y * 2, src.height - 1);
+            int y1 = std::min(y * 2 + 1, src.height - 1);
+            for (int x = 0; x < dst.width; ++x) {
+                int x0 = std::min(x * 2, src.width - 1);
+                int x1 = std::min(x * 2 + 1, src.width - 1);
+                for (int c = 0; c < channels; ++c) {
+                    int sum = srcPixels[(y0 * src.width + x0) * channels + c]
+                            + srcPixels[(y0 * src.width + x1) * channels + c]
+                            + srcPixels[(y1 * src.width + x0) * channels + c]
+                            + srcPixels[(y1 * src.width + x1) * channels + c];
+                    dstPixels[(y * dst.width + x) * channels + c] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+    }
+}
+
+bool TextureLoader::readCachedMipChain(const std::string& cachePath, DecodedTexture& texture) {
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    MipCacheHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (header.magic != MIP_CACHE_MAGIC || header.version != MIP_CACHE_VERSION ||
+        header.levelCount <= 0 || header.levelCount > 32 || header.channels <= 0 || header.channels > 4) {
+        return false;
+    }
+
+    // Wymiary z pliku: poziom 0 nie większy niż MAX_CACHED_TEXTURE_SIZE, każdy kolejny to połowa
+    // poprzedniego (jak w buildMipChain) - wtedy suma rozmiarów nie może się przepełnić
+    std::vector<MipLevel> levels;
+    size_t totalSize = 0;
+    for (int i = 0; i < header.levelCount; ++i) {
+        int32_t dims[2];
+        if (!file.read(reinterpret_cast<char*>(dims), sizeof(dims))) return false;
+        if (i == 0) {
+            if (dims[0] <= 0 || dims[1] <= 0 || dims[0] > MAX_CACHED_TEXTURE_SIZE || dims[1] > MAX_CACHED_TEXTURE_SIZE) return false;
+        } else if (dims[0] != std::max(1, levels.back().width / 2) || dims[1] != std::max(1, levels.back().height / 2)) {
+            return false;
+        }
+        size_t levelSize = static_cast<size_t>(dims[0]) * dims[1] * header.channels;
+        levels.push_back({dims[0], dims[1], totalSize, levelSize});
+        totalSize += levelSize;
+    }
+
+    // Piksele muszą zmieścić się w pozostałej części pliku - uszkodzony wpis nie może wymusić
+    // ogromnej alokacji na wątku dekodującym
+    const std::streamoff dataStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::streamoff remaining = file.tellg() - dataStart;
+    file.seekg(dataStart);
+    if (dataStart < 0 || static_cast<std::streamoff>(totalSize) > remaining) {
+        std::cout << "INFO::TEXTURE_LOADER::Texture cache entry " << cachePath << " is truncated, decoding the source" << std::endl;
+        return false;
+    }
+
+    TrackedVector<unsigned char, MemoryTag::Assets> pixels(totalSize);
+    if (!file.read(reinterpret_cast<char*>(pixels.data()), static_cast<std::streamsize>(totalSize))) return false;
+
+    texture.channels = header.channels;
+    texture.levels = std::move(levels);
+    texture.pixels = std::move(pixels);
+    return true;
+}
+
+void TextureLoader::writeCachedMipChain(const std::string& cachePath, const DecodedTexture& texture) {
+    std::error_code ec;
+    std::filesystem::create_directories(CACHE_DIRECTORY, ec);
+
+    // Zapis do pliku tymczasowego i podmiana, żeby przerwany zapis nie zostawił uszkodzonego wpisu
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "WARNING::TEXTURE_LOADER::Could not write texture cache: " << cachePath << std::endl;
+            return;
+        }
+        MipCacheHeader header{MIP_CACHE_MAGIC, MIP_CACHE_VERSION, texture.channels, static_cast<int32_t>(texture.levels.size())};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& level : texture.levels) {
+            int32_t dims[2] = {level.width, level.height};
+            file.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+        }
+        file.write(reinterpret_cast<const char*>(texture.pixels.data()), static_cast<std::streamsize>(texture.pixels.size()));
+        if (!file) {
+            std::cerr << "WARNING::TEXTURE_LOADER::Could not write texture cache: " << cachePath << std::endl;
+            return;
+        }
+    }
+    std::filesystem::rename(tempPath, cachePath, ec);
+}
+
+// Wysłanie całego łańcucha mipmap przez PBO - kopiowanie do sterownika odbywa się asynchronicznie
+void TextureLoader::uploadTexture(const DecodedTexture& texture) {
+    GLuint pbo;
+    glGenBuffers(1, &pbo);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, texture.pixels.size(), nullptr, GL_STREAM_DRAW);
+    trackGpuObject(GpuObjectKind::Buffer, pbo, texture.pixels.size());
+
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, texture.pixels.size(),
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!mapped) {
+        std::cerr << "ERROR::TEXTURE_LOADER::Failed to map PBO for: " << texture.filename << std::endl;
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        untrackGpuObject(GpuObjectKind::Buffer, pbo);
+        glDeleteBuffers(1, &pbo);
+        return;
+    }
+    std::memcpy(mapped, texture.pixels.data(), texture.pixels.size());
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    GLenum format = formatForChannels(texture.channels);
+    glBindTexture(GL_TEXTURE_2D, texture.textureID);
+    // Wiersze mniejszych mipmap RGB nie są wyrównane do 4 bajtów
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (size_t level = 0; level < texture.levels.size(); ++level) {
+        const MipLevel& mip = texture.levels[level];
+        glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), format, mip.width, mip.height, 0,
+                     format, GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(mip.offset));
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(texture.levels.size() - 1));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glBindTexture(GL_TEXTURE_2D, 0);
-    
-    return textureID;
+    // Placeholder zastąpiony pełnym łańcuchem mipmap
+    trackGpuObject(GpuObjectKind::Texture, texture.textureID, texture.pixels.size());
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    // Sterownik trzyma bufor przy życiu aż do zakończenia transferu
+    untrackGpuObject(GpuObjectKind::Buffer, pbo);
+    glDeleteBuffers(1, &pbo);
+
+    std::cout << "INFO::TEXTURE_LOADER::Loaded texture: " << texture.filename
+              << (texture.fromCache ? " (from mip cache, " : " (decoded, ")
+              << texture.decodeMilliseconds << " ms on worker)" << std::endl;
 }
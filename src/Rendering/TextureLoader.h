@@ -5,8 +5,67 @@
 #include <map>
 #include <vector> 
 #include <iostream>
+#include <mutex>
+#include <memory>
+#include <cstdint>
 
+#include "Utils/ThreadPool.h"
+#include "Utils/MemoryTracker.h"
+
+// Jeden poziom mipmapy w zdekodowanym łańcuchu
+struct MipLevel {
+    int width;
+    int height;
+    size_t offset; // Przesunięcie w buforze pikseli
+    size_t size;
+};
+
+// Zdekodowana tekstura z pełnym łańcuchem mipmap, przygotowana na wątku roboczym
+struct DecodedTexture {
+    GLuint textureID = 0;
+    std::string filename;
+    int channels = 0;
+    bool fromCache = false;
+    bool failed = false;
+    double decodeMilliseconds = 0.0;
+    std::vector<MipLevel> levels;
+    TrackedVector<unsigned char, MemoryTag::Assets> pixels;
+};
+
+// Ładowanie tekstur w tle: dekodowanie JPEG i generowanie mipmap odbywa się na puli wątków,
+// a gotowe dane są wysyłane do GPU przez PBO w processPendingUploads() na wątku z kontekstem GL.
+// Zdekodowane łańcuchy mipmap są zapisywane na dysku (klucz = hash pliku źródłowego),
+// dzięki czemu kolejne uruchomienia pomijają dekodowanie i generowanie mipmap.
 class TextureLoader {
 public:
-    static GLuint loadTexture(const char* filename);
-};
\ No newline at end of file
+    explicit TextureLoader(size_t workerCount = 2);
+    ~TextureLoader();
+
+    // Zwraca od razu uchwyt tekstury z podpiętym placeholderem 1x1.
+    // Docelowe dane zostaną podmienione, gdy tylko będą gotowe. Zwraca 0 tylko przy błędzie GL.
+    GLuint loadTexture(const char* filename);
+
+    // Wysyła do GPU wszystkie tekstury zdekodowane od poprzedniego wywołania.
+    // Musi być wywoływane na wątku, który ma aktywny kontekst OpenGL.
+    void processPendingUploads();
+
+    // Liczba tekstur, które wciąż czekają na dekodowanie lub wysłanie
+    size_t getPendingCount() const;
+
+    static const char* CACHE_DIRECTORY;
+
+private:
+    static void decodeTexture(DecodedTexture& texture);
+    static bool readCachedMipChain(const std::string& cachePath, DecodedTexture& texture);
+    static void writeCachedMipChain(const std::string& cachePath, const DecodedTexture& texture);
+    static void buildMipChain(const unsigned char* base, int width, int height, DecodedTexture& texture);
+    void uploadTexture(const DecodedTexture& texture);
+
+    mutable std::mutex completedMutex;
+    std::vector<std::unique_ptr<DecodedTexture>> completedTextures;
+    size_t pendingCount;
+
+    // Ostatnie pole: niszczone jako pierwsze, więc zaległe zadania dekodowania kończą się,
+    // zanim znikną completedMutex i completedTextures, do których zapisują
+    ThreadPool workers;
+};
@@ -5,7 +5,17 @@ layout (location = 0) in vec2 a_vertexPosition;
 
 // Uniformy
 uniform mat4 u_modelMatrix;             // Macierz modelu dla pozycji i skali efektu antybiotyku
-uniform mat4 u_viewProjectionMatrix;    // Macierz widoku-projekcji
+
+// Wspólny blok uniformów klatki (std140) - aktualizowany raz na klatkę przez Renderer
+layout (std140) uniform FrameUniforms {
+    mat4 u_viewProjectionMatrix;    // Macierz widoku-projekcji
+    vec3 u_lightPositionWorld;      // Pozycja światła w przestrzeni świata
+    float u_lightRange;             // Zasięg światła
+    vec3 u_lightColor;              // Kolor światła
+    float u_time;                   // Czas globalny
+    vec3 u_ambientColor;            // Kolor otoczenia
+    vec3 u_cameraPositionWorld;     // Pozycja kamery w przestrzeni świata
+};
 
 void main() {
     gl_Position = u_viewProjectionMatrix * u_modelMatrix * vec4(a_vertexPosition, 0.0, 1.0);
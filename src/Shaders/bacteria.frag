@@ -1,22 +1,88 @@
 #version 330 core
 
+// Warianty (definiowane przez Renderer):
+//   OIT_PASS        - wyjście do buforów przezroczystości niezależnej od kolejności
+//   PATTERN_TEXTURE - wzór odczytywany z wypieczonej tablicy tekstur zamiast liczenia proceduralnego
+//   BAKE_PATTERN    - wypiekanie wzoru: zapis samego współczynnika wzoru dla u_bakeType/u_bakeTime
+//   IMPOSTOR        - bakteria rysowana jednym kwadratem, kształt z funkcji odległości ze znakiem
+// PATTERN_PHASES i PATTERN_EXTENT muszą odpowiadać stałym w Renderer.cpp.
+
 // Wejścia z shadera wierzchołków
+in vec2 v_localPosition; 
+#ifndef BAKE_PATTERN
 in vec3 v_fragWorldPosition;
 in vec3 v_normalWorld;
 in float v_health;
-flat in int v_bacteriaTypeOut; 
-in vec2 v_localPosition; 
-
-// Uniformy
-uniform float u_time;                   // Czas globalny
-uniform vec3 u_lightPositionWorld;      // Pozycja światła w przestrzeni świata
-uniform vec3 u_lightColor;              // Kolor światła
-uniform vec3 u_ambientColor;            // Kolor otoczenia
-uniform float u_lightRange;             // Zasięg światła
+flat in int v_bacteriaPatternOut;
+
+uniform vec3 u_bacteriaColor; // Kolor bazowy gatunku z rejestru
+#endif
+
+// Wspólny blok uniformów klatki (std140) - aktualizowany raz na klatkę przez Renderer
+layout (std140) uniform FrameUniforms {
+    mat4 u_viewProjectionMatrix;    // Macierz widoku-projekcji
+    vec3 u_lightPositionWorld;      // Pozycja światła w przestrzeni świata
+    float u_lightRange;             // Zasięg światła
+    vec3 u_lightColor;              // Kolor światła
+    float u_time;                   // Czas globalny
+    vec3 u_ambientColor;            // Kolor otoczenia
+    vec3 u_cameraPositionWorld;     // Pozycja kamery w przestrzeni świata
+};
+
+#ifdef BAKE_PATTERN
+uniform int u_bakeType;     // Styl wzoru wypiekanej warstwy
+uniform float u_bakeTime;   // Faza animacji wypiekanej warstwy
+#endif
+
+#ifdef PATTERN_TEXTURE
+uniform sampler2DArray u_patternTexture; // Warstwa = styl * PATTERN_PHASES + faza
+#endif
 
 // Wyjście shadera
+#ifdef OIT_PASS
+// Przebieg przezroczystości niezależnej od kolejności (weighted blended OIT)
+layout (location = 0) out vec4 out_Accumulation;
+layout (location = 1) out float out_Revealage;
+
+// Waga zależna od krycia i głębokości (McGuire & Bavoil 2013, wariant z gl_FragCoord.z)
+void writeTransparent(vec3 color, float alpha) {
+    float weight = clamp(pow(min(1.0, alpha * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - gl_FragCoord.z * 0.9, 3.0), 1e-2, 3e3);
+    out_Accumulation = vec4(color * alpha, alpha) * weight;
+    out_Revealage = alpha;
+}
+#else
 out vec4 out_FragColor;
-
+#endif
+
+#ifdef IMPOSTOR
+// Odległość ze znakiem od obrysu stylu (ujemna wewnątrz) w lokalnych współrzędnych obrysu
+float bacteriaSdf(int pattern, vec2 p) {
+    if (pattern == 0) { // Cocci: okrąg
+        return length(p) - 1.0;
+    } else if (pattern == 1) { // Diplococcus: dwa stykające się płaty
+        return min(length(p - vec2(-0.7, 0.0)), length(p - vec2(0.7, 0.0))) - 0.9;
+    } else if (pattern == 2) { // Staphylococci: nieregularna plama
+        float angle = atan(p.y, p.x);
+        float radius = 1.25 + 0.2 * sin(3.0 * angle + 0.5) + 0.1 * cos(5.0 * angle);
+        return length(p) - radius;
+    } else if (pattern == 3) { // Bacillus: kapsuła
+        return length(vec2(max(abs(p.x) - 0.9, 0.0), p.y)) - 0.6;
+    }
+    vec2 d = abs(p) - vec2(0.5); // Domyślnie kwadrat
+    return length(max(d, 0.0)) + min(max(d.x, d.y), 0.0);
+}
+#endif
+
+#ifdef PATTERN_TEXTURE
+// Jeden odczyt z wypieczonej tablicy - najbliższa faza animacji
+float patternFactor(int pattern, vec2 localPosition, float time) {
+    if (pattern < 0 || pattern > 3) return 1.0;
+    float phase = mod(floor(fract(time / 6.28318530718) * float(PATTERN_PHASES) + 0.5), float(PATTERN_PHASES));
+    float layer = float(pattern * PATTERN_PHASES) + phase;
+    vec2 uv = localPosition / (2.0 * PATTERN_EXTENT) + 0.5;
+    return texture(u_patternTexture, vec3(uv, layer)).r;
+}
+#else
 // Funkcja do generowania prostego szumu proceduralnego
 float random(vec2 st) {
     return fract(sin(dot(st.xy, vec2(12.9898, 78.233))) * 43758.5453123);
@@ -33,54 +99,66 @@ float noise(vec2 st, float scale) {
     return mix(mix(a, b, u.x), mix(c, d, u.x), u.y);
 }
 
-void main() {
-    vec3 patternedBaseColor;
-
-    if (v_bacteriaTypeOut == 0) { // Cocci
-        patternedBaseColor = vec3(0.9, 0.4, 0.4);
-        float dist_from_local_center = length(v_localPosition);
-        float localProceduralPattern = (sin(dist_from_local_center * 5.0 - u_time * 2.0) + 1.0) / 2.0;
-        patternedBaseColor = mix(patternedBaseColor * 0.7, patternedBaseColor * 1.1, localProceduralPattern);
-   
-    } else if (v_bacteriaTypeOut == 1) { // Diplococcus
-        patternedBaseColor = vec3(0.4, 0.9, 0.4);
+// Proceduralny wzór jako mnożnik koloru bazowego. Wszystkie animacje mają okres 2*PI,
+// dzięki czemu wzór da się wypiec do skończonej liczby faz.
+float patternFactor(int pattern, vec2 localPosition, float time) {
+    if (pattern == 0) { // Cocci
+        float dist_from_local_center = length(localPosition);
+        float localProceduralPattern = (sin(dist_from_local_center * 5.0 - time * 2.0) + 1.0) / 2.0;
+        return mix(0.7, 1.1, localProceduralPattern);
+
+    } else if (pattern == 1) { // Diplococcus
         float lobeIntensity = 0.0;
 
-        float distLobe1 = length(v_localPosition - vec2(-0.5, 0.0)); 
+        float distLobe1 = length(localPosition - vec2(-0.5, 0.0)); 
         lobeIntensity = max(lobeIntensity, 1.0 - smoothstep(0.0, 0.5, distLobe1)); 
-        float distLobe2 = length(v_localPosition - vec2(0.5, 0.0));  
+        float distLobe2 = length(localPosition - vec2(0.5, 0.0));  
 
         lobeIntensity = max(lobeIntensity, 1.0 - smoothstep(0.0, 0.5, distLobe2));
         
-        float pulse = (sin(u_time + v_localPosition.x * 2.0) + 1.0) / 2.0;
-        patternedBaseColor *= (0.6 + 0.4 * lobeIntensity * pulse);
+        float pulse = (sin(time + localPosition.x * 2.0) + 1.0) / 2.0;
+        return 0.6 + 0.4 * lobeIntensity * pulse;
 
-    } else if (v_bacteriaTypeOut == 2) { // Staphylococci
-        patternedBaseColor = vec3(0.4, 0.4, 0.9);
-        float spots = noise(v_localPosition, 8.0 + sin(u_time)*2.0);
+    } else if (pattern == 2) { // Staphylococci
+        float spots = noise(localPosition, 8.0 + sin(time)*2.0);
         spots = pow(spots, 3.0) * 1.5;
-        patternedBaseColor = mix(patternedBaseColor * 0.6, patternedBaseColor * 1.2, spots);
+        return mix(0.6, 1.2, spots);
 
-    } else if (v_bacteriaTypeOut == 3) { //Bacillus
-        patternedBaseColor = vec3(0.8, 0.6, 0.2);
-        float localProceduralPattern = (cos(v_localPosition.x * 15.0 + u_time) + 1.0) / 2.0;
-        patternedBaseColor = mix(patternedBaseColor * 0.7, patternedBaseColor * 1.0, localProceduralPattern);
+    } else if (pattern == 3) { //Bacillus
+        float localProceduralPattern = (cos(localPosition.x * 15.0 + time) + 1.0) / 2.0;
+        float factor = mix(0.7, 1.0, localProceduralPattern);
     
-        float edgeFactorX = 1.0 - pow(abs(v_localPosition.x / 1.5), 4.0); 
-        float edgeFactorY = 1.0 - pow(abs(v_localPosition.y / 0.4), 4.0); 
+        float edgeFactorX = 1.0 - pow(abs(localPosition.x / 1.5), 4.0); 
+        float edgeFactorY = 1.0 - pow(abs(localPosition.y / 0.4), 4.0); 
         float edgeFactor = clamp(edgeFactorX * edgeFactorY, 0.0, 1.0);
 
-        float pulse = (sin(u_time + v_localPosition.x * 2.0) + 1.0) / 2.0;
-        patternedBaseColor *= (0.5 + 0.5 * edgeFactor * pulse);
-
-    } else {
-        patternedBaseColor = vec3(0.7, 0.7, 0.7); 
+        float pulse = (sin(time + localPosition.x * 2.0) + 1.0) / 2.0;
+        return factor * (0.5 + 0.5 * edgeFactor * pulse);
     }
+    return 1.0;
+}
+#endif
+
+void main() {
+#ifdef BAKE_PATTERN
+    out_FragColor = vec4(patternFactor(u_bakeType, v_localPosition, u_bakeTime), 0.0, 0.0, 1.0);
+#else
+#ifdef IMPOSTOR
+    // Analityczny antyaliasing: pokrycie piksela z odległości i jej pochodnej ekranowej
+    float signedDistance = bacteriaSdf(v_bacteriaPatternOut, v_localPosition);
+    float coverage = clamp(0.5 - signedDistance / max(fwidth(signedDistance), 1e-5), 0.0, 1.0);
+    if (coverage <= 0.0) discard;
+#endif
+
+    vec3 patternedBaseColor = u_bacteriaColor * patternFactor(v_bacteriaPatternOut, v_localPosition, u_time);
 
     // Kolor w zależności od zdrowia
     vec3 objectColor = patternedBaseColor * (0.3 + 0.7 * v_health);
     float alpha = (v_health > 0.05) ? (0.2 + v_health * 0.8) : (v_health / 0.05 * 0.3);
     alpha = clamp(alpha, 0.0, 1.0);
+#ifdef IMPOSTOR
+    alpha *= coverage;
+#endif
 
     // Obliczanie oświetlenia
     vec3 norm = normalize(v_normalWorld);
@@ -102,5 +180,10 @@ void main() {
 
     vec3 finalLitColor = (ambient + diffuse) * attenuation;
     
+#ifdef OIT_PASS
+    writeTransparent(finalLitColor, alpha);
+#else
     out_FragColor = vec4(finalLitColor, alpha);
+#endif
+#endif
 }
@@ -4,18 +4,27 @@
 layout (location = 0) in vec2 a_vertexLocalPosition; // Lokalna pozycja wierzchołka modelu bakterii
 
 // Uniformy
-uniform mat4 u_viewProjectionMatrix;    // Macierz widoku-projekcji
 uniform vec3 u_instanceWorldPosition;   // Pozycja instancji bakterii w świecie (X, Y, Z-index) // ZMIENIONO na vec3
 uniform float u_instanceScale;          // Skala instancji bakterii
 uniform float u_bacteriaHealth;         // Kondycja bakterii 
-uniform int u_bacteriaType;             // Typ bakterii 
-uniform float u_time;                   // Czas globalny dla animacji
+uniform int u_bacteriaPattern;          // Styl wzoru gatunku (SpeciesPattern)
+
+// Wspólny blok uniformów klatki (std140) - aktualizowany raz na klatkę przez Renderer
+layout (std140) uniform FrameUniforms {
+    mat4 u_viewProjectionMatrix;    // Macierz widoku-projekcji
+    vec3 u_lightPositionWorld;      // Pozycja światła w przestrzeni świata
+    float u_lightRange;             // Zasięg światła
+    vec3 u_lightColor;              // Kolor światła
+    float u_time;                   // Czas globalny
+    vec3 u_ambientColor;            // Kolor otoczenia
+    vec3 u_cameraPositionWorld;     // Pozycja kamery w przestrzeni świata
+};
 
 // Wyjścia do shadera fragmentów
 out vec3 v_fragWorldPosition; 
 out vec3 v_normalWorld;         
 out float v_health;
-flat out int v_bacteriaTypeOut; 
+flat out int v_bacteriaPatternOut;
 out vec2 v_localPosition; 
 
 void main() {
@@ -32,6 +41,6 @@ void main() {
     v_fragWorldPosition = worldPosWithZ; 
     v_normalWorld = vec3(0.0, 0.0, 1.0); 
     v_health = u_bacteriaHealth;
-    v_bacteriaTypeOut = u_bacteriaType;
+    v_bacteriaPatternOut = u_bacteriaPattern;
     v_localPosition = a_vertexLocalPosition;
 }
\ No newline at end of file
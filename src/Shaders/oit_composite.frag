@@ -0,0 +1,24 @@
+#version 330 core
+
+in vec2 v_texCoords;
+
+// Bufory przebiegu OIT
+uniform sampler2D u_accumulationTexture;  // Suma ważonych kolorów (rgb) i krycia (a)
+uniform sampler2D u_revealageTexture;     // Iloczyn (1 - alpha) wszystkich warstw
+
+// Wyjście shadera
+out vec4 out_FragColor;
+
+void main() {
+    float revealage = texture(u_revealageTexture, v_texCoords).r;
+    // Piksel bez przezroczystych warstw - nic do złożenia
+    if (revealage >= 1.0) {
+        discard;
+    }
+
+    vec4 accumulation = texture(u_accumulationTexture, v_texCoords);
+    vec3 averageColor = accumulation.rgb / max(accumulation.a, 1e-5);
+
+    // Mieszane z GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA na tle
+    out_FragColor = vec4(averageColor, 1.0 - revealage);
+}
@@ -0,0 +1,10 @@
+#version 330 core
+
+// Pełnoekranowy trójkąt generowany z gl_VertexID - bez bufora wierzchołków
+out vec2 v_texCoords;
+
+void main() {
+    vec2 position = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+    v_texCoords = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
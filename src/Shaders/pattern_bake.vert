@@ -0,0 +1,11 @@
+#version 330 core
+
+// Pełnoekranowy trójkąt pokrywający jedną warstwę tablicy wzorów.
+// Pozycja lokalna obejmuje [-PATTERN_EXTENT, PATTERN_EXTENT] w obu osiach.
+out vec2 v_localPosition;
+
+void main() {
+    vec2 position = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+    v_localPosition = (position * 2.0 - 1.0) * PATTERN_EXTENT;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -1,5 +1,18 @@
 #version 330 core
+#ifdef OIT_PASS
+// Przebieg przezroczystości niezależnej od kolejności (weighted blended OIT)
+layout (location = 0) out vec4 out_Accumulation;
+layout (location = 1) out float out_Revealage;
+
+// Waga zależna od krycia i głębokości (McGuire & Bavoil 2013, wariant z gl_FragCoord.z)
+void writeTransparent(vec3 color, float alpha) {
+    float weight = clamp(pow(min(1.0, alpha * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - gl_FragCoord.z * 0.9, 3.0), 1e-2, 3e3);
+    out_Accumulation = vec4(color * alpha, alpha) * weight;
+    out_Revealage = alpha;
+}
+#else
 out vec4 FragColor;
+#endif
 
 in vec3 v_fragWorldPosition;
 in vec3 v_normalWorld;
@@ -8,11 +21,16 @@ in vec2 v_texCoords;
 uniform vec3 u_objectColor;
 uniform float u_objectAlpha;
 
-uniform vec3 u_lightPosWorld;
-uniform vec3 u_lightColor;
-uniform float u_lightRange; 
-uniform vec3 u_ambientColor;
-uniform vec3 u_cameraPositionWorld;
+// Wspólny blok uniformów klatki (std140) - aktualizowany raz na klatkę przez Renderer
+layout (std140) uniform FrameUniforms {
+    mat4 u_viewProjectionMatrix;    // Macierz widoku-projekcji
+    vec3 u_lightPositionWorld;      // Pozycja światła w przestrzeni świata
+    float u_lightRange;             // Zasięg światła
+    vec3 u_lightColor;              // Kolor światła
+    float u_time;                   // Czas globalny
+    vec3 u_ambientColor;            // Kolor otoczenia
+    vec3 u_cameraPositionWorld;     // Pozycja kamery w przestrzeni świata
+};
 
 uniform sampler2D uTextureSampler; 
 
@@ -22,11 +40,11 @@ void main() {
 
     // Swiatlo  zalezne od kąta padania światła na powierzchnię.
     vec3 norm = normalize(v_normalWorld);
-    vec3 lightDir = normalize(u_lightPosWorld - v_fragWorldPosition);
+    vec3 lightDir = normalize(u_lightPositionWorld - v_fragWorldPosition);
     float diff = max(dot(norm, lightDir), 0.0);
     
     // Tlumienie swiatla wraz z odlegloscia
-    float distanceToLight = length(u_lightPosWorld - v_fragWorldPosition);
+    float distanceToLight = length(u_lightPositionWorld - v_fragWorldPosition);
     float attenuation = 1.0 / (1.0 + 0.01 * distanceToLight + 0.001 * distanceToLight * distanceToLight);
     attenuation = clamp(attenuation, 0.0, 1.0);
     
@@ -48,5 +66,9 @@ void main() {
                                                                   
     vec3 phongColor = ambient * objectBaseColor + diffuse + specular; 
                                                             
+#ifdef OIT_PASS
+    writeTransparent(phongColor, u_objectAlpha);
+#else
     FragColor = vec4(phongColor, u_objectAlpha);
+#endif
 }
\ No newline at end of file
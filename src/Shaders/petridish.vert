@@ -8,9 +8,19 @@ out vec3 v_normalWorld;
 out vec2 v_texCoords;
 
 uniform mat4 u_modelMatrix;
-uniform mat4 u_viewProjectionMatrix;
 uniform mat3 u_normalMatrix;
 
+// Wspólny blok uniformów klatki (std140) - aktualizowany raz na klatkę przez Renderer
+layout (std140) uniform FrameUniforms {
+    mat4 u_viewProjectionMatrix;    // Macierz widoku-projekcji
+    vec3 u_lightPositionWorld;      // Pozycja światła w przestrzeni świata
+    float u_lightRange;             // Zasięg światła
+    vec3 u_lightColor;              // Kolor światła
+    float u_time;                   // Czas globalny
+    vec3 u_ambientColor;            // Kolor otoczenia
+    vec3 u_cameraPositionWorld;     // Pozycja kamery w przestrzeni świata
+};
+
 void main() {
     v_fragWorldPosition = vec3(u_modelMatrix * vec4(a_pos, 1.0));
     v_normalWorld = normalize(u_normalMatrix * a_normal);
@@ -1,29 +1,132 @@
 #include "Bacteria.h"
 
-Bacteria::Bacteria(glm::vec4 initialPosition, BacteriaType type)
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+    // Obiekty Bacteria przydzielane są z bloków po CELL_SLAB_OBJECTS - zaszczepienie miliona
+    // komórek to kilkaset alokacji bloków zamiast miliona wywołań ::operator new.
+    // Każdy wątek ma własną listę wolnych miejsc, wspólna pula zamykana jest tylko przy
+    // wymianie całych paczek. Bloki nie wracają do systemu, a liczniki pamięci nadal liczą
+    // żywe obiekty, nie zarezerwowane bloki.
+    const size_t CELL_SLAB_OBJECTS = 4096;
+    const size_t CELL_SLOT_SIZE = (sizeof(Bacteria) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    struct FreeCell {
+        FreeCell* next;
+    };
+
+    struct FreeBatch {
+        FreeCell* head;
+        size_t count;
+    };
+
+    class CellSlabPool {
+    public:
+        // Paczka wolnych miejsc - oddana przez inny wątek albo wycięta z nowego bloku
+        FreeBatch takeBatch() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!batches.empty()) {
+                FreeBatch batch = batches.back();
+                batches.pop_back();
+                return batch;
+            }
+            slabs.push_back(std::make_unique<unsigned char[]>(CELL_SLAB_OBJECTS * CELL_SLOT_SIZE));
+            unsigned char* slab = slabs.back().get();
+            FreeCell* head = nullptr;
+            for (size_t i = CELL_SLAB_OBJECTS; i-- > 0;) {
+                FreeCell* cell = reinterpret_cast<FreeCell*>(slab + i * CELL_SLOT_SIZE);
+                cell->next = head;
+                head = cell;
+            }
+            return {head, CELL_SLAB_OBJECTS};
+        }
+
+        void returnBatch(const FreeBatch& batch) {
+            if (batch.count == 0) return;
+            std::lock_guard<std::mutex> lock(mutex);
+            batches.push_back(batch);
+        }
+
+    private:
+        std::mutex mutex;
+        std::vector<std::unique_ptr<unsigned char[]>> slabs;
+        std::vector<FreeBatch> batches;
+    };
+
+    // Pula nie jest niszczona - komórki mogą być zwalniane przez destruktory statyczne
+    // i kończące się wątki już po zakończeniu main()
+    CellSlabPool& cellSlabPool() {
+        static CellSlabPool* pool = new CellSlabPool();
+        return *pool;
+    }
+
+    // Wolne miejsca jednego wątku; nadmiar i resztki po zakończeniu wątku wracają do puli
+    struct ThreadCellCache {
+        FreeBatch local{nullptr, 0};
+
+        ~ThreadCellCache() {
+            cellSlabPool().returnBatch(local);
+        }
+
+        void* allocate() {
+            if (!local.head) local = cellSlabPool().takeBatch();
+            FreeCell* cell = local.head;
+            local.head = cell->next;
+            --local.count;
+            return cell;
+        }
+
+        void release(void* pointer) {
+            FreeCell* cell = static_cast<FreeCell*>(pointer);
+            cell->next = local.head;
+            local.head = cell;
+            // Wątek, który tylko zwalnia (np. łączenie komórek), oddaje pełne paczki innym
+            if (++local.count == 2 * CELL_SLAB_OBJECTS) {
+                FreeCell* split = local.head;
+                for (size_t i = 1; i < CELL_SLAB_OBJECTS; ++i) split = split->next;
+                cellSlabPool().returnBatch({local.head, CELL_SLAB_OBJECTS});
+                local.head = split->next;
+                split->next = nullptr;
+                local.count = CELL_SLAB_OBJECTS;
+            }
+        }
+    };
+
+    thread_local ThreadCellCache threadCellCache;
+}
+
+Bacteria::Bacteria(glm::vec4 initialPosition, SpeciesId type)
     : position(initialPosition),
       bacteriaType(type),
-      stats(getStatsForType(type)), 
-      divisionTimer(stats.divisionInterval) {
+      stats(getStatsForSpecies(type)), 
+      birthTime(0.0),
+      multiplicity(1),
+      cellId(INVALID_CELL_ID) {
 }
 
-void Bacteria::update(float deltaTime) {
-    if (!isAlive()) {
-        return;
-    }
-    divisionTimer -= deltaTime;
+bool Bacteria::canDivide(double simulationTime, float deltaTime) const {
+    if (!isAlive() || stats.health <= 0.7f || stats.divisionInterval <= 0.0f) return false;
+    // Czy w kończącym się kroku minęła kolejna wielokrotność interwału od narodzin
+    const double interval = stats.divisionInterval;
+    const double age = simulationTime - birthTime;
+    return std::floor(age / interval) > std::floor((age - deltaTime) / interval);
 }
 
-bool Bacteria::canDivide() const {
-
-    return isAlive() && stats.health > 0.7f && divisionTimer <= 0.0f; 
+void Bacteria::setBirthTime(double time) {
+    birthTime = time;
 }
 
 void Bacteria::applyAntibiotic(float intensity) {
     if (!isAlive()) return;
 
-    float effectiveResistance = glm::clamp(stats.antibioticResistance, 0.0f, 0.95f); 
-    float damage = intensity * (1.0f - effectiveResistance);
+    float damage = getAntibioticDamage(intensity);
     
     if (damage > 0.0f) {
         stats.health -= damage;
@@ -33,25 +136,30 @@ void Bacteria::applyAntibiotic(float intensity) {
     }
 }
 
-IBacteria* Bacteria::clone() const {
+float Bacteria::getAntibioticDamage(float intensity) const {
+    float effectiveResistance = glm::clamp(stats.antibioticResistance, 0.0f, 0.95f); 
+    return intensity * (1.0f - effectiveResistance);
+}
+
+IBacteria* Bacteria::clone(SimulationRng& rng) const {
     float offsetRadius = 0.5f; 
     float offsetZ = 0.05f;
-    glm::vec2 randomOffset = glm::diskRand(offsetRadius);
+    // Punkt losowany równomiernie w kole (jak glm::diskRand), ale z generatora kolonii
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    float offsetDistance = offsetRadius * std::sqrt(unit(rng));
+    float offsetAngle = 2.0f * static_cast<float>(M_PI) * unit(rng);
+    glm::vec2 randomOffset(offsetDistance * std::cos(offsetAngle), offsetDistance * std::sin(offsetAngle));
     glm::vec4 newPosition = position + glm::vec4(randomOffset.x, randomOffset.y, offsetZ, 0.0f);    
 
     const float maxZ = 2.0f;
     if (newPosition.z > maxZ) {
-        newPosition.z = maxZ - glm::linearRand(0.0f, 0.1f); 
+        newPosition.z = maxZ - 0.1f * unit(rng); 
     }
 
     Bacteria* child = new Bacteria(newPosition, this->bacteriaType);
     return child;
 }
 
-void Bacteria::resetDivisionTimer() {
-    divisionTimer = stats.divisionInterval;
-}
-
 bool Bacteria::isAlive() const {
     return stats.health > 0.0f;
 }
@@ -60,18 +168,83 @@ float Bacteria::getHealth() const {
     return stats.health;
 }
 
+float Bacteria::getAntibioticResistance() const {
+    return stats.antibioticResistance;
+}
+
 glm::vec4 Bacteria::getPos() const {
     return position;
 }
 
-BacteriaType Bacteria::getBacteriaType() const {
+SpeciesId Bacteria::getSpecies() const {
     return bacteriaType;
 }
 
-const std::vector<std::pair<float, float>>& Bacteria::getCircuit() const {
+const BacteriaCircuit& Bacteria::getCircuit() const {
     return stats.circuit;
 }
 
 void Bacteria::setPos(const glm::vec4& newPosition) {
     position = newPosition;
 }
+
+void Bacteria::setHealth(float newHealth) {
+    stats.health = newHealth < 0.0f ? 0.0f : newHealth;
+}
+
+uint64_t Bacteria::getMultiplicity() const {
+    return multiplicity;
+}
+
+void Bacteria::setMultiplicity(uint64_t newMultiplicity) {
+    multiplicity = newMultiplicity;
+}
+
+CellId Bacteria::getCellId() const {
+    return cellId;
+}
+
+void Bacteria::setCellId(CellId id) {
+    cellId = id;
+}
+
+CellState Bacteria::saveState() const {
+    CellState state;
+    state.position = position;
+    state.birthTime = birthTime;
+    state.multiplicity = multiplicity;
+    state.id = cellId;
+    state.health = stats.health;
+    state.antibioticResistance = stats.antibioticResistance;
+    state.type = bacteriaType;
+    return state;
+}
+
+void Bacteria::loadState(const CellState& state) {
+    if (state.type != bacteriaType) {
+        stats = getStatsForSpecies(state.type);
+        bacteriaType = state.type;
+    }
+    position = state.position;
+    birthTime = state.birthTime;
+    multiplicity = state.multiplicity;
+    cellId = state.id;
+    stats.health = state.health;
+    stats.antibioticResistance = state.antibioticResistance;
+}
+
+void* Bacteria::operator new(size_t size) {
+    // Klasy pochodne mają inny rozmiar - idą do alokatora ogólnego
+    void* pointer = size == sizeof(Bacteria) ? threadCellCache.allocate() : ::operator new(size);
+    trackAllocation(MemoryTag::SimulationCells, size);
+    return pointer;
+}
+
+void Bacteria::operator delete(void* pointer, size_t size) {
+    trackFree(MemoryTag::SimulationCells, size);
+    if (size == sizeof(Bacteria)) {
+        threadCellCache.release(pointer);
+    } else {
+        ::operator delete(pointer);
+    }
+}
@@ -15,25 +15,42 @@ class Bacteria : public IBacteria {
 private:
     glm::vec4 position;
     BacteriaStats stats; 
-    BacteriaType bacteriaType;
-    float divisionTimer; 
+    SpeciesId bacteriaType;
+    double birthTime;
     float radius;
+    uint64_t multiplicity;
+    CellId cellId;
 
 public:
-    Bacteria(glm::vec4 initialPosition, BacteriaType type);
+    Bacteria(glm::vec4 initialPosition, SpeciesId type);
     ~Bacteria() override = default;
 
-    void update(float deltaTime) override;
-    bool canDivide() const override;
+    bool canDivide(double simulationTime, float deltaTime) const override;
+    void setBirthTime(double time) override;
     void applyAntibiotic(float intensity) override;
-    IBacteria* clone() const override;
-    void resetDivisionTimer() override;
+    float getAntibioticDamage(float intensity) const override;
+    IBacteria* clone(SimulationRng& rng) const override;
     bool isAlive() const override;
 
     float getHealth() const override;
+    float getAntibioticResistance() const override;
     glm::vec4 getPos() const override;
-    BacteriaType getBacteriaType() const override;
-    const std::vector<std::pair<float, float>>& getCircuit() const override;
+    SpeciesId getSpecies() const override;
+    const BacteriaCircuit& getCircuit() const override;
     void setPos(const glm::vec4& newPosition) override;
+    void setHealth(float newHealth) override;
+
+    uint64_t getMultiplicity() const override;
+    void setMultiplicity(uint64_t newMultiplicity) override;
+
+    CellId getCellId() const override;
+    void setCellId(CellId id) override;
+
+    CellState saveState() const override;
+    void loadState(const CellState& state) override;
+
+    // Obiekty komórek liczone w pamięci podsystemu symulacji
+    static void* operator new(size_t size);
+    static void operator delete(void* pointer, size_t size);
     
 };
@@ -8,7 +8,7 @@
 
 class BacteriaFactory {
 public:
-    static std::unique_ptr<IBacteria> createAtPosition(BacteriaType type, const glm::vec4& position) {
+    static std::unique_ptr<IBacteria> createAtPosition(SpeciesId type, const glm::vec4& position) {
         return std::make_unique<Bacteria>(position, type);
     }
 };
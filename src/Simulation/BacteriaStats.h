@@ -2,9 +2,11 @@
 
 #include <vector>
 
+#include "IBacteria.h"
+
 struct BacteriaStats {
     float health;
     float divisionInterval;
     float antibioticResistance;
-    std::vector<std::pair<float, float>> circuit;
+    BacteriaCircuit circuit;
 };
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+
+#include "IBacteria.h"
+#include "Utils/MemoryTracker.h"
+
+// Tablica pośrednia kolonii: identyfikator komórki -> bieżący indeks w CellList.
+// Kolonia przestawia komórki (usuwanie martwych, porządkowanie przestrzenne), a identyfikatory
+// pozostają stałe. Zwolnione wpisy są używane ponownie z generacją zwiększoną o jeden.
+class CellIdTable {
+public:
+    static constexpr uint32_t NO_INDEX = UINT32_MAX;
+
+    CellId acquire(size_t index) {
+        uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(entries.size());
+            entries.push_back({NO_INDEX, 0});
+        }
+        entries[slot].index = static_cast<uint32_t>(index);
+        ++liveCount;
+        return makeId(slot, entries[slot].generation);
+    }
+
+    // Identyfikatory ids[0..count) dla komórek dopisanych kolejno od indeksu firstIndex.
+    // Najpierw wracają zwolnione wpisy, resztę tablica dokłada jednym powiększeniem.
+    void acquireRange(size_t firstIndex, size_t count, CellId* ids) {
+        size_t i = 0;
+        for (; i < count && !freeSlots.empty(); ++i) ids[i] = acquire(firstIndex + i);
+        const size_t firstSlot = entries.size();
+        entries.resize(firstSlot + (count - i));
+        for (size_t slot = firstSlot; i < count; ++i, ++slot) {
+            entries[slot] = {static_cast<uint32_t>(firstIndex + i), 0};
+            ids[i] = makeId(static_cast<uint32_t>(slot), 0);
+        }
+        liveCount += entries.size() - firstSlot;
+    }
+
+    void release(CellId id) {
+        Entry* entry = findEntry(id);
+        if (!entry) return;
+        entry->index = NO_INDEX;
+        ++entry->generation;
+        freeSlots.push_back(slotOf(id));
+        --liveCount;
+    }
+
+    // Nowy indeks komórki po przestawieniu
+    void update(CellId id, size_t index) {
+        Entry* entry = findEntry(id);
+        if (entry) entry->index = static_cast<uint32_t>(index);
+    }
+
+    // NO_INDEX, gdy komórka nie żyje (albo identyfikator pochodzi z innej kolonii)
+    uint32_t find(CellId id) const {
+        return isLive(id) ? entries[slotOf(id)].index : NO_INDEX;
+    }
+
+    // Odtworzenie indeksów z listy komórek po zmianie, której kolonia nie śledzi komórka po komórce
+    // (łączenie w superosobniki). Wpisy komórek, których już nie ma, są zwalniane.
+    void rebuild(const CellList& cells) {
+        for (Entry& entry : entries) {
+            if (entry.index != NO_INDEX) entry.index = STALE_INDEX;
+        }
+        for (size_t i = 0; i < cells.size(); ++i) {
+            if (cells[i]) update(cells[i]->getCellId(), i);
+        }
+        for (uint32_t slot = 0; slot < entries.size(); ++slot) {
+            if (entries[slot].index == STALE_INDEX) release(makeId(slot, entries[slot].generation));
+        }
+    }
+
+    // Tablica od nowa dla listy przywróconej z migawki: identyfikatory komórek pochodzą z migawki,
+    // a wpisy spoza niej są zwalniane z generacją zwiększoną jak przy release
+    void assign(const CellList& cells) {
+        for (Entry& entry : entries) {
+            if (entry.index == NO_INDEX) continue;
+            entry.index = NO_INDEX;
+            ++entry.generation;
+        }
+        liveCount = 0;
+        for (size_t i = 0; i < cells.size(); ++i) {
+            const CellId id = cells[i]->getCellId();
+            const uint32_t slot = slotOf(id);
+            if (slot >= entries.size()) entries.resize(slot + 1, {NO_INDEX, 0});
+            entries[slot] = {static_cast<uint32_t>(i), static_cast<uint32_t>(id >> 32)};
+            ++liveCount;
+        }
+        // Od końca, by najpierw wracały najniższe wpisy
+        freeSlots.clear();
+        for (uint32_t slot = static_cast<uint32_t>(entries.size()); slot-- > 0;) {
+            if (entries[slot].index == NO_INDEX) freeSlots.push_back(slot);
+        }
+    }
+
+    size_t size() const { return liveCount; }
+
+private:
+    // Znacznik wpisu czekającego na potwierdzenie w rebuild
+    static constexpr uint32_t STALE_INDEX = UINT32_MAX - 1;
+
+    struct Entry {
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    static CellId makeId(uint32_t slot, uint32_t generation) {
+        return (static_cast<CellId>(generation) << 32) | slot;
+    }
+    static uint32_t slotOf(CellId id) { return static_cast<uint32_t>(id); }
+
+    bool isLive(CellId id) const {
+        const uint32_t slot = slotOf(id);
+        return id != INVALID_CELL_ID && slot < entries.size() &&
+               entries[slot].generation == static_cast<uint32_t>(id >> 32) && entries[slot].index != NO_INDEX;
+    }
+    Entry* findEntry(CellId id) { return isLive(id) ? &entries[slotOf(id)] : nullptr; }
+
+    TrackedVector<Entry, MemoryTag::SimulationColony> entries;
+    TrackedVector<uint32_t, MemoryTag::SimulationColony> freeSlots;
+    size_t liveCount = 0;
+};
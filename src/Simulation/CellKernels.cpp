@@ -0,0 +1,343 @@
+#include "CellKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CELL_KERNELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC i Clang kompilują warianty z atrybutem target, więc cały plik nie wymaga flag -m*.
+// MSVC udostępnia intrynsyki AVX bez dodatkowych opcji.
+#if defined(__GNUC__) || defined(__clang__)
+#define CELL_KERNEL_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CELL_KERNEL_TARGET(isa)
+#endif
+
+// Bez łączenia mnożenia i dodawania w FMA: każdy wariant daje wyniki identyczne ze skalarnym,
+// więc przebieg symulacji (i odtwarzanie scenariuszy) nie zależy od procesora
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+// Odporność powyżej tego progu nie chroni bardziej (jak w Bacteria::applyAntibiotic)
+const float MAX_EFFECTIVE_RESISTANCE = 0.95f;
+
+// --- Wersja skalarna: wzorzec dla wariantów wektorowych i obsługa końcówek tablic ---
+
+static void antibioticFalloffScalar(const float* x, const float* y, size_t count,
+                                    float centerX, float centerY, float strength, float radius, float* intensity) {
+    for (size_t i = 0; i < count; ++i) {
+        float dx = x[i] - centerX;
+        float dy = y[i] - centerY;
+        float distance = std::sqrt(dx * dx + dy * dy);
+        float t = std::clamp(distance / radius, 0.0f, 1.0f);
+        float smooth = t * t * (3.0f - 2.0f * t);
+        intensity[i] = distance <= radius ? strength * (1.0f - smooth) : 0.0f;
+    }
+}
+
+static void applyDamageScalar(float* health, const float* resistance, const float* intensity, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (health[i] <= 0.0f) continue;
+        float effectiveResistance = std::clamp(resistance[i], 0.0f, MAX_EFFECTIVE_RESISTANCE);
+        health[i] = std::max(health[i] - intensity[i] * (1.0f - effectiveResistance), 0.0f);
+    }
+}
+
+static void decrementTimersScalar(float* timer, const float* health, size_t count, float deltaTime) {
+    for (size_t i = 0; i < count; ++i) {
+        if (health[i] > 0.0f) timer[i] -= deltaTime;
+    }
+}
+
+static size_t countAliveScalar(const float* health, size_t count) {
+    size_t alive = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (health[i] > 0.0f) ++alive;
+    }
+    return alive;
+}
+
+#ifdef CELL_KERNELS_X86
+
+// --- SSE2: 4 komórki na instrukcję ---
+
+CELL_KERNEL_TARGET("sse2")
+static void antibioticFalloffSse2(const float* x, const float* y, size_t count,
+                                  float centerX, float centerY, float strength, float radius, float* intensity) {
+    const __m128 cx = _mm_set1_ps(centerX), cy = _mm_set1_ps(centerY);
+    const __m128 vStrength = _mm_set1_ps(strength), vRadius = _mm_set1_ps(radius);
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f), three = _mm_set1_ps(3.0f);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), cx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), cy);
+        __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+        __m128 t = _mm_min_ps(_mm_max_ps(_mm_div_ps(distance, vRadius), zero), one);
+        __m128 smooth = _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(three, _mm_mul_ps(two, t)));
+        __m128 value = _mm_mul_ps(vStrength, _mm_sub_ps(one, smooth));
+        __m128 inside = _mm_cmple_ps(distance, vRadius);
+        _mm_storeu_ps(intensity + i, _mm_and_ps(inside, value));
+    }
+    antibioticFalloffScalar(x + i, y + i, count - i, centerX, centerY, strength, radius, intensity + i);
+}
+
+CELL_KERNEL_TARGET("sse2")
+static void applyDamageSse2(float* health, const float* resistance, const float* intensity, size_t count) {
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    const __m128 maxResistance = _mm_set1_ps(MAX_EFFECTIVE_RESISTANCE);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 h = _mm_loadu_ps(health + i);
+        __m128 r = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(resistance + i), zero), maxResistance);
+        __m128 damaged = _mm_max_ps(_mm_sub_ps(h, _mm_mul_ps(_mm_loadu_ps(intensity + i), _mm_sub_ps(one, r))), zero);
+        __m128 alive = _mm_cmpgt_ps(h, zero);
+        _mm_storeu_ps(health + i, _mm_or_ps(_mm_and_ps(alive, damaged), _mm_andnot_ps(alive, h)));
+    }
+    applyDamageScalar(health + i, resistance + i, intensity + i, count - i);
+}
+
+CELL_KERNEL_TARGET("sse2")
+static void decrementTimersSse2(float* timer, const float* health, size_t count, float deltaTime) {
+    const __m128 zero = _mm_setzero_ps(), step = _mm_set1_ps(deltaTime);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 alive = _mm_cmpgt_ps(_mm_loadu_ps(health + i), zero);
+        __m128 value = _mm_loadu_ps(timer + i);
+        _mm_storeu_ps(timer + i, _mm_sub_ps(value, _mm_and_ps(alive, step)));
+    }
+    decrementTimersScalar(timer + i, health + i, count - i, deltaTime);
+}
+
+CELL_KERNEL_TARGET("sse2")
+static size_t countAliveSse2(const float* health, size_t count) {
+    const __m128 zero = _mm_setzero_ps();
+    size_t alive = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        int mask = _mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(health + i), zero));
+        alive += static_cast<size_t>((mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1));
+    }
+    return alive + countAliveScalar(health + i, count - i);
+}
+
+// --- AVX2: 8 komórek na instrukcję ---
+
+CELL_KERNEL_TARGET("avx2")
+static void antibioticFalloffAvx2(const float* x, const float* y, size_t count,
+                                  float centerX, float centerY, float strength, float radius, float* intensity) {
+    const __m256 cx = _mm256_set1_ps(centerX), cy = _mm256_set1_ps(centerY);
+    const __m256 vStrength = _mm256_set1_ps(strength), vRadius = _mm256_set1_ps(radius);
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f), three = _mm256_set1_ps(3.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), cx);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), cy);
+        __m256 distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+        __m256 t = _mm256_min_ps(_mm256_max_ps(_mm256_div_ps(distance, vRadius), zero), one);
+        __m256 smooth = _mm256_mul_ps(_mm256_mul_ps(t, t), _mm256_sub_ps(three, _mm256_mul_ps(two, t)));
+        __m256 value = _mm256_mul_ps(vStrength, _mm256_sub_ps(one, smooth));
+        __m256 inside = _mm256_cmp_ps(distance, vRadius, _CMP_LE_OQ);
+        _mm256_storeu_ps(intensity + i, _mm256_and_ps(inside, value));
+    }
+    antibioticFalloffScalar(x + i, y + i, count - i, centerX, centerY, strength, radius, intensity + i);
+}
+
+CELL_KERNEL_TARGET("avx2")
+static void applyDamageAvx2(float* health, const float* resistance, const float* intensity, size_t count) {
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+    const __m256 maxResistance = _mm256_set1_ps(MAX_EFFECTIVE_RESISTANCE);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 h = _mm256_loadu_ps(health + i);
+        __m256 r = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(resistance + i), zero), maxResistance);
+        __m256 damaged = _mm256_max_ps(_mm256_sub_ps(h, _mm256_mul_ps(_mm256_loadu_ps(intensity + i), _mm256_sub_ps(one, r))), zero);
+        __m256 alive = _mm256_cmp_ps(h, zero, _CMP_GT_OQ);
+        _mm256_storeu_ps(health + i, _mm256_blendv_ps(h, damaged, alive));
+    }
+    applyDamageScalar(health + i, resistance + i, intensity + i, count - i);
+}
+
+CELL_KERNEL_TARGET("avx2")
+static void decrementTimersAvx2(float* timer, const float* health, size_t count, float deltaTime) {
+    const __m256 zero = _mm256_setzero_ps(), step = _mm256_set1_ps(deltaTime);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 alive = _mm256_cmp_ps(_mm256_loadu_ps(health + i), zero, _CMP_GT_OQ);
+        __m256 value = _mm256_loadu_ps(timer + i);
+        _mm256_storeu_ps(timer + i, _mm256_sub_ps(value, _mm256_and_ps(alive, step)));
+    }
+    decrementTimersScalar(timer + i, health + i, count - i, deltaTime);
+}
+
+CELL_KERNEL_TARGET("avx2,popcnt")
+static size_t countAliveAvx2(const float* health, size_t count) {
+    const __m256 zero = _mm256_setzero_ps();
+    size_t alive = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(health + i), zero, _CMP_GT_OQ));
+        alive += static_cast<size_t>(_mm_popcnt_u32(static_cast<unsigned int>(mask)));
+    }
+    return alive + countAliveScalar(health + i, count - i);
+}
+
+// --- AVX-512F: 16 komórek na instrukcję, maski zamiast mieszania ---
+
+CELL_KERNEL_TARGET("avx512f")
+static void antibioticFalloffAvx512(const float* x, const float* y, size_t count,
+                                    float centerX, float centerY, float strength, float radius, float* intensity) {
+    const __m512 cx = _mm512_set1_ps(centerX), cy = _mm512_set1_ps(centerY);
+    const __m512 vStrength = _mm512_set1_ps(strength), vRadius = _mm512_set1_ps(radius);
+    const __m512 zero = _mm512_setzero_ps(), one = _mm512_set1_ps(1.0f);
+    const __m512 two = _mm512_set1_ps(2.0f), three = _mm512_set1_ps(3.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 dx = _mm512_sub_ps(_mm512_loadu_ps(x + i), cx);
+        __m512 dy = _mm512_sub_ps(_mm512_loadu_ps(y + i), cy);
+        __m512 distance = _mm512_sqrt_ps(_mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy)));
+        __m512 t = _mm512_min_ps(_mm512_max_ps(_mm512_div_ps(distance, vRadius), zero), one);
+        __m512 smooth = _mm512_mul_ps(_mm512_mul_ps(t, t), _mm512_sub_ps(three, _mm512_mul_ps(two, t)));
+        __m512 value = _mm512_mul_ps(vStrength, _mm512_sub_ps(one, smooth));
+        __mmask16 inside = _mm512_cmp_ps_mask(distance, vRadius, _CMP_LE_OQ);
+        _mm512_storeu_ps(intensity + i, _mm512_maskz_mov_ps(inside, value));
+    }
+    antibioticFalloffScalar(x + i, y + i, count - i, centerX, centerY, strength, radius, intensity + i);
+}
+
+CELL_KERNEL_TARGET("avx512f")
+static void applyDamageAvx512(float* health, const float* resistance, const float* intensity, size_t count) {
+    const __m512 zero = _mm512_setzero_ps(), one = _mm512_set1_ps(1.0f);
+    const __m512 maxResistance = _mm512_set1_ps(MAX_EFFECTIVE_RESISTANCE);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 h = _mm512_loadu_ps(health + i);
+        __m512 r = _mm512_min_ps(_mm512_max_ps(_mm512_loadu_ps(resistance + i), zero), maxResistance);
+        __m512 damaged = _mm512_max_ps(_mm512_sub_ps(h, _mm512_mul_ps(_mm512_loadu_ps(intensity + i), _mm512_sub_ps(one, r))), zero);
+        __mmask16 alive = _mm512_cmp_ps_mask(h, zero, _CMP_GT_OQ);
+        _mm512_storeu_ps(health + i, _mm512_mask_mov_ps(h, alive, damaged));
+    }
+    applyDamageScalar(health + i, resistance + i, intensity + i, count - i);
+}
+
+CELL_KERNEL_TARGET("avx512f")
+static void decrementTimersAvx512(float* timer, const float* health, size_t count, float deltaTime) {
+    const __m512 zero = _mm512_setzero_ps(), step = _mm512_set1_ps(deltaTime);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __mmask16 alive = _mm512_cmp_ps_mask(_mm512_loadu_ps(health + i), zero, _CMP_GT_OQ);
+        __m512 value = _mm512_loadu_ps(timer + i);
+        _mm512_storeu_ps(timer + i, _mm512_mask_sub_ps(value, alive, value, step));
+    }
+    decrementTimersScalar(timer + i, health + i, count - i, deltaTime);
+}
+
+CELL_KERNEL_TARGET("avx512f,popcnt")
+static size_t countAliveAvx512(const float* health, size_t count) {
+    const __m512 zero = _mm512_setzero_ps();
+    size_t alive = 0;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __mmask16 mask = _mm512_cmp_ps_mask(_mm512_loadu_ps(health + i), zero, _CMP_GT_OQ);
+        alive += static_cast<size_t>(_mm_popcnt_u32(static_cast<unsigned int>(mask)));
+    }
+    return alive + countAliveScalar(health + i, count - i);
+}
+
+// Wykrywanie obsługi przez procesor i system (zapis rejestrów YMM/ZMM przy przełączaniu kontekstu)
+static bool isIsaSupported(CellKernelIsa isa) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    switch (isa) {
+        case CellKernelIsa::Scalar: return true;
+        case CellKernelIsa::Sse2: return __builtin_cpu_supports("sse2");
+        case CellKernelIsa::Avx2: return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+        case CellKernelIsa::Avx512: return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("popcnt");
+    }
+    return false;
+#elif defined(_MSC_VER)
+    int registers[4];
+    __cpuid(registers, 0);
+    const int maxLeaf = registers[0];
+    __cpuid(registers, 1);
+    const bool sse2 = (registers[3] & (1 << 26)) != 0;
+    const bool popcnt = (registers[2] & (1 << 23)) != 0;
+    const bool osXsave = (registers[2] & (1 << 27)) != 0;
+    const unsigned long long xcr0 = osXsave ? _xgetbv(0) : 0;
+    const bool osYmm = (xcr0 & 0x6) == 0x6;
+    const bool osZmm = (xcr0 & 0xE6) == 0xE6;
+    bool avx2 = false, avx512f = false;
+    if (maxLeaf >= 7) {
+        __cpuidex(registers, 7, 0);
+        avx2 = (registers[1] & (1 << 5)) != 0;
+        avx512f = (registers[1] & (1 << 16)) != 0;
+    }
+    switch (isa) {
+        case CellKernelIsa::Scalar: return true;
+        case CellKernelIsa::Sse2: return sse2;
+        case CellKernelIsa::Avx2: return avx2 && popcnt && osYmm;
+        case CellKernelIsa::Avx512: return avx512f && popcnt && osZmm;
+    }
+    return false;
+#else
+    return isa == CellKernelIsa::Scalar;
+#endif
+}
+
+#else
+
+static bool isIsaSupported(CellKernelIsa isa) {
+    return isa == CellKernelIsa::Scalar;
+}
+
+#endif
+
+static const CellKernelTable CELL_KERNEL_TABLES[CELL_KERNEL_ISA_COUNT] = {
+    {CellKernelIsa::Scalar, antibioticFalloffScalar, applyDamageScalar, decrementTimersScalar, countAliveScalar},
+#ifdef CELL_KERNELS_X86
+    {CellKernelIsa::Sse2, antibioticFalloffSse2, applyDamageSse2, decrementTimersSse2, countAliveSse2},
+    {CellKernelIsa::Avx2, antibioticFalloffAvx2, applyDamageAvx2, decrementTimersAvx2, countAliveAvx2},
+    {CellKernelIsa::Avx512, antibioticFalloffAvx512, applyDamageAvx512, decrementTimersAvx512, countAliveAvx512},
+#else
+    {CellKernelIsa::Sse2, nullptr, nullptr, nullptr, nullptr},
+    {CellKernelIsa::Avx2, nullptr, nullptr, nullptr, nullptr},
+    {CellKernelIsa::Avx512, nullptr, nullptr, nullptr, nullptr},
+#endif
+};
+
+const CellKernelTable* getCellKernelsForIsa(CellKernelIsa isa) {
+    if (!isIsaSupported(isa)) return nullptr;
+    return &CELL_KERNEL_TABLES[static_cast<int>(isa)];
+}
+
+const CellKernelTable& getCellKernels() {
+    // Najszerszy obsługiwany wariant; wybór raz na proces
+    static const CellKernelTable* selected = [] {
+        for (int isa = CELL_KERNEL_ISA_COUNT - 1; isa > 0; --isa) {
+            const CellKernelTable* table = getCellKernelsForIsa(static_cast<CellKernelIsa>(isa));
+            if (table) return table;
+        }
+        return &CELL_KERNEL_TABLES[0];
+    }();
+    return *selected;
+}
+
+const char* getCellKernelIsaName(CellKernelIsa isa) {
+    switch (isa) {
+        case CellKernelIsa::Scalar: return "scalar";
+        case CellKernelIsa::Sse2: return "SSE2";
+        case CellKernelIsa::Avx2: return "AVX2";
+        case CellKernelIsa::Avx512: return "AVX-512";
+    }
+    return "unknown";
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Zestawy instrukcji, dla których istnieją warianty jąder obliczeń na komórkach
+enum class CellKernelIsa {
+    Scalar,
+    Sse2,
+    Avx2,
+    Avx512
+};
+
+const int CELL_KERNEL_ISA_COUNT = static_cast<int>(CellKernelIsa::Avx512) + 1;
+
+// Jądra obliczeń na ciągłych tablicach komórek (układ SoA).
+// Wszystkie warianty liczą to samo co wersja skalarna - różnią się tylko szerokością wektora.
+struct CellKernelTable {
+    CellKernelIsa isa;
+
+    // intensity[i] = strength * (1 - smoothstep(0, radius, d)) dla d <= radius, inaczej 0,
+    // gdzie d to odległość (x[i], y[i]) od (centerX, centerY)
+    void (*antibioticFalloff)(const float* x, const float* y, size_t count,
+                              float centerX, float centerY, float strength, float radius, float* intensity);
+    // health[i] -= intensity[i] * (1 - clamp(resistance[i], 0, 0.95)), nie mniej niż 0; martwe bez zmian
+    void (*applyDamage)(float* health, const float* resistance, const float* intensity, size_t count);
+    // timer[i] -= deltaTime dla żywych komórek (health[i] > 0)
+    void (*decrementTimers)(float* timer, const float* health, size_t count, float deltaTime);
+    // Liczba komórek z health[i] > 0
+    size_t (*countAlive)(const float* health, size_t count);
+};
+
+// Jądra wybrane przy pierwszym użyciu na podstawie możliwości procesora
+const CellKernelTable& getCellKernels();
+// Konkretny wariant albo nullptr, gdy procesor lub kompilator go nie obsługuje
+const CellKernelTable* getCellKernelsForIsa(CellKernelIsa isa);
+const char* getCellKernelIsaName(CellKernelIsa isa);
@@ -0,0 +1,629 @@
+#include "Colony.h"
+
+#include "BacteriaFactory.h"
+#include "CellKernels.h"
+#include "Utils/ThreadAffinity.h"
+#include "Utils/Trace.h"
+
+
+#include <algorithm>
+#include <chrono>
+
+// Najmniejsza liczba bakterii na fragment pracy równoległej - poniżej narzut wątków przeważa
+const size_t MIN_BACTERIA_PER_CHUNK = 2048;
+// Szansa na podział bakterii gotowej do podziału
+const float DIVISION_CHANCE = 0.05f;
+
+// Bakterie zaszczepiane są nad agarem, kolejne minimalnie wyżej, by nie walczyły o głębię
+const float INOCULATION_BASE_Z = 1.85f;
+const float INOCULATION_Z_JITTER = 0.001f;
+// Po tylu komórkach wysokość zaczyna się od nowa - murawa nie rośnie ponad szalkę
+const size_t INOCULATION_Z_LAYERS = 512;
+// Większe zaszczepienie zgłasza odbiorcom dziennika pełną przebudowę zamiast zmian punktowych
+const size_t MAX_RECORDED_INOCULATION_CELLS = 65536;
+
+size_t Colony::getDefaultWorkerCount() {
+    unsigned int hardwareThreads = getLogicalCoreCount();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+}
+
+Colony::Colony(uint32_t seed, size_t workerCount, const std::vector<unsigned int>& pinnedCores) : rng(seed) {
+    if (workerCount > 0) {
+        workers = std::make_unique<ThreadPool>(workerCount, pinnedCores);
+    }
+}
+
+size_t Colony::getChunkCount(size_t count) const {
+    if (!workers) return count > 0 ? 1 : 0;
+    return workers->getChunkCount(count, MIN_BACTERIA_PER_CHUNK);
+}
+
+void Colony::forEachChunk(size_t count, const std::function<void(size_t chunkIndex, size_t begin, size_t end)>& body) {
+    if (!workers) {
+        if (count > 0) body(0, 0, count);
+        return;
+    }
+    workers->parallelFor(count, MIN_BACTERIA_PER_CHUNK, [&body](size_t chunkIndex, size_t begin, size_t end) {
+        TRACE_SCOPE("sim", "Colony::chunk");
+        body(chunkIndex, begin, end);
+    });
+}
+
+void Colony::addBacteria(SpeciesId type, const glm::vec4& position, uint64_t multiplicity) {
+    std::unique_ptr<IBacteria> cell = BacteriaFactory::createAtPosition(type, position);
+    cell->setMultiplicity(multiplicity);
+    cell->setBirthTime(simulationTime);
+    ColonyStatsDelta delta;
+    delta.onAdded(type, cell->getHealth(), cell->getAntibioticResistance(), multiplicity);
+    stats.merge(delta);
+    populationChanges.record(position.x, position.y, static_cast<int64_t>(multiplicity));
+    cell->setCellId(cellIds.acquire(bacteria.size()));
+    markCellsChanged(bacteria.size(), bacteria.size() + 1);
+    positionX.push_back(position.x);
+    positionY.push_back(position.y);
+    bacteria.push_back(std::move(cell));
+}
+
+void Colony::inoculate(SpeciesId type, const InoculationPattern& pattern, uint64_t count) {
+    if (count == 0) return;
+    TRACE_SCOPE("sim", "Colony::inoculate");
+
+    // Komórki, które nie mieszczą się w budżecie, rozkładamy równo na dostępne obiekty
+    const uint64_t objectCount = std::min<uint64_t>(count, std::max<size_t>(governor.getHeadroom(bacteria.size()), 1));
+    const uint64_t baseMultiplicity = count / objectCount;
+    const uint64_t remainder = count % objectCount;
+    const size_t objects = static_cast<size_t>(objectCount);
+    const size_t firstIndex = bacteria.size();
+
+    // Jedno losowanie ze strumienia kolonii - pozostałe liczby wynikają z niego i indeksu komórki,
+    // więc wynik nie zależy od liczby wątków
+    const uint64_t seed = (static_cast<uint64_t>(rng()) << 32) | rng();
+    const InoculationSampler sampler(pattern, objectCount, seed);
+
+    inoculationIds.resize(objects);
+    cellIds.acquireRange(firstIndex, objects, inoculationIds.data());
+    bacteria.resize(firstIndex + objects);
+    positionX.resize(firstIndex + objects);
+    positionY.resize(firstIndex + objects);
+    forEachChunk(objects, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const glm::vec2 position = sampler.position(i);
+            float offsetZ = INOCULATION_BASE_Z +
+                static_cast<float>(i % INOCULATION_Z_LAYERS) * INOCULATION_Z_JITTER * sampler.uniform(i, INOCULATION_POSITION_STREAMS);
+            std::unique_ptr<IBacteria> cell = BacteriaFactory::createAtPosition(type, glm::vec4(position.x, position.y, offsetZ, 1.0f));
+            cell->setMultiplicity(baseMultiplicity + (i < remainder ? 1 : 0));
+            cell->setBirthTime(simulationTime);
+            cell->setCellId(inoculationIds[i]);
+            positionX[firstIndex + i] = position.x;
+            positionY[firstIndex + i] = position.y;
+            bacteria[firstIndex + i] = std::move(cell);
+        }
+    });
+    markCellsChanged(firstIndex, firstIndex + objects);
+
+    // Nowe komórki gatunku mają jednakowe zdrowie i odporność
+    ColonyStatsDelta delta;
+    delta.onAdded(type, bacteria[firstIndex]->getHealth(), bacteria[firstIndex]->getAntibioticResistance(), count);
+    stats.merge(delta);
+    if (objects > MAX_RECORDED_INOCULATION_CELLS) {
+        populationChanges.requestRebuild();
+    } else {
+        for (size_t i = firstIndex; i < firstIndex + objects; ++i) {
+            populationChanges.record(positionX[i], positionY[i], static_cast<int64_t>(bacteria[i]->getMultiplicity()));
+        }
+    }
+    enforcePopulationBudget();
+}
+
+void Colony::inoculate(SpeciesId type, const glm::vec2& center, int count, float spread) {
+    if (count <= 0) return;
+    InoculationPattern pattern;
+    pattern.shape = InoculationShape::Blob;
+    pattern.center = center;
+    pattern.size = spread;
+    inoculate(type, pattern, static_cast<uint64_t>(count));
+}
+
+void Colony::setPopulationBudget(const PopulationBudget& budget) {
+    governor.setBudget(budget);
+    enforcePopulationBudget();
+}
+
+void Colony::enforcePopulationBudget() {
+    if (governor.needsAggregation(bacteria.size())) {
+        TRACE_SCOPE("sim", "Colony::aggregate");
+        const size_t countBefore = bacteria.size();
+        governor.aggregate(bacteria);
+        markCellsChanged(0, countBefore);
+        // Łączenie przesuwa komórki - zmian nie da się opisać punktowo
+        populationChanges.requestRebuild();
+        cellIds.rebuild(bacteria);
+        rebuildPositionCache();
+        // Łączenie zachowuje kolejność, ale przesuwa połączone komórki - uporządkowany
+        // pozostaje najdłuższy początek listy z niemalejącym kluczem
+        size_t prefix = std::min(orderedPrefix, bacteria.size());
+        for (size_t i = 1; i < prefix; ++i) {
+            if (mortonKey(positionX[i], positionY[i]) < mortonKey(positionX[i - 1], positionY[i - 1])) {
+                prefix = i;
+                break;
+            }
+        }
+        orderedPrefix = prefix;
+    }
+}
+
+void Colony::rebuildPositionCache() {
+    positionX.resize(bacteria.size());
+    positionY.resize(bacteria.size());
+    for (size_t i = 0; i < bacteria.size(); ++i) {
+        glm::vec4 position = bacteria[i]->getPos();
+        positionX[i] = position.x;
+        positionY[i] = position.y;
+    }
+}
+
+// Martwe komórki zostały odjęte od statystyk w chwili śmierci (onDamaged)
+void Colony::removeDeadCells() {
+    size_t kept = 0;
+    size_t removedFromOrdered = 0;
+    size_t firstRemoved = bacteria.size();
+    for (size_t i = 0; i < bacteria.size(); ++i) {
+        if (!bacteria[i] || !bacteria[i]->isAlive()) {
+            firstRemoved = std::min(firstRemoved, i);
+            if (bacteria[i]) {
+                populationChanges.record(positionX[i], positionY[i], -static_cast<int64_t>(bacteria[i]->getMultiplicity()));
+                cellIds.release(bacteria[i]->getCellId());
+            }
+            if (i < orderedPrefix) ++removedFromOrdered;
+            continue;
+        }
+        if (kept != i) {
+            bacteria[kept] = std::move(bacteria[i]);
+            positionX[kept] = positionX[i];
+            positionY[kept] = positionY[i];
+            cellIds.update(bacteria[kept]->getCellId(), kept);
+        }
+        ++kept;
+    }
+    orderedPrefix -= removedFromOrdered;
+    // Komórki za pierwszą usuniętą przesunęły się na niższe indeksy
+    markCellsChanged(firstRemoved, bacteria.size());
+    bacteria.resize(kept);
+    positionX.resize(kept);
+    positionY.resize(kept);
+}
+
+void Colony::absorbOffspring(IBacteria& parent, uint64_t offspring, float offspringHealth, ColonyStatsDelta& delta) {
+    const SpeciesId type = parent.getSpecies();
+    const float resistance = parent.getAntibioticResistance();
+    const uint64_t parentMultiplicity = parent.getMultiplicity();
+    const float parentHealth = parent.getHealth();
+    const uint64_t mergedMultiplicity = parentMultiplicity + offspring;
+    const float mergedHealth = static_cast<float>(
+        (static_cast<double>(parentHealth) * parentMultiplicity + static_cast<double>(offspringHealth) * offspring) /
+        static_cast<double>(mergedMultiplicity));
+
+    // Narodziny liczone ze zdrowiem potomstwa, następnie obie grupy przesuwane do wspólnej średniej
+    delta.onBirth(type, offspringHealth, resistance, offspring);
+    delta.onDamaged(type, offspringHealth, mergedHealth, resistance, offspring);
+    delta.onDamaged(type, parentHealth, mergedHealth, resistance, parentMultiplicity);
+
+    parent.setHealth(mergedHealth);
+    parent.setMultiplicity(mergedMultiplicity);
+    glm::vec4 position = parent.getPos();
+    populationChanges.record(position.x, position.y, static_cast<int64_t>(offspring));
+}
+
+void Colony::update(float deltaTime) {
+    TRACE_SCOPE("sim", "Colony::update");
+    // Koniec bieżącego kroku - względem niego komórki sprawdzają, czy minął ich interwał
+    const double stepEndTime = simulationTime + deltaTime;
+
+    // Podziały losujemy sekwencyjnie, aby wynik zależał wyłącznie od ziarna kolonii
+    std::uniform_real_distribution<float> divisionRoll(0.0f, 1.0f);
+    ColonyStatsDelta delta;
+    TrackedVector<std::unique_ptr<IBacteria>, MemoryTag::SimulationScratch> newBacteria;
+    const size_t individualLimit = governor.getIndividualLimit();
+    for (size_t i = 0; i < bacteria.size(); ++i) {
+        IBacteria* cell = bacteria[i].get();
+        if (cell && cell->canDivide(stepEndTime, deltaTime)) {
+            const uint64_t multiplicity = cell->getMultiplicity();
+            uint64_t divisions = 0;
+            if (multiplicity == 1) {
+                divisions = divisionRoll(rng) < DIVISION_CHANCE ? 1 : 0;
+            } else {
+                std::binomial_distribution<uint64_t> divisionCount(multiplicity, DIVISION_CHANCE);
+                divisions = divisionCount(rng);
+            }
+
+            if (divisions > 0) {
+                if (bacteria.size() + newBacteria.size() < individualLimit) {
+                    IBacteria* child = cell->clone(rng);
+                    if (child) {
+                        child->setMultiplicity(divisions);
+                        child->setBirthTime(stepEndTime);
+                        delta.onBirth(child->getSpecies(), child->getHealth(), child->getAntibioticResistance(), divisions);
+                        newBacteria.push_back(std::unique_ptr<IBacteria>(child));
+                    }
+                } else {
+                    absorbOffspring(*cell, divisions, getStatsForSpecies(cell->getSpecies()).health, delta);
+                    markCellsChanged(i, i + 1);
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < newBacteria.size(); ++i) {
+        IBacteria* child = newBacteria[i].get();
+        glm::vec4 position = child->getPos();
+        populationChanges.record(position.x, position.y, static_cast<int64_t>(child->getMultiplicity()));
+        child->setCellId(cellIds.acquire(bacteria.size() + i));
+        positionX.push_back(position.x);
+        positionY.push_back(position.y);
+    }
+    markCellsChanged(bacteria.size(), bacteria.size() + newBacteria.size());
+    bacteria.insert(bacteria.end(), std::make_move_iterator(newBacteria.begin()), std::make_move_iterator(newBacteria.end()));
+
+    removeDeadCells();
+    enforcePopulationBudget();
+    advanceSpatialOrder();
+
+    stats.merge(delta);
+    stats.tick(deltaTime);
+
+    ++tickIndex;
+    simulationTime += deltaTime;
+    if (clusterSettings.intervalTicks > 0 && tickIndex % clusterSettings.intervalTicks == 0) {
+        detectClusters();
+    }
+    publishTelemetry();
+}
+
+float Colony::getFragmentation() const {
+    if (bacteria.empty()) return 0.0f;
+    return 1.0f - static_cast<float>(orderedPrefix) / static_cast<float>(bacteria.size());
+}
+
+// Jeden przebieg sortowania na krok. Próg sprawdzany jest dopiero po przestawieniu,
+// więc kolonia nigdy nie ma dwóch porządkowań w toku.
+void Colony::advanceSpatialOrder() {
+    spatialOrderStats.fragmentation = getFragmentation();
+    if (spatialOrderSorter.isActive()) {
+        if (spatialOrderSorter.step(workers.get())) applySpatialOrder();
+        return;
+    }
+    if (spatialOrderSettings.fragmentationThreshold > 0.0f && bacteria.size() >= spatialOrderSettings.minCells &&
+        spatialOrderStats.fragmentation >= spatialOrderSettings.fragmentationThreshold) {
+        spatialOrderSorter.begin(positionX.data(), positionY.data(), bacteria, workers.get());
+    }
+}
+
+void Colony::reorderNow() {
+    if (!spatialOrderSorter.isActive()) {
+        spatialOrderSorter.begin(positionX.data(), positionY.data(), bacteria, workers.get());
+    }
+    while (!spatialOrderSorter.step(workers.get())) {
+    }
+    applySpatialOrder();
+    spatialOrderStats.fragmentation = getFragmentation();
+}
+
+// Komórki z posortowanej listy identyfikatorów (te, które nadal żyją) idą na początek w jej
+// kolejności, za nimi urodzone po rozpoczęciu sortowania w dotychczasowej kolejności.
+// Identyfikatory i pozycje przechodzą razem z komórkami, obiekty komórek zostają na miejscu.
+void Colony::applySpatialOrder() {
+    TRACE_SCOPE("sim", "Colony::applySpatialOrder");
+    auto startTime = std::chrono::steady_clock::now();
+    const size_t count = bacteria.size();
+
+    reorderIndices.clear();
+    reorderIndices.reserve(count);
+    reorderPlaced.assign(count, 0);
+    for (CellId id : spatialOrderSorter.getSortedIds()) {
+        const uint32_t index = cellIds.find(id);
+        if (index == CellIdTable::NO_INDEX || reorderPlaced[index]) continue;
+        reorderPlaced[index] = 1;
+        reorderIndices.push_back(index);
+    }
+    orderedPrefix = reorderIndices.size();
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!reorderPlaced[i]) reorderIndices.push_back(i);
+    }
+
+    // Przestawienie przez bufory, zamieniane potem z listą i tablicami pozycji
+    reorderedCells.resize(count);
+    reorderedPositions.resize(count);
+    forEachChunk(count, [&](size_t, size_t begin, size_t end) {
+        for (size_t target = begin; target < end; ++target) {
+            const uint32_t source = reorderIndices[target];
+            reorderedCells[target] = std::move(bacteria[source]);
+            reorderedPositions[target] = positionX[source];
+            cellIds.update(reorderedCells[target]->getCellId(), target);
+        }
+    });
+    std::swap(bacteria, reorderedCells);
+    reorderedCells.clear();
+    std::swap(positionX, reorderedPositions);
+    forEachChunk(count, [&](size_t, size_t begin, size_t end) {
+        for (size_t target = begin; target < end; ++target) reorderedPositions[target] = positionY[reorderIndices[target]];
+    });
+    std::swap(positionY, reorderedPositions);
+    markCellsChanged(0, count);
+
+    spatialOrderSorter.finish();
+    ++spatialOrderStats.reorders;
+    spatialOrderStats.lastReorderTick = tickIndex;
+    spatialOrderStats.lastReorderMilliseconds = spatialOrderSorter.getElapsedMilliseconds() +
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void Colony::detectClusters() {
+    clusterDetector.detect(positionX.data(), positionY.data(), bacteria, clusterSettings.contactDistance,
+                           workers.get(), clusterReport);
+    clusterReport.tick = tickIndex;
+}
+
+// Rekord budowany wyłącznie z bloku statystyk - bez alokacji i bez przeglądania komórek
+void Colony::publishTelemetry() {
+    if (!telemetryChannel) return;
+
+    const ColonyStatsSnapshot& snapshot = stats.getSnapshot();
+    TelemetryRecord record;
+    record.tick = tickIndex;
+    record.simulationTime = simulationTime;
+    record.population = static_cast<uint32_t>(snapshot.total);
+    for (int i = 0; i < MAX_SPECIES; ++i) {
+        record.typeCounts[i] = static_cast<uint32_t>(snapshot.typeCounts[i]);
+    }
+    // Zgony od antybiotyku podanego między krokami wliczają się do najbliższego rekordu
+    record.births = static_cast<uint32_t>(snapshot.totalBirths - lastPublishedBirths);
+    record.kills = static_cast<uint32_t>(snapshot.totalDeaths - lastPublishedDeaths);
+    record.meanHealth = snapshot.meanHealth;
+    // Ostatni policzony raport kolonii (między przebiegami wartości się powtarzają)
+    record.colonyCount = static_cast<uint32_t>(clusterReport.clusterCount);
+    record.largestColony = clusterReport.largest.empty() ? 0 : static_cast<uint32_t>(clusterReport.largest.front().cellCount);
+    lastPublishedBirths = snapshot.totalBirths;
+    lastPublishedDeaths = snapshot.totalDeaths;
+
+    telemetryChannel->publish(record);
+}
+
+void Colony::applyAntibiotic(const glm::vec2& center, float strength, float radius) {
+    if (radius <= 0.0f) return;
+    TRACE_SCOPE("sim", "Colony::applyAntibiotic");
+
+    // Każdy fragment zbiera własne zmiany statystyk; scalamy je po zakończeniu wszystkich wątków
+    TrackedVector<ColonyStatsDelta, MemoryTag::SimulationScratch> partials(getChunkCount(bacteria.size()));
+    // Częściowe zgony w superosobnikach dla dziennika zmian; pełne zgony zapisuje removeDeadCells
+    TrackedVector<PopulationChangeList, MemoryTag::SimulationScratch> partialChanges(
+        populationChanges.isEnabled() ? partials.size() : 0);
+    // Zakres komórek zmienionych w każdym fragmencie - dla znaczników migawek
+    TrackedVector<std::pair<size_t, size_t>, MemoryTag::SimulationScratch> partialRanges(partials.size(), {0, 0});
+    // Zgony w superosobnikach losowane z klucza (ziarno, indeks) - wynik nie zależy od podziału na wątki
+    const uint64_t damageSeedHigh = rng();
+    const uint64_t damageSeed = (damageSeedHigh << 32) | rng();
+    const CellKernelTable& kernels = getCellKernels();
+    antibioticIntensity.resize(bacteria.size());
+
+    forEachChunk(bacteria.size(), [&](size_t chunk, size_t begin, size_t end) {
+        ColonyStatsDelta& delta = partials[chunk];
+        size_t firstChanged = end;
+        size_t lastChanged = begin;
+        // Spadek siły z odległością liczony wektorowo dla całego fragmentu; komórki
+        // poza zasięgiem odpadają bez dotykania obiektów
+        kernels.antibioticFalloff(&positionX[begin], &positionY[begin], end - begin,
+                                  center.x, center.y, strength, radius, &antibioticIntensity[begin]);
+        for (size_t i = begin; i < end; ++i) {
+            float strengthAtDistance = antibioticIntensity[i];
+            if (strengthAtDistance <= 0.0f) continue;
+            IBacteria* cell = bacteria[i].get();
+            if (!cell || !cell->isAlive()) continue;
+            firstChanged = std::min(firstChanged, i);
+            lastChanged = i + 1;
+
+            float oldHealth = cell->getHealth();
+            const uint64_t multiplicity = cell->getMultiplicity();
+            if (multiplicity == 1) {
+                cell->applyAntibiotic(strengthAtDistance);
+                delta.onDamaged(cell->getSpecies(), oldHealth, cell->getHealth(), cell->getAntibioticResistance());
+                continue;
+            }
+
+            float roll = PopulationGovernor::uniformFromKey(damageSeed ^ (static_cast<uint64_t>(i) * 0x9E3779B97F4A7C15ull));
+            AggregateDamage damage = PopulationGovernor::resolveAggregateDamage(
+                oldHealth, cell->getAntibioticDamage(strengthAtDistance), multiplicity, roll);
+            const SpeciesId type = cell->getSpecies();
+            const float resistance = cell->getAntibioticResistance();
+            delta.onDamaged(type, oldHealth, 0.0f, resistance, damage.killed);
+            if (damage.killed >= multiplicity) {
+                cell->setHealth(0.0f);
+            } else {
+                delta.onDamaged(type, oldHealth, damage.survivorHealth, resistance, multiplicity - damage.killed);
+                cell->setHealth(damage.survivorHealth);
+                cell->setMultiplicity(multiplicity - damage.killed);
+                if (!partialChanges.empty() && damage.killed > 0) {
+                    partialChanges[chunk].push_back({positionX[i], positionY[i], -static_cast<int64_t>(damage.killed)});
+                }
+            }
+        }
+        if (firstChanged < lastChanged) partialRanges[chunk] = {firstChanged, lastChanged};
+    });
+
+    for (const ColonyStatsDelta& delta : partials) {
+        stats.merge(delta);
+    }
+    for (const PopulationChangeList& changes : partialChanges) {
+        populationChanges.append(changes);
+    }
+    for (const std::pair<size_t, size_t>& range : partialRanges) {
+        markCellsChanged(range.first, range.second);
+    }
+}
+
+// Zakres większy od limitu łatki oznacza od razu cały fragment; mniejsze zapisują
+// pojedyncze komórki, dopóki ich liczba nie przekroczy limitu
+void Colony::markCellsChanged(size_t begin, size_t end) {
+    if (begin >= end) return;
+    const size_t lastChunk = (end - 1) / HISTORY_CHUNK_CELLS;
+    if (changedChunkCells.size() <= lastChunk) {
+        changedChunkCells.resize(lastChunk + 1, 0);
+        changedCells.resize((lastChunk + 1) * HISTORY_CHUNK_CELLS / 64, 0);
+    }
+    for (size_t chunk = begin / HISTORY_CHUNK_CELLS; chunk <= lastChunk; ++chunk) {
+        uint32_t& changed = changedChunkCells[chunk];
+        if (changed == CHUNK_REWRITTEN) continue;
+        const size_t first = std::max(begin, chunk * HISTORY_CHUNK_CELLS);
+        const size_t last = std::min(end, (chunk + 1) * HISTORY_CHUNK_CELLS);
+        if (last - first > HISTORY_PATCH_LIMIT) {
+            changed = CHUNK_REWRITTEN;
+            continue;
+        }
+        for (size_t i = first; i < last; ++i) {
+            uint64_t& word = changedCells[i / 64];
+            const uint64_t bit = uint64_t(1) << (i % 64);
+            if (word & bit) continue;
+            word |= bit;
+            ++changed;
+        }
+        if (changed > HISTORY_PATCH_LIMIT) changed = CHUNK_REWRITTEN;
+    }
+}
+
+// Fragment przechodzi z poprzedniej migawki, gdy nic się w nim nie zmieniło i ma tyle samo
+// komórek (zmiany obejmują też przesunięcia po usunięciu martwych i dopisywanie na końcu).
+// Kilka zmienionych komórek trafia do łatki na tle ostatniej pełnej kopii fragmentu - łatka
+// przejmuje wcześniejszą, więc zawsze odnosi się bezpośrednio do pełnej kopii. Zapisywane
+// fragmenty dzielone są między wątki puli po jednym.
+void Colony::captureSnapshot(ColonySnapshot& snapshot) {
+    TRACE_SCOPE("sim", "Colony::captureSnapshot");
+    const size_t count = bacteria.size();
+    const size_t chunkCount = (count + HISTORY_CHUNK_CELLS - 1) / HISTORY_CHUNK_CELLS;
+    if (changedChunkCells.size() < chunkCount) {
+        changedChunkCells.resize(chunkCount, CHUNK_REWRITTEN);
+        changedCells.resize(chunkCount * HISTORY_CHUNK_CELLS / 64, 0);
+    }
+
+    snapshot.chunks.assign(chunkCount, nullptr);
+    snapshot.copiedChunks = 0;
+    snapshot.patchedChunks = 0;
+    snapshotWriteList.clear();
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        const size_t chunkSize = std::min(HISTORY_CHUNK_CELLS, count - chunk * HISTORY_CHUNK_CELLS);
+        const bool reusable = chunk < lastSnapshotChunks.size() && lastSnapshotChunks[chunk]->size() == chunkSize;
+        if (!reusable) changedChunkCells[chunk] = CHUNK_REWRITTEN;
+        if (changedChunkCells[chunk] == 0) {
+            snapshot.chunks[chunk] = lastSnapshotChunks[chunk];
+            continue;
+        }
+        snapshotWriteList.push_back(static_cast<uint32_t>(chunk));
+        if (changedChunkCells[chunk] == CHUNK_REWRITTEN) {
+            ++snapshot.copiedChunks;
+        } else {
+            ++snapshot.patchedChunks;
+        }
+    }
+
+    auto writeChunks = [&](size_t, size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            const size_t chunk = snapshotWriteList[k];
+            const size_t first = chunk * HISTORY_CHUNK_CELLS;
+            const size_t chunkSize = std::min(HISTORY_CHUNK_CELLS, count - first);
+            auto written = std::make_shared<CellStateChunk>();
+            if (changedChunkCells[chunk] == CHUNK_REWRITTEN) {
+                written->cells.resize(chunkSize);
+                for (size_t i = 0; i < chunkSize; ++i) written->cells[i] = bacteria[first + i]->saveState();
+                snapshot.chunks[chunk] = std::move(written);
+                continue;
+            }
+            // Scalenie poprzedniej łatki ze zmienionymi komórkami (obie listy rosnąco)
+            const std::shared_ptr<const CellStateChunk>& previous = lastSnapshotChunks[chunk];
+            written->base = previous->base ? previous->base : previous;
+            const size_t previousCount = previous->base ? previous->offsets.size() : 0;
+            written->cells.reserve(previousCount + changedChunkCells[chunk]);
+            written->offsets.reserve(previousCount + changedChunkCells[chunk]);
+            size_t previousIndex = 0;
+            for (size_t offset = 0; offset < chunkSize; ++offset) {
+                const size_t i = first + offset;
+                const bool changed = (changedCells[i / 64] >> (i % 64)) & 1;
+                const bool patched = previousIndex < previousCount && previous->offsets[previousIndex] == offset;
+                if (changed) {
+                    written->offsets.push_back(static_cast<uint16_t>(offset));
+                    written->cells.push_back(bacteria[i]->saveState());
+                } else if (patched) {
+                    written->offsets.push_back(static_cast<uint16_t>(offset));
+                    written->cells.push_back(previous->cells[previousIndex]);
+                }
+                if (patched) ++previousIndex;
+            }
+            snapshot.chunks[chunk] = std::move(written);
+        }
+    };
+    if (workers) {
+        workers->parallelFor(snapshotWriteList.size(), 1, writeChunks);
+    } else {
+        writeChunks(0, 0, snapshotWriteList.size());
+    }
+
+    snapshot.tick = tickIndex;
+    snapshot.simulationTime = simulationTime;
+    snapshot.cellCount = count;
+    snapshot.stats = stats;
+    snapshot.rng = rng;
+    snapshot.orderedPrefix = orderedPrefix;
+    snapshot.spatialOrderStats = spatialOrderStats;
+    snapshot.clusterReport = clusterReport;
+    snapshot.lastPublishedBirths = lastPublishedBirths;
+    snapshot.lastPublishedDeaths = lastPublishedDeaths;
+
+    lastSnapshotChunks = snapshot.chunks;
+    changedChunkCells.assign(chunkCount, 0);
+    changedCells.assign(chunkCount * HISTORY_CHUNK_CELLS / 64, 0);
+}
+
+// Obiekty komórek, które nadal żyją, są używane ponownie (odnajdywane po identyfikatorze),
+// brakujące tworzone od nowa, a te spoza migawki usuwane.
+void Colony::restoreSnapshot(const ColonySnapshot& snapshot) {
+    TRACE_SCOPE("sim", "Colony::restoreSnapshot");
+    // Posortowane identyfikatory przerwanego porządkowania dotyczą porzuconego stanu
+    spatialOrderSorter.finish();
+
+    reorderedCells.clear();
+    reorderedCells.reserve(snapshot.cellCount);
+    for (const std::shared_ptr<const CellStateChunk>& chunk : snapshot.chunks) {
+        const CellStateChunk& full = chunk->base ? *chunk->base : *chunk;
+        size_t patchIndex = 0;
+        for (size_t offset = 0; offset < full.cells.size(); ++offset) {
+            const CellState* state = &full.cells[offset];
+            if (chunk->base && patchIndex < chunk->offsets.size() && chunk->offsets[patchIndex] == offset) {
+                state = &chunk->cells[patchIndex++];
+            }
+            std::unique_ptr<IBacteria> cell;
+            const uint32_t index = cellIds.find(state->id);
+            if (index != CellIdTable::NO_INDEX && bacteria[index]) {
+                cell = std::move(bacteria[index]);
+            } else {
+                cell = BacteriaFactory::createAtPosition(state->type, state->position);
+            }
+            cell->loadState(*state);
+            reorderedCells.push_back(std::move(cell));
+        }
+    }
+    std::swap(bacteria, reorderedCells);
+    reorderedCells.clear();
+    cellIds.assign(bacteria);
+    rebuildPositionCache();
+    populationChanges.requestRebuild();
+
+    tickIndex = snapshot.tick;
+    simulationTime = snapshot.simulationTime;
+    stats = snapshot.stats;
+    rng = snapshot.rng;
+    orderedPrefix = snapshot.orderedPrefix;
+    spatialOrderStats = snapshot.spatialOrderStats;
+    clusterReport = snapshot.clusterReport;
+    lastPublishedBirths = snapshot.lastPublishedBirths;
+    lastPublishedDeaths = snapshot.lastPublishedDeaths;
+
+    lastSnapshotChunks = snapshot.chunks;
+    changedChunkCells.assign(snapshot.chunks.size(), 0);
+    changedCells.assign(snapshot.chunks.size() * HISTORY_CHUNK_CELLS / 64, 0);
+}
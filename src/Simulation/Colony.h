@@ -0,0 +1,166 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "IBacteria.h"
+#include "ColonyStats.h"
+#include "ColonyClusters.h"
+#include "PopulationGovernor.h"
+#include "PopulationChanges.h"
+#include "CellIdTable.h"
+#include "SpatialOrder.h"
+#include "ColonySnapshot.h"
+#include "InoculationPattern.h"
+#include "Telemetry.h"
+#include "Utils/ThreadPool.h"
+
+// Kolonia bakterii: właściciel komórek, krok symulacji i przyrostowe statystyki.
+// Każda zmiana populacji lub zdrowia przechodzi przez tę klasę, dzięki czemu
+// ColonyStats odpowiada aktualnemu stanowi bez przeglądania całej kolonii.
+class Colony {
+public:
+    // workerCount == 0 oznacza pracę wyłącznie na wątku wywołującym (np. małe kolonie w zespole)
+    explicit Colony(uint32_t seed = std::random_device{}(), size_t workerCount = getDefaultWorkerCount(),
+                    const std::vector<unsigned int>& pinnedCores = {});
+
+    Colony(const Colony&) = delete;
+    Colony& operator=(const Colony&) = delete;
+
+    void addBacteria(SpeciesId type, const glm::vec4& position, uint64_t multiplicity = 1);
+    // Zaszczepienie count bakterii według wzoru (kropla, murawa, posiew, siatka). Pamięć rezerwowana
+    // jest raz, a komórki i ich pozycje powstają równolegle na puli kolonii.
+    // Gdy count przekracza wolne miejsce w budżecie, powstają od razu superosobniki.
+    // Obiekty komórek pochodzą z puli bloków Bacteria, ale milion komórek to nadal ok. 120 ms
+    // na jednym rdzeniu (ok. 220 ms przy pierwszym zapełnieniu puli) - każda komórka kopiuje
+    // obrys gatunku do własnego wektora i aktualizuje liczniki pamięci.
+    void inoculate(SpeciesId type, const InoculationPattern& pattern, uint64_t count);
+    // Kropla wokół punktu (rozkład normalny o odchyleniu spread)
+    void inoculate(SpeciesId type, const glm::vec2& center, int count, float spread);
+
+    // Podziały komórek, którym minął kolejny interwał (5% szans na komórkę), i usunięcie martwych.
+    // Superosobnik dzieli się dwumianowo według krotności; przy wyczerpanym budżecie
+    // potomstwo zwiększa krotność rodzica zamiast tworzyć nowy obiekt.
+    void update(float deltaTime);
+
+    // Antybiotyk o sile malejącej z odległością od środka; liczony równolegle
+    void applyAntibiotic(const glm::vec2& center, float strength, float radius);
+
+    // Limit obiektów i pamięci - powyżej niego komórki łączone są w superosobniki
+    void setPopulationBudget(const PopulationBudget& budget);
+    const PopulationGovernor& getPopulationGovernor() const { return governor; }
+
+    const CellList& getBacteria() const { return bacteria; }
+    size_t size() const { return bacteria.size(); }
+    double getSimulationTime() const { return simulationTime; }
+    uint64_t getTick() const { return tickIndex; }
+
+    static size_t getDefaultWorkerCount();
+
+    const ColonyStatsSnapshot& getStats() const { return stats.getSnapshot(); }
+
+    // Wykrywanie kolonii (skupisk stykających się komórek) co intervalTicks kroków
+    void setClusterSettings(const ColonyClusterSettings& settings) { clusterSettings = settings; }
+    const ColonyClusterSettings& getClusterSettings() const { return clusterSettings; }
+    // Natychmiastowe przeliczenie raportu niezależnie od interwału
+    void detectClusters();
+    const ColonyClusterReport& getClusterReport() const { return clusterReport; }
+
+    // Dziennik zmian populacji (narodziny i zgony z pozycjami) dla odbiorców przyrostowych.
+    // take zwraca true, gdy zamiast zmian trzeba przebudować stan z getBacteria().
+    void setPopulationChangeTracking(bool enabled) { populationChanges.setEnabled(enabled); }
+    bool takePopulationChanges(PopulationChangeList& changes) { return populationChanges.take(changes); }
+
+    // Porządkowanie listy komórek wzdłuż krzywej Mortona, gdy potomstwo dopisywane na końcu
+    // rozproszy sąsiadów po pamięci. Sortowanie rozkłada się na kilka kroków symulacji.
+    void setSpatialOrderSettings(const SpatialOrderSettings& settings) { spatialOrderSettings = settings; }
+    const SpatialOrderSettings& getSpatialOrderSettings() const { return spatialOrderSettings; }
+    const SpatialOrderStats& getSpatialOrderStats() const { return spatialOrderStats; }
+    // Udział komórek spoza uporządkowanego początku listy
+    float getFragmentation() const;
+    // Pełne uporządkowanie od razu, niezależnie od progu (np. w pomiarach)
+    void reorderNow();
+
+    // Bieżący indeks komórki o danym identyfikatorze albo CellIdTable::NO_INDEX, gdy nie żyje
+    uint32_t findCell(CellId id) const { return cellIds.find(id); }
+
+    // Migawki do cofania symulacji. Kolonia pamięta fragmenty listy zmienione od ostatniej
+    // migawki (lub przywrócenia), więc kolejna kopiuje tylko je, a resztę współdzieli.
+    // Migawki nie da się zrobić w trakcie porządkowania przestrzennego.
+    bool canCaptureSnapshot() const { return !spatialOrderSorter.isActive(); }
+    void captureSnapshot(ColonySnapshot& snapshot);
+    // Odtworzenie stanu z migawki; przerywa porządkowanie i zgłasza pełną przebudowę dziennika zmian
+    void restoreSnapshot(const ColonySnapshot& snapshot);
+
+    // Pula wątków kolonii (nullptr przy pracy jednowątkowej) - dla przebiegów pomocniczych
+    // wykonywanych na wątku symulacji między krokami
+    ThreadPool* getWorkerPool() const { return workers.get(); }
+
+    // Opcjonalny kanał telemetrii - po każdym kroku trafia do niego jeden rekord
+    void setTelemetryChannel(TelemetryChannel* channel) { telemetryChannel = channel; }
+
+private:
+    void publishTelemetry();
+    void enforcePopulationBudget();
+    // Usunięcie martwych komórek z zachowaniem zgodności tablic pozycji
+    void removeDeadCells();
+    void rebuildPositionCache();
+    // Krok porządkowania przestrzennego na końcu update i przestawienie po jego zakończeniu
+    void advanceSpatialOrder();
+    void applySpatialOrder();
+    // Zaznaczenie fragmentów migawki obejmujących komórki [begin, end)
+    void markCellsChanged(size_t begin, size_t end);
+    // Potomstwo superosobnika dołączone do rodzica - zdrowie ważone krotnością
+    void absorbOffspring(IBacteria& parent, uint64_t offspring, float offspringHealth, ColonyStatsDelta& delta);
+    // parallelFor na puli kolonii albo pętla na bieżącym wątku, gdy puli nie ma
+    size_t getChunkCount(size_t count) const;
+    void forEachChunk(size_t count, const std::function<void(size_t chunkIndex, size_t begin, size_t end)>& body);
+
+    CellList bacteria;
+    // Pozycje komórek w ciągłych tablicach (indeksy jak w bacteria) dla jąder SIMD.
+    // Komórki się nie przemieszczają - pozycję zmienia tylko łączenie w superosobniki.
+    TrackedVector<float, MemoryTag::SimulationColony> positionX;
+    TrackedVector<float, MemoryTag::SimulationColony> positionY;
+    TrackedVector<float, MemoryTag::SimulationScratch> antibioticIntensity;
+    ColonyStats stats;
+    PopulationGovernor governor;
+    SimulationRng rng;
+    std::unique_ptr<ThreadPool> workers;
+
+    // Stałe identyfikatory komórek; indeks zmienia się przy usuwaniu martwych i porządkowaniu
+    CellIdTable cellIds;
+    SpatialOrderSettings spatialOrderSettings;
+    SpatialOrderSorter spatialOrderSorter;
+    SpatialOrderStats spatialOrderStats;
+    // Liczba komórek na początku listy ułożonych według ostatniego porządkowania
+    size_t orderedPrefix = 0;
+    TrackedVector<uint32_t, MemoryTag::SimulationScratch> reorderIndices;
+    TrackedVector<uint8_t, MemoryTag::SimulationScratch> reorderPlaced;
+    CellList reorderedCells;
+    TrackedVector<float, MemoryTag::SimulationColony> reorderedPositions;
+    // Identyfikatory komórek zaszczepianych hurtowo
+    TrackedVector<CellId, MemoryTag::SimulationScratch> inoculationIds;
+
+    // Fragmenty ostatniej migawki i komórki zmienione od niej: bit na komórkę oraz liczba
+    // zmienionych na fragment (CHUNK_REWRITTEN, gdy zmienił się cały)
+    static constexpr uint32_t CHUNK_REWRITTEN = UINT32_MAX;
+    CellStateChunkList lastSnapshotChunks;
+    TrackedVector<uint64_t, MemoryTag::SimulationColony> changedCells;
+    TrackedVector<uint32_t, MemoryTag::SimulationColony> changedChunkCells;
+    TrackedVector<uint32_t, MemoryTag::SimulationScratch> snapshotWriteList;
+
+    PopulationChangeLog populationChanges;
+    ColonyClusterSettings clusterSettings;
+    ColonyClusterDetector clusterDetector;
+    ColonyClusterReport clusterReport;
+
+    TelemetryChannel* telemetryChannel = nullptr;
+    uint64_t tickIndex = 0;
+    double simulationTime = 0.0;
+    uint64_t lastPublishedBirths = 0;
+    uint64_t lastPublishedDeaths = 0;
+};
@@ -0,0 +1,320 @@
+#include "ColonyClusters.h"
+
+#include "Utils/Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+#include <functional>
+#include <numeric>
+
+// Najmniejsze fragmenty pracy równoległej - komórki i oczka siatki
+const size_t MIN_POINTS_PER_CHUNK = 8192;
+const size_t MIN_RUNS_PER_CHUNK = 1024;
+// Współrzędne siatki ograniczone do 30 bitów - klucz (wiersz, kolumna) mieści się w 64 bitach
+const float MAX_GRID_COORDINATE = static_cast<float>(1u << 30);
+// Sortowanie pozycyjne LSD po 11 bitów klucza na przebieg
+const int RADIX_BITS = 11;
+const size_t RADIX_BUCKETS = size_t(1) << RADIX_BITS;
+
+static int bitsFor(uint64_t value) {
+    int bits = 0;
+    while (value > 0) {
+        ++bits;
+        value >>= 1;
+    }
+    return bits;
+}
+
+static size_t getChunkCount(ThreadPool* pool, size_t count, size_t minChunkSize) {
+    if (!pool) return count > 0 ? 1 : 0;
+    return pool->getChunkCount(count, minChunkSize);
+}
+
+static void forEachRange(ThreadPool* pool, size_t count, size_t minChunkSize,
+                         const std::function<void(size_t chunkIndex, size_t begin, size_t end)>& body) {
+    if (!pool) {
+        if (count > 0) body(0, 0, count);
+        return;
+    }
+    pool->parallelFor(count, minChunkSize, body);
+}
+
+// Połowienie ścieżki: każdy odwiedzony węzeł przepinamy na dziadka. Rodzic ma zawsze
+// mniejszy indeks, więc równoległe przepięcia nie tworzą cykli.
+uint32_t ColonyClusterDetector::findRoot(uint32_t point) {
+    while (true) {
+        uint32_t parent = parents[point].load(std::memory_order_relaxed);
+        if (parent == point) return point;
+        uint32_t grandparent = parents[parent].load(std::memory_order_relaxed);
+        if (grandparent != parent) {
+            parents[point].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+        }
+        point = grandparent;
+    }
+}
+
+// Korzeń o większym indeksie podpinamy pod mniejszy; CAS zawodzi, gdy inny wątek
+// zdążył już podpiąć ten korzeń - wtedy szukamy korzeni od nowa
+void ColonyClusterDetector::unite(uint32_t a, uint32_t b) {
+    while (true) {
+        a = findRoot(a);
+        b = findRoot(b);
+        if (a == b) return;
+        if (a < b) std::swap(a, b);
+        uint32_t expected = a;
+        if (parents[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) return;
+    }
+}
+
+void ColonyClusterDetector::detect(const float* positionX, const float* positionY, const CellList& cells,
+                                   float contactDistance, ThreadPool* pool, ColonyClusterReport& report) {
+    TRACE_SCOPE("sim", "ColonyClusters::detect");
+    auto startTime = std::chrono::steady_clock::now();
+
+    contactDistance = std::max(contactDistance, FLT_EPSILON);
+    report.valid = true;
+    report.contactDistance = contactDistance;
+    report.clusterCount = 0;
+    report.sizeHistogram.fill(0);
+    report.largest.clear();
+
+    const size_t count = cells.size();
+    if (count == 0 || count >= UINT32_MAX) {
+        report.detectionMilliseconds = 0.0;
+        return;
+    }
+
+    // Prostokąt otaczający wyznacza początek siatki i liczbę bitów na wiersz i kolumnę
+    const size_t boundsChunks = getChunkCount(pool, count, MIN_POINTS_PER_CHUNK);
+    std::vector<glm::vec4> chunkBounds(boundsChunks);
+    forEachRange(pool, count, MIN_POINTS_PER_CHUNK, [&](size_t chunkIndex, size_t begin, size_t end) {
+        glm::vec4 bounds(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for (size_t i = begin; i < end; ++i) {
+            bounds.x = std::min(bounds.x, positionX[i]);
+            bounds.y = std::min(bounds.y, positionY[i]);
+            bounds.z = std::max(bounds.z, positionX[i]);
+            bounds.w = std::max(bounds.w, positionY[i]);
+        }
+        chunkBounds[chunkIndex] = bounds;
+    });
+    glm::vec4 bounds(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (const glm::vec4& chunk : chunkBounds) {
+        bounds.x = std::min(bounds.x, chunk.x);
+        bounds.y = std::min(bounds.y, chunk.y);
+        bounds.z = std::max(bounds.z, chunk.z);
+        bounds.w = std::max(bounds.w, chunk.w);
+    }
+
+    const float cellSide = contactDistance / std::sqrt(2.0f);
+    const float inverseCellSide = 1.0f / cellSide;
+    auto gridCoordinate = [inverseCellSide](float value, float origin) {
+        return static_cast<uint32_t>(std::min((value - origin) * inverseCellSide, MAX_GRID_COORDINATE));
+    };
+    // Zapas na przesunięcie do sąsiadów (+2) bez przeniesienia do sąsiedniego pola klucza
+    const int columnBits = bitsFor(static_cast<uint64_t>(gridCoordinate(bounds.z, bounds.x)) + 2);
+    const int rowBits = bitsFor(static_cast<uint64_t>(gridCoordinate(bounds.w, bounds.y)) + 2);
+    const uint64_t columnMask = (uint64_t(1) << columnBits) - 1;
+
+    // Klucz oczka: wiersz w starszych bitach - posortowane oczka idą wierszami
+    sortKeys.resize(count);
+    order.resize(count);
+    weights.resize(count);
+    types.resize(count);
+    forEachRange(pool, count, MIN_POINTS_PER_CHUNK, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            uint64_t column = gridCoordinate(positionX[i], bounds.x);
+            uint64_t row = gridCoordinate(positionY[i], bounds.y);
+            sortKeys[i] = (row << columnBits) | column;
+            order[i] = static_cast<uint32_t>(i);
+            weights[i] = cells[i]->getMultiplicity();
+            types[i] = static_cast<uint8_t>(cells[i]->getSpecies());
+        }
+    });
+
+    {
+        // Sortowanie pozycyjne jest stabilne - w oczku komórki zostają w kolejności indeksów
+        TRACE_SCOPE("sim", "ColonyClusters::sort");
+        // Każdy fragment ma własny histogram cyfr, a jego komórki trafiają za komórki
+        // fragmentów wcześniejszych - dzięki temu przebiegi mogą być równoległe
+        const size_t sortChunks = getChunkCount(pool, count, MIN_POINTS_PER_CHUNK);
+        sortKeysScratch.resize(count);
+        orderScratch.resize(count);
+        radixCounts.resize(sortChunks * RADIX_BUCKETS);
+        for (int shift = 0; shift < columnBits + rowBits; shift += RADIX_BITS) {
+            forEachRange(pool, count, MIN_POINTS_PER_CHUNK, [&](size_t chunkIndex, size_t begin, size_t end) {
+                uint32_t* counts = radixCounts.data() + chunkIndex * RADIX_BUCKETS;
+                std::fill(counts, counts + RADIX_BUCKETS, 0u);
+                for (size_t i = begin; i < end; ++i) ++counts[(sortKeys[i] >> shift) & (RADIX_BUCKETS - 1)];
+            });
+            uint32_t offset = 0;
+            for (size_t digit = 0; digit < RADIX_BUCKETS; ++digit) {
+                for (size_t chunk = 0; chunk < sortChunks; ++chunk) {
+                    uint32_t& bucket = radixCounts[chunk * RADIX_BUCKETS + digit];
+                    uint32_t bucketCount = bucket;
+                    bucket = offset;
+                    offset += bucketCount;
+                }
+            }
+            forEachRange(pool, count, MIN_POINTS_PER_CHUNK, [&](size_t chunkIndex, size_t begin, size_t end) {
+                uint32_t* offsets = radixCounts.data() + chunkIndex * RADIX_BUCKETS;
+                for (size_t i = begin; i < end; ++i) {
+                    uint32_t target = offsets[(sortKeys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+                    sortKeysScratch[target] = sortKeys[i];
+                    orderScratch[target] = order[i];
+                }
+            });
+            std::swap(sortKeys, sortKeysScratch);
+            std::swap(order, orderScratch);
+        }
+
+        sortedX.resize(count);
+        sortedY.resize(count);
+        sortedWeights.resize(count);
+        sortedTypes.resize(count);
+        forEachRange(pool, count, MIN_POINTS_PER_CHUNK, [&](size_t, size_t begin, size_t end) {
+            for (size_t p = begin; p < end; ++p) {
+                const uint32_t cell = order[p];
+                sortedX[p] = positionX[cell];
+                sortedY[p] = positionY[cell];
+                sortedWeights[p] = weights[cell];
+                sortedTypes[p] = types[cell];
+            }
+        });
+
+        runKeys.clear();
+        runStart.clear();
+        for (size_t p = 0; p < count; ++p) {
+            if (p == 0 || sortKeys[p] != runKeys.back()) {
+                runKeys.push_back(sortKeys[p]);
+                runStart.push_back(static_cast<uint32_t>(p));
+            }
+        }
+        runStart.push_back(static_cast<uint32_t>(count));
+    }
+    const size_t runCount = runKeys.size();
+
+    // Komórki jednego oczka są połączone - wszystkie wskazują na pierwszą z nich
+    if (parents.size() < count) parents = Scratch<std::atomic<uint32_t>>(count);
+    forEachRange(pool, runCount, MIN_RUNS_PER_CHUNK, [&](size_t, size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r) {
+            for (uint32_t p = runStart[r]; p < runStart[r + 1]; ++p) {
+                parents[p].store(runStart[r], std::memory_order_relaxed);
+            }
+        }
+    });
+
+    // Łączenie sąsiednich oczek: wystarczy jedna para w odległości styku. Pary, które
+    // są już w jednej składowej, pomijamy bez przeglądania komórek. Przy przekątnej oczka
+    // równej odległości styku oczka odległe o (2, 2) lub dalej nie mogą się stykać.
+    {
+        TRACE_SCOPE("sim", "ColonyClusters::union");
+        const float contactSquared = contactDistance * contactDistance;
+        // root to ostatnio znany korzeń oczka a - po połączeniu zwykle wciąż korzeń,
+        // więc kolejne sprawdzenia sąsiadów kosztują jeden odczyt
+        auto linkRuns = [&](uint32_t& root, size_t a, size_t b) {
+            root = findRoot(root);
+            uint32_t neighbourRoot = findRoot(runStart[b]);
+            if (root == neighbourRoot) return;
+            for (uint32_t p = runStart[a]; p < runStart[a + 1]; ++p) {
+                for (uint32_t q = runStart[b]; q < runStart[b + 1]; ++q) {
+                    float dx = sortedX[p] - sortedX[q];
+                    float dy = sortedY[p] - sortedY[q];
+                    if (dx * dx + dy * dy <= contactSquared) {
+                        unite(root, neighbourRoot);
+                        return;
+                    }
+                }
+            }
+        };
+        forEachRange(pool, runCount, MIN_RUNS_PER_CHUNK, [&](size_t, size_t begin, size_t end) {
+            // Kursory w dwóch kolejnych wierszach; cele rosną razem z r, więc kursory
+            // tylko przesuwają się do przodu
+            size_t cursors[2];
+            for (int dy = 1; dy <= 2; ++dy) {
+                uint64_t firstTarget = runKeys[begin] + (uint64_t(dy) << columnBits) - std::min<uint64_t>(runKeys[begin] & columnMask, 2);
+                cursors[dy - 1] = std::lower_bound(runKeys.begin() + begin, runKeys.end(), firstTarget) - runKeys.begin();
+            }
+            for (size_t r = begin; r < end; ++r) {
+                const uint64_t column = runKeys[r] & columnMask;
+                uint32_t root = runStart[r];
+                // Ten sam wiersz: kolumny +1 i +2
+                for (size_t n = r + 1; n < runCount && runKeys[n] <= runKeys[r] + 2; ++n) {
+                    linkRuns(root, r, n);
+                }
+                // Wiersz +1: kolumny -2..+2, wiersz +2: kolumny -1..+1
+                for (int dy = 1; dy <= 2; ++dy) {
+                    const uint64_t reach = dy == 1 ? 2 : 1;
+                    const uint64_t rowBase = runKeys[r] - column + (uint64_t(dy) << columnBits);
+                    const uint64_t low = rowBase + (column >= reach ? column - reach : 0);
+                    const uint64_t high = rowBase + column + reach;
+                    size_t& cursor = cursors[dy - 1];
+                    while (cursor < runCount && runKeys[cursor] < low) ++cursor;
+                    for (size_t n = cursor; n < runCount && runKeys[n] <= high; ++n) {
+                        linkRuns(root, r, n);
+                    }
+                }
+            }
+        });
+    }
+
+    // Numeracja składowych w kolejności korzeni (korzeń poprzedza resztę składowej)
+    componentOf.resize(count);
+    forEachRange(pool, count, MIN_POINTS_PER_CHUNK, [&](size_t, size_t begin, size_t end) {
+        for (size_t p = begin; p < end; ++p) componentOf[p] = findRoot(static_cast<uint32_t>(p));
+    });
+    uint32_t componentCount = 0;
+    for (size_t p = 0; p < count; ++p) {
+        uint32_t root = componentOf[p];
+        componentOf[p] = root == p ? componentCount++ : componentOf[root];
+    }
+
+    componentCells.assign(componentCount, 0);
+    componentObjects.assign(componentCount, 0);
+    componentSumX.assign(componentCount, 0.0);
+    componentSumY.assign(componentCount, 0.0);
+    // Liczniki gatunków składowych z krokiem równym liczbie zarejestrowanych gatunków, nie MAX_SPECIES
+    const size_t speciesCount = getSpeciesRegistry().size();
+    componentTypes.assign(static_cast<size_t>(componentCount) * speciesCount, 0);
+    for (size_t p = 0; p < count; ++p) {
+        const uint32_t component = componentOf[p];
+        const uint64_t weight = sortedWeights[p];
+        componentCells[component] += weight;
+        componentObjects[component] += 1;
+        componentSumX[component] += static_cast<double>(sortedX[p]) * static_cast<double>(weight);
+        componentSumY[component] += static_cast<double>(sortedY[p]) * static_cast<double>(weight);
+        componentTypes[static_cast<size_t>(component) * speciesCount + sortedTypes[p]] += weight;
+    }
+
+    report.clusterCount = componentCount;
+    for (uint32_t c = 0; c < componentCount; ++c) {
+        int bin = 0;
+        for (uint64_t size = componentCells[c]; size > 1 && bin < CLUSTER_SIZE_HISTOGRAM_BINS - 1; size >>= 1) ++bin;
+        ++report.sizeHistogram[bin];
+    }
+
+    // Największe kolonie; przy równym rozmiarze decyduje kolejność składowych
+    const size_t reportedCount = std::min<size_t>(componentCount, MAX_REPORTED_CLUSTERS);
+    ranking.resize(componentCount);
+    std::iota(ranking.begin(), ranking.end(), 0u);
+    std::partial_sort(ranking.begin(), ranking.begin() + reportedCount, ranking.end(), [this](uint32_t a, uint32_t b) {
+        return componentCells[a] != componentCells[b] ? componentCells[a] > componentCells[b] : a < b;
+    });
+    report.largest.resize(reportedCount);
+    for (size_t i = 0; i < reportedCount; ++i) {
+        const uint32_t component = ranking[i];
+        ColonyCluster& cluster = report.largest[i];
+        const double cellCount = static_cast<double>(componentCells[component]);
+        cluster.cellCount = componentCells[component];
+        cluster.objectCount = componentObjects[component];
+        cluster.centroid = glm::vec2(static_cast<float>(componentSumX[component] / cellCount),
+                                     static_cast<float>(componentSumY[component] / cellCount));
+        cluster.typeCounts.fill(0);
+        for (size_t t = 0; t < speciesCount; ++t) {
+            cluster.typeCounts[t] = componentTypes[static_cast<size_t>(component) * speciesCount + t];
+        }
+    }
+
+    report.detectionMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "ColonyStats.h"
+#include "IBacteria.h"
+#include "Utils/MemoryTracker.h"
+#include "Utils/ThreadPool.h"
+
+// Domyślna odległość styku - potomek pojawia się do 0.5 od rodzica, więc zawsze do niego należy
+const float DEFAULT_CONTACT_DISTANCE = 0.6f;
+// Liczba największych kolonii opisanych w raporcie szczegółowo
+const size_t MAX_REPORTED_CLUSTERS = 64;
+// Histogram rozmiarów kolonii: przedział i obejmuje rozmiary [2^i, 2^(i+1))
+const int CLUSTER_SIZE_HISTOGRAM_BINS = 32;
+static_assert(MAX_SPECIES <= 256, "Gatunek komórki zapisywany jest w detektorze na jednym bajcie");
+
+// Ustawienia wykrywania kolonii; intervalTicks == 0 wyłącza przebieg w Colony::update
+struct ColonyClusterSettings {
+    uint32_t intervalTicks = 0;
+    float contactDistance = DEFAULT_CONTACT_DISTANCE;
+};
+
+// Jedna kolonia - składowa spójna grafu komórek odległych o co najwyżej contactDistance
+struct ColonyCluster {
+    uint64_t cellCount = 0;     // Suma krotności
+    uint32_t objectCount = 0;   // Obiekty symulacji (superosobnik liczony raz)
+    glm::vec2 centroid{0.0f};   // Środek ważony krotnością
+    std::array<uint64_t, MAX_SPECIES> typeCounts{};
+};
+
+struct ColonyClusterReport {
+    uint64_t tick = 0;                 // Krok symulacji, w którym policzono raport
+    bool valid = false;                // false, dopóki wykrywanie nie zostało uruchomione
+    float contactDistance = 0.0f;
+    uint64_t clusterCount = 0;
+    std::array<uint64_t, CLUSTER_SIZE_HISTOGRAM_BINS> sizeHistogram{};
+    std::vector<ColonyCluster> largest;  // Co najwyżej MAX_REPORTED_CLUSTERS, malejąco wg cellCount
+    double detectionMilliseconds = 0.0;
+};
+
+// Wykrywanie kolonii przez równoległe union-find na siatce.
+// Oczko siatki ma przekątną równą odległości styku, więc komórki z jednego oczka są od razu
+// połączone; pary sprawdzamy tylko między oczkami sąsiednimi (5x5 bez narożników, połowa
+// w przód). Siatka jest rzadka: komórki sortowane są pozycyjnie według klucza oczka, a puste
+// oczka nie zajmują pamięci, więc odległe pojedyncze komórki jej nie powiększają.
+// Bufory robocze są zachowywane między wywołaniami.
+class ColonyClusterDetector {
+public:
+    // positionX/positionY - pozycje o indeksach jak w cells; pool może być nullptr
+    void detect(const float* positionX, const float* positionY, const CellList& cells, float contactDistance,
+                ThreadPool* pool, ColonyClusterReport& report);
+
+private:
+    template <typename T>
+    using Scratch = TrackedVector<T, MemoryTag::SimulationScratch>;
+
+    uint32_t findRoot(uint32_t point);
+    void unite(uint32_t a, uint32_t b);
+
+    // Dane komórek w kolejności oryginalnej
+    Scratch<uint64_t> weights;
+    Scratch<uint8_t> types; // Gatunek - MAX_SPECIES mieści się w bajcie
+    // Klucze oczek (wiersz, kolumna) i permutacja sortowania pozycyjnego
+    Scratch<uint64_t> sortKeys;
+    Scratch<uint64_t> sortKeysScratch;
+    Scratch<uint32_t> order;
+    Scratch<uint32_t> orderScratch;
+    Scratch<uint32_t> radixCounts;
+    // Dane komórek w kolejności posortowanej
+    Scratch<float> sortedX;
+    Scratch<float> sortedY;
+    Scratch<uint64_t> sortedWeights;
+    Scratch<uint8_t> sortedTypes;
+    // Oczka - ciągłe przedziały posortowanych komórek o tym samym kluczu, wierszami
+    Scratch<uint64_t> runKeys;
+    Scratch<uint32_t> runStart;
+    // Las union-find na indeksach posortowanych; korzeń to najmniejszy indeks składowej
+    Scratch<std::atomic<uint32_t>> parents;
+    Scratch<uint32_t> componentOf;
+    // Sumy dla składowych
+    Scratch<uint64_t> componentCells;
+    Scratch<uint32_t> componentObjects;
+    Scratch<double> componentSumX;
+    Scratch<double> componentSumY;
+    Scratch<uint64_t> componentTypes;
+    Scratch<uint32_t> ranking;
+};
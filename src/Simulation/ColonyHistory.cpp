@@ -0,0 +1,127 @@
+#include "ColonyHistory.h"
+
+#include "Colony.h"
+#include "Utils/Trace.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    size_t chunkBytes(const CellStateChunk& chunk) {
+        return sizeof(CellStateChunk) + chunk.cells.capacity() * sizeof(CellState) +
+               chunk.offsets.capacity() * sizeof(uint16_t);
+    }
+
+    // Część migawki niezależna od fragmentów
+    size_t snapshotBytes(const ColonySnapshot& snapshot) {
+        return sizeof(ColonySnapshot) + snapshot.chunks.capacity() * sizeof(snapshot.chunks[0]) +
+               snapshot.clusterReport.largest.capacity() * sizeof(ColonyCluster);
+    }
+}
+
+void ColonyHistory::setSettings(const ColonyHistorySettings& newSettings) {
+    settings = newSettings;
+    if (!isEnabled()) {
+        clear();
+        return;
+    }
+    enforceBudget();
+}
+
+void ColonyHistory::afterTick(Colony& colony) {
+    if (!isEnabled()) return;
+    const uint64_t tick = colony.getTick();
+    // Migawki z kroków, które symulacja przechodzi ponownie po cofnięciu
+    while (!snapshots.empty() && snapshots.back()->tick >= tick) popNewest();
+    if (tick < nextCaptureTick || !colony.canCaptureSnapshot()) return;
+
+    TRACE_SCOPE("sim", "ColonyHistory::capture");
+    auto startTime = std::chrono::steady_clock::now();
+    auto snapshot = std::make_unique<ColonySnapshot>();
+    colony.captureSnapshot(*snapshot);
+    stats.lastCaptureMilliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    stats.lastSharedFraction = snapshot->chunks.empty() ? 1.0f :
+        1.0f - static_cast<float>(snapshot->copiedChunks + snapshot->patchedChunks) / static_cast<float>(snapshot->chunks.size());
+    stats.lastPatchedFraction = snapshot->chunks.empty() ? 0.0f :
+        static_cast<float>(snapshot->patchedChunks) / static_cast<float>(snapshot->chunks.size());
+
+    // Kolejna migawka na najbliższej wielokrotności interwału
+    nextCaptureTick = (tick / settings.intervalTicks + 1) * settings.intervalTicks;
+    push(std::move(snapshot));
+}
+
+bool ColonyHistory::restore(Colony& colony, uint64_t tick) {
+    auto found = std::find_if(snapshots.begin(), snapshots.end(),
+                              [tick](const std::unique_ptr<ColonySnapshot>& snapshot) { return snapshot->tick == tick; });
+    if (found == snapshots.end()) return false;
+
+    TRACE_SCOPE("sim", "ColonyHistory::restore");
+    colony.restoreSnapshot(**found);
+    nextCaptureTick = tick + settings.intervalTicks;
+    return true;
+}
+
+void ColonyHistory::clear() {
+    while (!snapshots.empty()) popNewest();
+    nextCaptureTick = 0;
+}
+
+void ColonyHistory::getTicks(std::vector<uint64_t>& ticks) const {
+    ticks.clear();
+    ticks.reserve(snapshots.size());
+    for (const std::unique_ptr<ColonySnapshot>& snapshot : snapshots) ticks.push_back(snapshot->tick);
+}
+
+void ColonyHistory::push(std::unique_ptr<ColonySnapshot> snapshot) {
+    retainChunks(*snapshot);
+    snapshots.push_back(std::move(snapshot));
+    stats.snapshots = snapshots.size();
+    enforceBudget();
+}
+
+void ColonyHistory::popOldest() {
+    releaseChunks(*snapshots.front());
+    snapshots.pop_front();
+    stats.snapshots = snapshots.size();
+    ++stats.evicted;
+}
+
+void ColonyHistory::popNewest() {
+    releaseChunks(*snapshots.back());
+    snapshots.pop_back();
+    stats.snapshots = snapshots.size();
+}
+
+void ColonyHistory::retainChunks(const ColonySnapshot& snapshot) {
+    stats.retainedBytes += snapshotBytes(snapshot);
+    for (const std::shared_ptr<const CellStateChunk>& chunk : snapshot.chunks) {
+        retainChunk(*chunk);
+        if (chunk->base) retainChunk(*chunk->base);
+    }
+}
+
+void ColonyHistory::retainChunk(const CellStateChunk& chunk) {
+    if (chunkReferences[&chunk]++ == 0) stats.retainedBytes += chunkBytes(chunk);
+}
+
+void ColonyHistory::releaseChunks(const ColonySnapshot& snapshot) {
+    stats.retainedBytes -= snapshotBytes(snapshot);
+    for (const std::shared_ptr<const CellStateChunk>& chunk : snapshot.chunks) {
+        releaseChunk(*chunk);
+        if (chunk->base) releaseChunk(*chunk->base);
+    }
+}
+
+void ColonyHistory::releaseChunk(const CellStateChunk& chunk) {
+    auto reference = chunkReferences.find(&chunk);
+    if (--reference->second == 0) {
+        stats.retainedBytes -= chunkBytes(chunk);
+        chunkReferences.erase(reference);
+    }
+}
+
+// Najnowsza migawka zostaje zawsze, nawet ponad budżet - to od niej liczone są następne
+void ColonyHistory::enforceBudget() {
+    while (snapshots.size() > 1 && stats.retainedBytes > settings.memoryBudgetBytes) popOldest();
+}
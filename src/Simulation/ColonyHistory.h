@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "ColonySnapshot.h"
+
+class Colony;
+
+// Historia kolonii do cofania. memoryBudgetBytes == 0 lub intervalTicks == 0 ją wyłącza.
+struct ColonyHistorySettings {
+    // Limit pamięci migawek - po jego przekroczeniu usuwane są najstarsze
+    size_t memoryBudgetBytes = static_cast<size_t>(256) * 1024 * 1024;
+    // Co ile kroków symulacji powstaje migawka
+    uint32_t intervalTicks = 30;
+};
+
+struct ColonyHistoryStats {
+    size_t snapshots = 0;
+    // Pamięć migawek - fragment współdzielony przez kilka migawek liczony raz
+    size_t retainedBytes = 0;
+    uint64_t evicted = 0;
+    double lastCaptureMilliseconds = 0.0;
+    // Udział fragmentów ostatniej migawki przejętych bez zmian z poprzedniej i zapisanych jako łatki
+    float lastSharedFraction = 0.0f;
+    float lastPatchedFraction = 0.0f;
+};
+
+// Ograniczona historia migawek kolonii. Kolejne migawki współdzielą niezmienione fragmenty
+// stanu komórek, a fragmenty z kilkoma zmienionymi komórkami zapisują tylko je (łatki), więc koszt
+// migawki i jej pamięć rosną z liczbą zmian, a nie z rozmiarem kolonii.
+// Po przywróceniu migawki późniejsze zostają do kolejnego kroku symulacji (można między nimi
+// przewijać), a gdy symulacja ruszy od przywróconego kroku, porzucona przyszłość jest usuwana.
+class ColonyHistory {
+public:
+    void setSettings(const ColonyHistorySettings& newSettings);
+    const ColonyHistorySettings& getSettings() const { return settings; }
+    bool isEnabled() const { return settings.memoryBudgetBytes > 0 && settings.intervalTicks > 0; }
+
+    // Wywoływane po każdym kroku kolonii. Migawka w trakcie porządkowania przestrzennego
+    // jest odkładana do pierwszego kroku po nim.
+    void afterTick(Colony& colony);
+    // Przywraca migawkę z danego kroku; false, gdy takiej nie ma
+    bool restore(Colony& colony, uint64_t tick);
+    void clear();
+
+    // Kroki zachowanych migawek, od najstarszej
+    void getTicks(std::vector<uint64_t>& ticks) const;
+    const ColonyHistoryStats& getStats() const { return stats; }
+
+private:
+    void push(std::unique_ptr<ColonySnapshot> snapshot);
+    void popOldest();
+    void popNewest();
+    // Liczniki odwołań do fragmentów (także pełnych kopii pod łatkami) i pamięć liczona
+    // przy pierwszym/ostatnim odwołaniu
+    void retainChunks(const ColonySnapshot& snapshot);
+    void releaseChunks(const ColonySnapshot& snapshot);
+    void retainChunk(const CellStateChunk& chunk);
+    void releaseChunk(const CellStateChunk& chunk);
+    void enforceBudget();
+
+    ColonyHistorySettings settings;
+    ColonyHistoryStats stats;
+    std::deque<std::unique_ptr<ColonySnapshot>> snapshots;
+    std::unordered_map<const CellStateChunk*, uint32_t> chunkReferences;
+    uint64_t nextCaptureTick = 0;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "IBacteria.h"
+#include "ColonyStats.h"
+#include "ColonyClusters.h"
+#include "SpatialOrder.h"
+#include "Utils/MemoryTracker.h"
+
+// Liczba komórek w jednym fragmencie migawki. Fragment to jednostka współdzielenia:
+// niezmieniony od poprzedniej migawki przechodzi do następnej bez kopiowania.
+const size_t HISTORY_CHUNK_CELLS = 4096;
+// Fragment, w którym od ostatniej pełnej kopii zmieniło się co najwyżej tyle komórek,
+// zapisywany jest jako łatka (zmienione komórki na tle pełnej kopii) zamiast nowej kopii
+const size_t HISTORY_PATCH_LIMIT = HISTORY_CHUNK_CELLS / 8;
+
+// Stany kolejnych komórek listy kolonii; po utworzeniu tylko do odczytu.
+// Pełny fragment ma stany wszystkich komórek, łatka - tylko zmienione (offsets rosnąco)
+// na tle pełnego fragmentu base.
+struct CellStateChunk {
+    std::shared_ptr<const CellStateChunk> base;
+    TrackedVector<CellState, MemoryTag::SimulationHistory> cells;
+    TrackedVector<uint16_t, MemoryTag::SimulationHistory> offsets;
+
+    size_t size() const { return base ? base->cells.size() : cells.size(); }
+};
+
+using CellStateChunkList = TrackedVector<std::shared_ptr<const CellStateChunk>, MemoryTag::SimulationHistory>;
+
+// Stan kolonii po kroku tick, z którego da się ją odtworzyć w całości
+struct ColonySnapshot {
+    uint64_t tick = 0;
+    double simulationTime = 0.0;
+    size_t cellCount = 0;
+    CellStateChunkList chunks;
+    // Pełne kopie i łatki zapisane przy tej migawce - pozostałe fragmenty są współdzielone z poprzednią
+    size_t copiedChunks = 0;
+    size_t patchedChunks = 0;
+
+    ColonyStats stats;
+    SimulationRng rng;
+    size_t orderedPrefix = 0;
+    SpatialOrderStats spatialOrderStats;
+    ColonyClusterReport clusterReport;
+    uint64_t lastPublishedBirths = 0;
+    uint64_t lastPublishedDeaths = 0;
+};
@@ -0,0 +1,134 @@
+#include "ColonyStats.h"
+
+#include <algorithm>
+
+// Długość okna, z którego liczone są urodzenia i zgony na sekundę
+const float RATE_WINDOW_SECONDS = 1.0f;
+
+void ColonyStatsDelta::onAdded(SpeciesId type, float health, float resistance, uint64_t count) {
+    const int64_t cells = static_cast<int64_t>(count);
+    typeCounts[static_cast<int>(type)] += cells;
+    healthBins[ColonyStats::healthBin(health)] += cells;
+    resistanceBins[ColonyStats::resistanceBin(resistance)] += cells;
+    healthSum += static_cast<double>(health) * static_cast<double>(count);
+    resistanceSum += static_cast<double>(resistance) * static_cast<double>(count);
+}
+
+void ColonyStatsDelta::onBirth(SpeciesId type, float health, float resistance, uint64_t count) {
+    onAdded(type, health, resistance, count);
+    births += count;
+}
+
+void ColonyStatsDelta::onDamaged(SpeciesId type, float oldHealth, float newHealth, float resistance, uint64_t count) {
+    if (count == 0 || oldHealth <= 0.0f || newHealth == oldHealth) return;
+
+    const int64_t cells = static_cast<int64_t>(count);
+    healthBins[ColonyStats::healthBin(oldHealth)] -= cells;
+    healthSum -= static_cast<double>(oldHealth) * static_cast<double>(count);
+
+    if (newHealth <= 0.0f) {
+        typeCounts[static_cast<int>(type)] -= cells;
+        resistanceBins[ColonyStats::resistanceBin(resistance)] -= cells;
+        resistanceSum -= static_cast<double>(resistance) * static_cast<double>(count);
+        deaths += count;
+        return;
+    }
+    healthBins[ColonyStats::healthBin(newHealth)] += cells;
+    healthSum += static_cast<double>(newHealth) * static_cast<double>(count);
+}
+
+void ColonyStatsDelta::onTypeChanged(SpeciesId oldType, SpeciesId newType) {
+    typeCounts[static_cast<int>(oldType)] -= 1;
+    typeCounts[static_cast<int>(newType)] += 1;
+}
+
+bool ColonyStatsDelta::isEmpty() const {
+    auto allZero = [](const auto& values) {
+        return std::all_of(values.begin(), values.end(), [](int64_t value) { return value == 0; });
+    };
+    return births == 0 && deaths == 0 && allZero(typeCounts) && allZero(healthBins) && allZero(resistanceBins);
+}
+
+int ColonyStats::healthBin(float health) {
+    int bin = static_cast<int>(health / MAX_TRACKED_HEALTH * HEALTH_HISTOGRAM_BINS);
+    return std::clamp(bin, 0, HEALTH_HISTOGRAM_BINS - 1);
+}
+
+int ColonyStats::resistanceBin(float resistance) {
+    int bin = static_cast<int>(resistance * RESISTANCE_HISTOGRAM_BINS);
+    return std::clamp(bin, 0, RESISTANCE_HISTOGRAM_BINS - 1);
+}
+
+void ColonyStats::merge(const ColonyStatsDelta& delta) {
+    if (delta.isEmpty()) return;
+
+    for (int i = 0; i < MAX_SPECIES; ++i) {
+        snapshot.typeCounts[i] = static_cast<uint64_t>(static_cast<int64_t>(snapshot.typeCounts[i]) + delta.typeCounts[i]);
+    }
+    for (int i = 0; i < HEALTH_HISTOGRAM_BINS; ++i) {
+        snapshot.healthHistogram[i] = static_cast<uint64_t>(static_cast<int64_t>(snapshot.healthHistogram[i]) + delta.healthBins[i]);
+    }
+    for (int i = 0; i < RESISTANCE_HISTOGRAM_BINS; ++i) {
+        snapshot.resistanceHistogram[i] = static_cast<uint64_t>(static_cast<int64_t>(snapshot.resistanceHistogram[i]) + delta.resistanceBins[i]);
+    }
+    healthSum += delta.healthSum;
+    resistanceSum += delta.resistanceSum;
+    snapshot.totalBirths += delta.births;
+    snapshot.totalDeaths += delta.deaths;
+    rateWindowBirths += delta.births;
+    rateWindowDeaths += delta.deaths;
+
+    refreshDerived();
+}
+
+void ColonyStats::tick(float deltaTime) {
+    rateWindowElapsed += deltaTime;
+    if (rateWindowElapsed < RATE_WINDOW_SECONDS) return;
+
+    snapshot.birthsPerSecond = static_cast<float>(rateWindowBirths) / rateWindowElapsed;
+    snapshot.deathsPerSecond = static_cast<float>(rateWindowDeaths) / rateWindowElapsed;
+    rateWindowElapsed = 0.0f;
+    rateWindowBirths = 0;
+    rateWindowDeaths = 0;
+}
+
+void ColonyStats::reset() {
+    *this = ColonyStats();
+}
+
+// Średnie i percentyle z histogramu - koszt zależy tylko od liczby przedziałów
+void ColonyStats::refreshDerived() {
+    uint64_t total = 0;
+    for (uint64_t count : snapshot.typeCounts) total += count;
+    snapshot.total = total;
+
+    if (total == 0) {
+        // Zerujemy akumulatory, żeby nie zbierały błędów zaokrągleń między pustymi okresami
+        healthSum = 0.0;
+        resistanceSum = 0.0;
+        snapshot.meanHealth = snapshot.meanResistance = 0.0f;
+        snapshot.healthP10 = snapshot.healthP50 = snapshot.healthP90 = 0.0f;
+        return;
+    }
+    snapshot.meanHealth = static_cast<float>(healthSum / static_cast<double>(total));
+    snapshot.meanResistance = static_cast<float>(resistanceSum / static_cast<double>(total));
+
+    auto percentile = [this, total](float fraction) {
+        const float binWidth = MAX_TRACKED_HEALTH / HEALTH_HISTOGRAM_BINS;
+        float target = fraction * static_cast<float>(total);
+        uint64_t cumulative = 0;
+        for (int i = 0; i < HEALTH_HISTOGRAM_BINS; ++i) {
+            uint64_t binCount = snapshot.healthHistogram[i];
+            if (binCount > 0 && static_cast<float>(cumulative + binCount) >= target) {
+                // Interpolacja liniowa wewnątrz przedziału
+                float withinBin = (target - static_cast<float>(cumulative)) / static_cast<float>(binCount);
+                return (static_cast<float>(i) + std::clamp(withinBin, 0.0f, 1.0f)) * binWidth;
+            }
+            cumulative += binCount;
+        }
+        return MAX_TRACKED_HEALTH;
+    };
+    snapshot.healthP10 = percentile(0.1f);
+    snapshot.healthP50 = percentile(0.5f);
+    snapshot.healthP90 = percentile(0.9f);
+}
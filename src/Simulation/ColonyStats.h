@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "IBacteria.h"
+#include "SpeciesRegistry.h"
+
+// Histogramy o stałej liczbie przedziałów - zdrowie w [0, MAX_TRACKED_HEALTH], odporność w [0, 1]
+const int HEALTH_HISTOGRAM_BINS = 16;
+const int RESISTANCE_HISTOGRAM_BINS = 16;
+const float MAX_TRACKED_HEALTH = 1.2f;
+
+// Zmiany statystyk zebrane przez jeden wątek (lub jedną fazę aktualizacji).
+// Zdarzenia są tu tylko zliczane; do ColonyStats trafiają przez merge().
+// count to liczba komórek objętych zdarzeniem - dla superosobnika jego krotność.
+struct ColonyStatsDelta {
+    std::array<int64_t, MAX_SPECIES> typeCounts{};
+    std::array<int64_t, HEALTH_HISTOGRAM_BINS> healthBins{};
+    std::array<int64_t, RESISTANCE_HISTOGRAM_BINS> resistanceBins{};
+    double healthSum = 0.0;
+    double resistanceSum = 0.0;
+    uint64_t births = 0;
+    uint64_t deaths = 0;
+
+    // Pojawienie się żywej komórki (zaszczepienie); onBirth dodatkowo liczy podział
+    void onAdded(SpeciesId type, float health, float resistance, uint64_t count = 1);
+    void onBirth(SpeciesId type, float health, float resistance, uint64_t count = 1);
+    // Zmiana zdrowia; spadek do zera jest śmiercią i usuwa komórkę z agregatów
+    void onDamaged(SpeciesId type, float oldHealth, float newHealth, float resistance, uint64_t count = 1);
+    void onTypeChanged(SpeciesId oldType, SpeciesId newType);
+
+    bool isEmpty() const;
+};
+
+// Gotowy do odczytu blok statystyk kolonii - wartości pochodne liczone przy scalaniu
+struct ColonyStatsSnapshot {
+    uint64_t total = 0;
+    std::array<uint64_t, MAX_SPECIES> typeCounts{};
+    std::array<uint64_t, HEALTH_HISTOGRAM_BINS> healthHistogram{};
+    std::array<uint64_t, RESISTANCE_HISTOGRAM_BINS> resistanceHistogram{};
+    float meanHealth = 0.0f;
+    float healthP10 = 0.0f;
+    float healthP50 = 0.0f;
+    float healthP90 = 0.0f;
+    float meanResistance = 0.0f;
+    uint64_t totalBirths = 0;
+    uint64_t totalDeaths = 0;
+    float birthsPerSecond = 0.0f;
+    float deathsPerSecond = 0.0f;
+};
+
+// Statystyki kolonii utrzymywane przyrostowo ze zdarzeń symulacji.
+// Koszt scalenia nie zależy od liczby bakterii, a odczyt to zwrócenie referencji.
+class ColonyStats {
+public:
+    void merge(const ColonyStatsDelta& delta);
+    // Przesuwa okno pomiaru urodzeń i zgonów na sekundę
+    void tick(float deltaTime);
+    void reset();
+
+    const ColonyStatsSnapshot& getSnapshot() const { return snapshot; }
+
+    static int healthBin(float health);
+    static int resistanceBin(float resistance);
+
+private:
+    void refreshDerived();
+
+    ColonyStatsSnapshot snapshot;
+    double healthSum = 0.0;
+    double resistanceSum = 0.0;
+
+    float rateWindowElapsed = 0.0f;
+    uint64_t rateWindowBirths = 0;
+    uint64_t rateWindowDeaths = 0;
+};
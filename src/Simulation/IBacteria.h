@@ -5,32 +5,75 @@
 #include <vector>
 #include <utility> 
 #include <string>  
+#include <random>
+#include <cstdint>
+#include <memory>
 
-enum class BacteriaType {
-    Cocci,
-    Diplococcus,
-    Staphylococci,
-    Bacillus
-};
+#include "Utils/MemoryTracker.h"
+
+// Indeks gatunku w rejestrze gatunków (SpeciesRegistry)
+using SpeciesId = uint16_t;
 
 struct BacteriaStats;
 
+// Wierzchołki obrysu komórki w jej lokalnym układzie
+using BacteriaCircuit = TrackedVector<std::pair<float, float>, MemoryTag::SimulationCircuits>;
+
+// Generator liczb losowych symulacji - każda kolonia ma własny, ziarnisty strumień
+using SimulationRng = std::mt19937;
+
+// Stały identyfikator komórki w kolonii: młodsze 32 bity to wpis tablicy pośredniej,
+// starsze - generacja wpisu, więc identyfikator martwej komórki nie wskaże jej następczyni
+using CellId = uint64_t;
+const CellId INVALID_CELL_ID = ~CellId(0);
+
+// Pełny stan komórki zapisywany w migawkach historii kolonii. Obrys nie jest zapisywany -
+// wynika z gatunku komórki.
+struct CellState {
+    glm::vec4 position;
+    double birthTime;
+    uint64_t multiplicity;
+    CellId id;
+    float health;
+    float antibioticResistance;
+    SpeciesId type;
+};
+
 class IBacteria {
 public:
     virtual ~IBacteria() = default;
 
-    virtual void update(float deltaTime) = 0;
-    virtual bool canDivide() const = 0;
+    // Okazja do podziału przypada co divisionInterval od narodzin - komórka między zdarzeniami
+    // się nie zmienia. Sprawdzany jest krok (simulationTime - deltaTime, simulationTime].
+    virtual bool canDivide(double simulationTime, float deltaTime) const = 0;
+    virtual void setBirthTime(double time) = 0;
     virtual void applyAntibiotic(float intensity) = 0;
-    virtual IBacteria* clone() const = 0; 
-    virtual void resetDivisionTimer() = 0;
+    // Spadek zdrowia, jaki spowodowałby antybiotyk o danej intensywności (z uwzględnieniem odporności)
+    virtual float getAntibioticDamage(float intensity) const = 0;
+    virtual IBacteria* clone(SimulationRng& rng) const = 0; 
     virtual bool isAlive() const = 0;
 
     virtual float getHealth() const = 0;
+    virtual float getAntibioticResistance() const = 0;
     virtual glm::vec4 getPos() const = 0;
-    virtual BacteriaType getBacteriaType() const = 0;
+    virtual SpeciesId getSpecies() const = 0;
 
-    virtual const std::vector<std::pair<float, float>>& getCircuit() const = 0; 
+    virtual const BacteriaCircuit& getCircuit() const = 0; 
 
     virtual void setPos(const glm::vec4& newPosition) = 0;
+    virtual void setHealth(float newHealth) = 0;
+
+    // Liczba rzeczywistych komórek reprezentowanych przez obiekt (superosobnik > 1)
+    virtual uint64_t getMultiplicity() const = 0;
+    virtual void setMultiplicity(uint64_t newMultiplicity) = 0;
+
+    // Identyfikator nadawany przez kolonię (INVALID_CELL_ID dla komórki spoza kolonii)
+    virtual CellId getCellId() const = 0;
+    virtual void setCellId(CellId id) = 0;
+
+    virtual CellState saveState() const = 0;
+    virtual void loadState(const CellState& state) = 0;
 };
+
+// Lista komórek kolonii
+using CellList = TrackedVector<std::unique_ptr<IBacteria>, MemoryTag::SimulationColony>;
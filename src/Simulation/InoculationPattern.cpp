@@ -0,0 +1,84 @@
+#include "InoculationPattern.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+    // Mieszanie SplitMix64 - kolejne wartości licznika dają niezależnie wyglądające liczby
+    uint64_t splitMix64(uint64_t value) {
+        value += 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+}
+
+InoculationSampler::InoculationSampler(const InoculationPattern& pattern, uint64_t count, uint64_t seed)
+    : pattern(pattern), seed(splitMix64(seed)), gridSide(1) {
+    if (pattern.shape == InoculationShape::Grid) {
+        gridSide = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::sqrt(static_cast<double>(count)))));
+    }
+    if (pattern.shape == InoculationShape::Streak && !pattern.points.empty()) {
+        streakLengths.reserve(pattern.points.size());
+        float length = 0.0f;
+        streakLengths.push_back(length);
+        for (size_t i = 1; i < pattern.points.size(); ++i) {
+            length += glm::length(pattern.points[i] - pattern.points[i - 1]);
+            streakLengths.push_back(length);
+        }
+    }
+}
+
+float InoculationSampler::uniform(uint64_t index, uint32_t stream) const {
+    // 24 najstarsze bity - dokładnie reprezentowalne we float, wynik < 1
+    uint64_t bits = splitMix64(seed + index * INOCULATION_STREAMS_PER_CELL + stream) >> 40;
+    return static_cast<float>(bits) * (1.0f / 16777216.0f);
+}
+
+// Box-Muller: para niezależnych wartości N(0, 1) z dwóch kolejnych strumieni
+glm::vec2 InoculationSampler::normal(uint64_t index, uint32_t stream) const {
+    float radius = std::sqrt(-2.0f * std::log(1.0f - uniform(index, stream)));
+    float angle = 2.0f * static_cast<float>(M_PI) * uniform(index, stream + 1);
+    return glm::vec2(radius * std::cos(angle), radius * std::sin(angle));
+}
+
+glm::vec2 InoculationSampler::position(uint64_t index) const {
+    switch (pattern.shape) {
+        case InoculationShape::Lawn: {
+            // Pierwiastek z promienia daje równomierną gęstość na powierzchni dysku
+            float radius = pattern.size * std::sqrt(uniform(index, 0));
+            float angle = 2.0f * static_cast<float>(M_PI) * uniform(index, 1);
+            return pattern.center + glm::vec2(radius * std::cos(angle), radius * std::sin(angle));
+        }
+        case InoculationShape::Streak: {
+            if (streakLengths.size() < 2 || streakLengths.back() <= 0.0f) break;
+            // Punkt równomiernie wzdłuż łamanej, przesunięty w poprzek linii
+            float distance = uniform(index, 0) * streakLengths.back();
+            size_t segment = static_cast<size_t>(std::upper_bound(streakLengths.begin(), streakLengths.end(), distance) - streakLengths.begin());
+            segment = std::clamp<size_t>(segment, 1, streakLengths.size() - 1);
+            const glm::vec2 from = pattern.points[segment - 1];
+            const glm::vec2 to = pattern.points[segment];
+            float segmentLength = streakLengths[segment] - streakLengths[segment - 1];
+            float t = segmentLength > 0.0f ? (distance - streakLengths[segment - 1]) / segmentLength : 0.0f;
+            glm::vec2 direction = segmentLength > 0.0f ? (to - from) / segmentLength : glm::vec2(1.0f, 0.0f);
+            glm::vec2 across(-direction.y, direction.x);
+            return from + (to - from) * t + across * (pattern.size * normal(index, 2).x);
+        }
+        case InoculationShape::Grid: {
+            // Wiersze od dołu, siatka wyśrodkowana na center
+            float offset = 0.5f * static_cast<float>(gridSide - 1);
+            float column = static_cast<float>(index % gridSide) - offset;
+            float row = static_cast<float>(index / gridSide) - offset;
+            return pattern.center + glm::vec2(column, row) * pattern.size;
+        }
+        case InoculationShape::Blob:
+            break;
+    }
+    // Kropla, a także posiew bez łamanej
+    const glm::vec2 origin = (pattern.shape == InoculationShape::Streak && !pattern.points.empty()) ? pattern.points.front() : pattern.center;
+    return origin + normal(index, 0) * pattern.size;
+}
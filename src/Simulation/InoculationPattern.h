@@ -0,0 +1,48 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// Kształt zaszczepienia
+enum class InoculationShape : uint8_t {
+    Blob = 0,   // Kropla: rozkład normalny wokół środka, size to odchylenie
+    Lawn = 1,   // Murawa: równomiernie w dysku o promieniu size
+    Streak = 2, // Posiew ezą: wzdłuż łamanej points, size to odchylenie w poprzek linii
+    Grid = 3    // Siatka: kwadrat wokół środka, size to odstęp między komórkami
+};
+const int INOCULATION_SHAPE_COUNT = static_cast<int>(InoculationShape::Grid) + 1;
+
+// Opis zaszczepienia w przestrzeni świata
+struct InoculationPattern {
+    InoculationShape shape = InoculationShape::Blob;
+    glm::vec2 center{0.0f, 0.0f};
+    float size = 2.0f;
+    std::vector<glm::vec2> points; // Wierzchołki łamanej posiewu
+};
+
+const uint32_t INOCULATION_POSITION_STREAMS = 4;
+// Strumieni na komórkę - pozostałe są do dyspozycji wywołującego
+const uint32_t INOCULATION_STREAMS_PER_CELL = 8;
+
+// Losowanie pozycji zaszczepienia. Liczby losowe wynikają z (seed, indeks komórki) - pozycja
+// nie zależy od kolejności liczenia, więc zakresy komórek można generować na wielu wątkach.
+class InoculationSampler {
+public:
+    InoculationSampler(const InoculationPattern& pattern, uint64_t count, uint64_t seed);
+
+    glm::vec2 position(uint64_t index) const;
+    // Liczba z [0, 1) dla komórki index; stream rozróżnia niezależne wartości jednej komórki.
+    // Strumienie [0, INOCULATION_POSITION_STREAMS) zużywa position().
+    float uniform(uint64_t index, uint32_t stream) const;
+
+private:
+    glm::vec2 normal(uint64_t index, uint32_t stream) const;
+
+    InoculationPattern pattern;
+    uint64_t seed;
+    uint64_t gridSide;
+    // Długości łamanej od pierwszego wierzchołka (posiew)
+    std::vector<float> streakLengths;
+};
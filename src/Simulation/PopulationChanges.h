@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Utils/MemoryTracker.h"
+
+// Zmiana liczby komórek w punkcie szalki: narodziny (+), zgony (-), zaszczepienie (+).
+// weight to liczba komórek - dla superosobnika część jego krotności.
+struct PopulationChange {
+    float x;
+    float y;
+    int64_t weight;
+};
+
+using PopulationChangeList = TrackedVector<PopulationChange, MemoryTag::SimulationScratch>;
+
+// Po tylu zaległych zmianach dziennik zamienia je na żądanie pełnej przebudowy,
+// aby nieodbierany dziennik nie rósł bez ograniczeń
+const size_t MAX_PENDING_POPULATION_CHANGES = size_t(1) << 22;
+
+// Dziennik zmian populacji od ostatniego odbioru. Odbiorca (np. kontury kolonii) aktualizuje
+// na jego podstawie własne struktury przyrostowo; gdy zmiany nie da się opisać punktowo
+// (łączenie w superosobniki), dziennik zgłasza pełną przebudowę.
+class PopulationChangeLog {
+public:
+    void setEnabled(bool enabled) {
+        active = enabled;
+        changes.clear();
+        rebuildRequired = enabled;
+    }
+    bool isEnabled() const { return active; }
+
+    void record(float x, float y, int64_t weight) {
+        if (!active || rebuildRequired || weight == 0) return;
+        if (changes.size() >= MAX_PENDING_POPULATION_CHANGES) {
+            requestRebuild();
+            return;
+        }
+        changes.push_back({x, y, weight});
+    }
+
+    void append(const PopulationChangeList& list) {
+        for (const PopulationChange& change : list) record(change.x, change.y, change.weight);
+    }
+
+    void requestRebuild() {
+        if (!active) return;
+        rebuildRequired = true;
+        changes.clear();
+    }
+
+    // Przekazuje zaległe zmiany (zastępując zawartość out). Zwraca true, gdy odbiorca
+    // musi przebudować swój stan od zera na podstawie bieżącej listy komórek.
+    bool take(PopulationChangeList& out) {
+        out.clear();
+        out.swap(changes);
+        bool rebuild = rebuildRequired;
+        rebuildRequired = false;
+        return rebuild;
+    }
+
+private:
+    bool active = false;
+    bool rebuildRequired = false;
+    PopulationChangeList changes;
+};
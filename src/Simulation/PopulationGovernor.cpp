@@ -0,0 +1,148 @@
+#include "PopulationGovernor.h"
+
+#include "Bacteria.h"
+#include "BacteriaStatsProvider.h"
+#include "ColonyStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+// Łączenie zaczyna się po zajęciu tej części limitu i kończy po zejściu do docelowej
+const float AGGREGATION_TRIGGER_FRACTION = 0.95f;
+const float AGGREGATION_TARGET_FRACTION = 0.75f;
+// Pierwsze oczko siatki ma rozmiar rzędu odległości rodzic-potomek; każde przejście je podwaja
+const float AGGREGATION_INITIAL_CELL_SIZE = 1.0f;
+const int AGGREGATION_MAX_PASSES = 16;
+// Narzut alokatora na pojedynczą alokację (obiekt bakterii, wektor obrysu)
+const size_t ALLOCATION_OVERHEAD_BYTES = 16;
+
+PopulationGovernor::PopulationGovernor() {
+    setBudget(PopulationBudget());
+}
+
+void PopulationGovernor::setBudget(const PopulationBudget& newBudget) {
+    budget = newBudget;
+    size_t memoryLimit = budget.maxMemoryBytes / estimateBytesPerIndividual();
+    individualLimit = std::max<size_t>(1, std::min(budget.maxIndividuals, memoryLimit));
+}
+
+size_t PopulationGovernor::getHeadroom(size_t currentCount) const {
+    return currentCount < individualLimit ? individualLimit - currentCount : 0;
+}
+
+bool PopulationGovernor::needsAggregation(size_t currentCount) const {
+    return static_cast<float>(currentCount) >= AGGREGATION_TRIGGER_FRACTION * static_cast<float>(individualLimit);
+}
+
+size_t PopulationGovernor::estimateBytesPerIndividual() {
+    size_t largestCircuit = 0;
+    const SpeciesRegistry& registry = getSpeciesRegistry();
+    for (size_t species = 0; species < registry.size(); ++species) {
+        largestCircuit = std::max(largestCircuit, registry.get(static_cast<SpeciesId>(species)).stats.circuit.size());
+    }
+    // Obiekt, jego obrys, wskaźnik w wektorze kolonii i zapas pojemności tego wektora
+    return sizeof(Bacteria) + largestCircuit * sizeof(std::pair<float, float>) +
+           2 * ALLOCATION_OVERHEAD_BYTES + 2 * sizeof(std::unique_ptr<IBacteria>);
+}
+
+// Dołączenie source do target: pozycja i zdrowie ważone krotnością, krotności się sumują.
+// Obie komórki mają zdrowie z tego samego przedziału, więc średnia w nim pozostaje.
+static void mergeInto(IBacteria& target, const IBacteria& source) {
+    uint64_t targetMultiplicity = target.getMultiplicity();
+    uint64_t sourceMultiplicity = source.getMultiplicity();
+    uint64_t mergedMultiplicity = targetMultiplicity + sourceMultiplicity;
+    float targetWeight = static_cast<float>(static_cast<double>(targetMultiplicity) / static_cast<double>(mergedMultiplicity));
+    float sourceWeight = 1.0f - targetWeight;
+
+    glm::vec4 targetPosition = target.getPos();
+    glm::vec4 sourcePosition = source.getPos();
+    target.setPos(glm::vec4(targetPosition.x * targetWeight + sourcePosition.x * sourceWeight,
+                            targetPosition.y * targetWeight + sourcePosition.y * sourceWeight,
+                            std::max(targetPosition.z, sourcePosition.z),
+                            targetPosition.w));
+
+    float targetHealth = target.getHealth();
+    float sourceHealth = source.getHealth();
+    float mergedHealth = targetHealth * targetWeight + sourceHealth * sourceWeight;
+    target.setHealth(std::clamp(mergedHealth, std::min(targetHealth, sourceHealth), std::max(targetHealth, sourceHealth)));
+    target.setMultiplicity(mergedMultiplicity);
+}
+
+// Klucz oczka: gatunek, przedział zdrowia i współrzędne siatki (24 bity na oś)
+static uint64_t aggregationKey(const IBacteria& cell, float cellSize) {
+    glm::vec4 position = cell.getPos();
+    int64_t gridX = static_cast<int64_t>(std::floor(position.x / cellSize));
+    int64_t gridY = static_cast<int64_t>(std::floor(position.y / cellSize));
+    uint64_t type = static_cast<uint64_t>(cell.getSpecies());
+    uint64_t bin = static_cast<uint64_t>(ColonyStats::healthBin(cell.getHealth()));
+    return (type << 56) | (bin << 48) |
+           ((static_cast<uint64_t>(gridX) & 0xFFFFFF) << 24) | (static_cast<uint64_t>(gridY) & 0xFFFFFF);
+}
+
+size_t PopulationGovernor::aggregate(CellList& cells) const {
+    const size_t initialCount = cells.size();
+    const size_t targetCount = static_cast<size_t>(AGGREGATION_TARGET_FRACTION * static_cast<float>(individualLimit));
+
+    std::unordered_map<uint64_t, size_t> representatives;
+    float cellSize = AGGREGATION_INITIAL_CELL_SIZE;
+    for (int pass = 0; pass < AGGREGATION_MAX_PASSES && cells.size() > targetCount; ++pass, cellSize *= 2.0f) {
+        representatives.clear();
+        representatives.reserve(cells.size());
+
+        // Pierwsza żywa komórka w oczku zostaje reprezentantem, kolejne są do niej dołączane
+        for (size_t i = 0; i < cells.size(); ++i) {
+            IBacteria* cell = cells[i].get();
+            if (!cell || !cell->isAlive()) continue;
+
+            auto inserted = representatives.emplace(aggregationKey(*cell, cellSize), i);
+            if (!inserted.second) {
+                mergeInto(*cells[inserted.first->second], *cell);
+                cells[i].reset();
+            }
+        }
+        cells.erase(std::remove(cells.begin(), cells.end(), nullptr), cells.end());
+    }
+    return initialCount - cells.size();
+}
+
+AggregateDamage PopulationGovernor::resolveAggregateDamage(float health, float damage, uint64_t multiplicity, float roll) {
+    AggregateDamage result;
+    if (damage <= 0.0f) {
+        result.survivorHealth = health;
+        return result;
+    }
+
+    // Równomierny rozkład zdrowia członków o szerokości przedziału histogramu, ucięty w zerze
+    const float halfSpread = std::min(0.5f * MAX_TRACKED_HEALTH / HEALTH_HISTOGRAM_BINS, health);
+    const float lowest = health - halfSpread;
+    const float highest = health + halfSpread;
+
+    float killedFraction = 1.0f;
+    if (damage < highest) {
+        killedFraction = (highest > lowest) ? std::clamp((damage - lowest) / (highest - lowest), 0.0f, 1.0f)
+                                            : (damage >= health ? 1.0f : 0.0f);
+    }
+
+    double expectedKilled = killedFraction * static_cast<double>(multiplicity);
+    uint64_t killed = static_cast<uint64_t>(expectedKilled);
+    if (static_cast<double>(roll) < expectedKilled - static_cast<double>(killed)) ++killed;
+    result.killed = std::min(killed, multiplicity);
+
+    if (result.killed < multiplicity) {
+        // Przeżywają członkowie ze zdrowiem powyżej obrażeń - ich średnia pomniejszona o obrażenia
+        float survivorsLowest = std::max(lowest, damage);
+        result.survivorHealth = std::max(0.5f * (survivorsLowest + highest) - damage, 0.0f);
+        if (result.survivorHealth <= 0.0f) result.killed = multiplicity;
+    }
+    return result;
+}
+
+float PopulationGovernor::uniformFromKey(uint64_t key) {
+    // splitmix64
+    uint64_t z = key + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z = z ^ (z >> 31);
+    return static_cast<float>(z >> 40) / static_cast<float>(1ull << 24);
+}
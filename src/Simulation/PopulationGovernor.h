@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "IBacteria.h"
+
+// Budżet populacji: limit liczby obiektów symulacji i szacowanej pamięci, którą zajmują.
+// Efektywnym limitem jest mniejsza z obu wartości.
+struct PopulationBudget {
+    size_t maxIndividuals = 1000000;
+    size_t maxMemoryBytes = static_cast<size_t>(512) * 1024 * 1024;
+};
+
+// Wynik antybiotyku dla superosobnika - ile komórek zginęło i zdrowie pozostałych
+struct AggregateDamage {
+    uint64_t killed = 0;
+    float survivorHealth = 0.0f;
+};
+
+// Strażnik budżetu populacji. Gdy liczba obiektów zbliża się do limitu, łączy pobliskie
+// komórki tego samego typu i ze zdrowiem z tego samego przedziału histogramu w ważone
+// superosobniki z krotnością. Łączenie nie zmienia liczby komórek ani histogramów ColonyStats.
+class PopulationGovernor {
+public:
+    PopulationGovernor();
+
+    void setBudget(const PopulationBudget& newBudget);
+    const PopulationBudget& getBudget() const { return budget; }
+    size_t getIndividualLimit() const { return individualLimit; }
+
+    // Ile obiektów można jeszcze utworzyć bez przekroczenia limitu
+    size_t getHeadroom(size_t currentCount) const;
+    bool needsAggregation(size_t currentCount) const;
+    // Łączy komórki w coraz większych oczkach siatki, aż liczba obiektów spadnie
+    // do docelowego ułamka limitu. Zwraca liczbę usuniętych obiektów.
+    size_t aggregate(CellList& cells) const;
+
+    // Przybliżony koszt pamięci jednego obiektu bakterii w kolonii
+    static size_t estimateBytesPerIndividual();
+
+    // Zdrowie członków superosobnika przyjmujemy jako rozłożone równomiernie w przedziale
+    // histogramu wokół średniej; ginie ułamek, dla którego obrażenia przekraczają zdrowie.
+    // roll w [0, 1) zaokrągla losowo oczekiwaną liczbę zgonów do liczby całkowitej.
+    static AggregateDamage resolveAggregateDamage(float health, float damage, uint64_t multiplicity, float roll);
+    // Wartość w [0, 1) zależna wyłącznie od klucza - losowanie niezależne od podziału na wątki
+    static float uniformFromKey(uint64_t key);
+
+private:
+    PopulationBudget budget;
+    size_t individualLimit;
+};
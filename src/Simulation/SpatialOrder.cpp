@@ -0,0 +1,106 @@
+#include "SpatialOrder.h"
+
+#include "Utils/Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+// Najmniejszy fragment pracy równoległej
+const size_t MIN_CELLS_PER_CHUNK = 8192;
+// 32-bitowy klucz sortowany w trzech przebiegach po 11 bitów - po jednym na krok symulacji
+const int RADIX_BITS = 11;
+const size_t RADIX_BUCKETS = size_t(1) << RADIX_BITS;
+const int KEY_BITS = 32;
+const float MAX_GRID_OFFSET = 32767.0f;
+
+static uint32_t spreadBits(uint32_t value) {
+    value &= 0xFFFF;
+    value = (value | (value << 8)) & 0x00FF00FF;
+    value = (value | (value << 4)) & 0x0F0F0F0F;
+    value = (value | (value << 2)) & 0x33333333;
+    value = (value | (value << 1)) & 0x55555555;
+    return value;
+}
+
+uint32_t mortonKey(float x, float y) {
+    // Współrzędne przesunięte o połowę zakresu, by środek szalki wypadł w środku siatki
+    float gridX = std::clamp(std::floor(x / SPATIAL_ORDER_CELL_SIZE), -MAX_GRID_OFFSET, MAX_GRID_OFFSET) + MAX_GRID_OFFSET + 1.0f;
+    float gridY = std::clamp(std::floor(y / SPATIAL_ORDER_CELL_SIZE), -MAX_GRID_OFFSET, MAX_GRID_OFFSET) + MAX_GRID_OFFSET + 1.0f;
+    return spreadBits(static_cast<uint32_t>(gridX)) | (spreadBits(static_cast<uint32_t>(gridY)) << 1);
+}
+
+static size_t getChunkCount(ThreadPool* pool, size_t count) {
+    if (!pool) return count > 0 ? 1 : 0;
+    return pool->getChunkCount(count, MIN_CELLS_PER_CHUNK);
+}
+
+static void forEachRange(ThreadPool* pool, size_t count,
+                         const std::function<void(size_t chunkIndex, size_t begin, size_t end)>& body) {
+    if (!pool) {
+        if (count > 0) body(0, 0, count);
+        return;
+    }
+    pool->parallelFor(count, MIN_CELLS_PER_CHUNK, body);
+}
+
+void SpatialOrderSorter::begin(const float* positionX, const float* positionY, const CellList& cells, ThreadPool* pool) {
+    TRACE_SCOPE("sim", "SpatialOrder::begin");
+    auto startTime = std::chrono::steady_clock::now();
+    const size_t count = cells.size();
+    keys.resize(count);
+    ids.resize(count);
+    forEachRange(pool, count, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            keys[i] = mortonKey(positionX[i], positionY[i]);
+            ids[i] = cells[i] ? cells[i]->getCellId() : INVALID_CELL_ID;
+        }
+    });
+    active = true;
+    shift = 0;
+    elapsedMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+// Jeden przebieg stabilnego sortowania pozycyjnego LSD. Każdy fragment ma własny histogram
+// cyfr, a jego komórki trafiają za komórki fragmentów wcześniejszych.
+bool SpatialOrderSorter::step(ThreadPool* pool) {
+    if (!active) return false;
+    if (shift >= KEY_BITS) return true;
+    TRACE_SCOPE("sim", "SpatialOrder::step");
+    auto startTime = std::chrono::steady_clock::now();
+
+    const size_t count = keys.size();
+    const size_t chunks = getChunkCount(pool, count);
+    keysScratch.resize(count);
+    idsScratch.resize(count);
+    radixCounts.resize(chunks * RADIX_BUCKETS);
+    forEachRange(pool, count, [&](size_t chunkIndex, size_t begin, size_t end) {
+        uint32_t* counts = radixCounts.data() + chunkIndex * RADIX_BUCKETS;
+        std::fill(counts, counts + RADIX_BUCKETS, 0u);
+        for (size_t i = begin; i < end; ++i) ++counts[(keys[i] >> shift) & (RADIX_BUCKETS - 1)];
+    });
+    uint32_t offset = 0;
+    for (size_t digit = 0; digit < RADIX_BUCKETS; ++digit) {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            uint32_t& bucket = radixCounts[chunk * RADIX_BUCKETS + digit];
+            uint32_t bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+    }
+    forEachRange(pool, count, [&](size_t chunkIndex, size_t begin, size_t end) {
+        uint32_t* offsets = radixCounts.data() + chunkIndex * RADIX_BUCKETS;
+        for (size_t i = begin; i < end; ++i) {
+            uint32_t target = offsets[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+            keysScratch[target] = keys[i];
+            idsScratch[target] = ids[i];
+        }
+    });
+    std::swap(keys, keysScratch);
+    std::swap(ids, idsScratch);
+    shift += RADIX_BITS;
+
+    elapsedMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    return shift >= KEY_BITS;
+}
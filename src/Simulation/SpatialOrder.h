@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+#include "IBacteria.h"
+#include "Utils/MemoryTracker.h"
+#include "Utils/ThreadPool.h"
+
+// Oczko siatki, w którym liczony jest klucz Mortona. 16 bitów na oś pokrywa
+// +-32768 oczek wokół środka szalki; komórki dalej dostają klucz skrajnego oczka.
+const float SPATIAL_ORDER_CELL_SIZE = 1.0f;
+
+// Przeplot bitów współrzędnych oczka (x na bitach parzystych, y na nieparzystych)
+uint32_t mortonKey(float x, float y);
+
+// Porządkowanie przestrzenne kolonii. fragmentationThreshold == 0 je wyłącza.
+struct SpatialOrderSettings {
+    // Udział komórek spoza uporządkowanego początku listy, po którym rusza porządkowanie
+    float fragmentationThreshold = 0.25f;
+    // Mniejszych kolonii nie porządkujemy - mieszczą się w pamięci podręcznej
+    size_t minCells = 16384;
+};
+
+struct SpatialOrderStats {
+    uint64_t reorders = 0;
+    uint64_t lastReorderTick = 0;
+    float fragmentation = 0.0f;
+    double lastReorderMilliseconds = 0.0;   // Suma wszystkich kroków ostatniego porządkowania
+};
+
+// Sortowanie kolonii po kluczu Mortona rozłożone na kolejne kroki symulacji: begin() zapisuje
+// klucze i identyfikatory komórek, każde step() wykonuje jeden przebieg sortowania pozycyjnego.
+// Wynikiem jest lista identyfikatorów - między krokami komórki mogą ginąć i przybywać, więc
+// kolonia rozwiązuje ją przez tablicę pośrednią dopiero przy przestawianiu.
+// Przebiegi są równe dla każdego wywołania, więc wynik nie zależy od czasu ani liczby wątków.
+class SpatialOrderSorter {
+public:
+    bool isActive() const { return active; }
+
+    void begin(const float* positionX, const float* positionY, const CellList& cells, ThreadPool* pool);
+    // true, gdy posortowane identyfikatory są gotowe
+    bool step(ThreadPool* pool);
+    const TrackedVector<CellId, MemoryTag::SimulationScratch>& getSortedIds() const { return ids; }
+    // Koniec porządkowania po przestawieniu kolonii (bufory zostają na następne)
+    void finish() { active = false; }
+
+    double getElapsedMilliseconds() const { return elapsedMilliseconds; }
+
+private:
+    template <typename T>
+    using Scratch = TrackedVector<T, MemoryTag::SimulationScratch>;
+
+    bool active = false;
+    int shift = 0;
+    double elapsedMilliseconds = 0.0;
+    Scratch<uint32_t> keys;
+    Scratch<uint32_t> keysScratch;
+    Scratch<CellId> ids;
+    Scratch<CellId> idsScratch;
+    Scratch<uint32_t> radixCounts;
+};
@@ -0,0 +1,240 @@
+#include "SpeciesRegistry.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Ograniczenie obrysu - indeksy atlasu geometrii w rendererze
+const size_t MAX_OUTLINE_VERTICES = 1024;
+
+namespace {
+    std::string trim(const std::string& text) {
+        size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) return "";
+        size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    bool parseFloat(const std::string& text, float& value) {
+        std::string item = trim(text);
+        if (item.empty()) return false;
+        char* end = nullptr;
+        value = std::strtof(item.c_str(), &end);
+        return end == item.c_str() + item.size() && std::isfinite(value);
+    }
+
+    // Lista liczb po przecinku
+    bool parseFloatList(const std::string& text, std::vector<float>& values) {
+        values.clear();
+        std::stringstream stream(text);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            float value = 0.0f;
+            if (!parseFloat(item, value)) return false;
+            values.push_back(value);
+        }
+        return !values.empty();
+    }
+
+    // Wierzchołki "x y" po przecinku
+    bool parseOutline(const std::string& text, BacteriaCircuit& circuit) {
+        circuit.clear();
+        std::stringstream stream(text);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            std::stringstream pair(item);
+            std::string x, y, rest;
+            float vx = 0.0f, vy = 0.0f;
+            if (!(pair >> x >> y) || (pair >> rest) || !parseFloat(x, vx) || !parseFloat(y, vy)) return false;
+            circuit.push_back({vx, vy});
+        }
+        return circuit.size() >= 3 && circuit.size() <= MAX_OUTLINE_VERTICES;
+    }
+
+    // Elipsa zamknięta powtórzonym pierwszym wierzchołkiem
+    BacteriaCircuit ellipseOutline(float radiusX, float radiusY, int segments) {
+        BacteriaCircuit circuit;
+        for (int i = 0; i <= segments; ++i) {
+            float angle = static_cast<float>(i) / static_cast<float>(segments) * 2.0f * static_cast<float>(M_PI);
+            circuit.push_back({radiusX * std::cos(angle), radiusY * std::sin(angle)});
+        }
+        return circuit;
+    }
+
+    bool parsePattern(const std::string& name, SpeciesPattern& pattern) {
+        const char* names[SPECIES_PATTERN_COUNT] = {"cocci", "diplococcus", "staphylococci", "bacillus"};
+        for (int i = 0; i < SPECIES_PATTERN_COUNT; ++i) {
+            if (name == names[i]) {
+                pattern = static_cast<SpeciesPattern>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    SpeciesDefinition makeSpecies(const std::string& name, glm::vec3 color, SpeciesPattern pattern,
+                                  float health, float divisionInterval, float resistance, BacteriaCircuit circuit) {
+        SpeciesDefinition species;
+        species.name = name;
+        species.color = color;
+        species.pattern = pattern;
+        species.stats = {health, divisionInterval, resistance, std::move(circuit)};
+        return species;
+    }
+}
+
+SpeciesRegistry::SpeciesRegistry() {
+    species.push_back(makeSpecies("Cocci", glm::vec3(0.9f, 0.4f, 0.4f), SpeciesPattern::Cocci, 1.0f, 8.0f, 0.2f, {
+        {0.0f, 1.0f}, {0.707f, 0.707f}, {1.0f, 0.0f}, {0.707f, -0.707f},
+        {0.0f, -1.0f}, {-0.707f, -0.707f}, {-1.0f, 0.0f}, {-0.707f, 0.707f}
+    }));
+    species.push_back(makeSpecies("Diplococcus", glm::vec3(0.4f, 0.9f, 0.4f), SpeciesPattern::Diplococcus, 1.0f, 10.0f, 0.3f, {
+        // Dwa połączone okręgi
+        {-0.7f, 1.0f}, {-0.0f, 0.707f}, {0.2f, 0.0f}, {-0.0f, -0.707f},
+        {-0.7f, -1.0f}, {-1.4f, -0.707f}, {-1.6f, 0.0f}, {-1.4f, 0.707f},
+        {0.7f, 1.0f}, {1.4f, 0.707f}, {1.6f, 0.0f}, {1.4f, -0.707f},
+        {0.7f, -1.0f}, {0.0f, -0.707f}, {-0.2f, 0.0f}, {0.0f, 0.707f}
+    }));
+    species.push_back(makeSpecies("Staphylococci", glm::vec3(0.4f, 0.4f, 0.9f), SpeciesPattern::Staphylococci, 0.8f, 12.0f, 0.1f, {
+        // Nieregularny kształt
+        {0.0f, 1.5f}, {1.0f, 1.2f}, {1.5f, 0.5f}, {1.2f, -0.5f},
+        {0.5f, -1.5f}, {-0.5f, -1.2f}, {-1.5f, -0.5f}, {-1.0f, 1.0f}
+    }));
+    species.push_back(makeSpecies("Bacillus", glm::vec3(0.8f, 0.6f, 0.2f), SpeciesPattern::Bacillus, 1.2f, 11.0f, 0.25f,
+                                  ellipseOutline(1.5f, 0.6f, 16)));
+}
+
+bool SpeciesRegistry::loadFromFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "ERROR::SPECIES::Could not open species file: " << path << std::endl;
+        return false;
+    }
+
+    std::vector<SpeciesDefinition> loaded;
+    auto finishSpecies = [&](int lineNumber) {
+        if (loaded.empty()) return true;
+        if (loaded.back().stats.circuit.empty()) {
+            std::cerr << "ERROR::SPECIES::" << path << ":" << lineNumber << ": species '" << loaded.back().name
+                      << "' has no outline" << std::endl;
+            return false;
+        }
+        return true;
+    };
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+
+        if (line.front() == '[') {
+            std::string name = (line.back() == ']') ? trim(line.substr(1, line.size() - 2)) : "";
+            if (name.empty()) {
+                std::cerr << "ERROR::SPECIES::" << path << ":" << lineNumber << ": expected '[name]'" << std::endl;
+                return false;
+            }
+            if (!finishSpecies(lineNumber)) return false;
+            bool duplicate = std::any_of(loaded.begin(), loaded.end(),
+                                         [&name](const SpeciesDefinition& other) { return other.name == name; });
+            if (duplicate || loaded.size() >= static_cast<size_t>(MAX_SPECIES)) {
+                std::cerr << "ERROR::SPECIES::" << path << ":" << lineNumber << ": "
+                          << (duplicate ? "duplicate species '" + name + "'" : "more than " + std::to_string(MAX_SPECIES) + " species")
+                          << std::endl;
+                return false;
+            }
+            loaded.push_back(makeSpecies(name, glm::vec3(0.7f), SpeciesPattern::Cocci, 1.0f, 10.0f, 0.0f, {}));
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos || loaded.empty()) {
+            std::cerr << "ERROR::SPECIES::" << path << ":" << lineNumber
+                      << (loaded.empty() ? ": expected '[name]' before keys" : ": expected 'key = value'") << std::endl;
+            return false;
+        }
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+        SpeciesDefinition& current = loaded.back();
+
+        bool valid = true;
+        std::vector<float> values;
+        if (key == "pattern") {
+            valid = parsePattern(value, current.pattern);
+        } else if (key == "outline") {
+            valid = parseOutline(value, current.stats.circuit);
+        } else if (!parseFloatList(value, values)) {
+            valid = false;
+        } else if (key == "color") {
+            valid = values.size() == 3 && std::all_of(values.begin(), values.end(), [](float v) { return v >= 0.0f && v <= 1.0f; });
+            if (valid) current.color = glm::vec3(values[0], values[1], values[2]);
+        } else if (key == "health") {
+            valid = values.size() == 1 && values[0] > 0.0f;
+            current.stats.health = values[0];
+        } else if (key == "division_interval") {
+            // 0 - gatunek się nie dzieli
+            valid = values.size() == 1 && values[0] >= 0.0f;
+            current.stats.divisionInterval = values[0];
+        } else if (key == "resistance") {
+            valid = values.size() == 1 && values[0] >= 0.0f && values[0] <= 1.0f;
+            current.stats.antibioticResistance = values[0];
+        } else if (key == "ellipse") {
+            const int segments = (values.size() == 3) ? static_cast<int>(values[2]) : 0;
+            valid = segments >= 3 && static_cast<size_t>(segments) < MAX_OUTLINE_VERTICES && values[0] > 0.0f && values[1] > 0.0f;
+            if (valid) current.stats.circuit = ellipseOutline(values[0], values[1], segments);
+        } else {
+            std::cerr << "ERROR::SPECIES::" << path << ":" << lineNumber << ": unknown key '" << key << "'" << std::endl;
+            return false;
+        }
+        if (!valid) {
+            std::cerr << "ERROR::SPECIES::" << path << ":" << lineNumber << ": invalid value for '" << key << "'" << std::endl;
+            return false;
+        }
+    }
+    if (!finishSpecies(lineNumber)) return false;
+    if (loaded.empty()) {
+        std::cerr << "ERROR::SPECIES::" << path << ": no species defined" << std::endl;
+        return false;
+    }
+
+    species = std::move(loaded);
+    std::cout << "INFO::SPECIES::Loaded " << species.size() << " species from " << path << std::endl;
+    return true;
+}
+
+bool SpeciesRegistry::find(const std::string& name, SpeciesId& id) const {
+    for (size_t i = 0; i < species.size(); ++i) {
+        if (species[i].name == name) {
+            id = static_cast<SpeciesId>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string SpeciesRegistry::getColumnName(SpeciesId id) const {
+    std::string column;
+    for (char c : species[id].name) {
+        if (std::isalnum(static_cast<unsigned char>(c))) {
+            column += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        } else if (!column.empty() && column.back() != '_') {
+            column += '_';
+        }
+    }
+    if (!column.empty() && column.back() == '_') column.pop_back();
+    return column.empty() ? "species_" + std::to_string(id) : column;
+}
+
+SpeciesRegistry& getSpeciesRegistry() {
+    static SpeciesRegistry registry;
+    return registry;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "IBacteria.h"
+#include "BacteriaStats.h"
+
+// Górna granica liczby gatunków - wyznacza rozmiar stałych tablic statystyk i rekordów telemetrii
+const int MAX_SPECIES = 64;
+
+// Style wzoru i kształtu impostora wbudowane w shader bakterii; gatunek wybiera jeden z nich
+enum class SpeciesPattern {
+    Cocci,
+    Diplococcus,
+    Staphylococci,
+    Bacillus
+};
+const int SPECIES_PATTERN_COUNT = static_cast<int>(SpeciesPattern::Bacillus) + 1;
+
+struct SpeciesDefinition {
+    std::string name;
+    glm::vec3 color;
+    SpeciesPattern pattern;
+    // Zdrowie, interwał podziału, odporność i obrys nadawane każdej nowej komórce gatunku
+    BacteriaStats stats;
+};
+
+// Rejestr gatunków. Identyfikator gatunku to jego pozycja w rejestrze, więc rejestr ładuje się
+// raz przy starcie, zanim powstanie jakakolwiek kolonia.
+// Plik tekstowy z sekcjami "[nazwa]" i wierszami "klucz = wartość", '#' to komentarz:
+//   [Cocci]
+//   color = 0.9, 0.4, 0.4
+//   health = 1.0
+//   division_interval = 8
+//   resistance = 0.2
+//   pattern = cocci              # cocci | diplococcus | staphylococci | bacillus
+//   outline = 0 1, 0.707 0.707, 1 0, ...   # wierzchołki obrysu "x y" po przecinku
+//   ellipse = 1.5, 0.6, 16       # zamiast outline: półosie i liczba odcinków
+class SpeciesRegistry {
+public:
+    // Cztery wbudowane gatunki
+    SpeciesRegistry();
+
+    // Zastępuje zawartość gatunkami z pliku; przy błędzie rejestr zostaje bez zmian
+    bool loadFromFile(const std::string& path);
+
+    size_t size() const { return species.size(); }
+    const SpeciesDefinition& get(SpeciesId id) const { return species[id]; }
+    bool find(const std::string& name, SpeciesId& id) const;
+    // Nazwa kolumny liczności gatunku w plikach wyników: małe litery i cyfry, reszta jako '_'
+    std::string getColumnName(SpeciesId id) const;
+
+private:
+    std::vector<SpeciesDefinition> species;
+};
+
+SpeciesRegistry& getSpeciesRegistry();
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "ColonyStats.h"
+#include "Utils/SpscRing.h"
+
+// Jeden rekord szeregu czasowego - stan kolonii po kroku symulacji
+struct TelemetryRecord {
+    uint64_t tick;
+    double simulationTime;
+    uint32_t population;
+    uint32_t typeCounts[MAX_SPECIES];
+    uint32_t births; // Podziały w tym kroku
+    uint32_t kills;  // Zgony w tym kroku
+    float meanHealth;
+    uint32_t colonyCount;   // Liczba kolonii z ostatniego wykrywania (0, gdy wyłączone)
+    uint32_t largestColony; // Komórki w największej kolonii
+};
+
+// Kanał telemetrii: symulacja publikuje rekordy, eksporter w tle je odbiera.
+// Publikacja nigdy nie blokuje - gdy konsument nie nadąża, rekord jest odrzucany i liczony.
+class TelemetryChannel {
+public:
+    explicit TelemetryChannel(size_t capacity) : ring(capacity) {}
+
+    // Wątek symulacji
+    bool publish(const TelemetryRecord& record) {
+        if (!ring.tryPush(record)) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        publishedCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Wątek eksportera
+    bool consume(TelemetryRecord& record) { return ring.tryPop(record); }
+
+    uint64_t getPublishedCount() const { return publishedCount.load(std::memory_order_relaxed); }
+    uint64_t getDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
+    // Rekordy czekające na eksporter
+    size_t getDepth() const { return ring.getSize(); }
+
+private:
+    SpscRing<TelemetryRecord> ring;
+    std::atomic<uint64_t> publishedCount{0};
+    std::atomic<uint64_t> droppedCount{0};
+};
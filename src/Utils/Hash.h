@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 64-bitowy hash FNV-1a - używany jako klucz plików w cache'u na dysku.
+constexpr uint64_t FNV1A_64_OFFSET = 14695981039346656037ULL;
+constexpr uint64_t FNV1A_64_PRIME = 1099511628211ULL;
+
+inline uint64_t fnv1a64(const void* data, size_t size, uint64_t hash = FNV1A_64_OFFSET) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= FNV1A_64_PRIME;
+    }
+    return hash;
+}
+
+inline uint64_t fnv1a64(const std::string& text, uint64_t hash = FNV1A_64_OFFSET) {
+    return fnv1a64(text.data(), text.size(), hash);
+}
+
+inline std::string hashToHex(uint64_t hash) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        hex[i] = digits[hash & 0xF];
+        hash >>= 4;
+    }
+    return hex;
+}
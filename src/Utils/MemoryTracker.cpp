@@ -0,0 +1,60 @@
+#include "MemoryTracker.h"
+
+#include <algorithm>
+#include <cstdio>
+
+MemoryTagCounters memoryTagCounters[MEMORY_TAG_COUNT];
+
+namespace {
+    const char* const MEMORY_TAG_NAMES[MEMORY_TAG_COUNT] = {
+        "simulation.cells",
+        "simulation.circuits",
+        "simulation.colony",
+        "simulation.scratch",
+        "simulation.history",
+        "renderer.cpu",
+        "gpu.buffers",
+        "gpu.textures",
+        "assets",
+        "gui",
+    };
+}
+
+uint64_t MemoryReport::getTotalLiveBytes() const {
+    uint64_t total = 0;
+    for (const MemoryTagStats& tag : tags) total += tag.liveBytes;
+    return total;
+}
+
+MemoryReport getMemoryReport() {
+    MemoryReport report;
+    for (size_t i = 0; i < MEMORY_TAG_COUNT; ++i) {
+        const MemoryTagCounters& counters = memoryTagCounters[i];
+        // Liczniki czytane są osobno - przy równoległych alokacjach raport jest przybliżony
+        report.tags[i].liveBytes = static_cast<uint64_t>(std::max<int64_t>(counters.liveBytes.load(std::memory_order_relaxed), 0));
+        report.tags[i].peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+        report.tags[i].liveAllocations = static_cast<uint64_t>(std::max<int64_t>(counters.liveAllocations.load(std::memory_order_relaxed), 0));
+        report.tags[i].totalAllocations = counters.totalAllocations.load(std::memory_order_relaxed);
+    }
+    return report;
+}
+
+const char* getMemoryTagName(MemoryTag tag) {
+    size_t index = static_cast<size_t>(tag);
+    return index < MEMORY_TAG_COUNT ? MEMORY_TAG_NAMES[index] : "unknown";
+}
+
+void printMemoryReport(std::ostream& out) {
+    MemoryReport report = getMemoryReport();
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-22s %14s %14s %12s %14s", "subsystem", "live_bytes", "peak_bytes", "live_allocs", "total_allocs");
+    out << "INFO::MEMORY::" << line << '\n';
+    for (size_t i = 0; i < MEMORY_TAG_COUNT; ++i) {
+        const MemoryTagStats& stats = report.tags[i];
+        std::snprintf(line, sizeof(line), "%-22s %14llu %14llu %12llu %14llu", MEMORY_TAG_NAMES[i],
+                      static_cast<unsigned long long>(stats.liveBytes), static_cast<unsigned long long>(stats.peakBytes),
+                      static_cast<unsigned long long>(stats.liveAllocations), static_cast<unsigned long long>(stats.totalAllocations));
+        out << "INFO::MEMORY::" << line << '\n';
+    }
+    out << "INFO::MEMORY::total live " << report.getTotalLiveBytes() << " bytes" << std::endl;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <ostream>
+#include <vector>
+
+// Podsystemy, między które dzielona jest pamięć. Liczniki są zawsze włączone:
+// alokacja kosztuje kilka niesynchronizowanych (relaxed) operacji atomowych na liczniku
+// danego podsystemu, a każdy podsystem ma własną linię cache, więc wątki symulacji
+// i renderowania nie walczą o ten sam licznik.
+enum class MemoryTag : uint8_t {
+    SimulationCells,     // Obiekty komórek (Bacteria)
+    SimulationCircuits,  // Obrysy komórek (BacteriaStats::circuit, kopia w każdej komórce)
+    SimulationColony,    // Lista komórek i tablice pozycji kolonii
+    SimulationScratch,   // Bufory tymczasowe kroku (potomstwo w update(), wyniki częściowe)
+    SimulationHistory,   // Migawki historii kolonii do cofania (fragmenty współdzielone liczone raz)
+    RendererCpu,         // Kolejka renderowania i parametry rysowania po stronie CPU
+    GpuBuffers,          // Bufory GL - rozmiar zapisany przy tworzeniu
+    GpuTextures,         // Tekstury i renderbuffery GL - rozmiar zapisany przy tworzeniu
+    Assets,              // Zdekodowane tekstury i modele przed wysłaniem do GPU
+    Gui,                 // Alokacje ImGui
+    Count
+};
+
+const size_t MEMORY_TAG_COUNT = static_cast<size_t>(MemoryTag::Count);
+
+struct MemoryTagStats {
+    uint64_t liveBytes = 0;
+    uint64_t peakBytes = 0;
+    uint64_t liveAllocations = 0;
+    uint64_t totalAllocations = 0;  // Od uruchomienia programu
+};
+
+struct MemoryReport {
+    MemoryTagStats tags[MEMORY_TAG_COUNT];
+
+    uint64_t getTotalLiveBytes() const;
+    const MemoryTagStats& operator[](MemoryTag tag) const { return tags[static_cast<size_t>(tag)]; }
+};
+
+// Liczniki jednego podsystemu na osobnej linii cache
+struct alignas(64) MemoryTagCounters {
+    std::atomic<int64_t> liveBytes{0};
+    std::atomic<uint64_t> peakBytes{0};
+    std::atomic<int64_t> liveAllocations{0};
+    std::atomic<uint64_t> totalAllocations{0};
+};
+
+extern MemoryTagCounters memoryTagCounters[MEMORY_TAG_COUNT];
+
+inline void trackAllocation(MemoryTag tag, size_t bytes) {
+    MemoryTagCounters& counters = memoryTagCounters[static_cast<size_t>(tag)];
+    int64_t live = counters.liveBytes.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed) + static_cast<int64_t>(bytes);
+    counters.liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+    while (live > static_cast<int64_t>(peak) &&
+           !counters.peakBytes.compare_exchange_weak(peak, static_cast<uint64_t>(live), std::memory_order_relaxed)) {
+    }
+}
+
+inline void trackFree(MemoryTag tag, size_t bytes) {
+    MemoryTagCounters& counters = memoryTagCounters[static_cast<size_t>(tag)];
+    counters.liveBytes.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    counters.liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+MemoryReport getMemoryReport();
+// Krótka nazwa podsystemu, np. "simulation.cells"
+const char* getMemoryTagName(MemoryTag tag);
+// Tabela live/peak/alokacje dla wszystkich podsystemów
+void printMemoryReport(std::ostream& out);
+
+// Alokator STL przypisujący pamięć kontenera do podsystemu
+template <typename T, MemoryTag Tag>
+struct TrackedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = TrackedAllocator<U, Tag>;
+    };
+
+    TrackedAllocator() noexcept = default;
+    template <typename U>
+    TrackedAllocator(const TrackedAllocator<U, Tag>&) noexcept {}
+
+    T* allocate(size_t count) {
+        T* pointer = static_cast<T*>(::operator new(count * sizeof(T)));
+        trackAllocation(Tag, count * sizeof(T));
+        return pointer;
+    }
+
+    void deallocate(T* pointer, size_t count) noexcept {
+        trackFree(Tag, count * sizeof(T));
+        ::operator delete(pointer);
+    }
+};
+
+template <typename T, typename U, MemoryTag Tag>
+bool operator==(const TrackedAllocator<T, Tag>&, const TrackedAllocator<U, Tag>&) noexcept { return true; }
+template <typename T, typename U, MemoryTag Tag>
+bool operator!=(const TrackedAllocator<T, Tag>&, const TrackedAllocator<U, Tag>&) noexcept { return false; }
+
+template <typename T, MemoryTag Tag>
+using TrackedVector = std::vector<T, TrackedAllocator<T, Tag>>;
@@ -0,0 +1,224 @@
+#include "PngWriter.h"
+
+#include <array>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const uint8_t PNG_SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+const int BYTES_PER_PIXEL = 4;
+// Najdłuższe dopasowanie w deflate
+const size_t MAX_MATCH_LENGTH = 258;
+const size_t MIN_MATCH_LENGTH = 3;
+
+// Podstawy i liczby dodatkowych bitów kodów długości 257..285 (RFC 1951, 3.2.5)
+const uint16_t LENGTH_BASES[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                   35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t LENGTH_EXTRA_BITS[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                       3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+
+const std::array<uint32_t, 256>& getCrcTable() {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> values{};
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            values[n] = c;
+        }
+        return values;
+    }();
+    return table;
+}
+
+uint32_t updateCrc(uint32_t crc, const uint8_t* data, size_t size) {
+    const std::array<uint32_t, 256>& table = getCrcTable();
+    for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+uint32_t adler32(const uint8_t* data, size_t size) {
+    const uint32_t modulus = 65521;
+    uint32_t a = 1, b = 0;
+    // 5552 bajtów to najdłuższy blok bez przepełnienia 32 bitów przed redukcją
+    while (size > 0) {
+        size_t block = size < 5552 ? size : 5552;
+        size -= block;
+        while (block--) {
+            a += *data++;
+            b += a;
+        }
+        a %= modulus;
+        b %= modulus;
+    }
+    return (b << 16) | a;
+}
+
+// Strumień bitów deflate: bity zapisywane od najmłodszego
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& output) : output(output) {}
+
+    void writeBits(uint32_t value, int count) {
+        bitBuffer |= static_cast<uint64_t>(value) << bitCount;
+        bitCount += count;
+        while (bitCount >= 8) {
+            output.push_back(static_cast<uint8_t>(bitBuffer));
+            bitBuffer >>= 8;
+            bitCount -= 8;
+        }
+    }
+
+    // Kody Huffmana zapisywane są od najstarszego bitu
+    void writeCode(uint32_t code, int length) {
+        uint32_t reversed = 0;
+        for (int i = 0; i < length; ++i) reversed |= ((code >> i) & 1u) << (length - 1 - i);
+        writeBits(reversed, length);
+    }
+
+    void flush() {
+        if (bitCount > 0) output.push_back(static_cast<uint8_t>(bitBuffer));
+        bitBuffer = 0;
+        bitCount = 0;
+    }
+
+private:
+    std::vector<uint8_t>& output;
+    uint64_t bitBuffer = 0;
+    int bitCount = 0;
+};
+
+// Stałe kody Huffmana literałów i długości (RFC 1951, 3.2.6), już odwrócone do zapisu od najmłodszego bitu
+struct FixedCode {
+    uint16_t bits;
+    uint8_t length;
+};
+
+const std::array<FixedCode, 288>& getFixedLiteralCodes() {
+    static const std::array<FixedCode, 288> table = [] {
+        std::array<FixedCode, 288> codes{};
+        for (uint32_t symbol = 0; symbol < 288; ++symbol) {
+            uint32_t code = 0;
+            int length = 0;
+            if (symbol <= 143) { code = 0x30 + symbol; length = 8; }
+            else if (symbol <= 255) { code = 0x190 + (symbol - 144); length = 9; }
+            else if (symbol <= 279) { code = symbol - 256; length = 7; }
+            else { code = 0xC0 + (symbol - 280); length = 8; }
+            uint32_t reversed = 0;
+            for (int i = 0; i < length; ++i) reversed |= ((code >> i) & 1u) << (length - 1 - i);
+            codes[symbol] = {static_cast<uint16_t>(reversed), static_cast<uint8_t>(length)};
+        }
+        return codes;
+    }();
+    return table;
+}
+
+void writeFixedLiteral(BitWriter& bits, uint32_t symbol) {
+    const FixedCode& code = getFixedLiteralCodes()[symbol];
+    bits.writeBits(code.bits, code.length);
+}
+
+void writeMatch(BitWriter& bits, size_t length) {
+    int code = 28;
+    while (LENGTH_BASES[code] > length) --code;
+    writeFixedLiteral(bits, 257 + code);
+    if (LENGTH_EXTRA_BITS[code] > 0) bits.writeBits(static_cast<uint32_t>(length - LENGTH_BASES[code]), LENGTH_EXTRA_BITS[code]);
+    bits.writeCode(0, 5); // kod odległości 0 = odległość 1
+}
+
+// Strumień zlib z jednym blokiem stałych kodów Huffmana
+void deflateRle(const std::vector<uint8_t>& data, std::vector<uint8_t>& output) {
+    output.push_back(0x78); // CMF: deflate, okno 32 KB
+    output.push_back(0x01); // FLG: brak słownika, najszybszy poziom
+
+    BitWriter bits(output);
+    bits.writeBits(1, 1); // BFINAL
+    bits.writeBits(1, 2); // BTYPE = 01 (stałe kody)
+
+    size_t i = 0;
+    while (i < data.size()) {
+        if (i > 0) {
+            size_t run = 0;
+            const uint8_t previous = data[i - 1];
+            while (run < MAX_MATCH_LENGTH && i + run < data.size() && data[i + run] == previous) ++run;
+            if (run >= MIN_MATCH_LENGTH) {
+                writeMatch(bits, run);
+                i += run;
+                continue;
+            }
+        }
+        writeFixedLiteral(bits, data[i]);
+        ++i;
+    }
+    writeFixedLiteral(bits, 256); // koniec bloku
+    bits.flush();
+
+    uint32_t checksum = adler32(data.data(), data.size());
+    output.push_back(static_cast<uint8_t>(checksum >> 24));
+    output.push_back(static_cast<uint8_t>(checksum >> 16));
+    output.push_back(static_cast<uint8_t>(checksum >> 8));
+    output.push_back(static_cast<uint8_t>(checksum));
+}
+
+void writeUint32(std::FILE* file, uint32_t value) {
+    const uint8_t bytes[4] = {static_cast<uint8_t>(value >> 24), static_cast<uint8_t>(value >> 16),
+                              static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value)};
+    std::fwrite(bytes, 1, 4, file);
+}
+
+void writeChunk(std::FILE* file, const char type[4], const uint8_t* data, size_t size) {
+    writeUint32(file, static_cast<uint32_t>(size));
+    std::fwrite(type, 1, 4, file);
+    if (size > 0) std::fwrite(data, 1, size, file);
+    uint32_t crc = updateCrc(0xFFFFFFFFu, reinterpret_cast<const uint8_t*>(type), 4);
+    crc = updateCrc(crc, data, size);
+    writeUint32(file, crc ^ 0xFFFFFFFFu);
+}
+
+} // namespace
+
+bool writePngRgba(const std::string& path, int width, int height, const uint8_t* pixels, bool bottomUp) {
+    if (width <= 0 || height <= 0 || !pixels) return false;
+
+    // Wiersze z bajtem filtra Sub: różnica względem piksela po lewej
+    const size_t rowBytes = static_cast<size_t>(width) * BYTES_PER_PIXEL;
+    std::vector<uint8_t> filtered(static_cast<size_t>(height) * (rowBytes + 1));
+    for (int y = 0; y < height; ++y) {
+        const int sourceRow = bottomUp ? height - 1 - y : y;
+        const uint8_t* source = pixels + static_cast<size_t>(sourceRow) * rowBytes;
+        uint8_t* target = filtered.data() + static_cast<size_t>(y) * (rowBytes + 1);
+        target[0] = 1;
+        for (size_t x = 0; x < rowBytes; ++x) {
+            uint8_t left = x >= BYTES_PER_PIXEL ? source[x - BYTES_PER_PIXEL] : 0;
+            target[1 + x] = static_cast<uint8_t>(source[x] - left);
+        }
+    }
+
+    std::vector<uint8_t> compressed;
+    compressed.reserve(filtered.size() / 4);
+    deflateRle(filtered, compressed);
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "ERROR::PNG_WRITER::Could not open file for writing: " << path << std::endl;
+        return false;
+    }
+
+    const uint8_t header[13] = {
+        static_cast<uint8_t>(width >> 24), static_cast<uint8_t>(width >> 16), static_cast<uint8_t>(width >> 8), static_cast<uint8_t>(width),
+        static_cast<uint8_t>(height >> 24), static_cast<uint8_t>(height >> 16), static_cast<uint8_t>(height >> 8), static_cast<uint8_t>(height),
+        8, 6, 0, 0, 0 // 8 bitów na kanał, RGBA, deflate, filtry adaptacyjne, bez przeplotu
+    };
+    std::fwrite(PNG_SIGNATURE, 1, sizeof(PNG_SIGNATURE), file);
+    writeChunk(file, "IHDR", header, sizeof(header));
+    writeChunk(file, "IDAT", compressed.data(), compressed.size());
+    writeChunk(file, "IEND", nullptr, 0);
+
+    bool success = std::ferror(file) == 0;
+    success = (std::fclose(file) == 0) && success;
+    if (!success) {
+        std::cerr << "ERROR::PNG_WRITER::Failed to write file: " << path << std::endl;
+    }
+    return success;
+}
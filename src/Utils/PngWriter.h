@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Zapis obrazu RGBA8 do pliku PNG bez zewnętrznych bibliotek.
+// Wiersze filtrowane są filtrem Sub, a kompresja to deflate ze stałymi kodami Huffmana
+// i wyłącznie powtórzeniami poprzedniego bajtu (RLE) - szybka, a jednolite tło i agar
+// kompresują się dobrze. bottomUp odwraca kolejność wierszy (dane z glReadPixels).
+bool writePngRgba(const std::string& path, int width, int height, const uint8_t* pixels, bool bottomUp);
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Bezblokadowy bufor pierścieniowy dla jednego producenta i jednego konsumenta.
+// Pojemność jest zaokrąglana w górę do potęgi dwójki; cała pamięć jest alokowana
+// w konstruktorze, więc tryPush/tryPop nigdy nie alokują ani nie czekają.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t requestedCapacity)
+        : capacity(roundUpToPowerOfTwo(requestedCapacity < 2 ? 2 : requestedCapacity)),
+          mask(capacity - 1),
+          slots(new T[capacity]) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Wątek producenta. Zwraca false, gdy bufor jest pełny.
+    bool tryPush(const T& value) {
+        size_t writeIndex = head.load(std::memory_order_relaxed);
+        if (writeIndex - cachedTail == capacity) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (writeIndex - cachedTail == capacity) return false;
+        }
+        slots[writeIndex & mask] = value;
+        head.store(writeIndex + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Wątek konsumenta. Zwraca false, gdy bufor jest pusty.
+    bool tryPop(T& value) {
+        size_t readIndex = tail.load(std::memory_order_relaxed);
+        if (readIndex == cachedHead) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (readIndex == cachedHead) return false;
+        }
+        value = slots[readIndex & mask];
+        tail.store(readIndex + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t getCapacity() const { return capacity; }
+    // Przybliżona liczba elementów, do monitorowania z dowolnego wątku.
+    // Najpierw tail - head wczytany po nim nie może być mniejszy.
+    size_t getSize() const {
+        size_t readIndex = tail.load(std::memory_order_acquire);
+        return head.load(std::memory_order_acquire) - readIndex;
+    }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) result <<= 1;
+        return result;
+    }
+
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    const size_t capacity;
+    const size_t mask;
+    std::unique_ptr<T[]> slots;
+
+    // Indeksy rosną bez zawijania; producent i konsument trzymają się osobnych linii pamięci podręcznej
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head{0}; // Zapisywany przez producenta
+    size_t cachedTail = 0;                                  // Kopia tail widziana przez producenta
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail{0}; // Zapisywany przez konsumenta
+    size_t cachedHead = 0;                                  // Kopia head widziana przez konsumenta
+};
@@ -0,0 +1,8 @@
+#pragma once
+
+// Przypięcie bieżącego wątku do jednego rdzenia logicznego.
+// Zwraca false, gdy platforma tego nie obsługuje lub system odmówił.
+bool pinCurrentThreadToCore(unsigned int core);
+
+// Liczba rdzeni logicznych (co najmniej 1)
+unsigned int getLogicalCoreCount();
@@ -0,0 +1,91 @@
+#include "ThreadPool.h"
+#include "ThreadAffinity.h"
+#include "Trace.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t workerCount) : ThreadPool(workerCount, {}) {}
+
+ThreadPool::ThreadPool(size_t workerCount, const std::vector<unsigned int>& pinnedCores) : stopping(false) {
+    if (workerCount == 0) workerCount = 1;
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        int pinnedCore = pinnedCores.empty() ? -1 : static_cast<int>(pinnedCores[i % pinnedCores.size()]);
+        workers.emplace_back(&ThreadPool::workerLoop, this, pinnedCore);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCondition.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        tasks.push(std::move(task));
+    }
+    queueCondition.notify_one();
+}
+
+size_t ThreadPool::getChunkCount(size_t count, size_t minChunkSize) const {
+    if (count == 0) return 0;
+    if (minChunkSize == 0) minChunkSize = 1;
+    size_t maxChunks = (count + minChunkSize - 1) / minChunkSize;
+    return std::min(maxChunks, workers.size() + 1);
+}
+
+void ThreadPool::parallelFor(size_t count, size_t minChunkSize,
+                             const std::function<void(size_t chunkIndex, size_t begin, size_t end)>& body) {
+    size_t chunkCount = getChunkCount(count, minChunkSize);
+    if (chunkCount == 0) return;
+    if (chunkCount == 1) {
+        body(0, 0, count);
+        return;
+    }
+
+    size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+    size_t remaining = chunkCount - 1;
+    std::mutex doneMutex;
+    std::condition_variable doneCondition;
+
+    for (size_t chunk = 1; chunk < chunkCount; ++chunk) {
+        size_t begin = std::min(count, chunk * chunkSize);
+        size_t end = std::min(count, begin + chunkSize);
+        submit([&, chunk, begin, end] {
+            body(chunk, begin, end);
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if (--remaining == 0) doneCondition.notify_one();
+        });
+    }
+
+    body(0, 0, std::min(count, chunkSize));
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneCondition.wait(lock, [&remaining] { return remaining == 0; });
+}
+
+void ThreadPool::workerLoop(int pinnedCore) {
+    if (pinnedCore >= 0) {
+        pinCurrentThreadToCore(static_cast<unsigned int>(pinnedCore));
+    }
+    setTraceThreadName("pool worker");
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this] { return stopping || !tasks.empty(); });
+            // Przy zamykaniu puli dokańczamy zadania, które już są w kolejce
+            if (stopping && tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
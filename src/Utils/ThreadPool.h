@@ -0,0 +1,44 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Prosta pula wątków roboczych z jedną wspólną kolejką zadań.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t workerCount);
+    // Wątek i-ty przypinany jest do rdzenia pinnedCores[i % pinnedCores.size()]
+    ThreadPool(size_t workerCount, const std::vector<unsigned int>& pinnedCores);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Dodaje zadanie do kolejki; zadanie zostanie wykonane na jednym z wątków puli.
+    void submit(std::function<void()> task);
+
+    size_t getWorkerCount() const { return workers.size(); }
+
+    // Liczba fragmentów, na które parallelFor podzieli zakres [0, count).
+    // Pozwala wywołującemu przygotować wcześniej wyniki częściowe (jeden na fragment).
+    size_t getChunkCount(size_t count, size_t minChunkSize) const;
+
+    // Dzieli zakres [0, count) na getChunkCount() ciągłych fragmentów i wykonuje je równolegle.
+    // Jeden fragment liczy wątek wywołujący; funkcja wraca dopiero po zakończeniu wszystkich.
+    void parallelFor(size_t count, size_t minChunkSize,
+                     const std::function<void(size_t chunkIndex, size_t begin, size_t end)>& body);
+
+private:
+    void workerLoop(int pinnedCore);
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    bool stopping;
+};
@@ -0,0 +1,175 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> traceEnabledFlag{false};
+
+namespace {
+    // Zdarzeń na wątek (potęga dwójki) - przy kilku tysiącach zdarzeń na sekundę to kilkanaście sekund
+    const uint64_t TRACE_BUFFER_CAPACITY = 1u << 16;
+
+    struct TraceEvent {
+        uint64_t timestampNs;
+        const char* category;
+        const char* name;
+        int64_t value;
+        TracePhase phase;
+    };
+
+    // Bufor jednego wątku: pisze tylko właściciel, writeChromeTrace czyta kopię.
+    // Zdarzenia, które mogły zostać nadpisane w trakcie kopiowania, są odrzucane
+    // na podstawie indeksu zapisu odczytanego po kopii.
+    struct TraceThreadBuffer {
+        std::vector<TraceEvent> events;
+        std::atomic<uint64_t> writeIndex{0};
+        uint32_t threadId = 0;
+        std::string threadName;  // Chroniona przez registryMutex
+    };
+
+    std::mutex registryMutex;
+    std::vector<std::shared_ptr<TraceThreadBuffer>> registry;
+    uint32_t nextThreadId = 1;
+
+    const std::chrono::steady_clock::time_point traceEpoch = std::chrono::steady_clock::now();
+
+    uint64_t nowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - traceEpoch).count());
+    }
+
+    // Bufor tworzony przy pierwszym zdarzeniu wątku - wątki bez zdarzeń nie zajmują pamięci.
+    // Rejestr trzyma bufor także po zakończeniu wątku, żeby jego zdarzenia trafiły do zapisu.
+    thread_local TraceThreadBuffer* threadBuffer = nullptr;
+    thread_local std::string threadNameBeforeBuffer;
+
+    TraceThreadBuffer& currentThreadBuffer() {
+        if (!threadBuffer) {
+            auto created = std::make_shared<TraceThreadBuffer>();
+            created->events.resize(TRACE_BUFFER_CAPACITY);
+            std::lock_guard<std::mutex> lock(registryMutex);
+            created->threadId = nextThreadId++;
+            created->threadName = threadNameBeforeBuffer;
+            registry.push_back(created);
+            threadBuffer = created.get();
+        }
+        return *threadBuffer;
+    }
+
+    void writeJsonString(FILE* file, const char* text) {
+        std::fputc('"', file);
+        for (const char* c = text; *c; ++c) {
+            if (*c == '"' || *c == '\\') std::fputc('\\', file);
+            std::fputc(*c, file);
+        }
+        std::fputc('"', file);
+    }
+}
+
+void setTraceEnabled(bool enabled) {
+    traceEnabledFlag.store(enabled, std::memory_order_relaxed);
+}
+
+void traceRecord(TracePhase phase, const char* category, const char* name, int64_t value) {
+    TraceThreadBuffer& buffer = currentThreadBuffer();
+    uint64_t index = buffer.writeIndex.load(std::memory_order_relaxed);
+    buffer.events[index & (TRACE_BUFFER_CAPACITY - 1)] = {nowNs(), category, name, value, phase};
+    buffer.writeIndex.store(index + 1, std::memory_order_release);
+}
+
+void setTraceThreadName(const std::string& name) {
+    if (!threadBuffer) {
+        threadNameBeforeBuffer = name;
+        return;
+    }
+    std::lock_guard<std::mutex> lock(registryMutex);
+    threadBuffer->threadName = name;
+}
+
+bool writeChromeTrace(const std::string& path, double windowSeconds) {
+    std::vector<std::shared_ptr<TraceThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffers = registry;
+    }
+
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        std::cerr << "ERROR::TRACE::Could not open " << path << std::endl;
+        return false;
+    }
+
+    const uint64_t endNs = nowNs();
+    const uint64_t windowNs = static_cast<uint64_t>(std::max(windowSeconds, 0.0) * 1e9);
+    const uint64_t startNs = endNs > windowNs ? endNs - windowNs : 0;
+
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    bool first = true;
+    size_t written = 0;
+    std::vector<TraceEvent> events;
+    for (const std::shared_ptr<TraceThreadBuffer>& buffer : buffers) {
+        uint64_t end = buffer->writeIndex.load(std::memory_order_acquire);
+        uint64_t begin = end > TRACE_BUFFER_CAPACITY ? end - TRACE_BUFFER_CAPACITY : 0;
+        events.clear();
+        for (uint64_t i = begin; i < end; ++i) {
+            events.push_back(buffer->events[i & (TRACE_BUFFER_CAPACITY - 1)]);
+        }
+        // Wątek pisał dalej w trakcie kopiowania - najstarsze skopiowane wpisy mogą być już nowsze
+        uint64_t after = buffer->writeIndex.load(std::memory_order_acquire);
+        uint64_t overwritten = after + 1 > TRACE_BUFFER_CAPACITY ? after + 1 - TRACE_BUFFER_CAPACITY : 0;
+        size_t skip = overwritten > begin ? static_cast<size_t>(std::min<uint64_t>(overwritten - begin, events.size())) : 0;
+
+        std::string threadName;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            threadName = buffer->threadName;
+        }
+        if (!threadName.empty()) {
+            std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                         first ? "" : ",\n", buffer->threadId);
+            writeJsonString(file, threadName.c_str());
+            std::fputs("}}", file);
+            first = false;
+        }
+
+        // End bez Begin w oknie (zakres zaczęty przed oknem) jest pomijany
+        int depth = 0;
+        for (size_t i = skip; i < events.size(); ++i) {
+            const TraceEvent& event = events[i];
+            if (event.timestampNs < startNs) continue;
+            if (event.phase == TracePhase::End) {
+                if (depth == 0) continue;
+                --depth;
+            } else if (event.phase == TracePhase::Begin) {
+                ++depth;
+            }
+
+            const char* phase = event.phase == TracePhase::Begin ? "B" : (event.phase == TracePhase::End ? "E" : "C");
+            std::fprintf(file, "%s{\"name\":", first ? "" : ",\n");
+            writeJsonString(file, event.name);
+            std::fputs(",\"cat\":", file);
+            writeJsonString(file, event.category);
+            std::fprintf(file, ",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":%u", phase,
+                         static_cast<double>(event.timestampNs) / 1000.0, buffer->threadId);
+            if (event.phase == TracePhase::Counter) {
+                std::fprintf(file, ",\"args\":{\"value\":%lld}", static_cast<long long>(event.value));
+            }
+            std::fputc('}', file);
+            first = false;
+            ++written;
+        }
+    }
+    std::fputs("\n]}\n", file);
+    bool ok = std::fclose(file) == 0;
+    if (!ok) {
+        std::cerr << "ERROR::TRACE::Could not write " << path << std::endl;
+        return false;
+    }
+    std::cout << "INFO::TRACE::Wrote " << written << " events from " << buffers.size() << " threads to " << path << std::endl;
+    return true;
+}
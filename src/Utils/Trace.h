@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Śledzenie przebiegu w czasie (oś czasu wątków) zapisywane w formacie Chrome trace-event JSON,
+// do obejrzenia w chrome://tracing albo ui.perfetto.dev.
+// Każdy wątek zapisuje zdarzenia do własnego bufora pierścieniowego bez blokad - najstarsze
+// zdarzenia są nadpisywane, więc w pamięci zostaje zawsze ostatni odcinek czasu.
+// Gdy śledzenie jest wyłączone, makra kosztują jeden odczyt flagi atomowej.
+//
+// Nazwy i kategorie muszą być literałami (zapamiętywany jest sam wskaźnik).
+//   TRACE_SCOPE("render", "Renderer::executeRenderQueue");
+//   TRACE_COUNTER("sim", "cells", colony.size());
+
+enum class TracePhase : uint8_t {
+    Begin,
+    End,
+    Counter
+};
+
+extern std::atomic<bool> traceEnabledFlag;
+
+inline bool isTraceEnabled() {
+    return traceEnabledFlag.load(std::memory_order_relaxed);
+}
+
+void setTraceEnabled(bool enabled);
+// Zapis zdarzenia do bufora bieżącego wątku (bez sprawdzania flagi)
+void traceRecord(TracePhase phase, const char* category, const char* name, int64_t value = 0);
+// Nazwa wątku widoczna na osi czasu
+void setTraceThreadName(const std::string& name);
+// Zapisuje zdarzenia z ostatnich windowSeconds sekund ze wszystkich wątków
+bool writeChromeTrace(const std::string& path, double windowSeconds);
+
+// Zdarzenie Begin w konstruktorze i End w destruktorze. End zapisywany jest także wtedy,
+// gdy śledzenie wyłączono w trakcie zakresu - pary zdarzeń pozostają domknięte.
+class TraceScope {
+public:
+    TraceScope(const char* scopeCategory, const char* scopeName)
+        : category(scopeCategory), name(scopeName), active(isTraceEnabled()) {
+        if (active) traceRecord(TracePhase::Begin, category, name);
+    }
+    ~TraceScope() {
+        if (active) traceRecord(TracePhase::End, category, name);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* category;
+    const char* name;
+    bool active;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(category, name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(category, name)
+#define TRACE_COUNTER(category, name, value)                                                     \
+    do {                                                                                         \
+        if (isTraceEnabled()) traceRecord(TracePhase::Counter, category, name, static_cast<int64_t>(value)); \
+    } while (0)
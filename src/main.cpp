@@ -14,17 +14,59 @@
 #include "Rendering/Camera.h" 
 #include "Simulation/Bacteria.h"
 #include "Simulation/BacteriaFactory.h"
+#include "Simulation/Colony.h"
+#include "Simulation/ColonyHistory.h"
+#include "Simulation/SpeciesRegistry.h"
+#include "App/CommandLineOptions.h"
+#include "App/TelemetryExporter.h"
+#include "App/SharedStateExporter.h"
+#include "App/MetricsServer.h"
+#include "App/EnsembleRunner.h"
+#include "App/Scenario.h"
+#include "App/KernelBenchmark.h"
+#include "App/OffscreenContext.h"
+#include "Utils/Trace.h"
 
 #include <iostream>
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
 
 const int WINDOW_WIDTH = 1024;
 const int WINDOW_HEIGHT = 768;
+// Domyślny limit obiektów w trybie z oknem - powyżej bakterie łączone są w superosobniki
 const size_t MAX_BACTERIA_COUNT = 10000;
-
+// Stały krok symulacji - numer kroku jest znacznikiem czasu poleceń w scenariuszach
+const float SIMULATION_TIME_STEP = 1.0f / 60.0f;
+// Przyspieszenie czasu: kroki symulacji mieszczą się w czasie klatki pozostałym po renderowaniu
+const float TARGET_FRAME_SECONDS = 1.0f / 60.0f;
+const float MIN_SIMULATION_BUDGET_SECONDS = 0.002f;
+// Zaległość symulacji ponad tyle sekund czasu rzeczywistego jest porzucana
+const float MAX_SIMULATION_BACKLOG_SECONDS = 0.25f;
+// Gdy symulacja nie nadąża, kolonia i statystyki odświeżane są co tyle klatek
+const int BEHIND_REFRESH_INTERVAL = 4;
+// Waga nowej próbki w średnich kroczących czasu renderowania i osiągniętego przyspieszenia
+const float FRAME_TIMING_SMOOTHING = 0.1f;
+// Liczba komórek w pomiarze jąder SIMD (--benchmark-kernels)
+const size_t KERNEL_BENCHMARK_CELLS = 1 << 20;
+// Liczba komórek w samym sprawdzeniu zgodności jąder (--validate-kernels)
+const size_t KERNEL_VALIDATION_CELLS = 1 << 16;
+// Górny limit wątków kodujących PNG przy przechwytywaniu klatek
+const unsigned int MAX_CAPTURE_ENCODER_THREADS = 4;
+// Pojemność kanału telemetrii w rekordach (jeden rekord na krok symulacji)
+const size_t TELEMETRY_CHANNEL_CAPACITY = 8192;
+// Rejestr gatunków wczytywany, gdy nie podano --species
+const char* const DEFAULT_SPECIES_PATH = "assets/species.txt";
+
+// Rozmiar okna - w trybie przechwytywania równy rozmiarowi zapisywanych klatek
+int windowWidth = WINDOW_WIDTH;
+int windowHeight = WINDOW_HEIGHT;
 Camera camera(WINDOW_WIDTH, WINDOW_HEIGHT);
+// F9: pierwsze naciśnięcie włącza śledzenie, kolejne zapisują ostatni odcinek do trace_NNN.json
+bool traceSaveRequested = false;
 
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     if (key == GLFW_KEY_ENTER && action == GLFW_PRESS) {
@@ -33,6 +75,9 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     if (key == GLFW_KEY_R && action == GLFW_PRESS) {
         camera.reset3DView();
     }
+    if (key == GLFW_KEY_F9 && action == GLFW_PRESS) {
+        traceSaveRequested = true;
+    }
 }
 
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
@@ -58,6 +103,7 @@ void cursor_position_callback(GLFWwindow* window, double xpos, double ypos) {
 
 void setupImGUI(GLFWwindow* window) {
     IMGUI_CHECKVERSION();
+    GUIRenderer::installAllocatorHooks();
     ImGui::CreateContext();
     ImGui::StyleColorsDark();
     ImGui_ImplGlfw_InitForOpenGL(window, false);
@@ -70,86 +116,141 @@ void cleanupGUI() {
     ImGui::DestroyContext();
 }
 
-    // === sekcja UPDATE ===
-    // co klatkę aktualizujemy divisionTimer bakterii oraz sprawdzamy, czy nadaje się do usunięcia
-    // a także co klatkę aktualizujemy działanie antybiotyku na bakterie
-void update(std::vector<std::unique_ptr<IBacteria>>& allBacteria, float deltaTime) {
-    for (auto& bacteria : allBacteria) {
-        if (bacteria) {
-            bacteria->update(deltaTime);
-        }
-    }
-
-    std::vector<std::unique_ptr<IBacteria>> newBacteria;
-    for (auto& bacteria : allBacteria) {
-        if (bacteria && bacteria->canDivide()) {
-            if (glm::linearRand(0.0f, 1.0f) < 0.05f) { // 5% szans na podział
-                IBacteria* child = bacteria->clone();
-                if (child) {
-                    newBacteria.push_back(std::unique_ptr<IBacteria>(child));
-                }
-            }
-            bacteria->resetDivisionTimer();
-        }
-    }
-    allBacteria.insert(allBacteria.end(), std::make_move_iterator(newBacteria.begin()), std::make_move_iterator(newBacteria.end()));
-
-    allBacteria.erase(
-        std::remove_if(allBacteria.begin(), allBacteria.end(),
-                       [](const std::unique_ptr<IBacteria>& b) { return !b || !b->isAlive(); }),
-        allBacteria.end()
-    );
-}
-
-
-void setupGuiCallbacks(GUIRenderer& guiRenderer, Renderer& renderer, std::vector<std::unique_ptr<IBacteria>>& allBacteria) {
-    guiRenderer.onAddBacteria = [&](BacteriaType type, int bacteriaCount, int x_screen_raw, int y_screen_raw) {
-        glm::vec2 screen_pos_gl(static_cast<float>(x_screen_raw), static_cast<float>(WINDOW_HEIGHT - y_screen_raw));
-        glm::vec2 world_click_center_pos = camera.screenToWorld2D(screen_pos_gl);
-
-        glm::vec3 clickCenter(world_click_center_pos.x, world_click_center_pos.y, 0.1f);
-        float radius = 2.0f;
-
-        for (int i = 0; i < bacteriaCount; ++i) {
-            glm::vec2 randomOffset = glm::gaussRand(glm::vec2(0.0f), glm::vec2(radius));
-            float offsetZ = 1.75f + static_cast<float>(i) * glm::linearRand(0.0f, 0.001f);
-            glm::vec3 spawnPosition = clickCenter + glm::vec3(randomOffset.x, randomOffset.y, offsetZ);
-            allBacteria.push_back(BacteriaFactory::createAtPosition(type, glm::vec4(spawnPosition, 1.0f)));
+// Polecenia z GUI nie zmieniają kolonii od razu - trafiają do kolejki i są stosowane
+// na początku najbliższego kroku, tak samo jak polecenia odtwarzanego scenariusza
+void setupGuiCallbacks(GUIRenderer& guiRenderer, Renderer& renderer, std::vector<ScenarioCommand>& pendingCommands) {
+    guiRenderer.onAddBacteria = [&](SpeciesId type, InoculationShape shape, int bacteriaCount, float size, const std::vector<ImVec2>& screenPoints) {
+        if (screenPoints.empty()) return;
+        ScenarioCommand command;
+        command.type = ScenarioCommandType::AddBacteria;
+        for (const ImVec2& point : screenPoints) {
+            glm::vec2 screen_pos_gl(point.x, static_cast<float>(windowHeight) - point.y);
+            command.points.push_back(camera.screenToWorld2D(screen_pos_gl));
         }
+        command.position = command.points.front();
+        if (shape != InoculationShape::Streak) command.points.clear();
+        command.bacteriaType = type;
+        command.shape = shape;
+        command.count = static_cast<uint32_t>(bacteriaCount);
+        command.spread = size;
+        pendingCommands.push_back(command);
     };
 
     guiRenderer.onApplyAntibiotic = [&](float antibioticStrength, float antibioticRadius, int x_screen_raw, int y_screen_raw) {
-        glm::vec2 screen_pos_gl(static_cast<float>(x_screen_raw), static_cast<float>(WINDOW_HEIGHT - y_screen_raw));
+        glm::vec2 screen_pos_gl(static_cast<float>(x_screen_raw), static_cast<float>(windowHeight - y_screen_raw));
         glm::vec2 world_click_center_pos = camera.screenToWorld2D(screen_pos_gl);
-        renderer.addAntibioticEffect(world_click_center_pos, antibioticStrength, antibioticRadius);
-        for (auto& bacteria : allBacteria) {
-            if (bacteria && bacteria->isAlive()) {
-                glm::vec4 bacteriaPosVec4 = bacteria->getPos();
-                glm::vec2 bacteriaPos(bacteriaPosVec4.x, bacteriaPosVec4.y);
-                float distance = glm::distance(world_click_center_pos, bacteriaPos);
-                if (distance <= antibioticRadius) {
-                    float strengthAtDistance = antibioticStrength * (1.0f - glm::smoothstep(0.0f, antibioticRadius, distance));
-                    bacteria->applyAntibiotic(strengthAtDistance);
-                }
-            }
-        }
+        ScenarioCommand command;
+        command.type = ScenarioCommandType::ApplyAntibiotic;
+        command.position = world_click_center_pos;
+        command.strength = antibioticStrength;
+        command.radius = antibioticRadius;
+        pendingCommands.push_back(command);
     };
 
     guiRenderer.onLightRangeChanged = [&](float range) {
         renderer.setLightRange(range * 2); 
     };
+
+    guiRenderer.onBakedPatternsToggled = [&](bool enabled) {
+        renderer.setBakedPatternsEnabled(enabled);
+    };
+
+    guiRenderer.onImpostorsToggled = [&](bool enabled) {
+        renderer.setImpostorsEnabled(enabled);
+    };
+
+    guiRenderer.onColonyOutlinesToggled = [&](bool enabled) {
+        renderer.setColonyOutlinesEnabled(enabled);
+    };
 }
 
 
-int main() {
+int main(int argc, char** argv) {
+    CommandLineOptions options;
+    if (!parseCommandLine(argc, argv, options)) {
+        printUsage(argv[0]);
+        return -1;
+    }
+    if (options.showHelp) {
+        printUsage(argv[0]);
+        return 0;
+    }
+    // Rejestr gatunków musi być gotowy przed pierwszą kolonią i geometrią renderera
+    const bool speciesFileGiven = !options.speciesPath.empty();
+    const std::string speciesPath = speciesFileGiven ? options.speciesPath : DEFAULT_SPECIES_PATH;
+    if (speciesFileGiven || std::filesystem::exists(speciesPath)) {
+        if (!getSpeciesRegistry().loadFromFile(speciesPath)) return -1;
+    } else {
+        std::cout << "INFO::SPECIES::" << speciesPath << " not found, using built-in species" << std::endl;
+    }
+    if (!options.ensembleSpecPath.empty()) {
+        EnsembleConfig ensembleConfig;
+        ensembleConfig.specPath = options.ensembleSpecPath;
+        ensembleConfig.outputPath = options.ensembleOutputPath;
+        ensembleConfig.checkpointPath = options.ensembleCheckpointPath;
+        ensembleConfig.coreBudget = options.ensembleCores;
+        EnsembleRunner ensembleRunner(ensembleConfig);
+        return ensembleRunner.run();
+    }
+    if (options.benchmarkKernels) {
+        return runKernelBenchmark(KERNEL_BENCHMARK_CELLS);
+    }
+    if (options.validateKernels) {
+        return validateCellKernels(KERNEL_VALIDATION_CELLS);
+    }
+    setTraceThreadName("main");
+    if (!options.tracePath.empty()) {
+        setTraceEnabled(true);
+    }
+    // Serwer metryk czyta wyłącznie liczniki z liveMetrics, publikowane przez wątek główny
+    LiveMetrics liveMetrics;
+    std::unique_ptr<MetricsServer> metricsServer;
+    if (!options.metricsEndpoint.empty()) {
+        MetricsServerConfig metricsConfig;
+        metricsConfig.endpoint = options.metricsEndpoint;
+        metricsServer = std::make_unique<MetricsServer>(liveMetrics, metricsConfig);
+        if (!metricsServer->start()) {
+            metricsServer.reset();
+        }
+    }
+    // Odtwarzany scenariusz ma własny budżet populacji - inny rozbiegłby się z nagraniem
+    if (!options.playPath.empty() && (options.maxIndividuals > 0 || options.memoryBudgetBytes > 0)) {
+        std::cout << "INFO::SCENARIO::--max-individuals and --memory-budget-mb are ignored during playback, "
+                     "the budget stored in the scenario is used" << std::endl;
+    }
+    if (options.headless) {
+        int result = runHeadlessScenario(options.playPath, options.extraTicks, metricsServer ? &liveMetrics : nullptr);
+        if (!options.tracePath.empty()) writeChromeTrace(options.tracePath, options.traceWindowSeconds);
+        return result;
+    }
+
+    // Scenariusz do odtworzenia narzuca ziarno, krok czasu i budżet populacji
+    ScenarioPlayer scenarioPlayer;
+    ScenarioHeader scenarioHeader;
+    scenarioHeader.seed = options.seedSpecified ? options.seed : std::random_device{}();
+    scenarioHeader.timeStep = SIMULATION_TIME_STEP;
+    scenarioHeader.budget.maxIndividuals = options.maxIndividuals > 0 ? static_cast<size_t>(options.maxIndividuals) : MAX_BACTERIA_COUNT;
+    if (options.memoryBudgetBytes > 0) scenarioHeader.budget.maxMemoryBytes = static_cast<size_t>(options.memoryBudgetBytes);
+    if (!options.playPath.empty()) {
+        if (!scenarioPlayer.load(options.playPath)) return -1;
+        scenarioHeader = scenarioPlayer.getHeader();
+    }
+
+    const bool captureMode = !options.capturePrefix.empty();
+    if (captureMode) {
+        windowWidth = options.captureWidth;
+        windowHeight = options.captureHeight;
+        camera = Camera(windowWidth, windowHeight);
+    }
+
     // Inicjalizacja GLFW
-    if (!glfwInit()) {
+    if (options.offscreen ? !initOffscreenGlfw() : !glfwInit()) {
         std::cerr << "Failed to initialize GLFW" << std::endl;
         return -1;
     }
     
     // Utworzenie instancji Renderer która tworzy okno i inicjalizuje GLEW
-    Renderer renderer(WINDOW_WIDTH, WINDOW_HEIGHT);
+    Renderer renderer(windowWidth, windowHeight);
     if (!renderer.isInitialized()) {
         std::cerr << "Renderer initialization failed. Exiting." << std::endl;
         glfwTerminate();
@@ -157,8 +258,77 @@ int main() {
     }
     GLFWwindow* window = renderer.getWindow();
 
+    if (captureMode) {
+        unsigned int hardwareThreads = std::max(2u, std::thread::hardware_concurrency());
+        size_t encoderThreads = std::min(MAX_CAPTURE_ENCODER_THREADS, hardwareThreads - 1);
+        if (!renderer.enableCapture(options.capturePrefix, encoderThreads)) {
+            std::cerr << "ERROR::CAPTURE::INIT_FAILED " << options.capturePrefix << std::endl;
+            glfwTerminate();
+            return -1;
+        }
+    }
+
     GUIRenderer guiRenderer;
-    std::vector<std::unique_ptr<IBacteria>> allBacteria;
+    Colony colony(scenarioHeader.seed);
+    colony.setPopulationBudget(scenarioHeader.budget);
+    ColonyClusterSettings clusterSettings;
+    clusterSettings.intervalTicks = options.clusterIntervalTicks;
+    clusterSettings.contactDistance = options.contactDistance;
+    colony.setClusterSettings(clusterSettings);
+    // Kontury kolonii aktualizowane przyrostowo z dziennika zmian populacji
+    ColonyOutlines colonyOutlines;
+    PopulationChangeList populationChanges;
+    bool populationChangesTracked = false;
+    std::vector<ScenarioCommand> pendingCommands;
+    // Cofanie do migawek - nie przy nagrywaniu ani odtwarzaniu, bo scenariusz to ciągła historia kroków
+    ColonyHistory colonyHistory;
+    ColonyHistorySettings historySettings;
+    const bool rewindAvailable = options.recordPath.empty() && options.playPath.empty();
+    historySettings.memoryBudgetBytes = rewindAvailable ? static_cast<size_t>(options.rewindBudgetBytes) : 0;
+    historySettings.intervalTicks = options.rewindIntervalTicks;
+    colonyHistory.setSettings(historySettings);
+
+    ScenarioRecorder scenarioRecorder;
+    if (!options.recordPath.empty()) {
+        scenarioRecorder.open(options.recordPath, scenarioHeader);
+    }
+
+    // Wspólna ścieżka poleceń z GUI i ze scenariusza: zapis, efekt wizualny, zmiana kolonii
+    auto executeCommand = [&](const ScenarioCommand& command) {
+        scenarioRecorder.record(command);
+        if (command.type == ScenarioCommandType::ApplyAntibiotic) {
+            renderer.addAntibioticEffect(command.position, command.strength, command.radius);
+        }
+        applyScenarioCommand(colony, command);
+    };
+
+    // Telemetria: symulacja publikuje rekordy bez blokowania, zapis odbywa się w osobnym wątku
+    TelemetryChannel telemetryChannel(TELEMETRY_CHANNEL_CAPACITY);
+    std::unique_ptr<TelemetryExporter> telemetryExporter;
+    if (!options.telemetryPath.empty()) {
+        TelemetryExporterConfig telemetryConfig;
+        telemetryConfig.basePath = options.telemetryPath;
+        telemetryConfig.format = options.telemetryFormat;
+        telemetryConfig.rotateBytes = options.telemetryRotateBytes;
+        telemetryExporter = std::make_unique<TelemetryExporter>(telemetryChannel, telemetryConfig);
+        if (telemetryExporter->start()) {
+            colony.setTelemetryChannel(&telemetryChannel);
+        } else {
+            telemetryExporter.reset();
+        }
+    }
+
+    // Stan kolonii dla procesów zewnętrznych - publikowany raz na klatkę, bez czekania na czytelników
+    std::unique_ptr<SharedStateExporter> sharedStateExporter;
+    if (!options.sharedMemoryName.empty()) {
+        SharedStateExporterConfig sharedStateConfig;
+        sharedStateConfig.name = options.sharedMemoryName;
+        sharedStateConfig.capacity = static_cast<size_t>(options.sharedMemoryCapacity);
+        sharedStateExporter = std::make_unique<SharedStateExporter>(sharedStateConfig);
+        if (!sharedStateExporter->start(colony)) {
+            sharedStateExporter.reset();
+        }
+    }
 
     // Ustawienie callbacków GLFW
     glfwSetKeyCallback(window, key_callback);
@@ -169,26 +339,146 @@ int main() {
     // Inicjalizacja ImGui
     setupImGUI(window);
     // Ustawienie callbacków dla GUI 
-    setupGuiCallbacks(guiRenderer, renderer, allBacteria);
+    setupGuiCallbacks(guiRenderer, renderer, pendingCommands);
+
+    float timeWarp = 1.0f;
+    guiRenderer.onTimeWarpChanged = [&timeWarp](float warp) {
+        timeWarp = warp;
+    };
 
     float lastFrameTime = static_cast<float>(glfwGetTime());
+    float simulationAccumulator = 0.0f;
+    uint64_t simulationTick = 0;
+    float presentationSeconds = 0.0f;
+    float achievedTimeWarp = 1.0f;
+    uint64_t frameIndex = 0;
+    int traceFileIndex = 0;
+
+    guiRenderer.onRewindRequested = [&](uint64_t tick) {
+        if (!colonyHistory.restore(colony, tick)) return;
+        simulationTick = colony.getTick();
+        // Polecenia z GUI wydane po wybranym kroku przepadają razem z porzuconą historią
+        pendingCommands.clear();
+        simulationAccumulator = 0.0f;
+    };
 
     while (!glfwWindowShouldClose(window)) {
+        TRACE_SCOPE("frame", "Frame");
         float currentTime = static_cast<float>(glfwGetTime());
         float deltaTime = currentTime - lastFrameTime;
         lastFrameTime = currentTime;
+        if (metricsServer) liveMetrics.recordFrame(deltaTime);
         deltaTime = glm::min(deltaTime, 0.1f); 
+        // Przy przechwytywaniu każda klatka nagrania to stały odcinek czasu symulacji,
+        // niezależnie od tego, ile trwało jej wyrenderowanie i zapisanie
+        if (captureMode) deltaTime = TARGET_FRAME_SECONDS;
 
-        glfwPollEvents();
-        update(allBacteria, deltaTime);
-        renderer.updateAntibioticEffects(deltaTime);
+        {
+            TRACE_SCOPE("frame", "PollEvents");
+            glfwPollEvents();
+        }
+        if (traceSaveRequested) {
+            traceSaveRequested = false;
+            if (!isTraceEnabled()) {
+                setTraceEnabled(true);
+                std::cout << "INFO::TRACE::Recording started, press F9 again to save the last "
+                          << options.traceWindowSeconds << " s" << std::endl;
+            } else {
+                char tracePath[32];
+                std::snprintf(tracePath, sizeof(tracePath), "trace_%03d.json", traceFileIndex++);
+                writeChromeTrace(tracePath, options.traceWindowSeconds);
+            }
+        }
+
+        // Symulacja w stałych krokach; polecenia stosowane są na początku kroku.
+        // Kroków jest tyle, ile zmieści się w budżecie klatki - reszta czeka na kolejną klatkę,
+        // więc polecenia z GUI trafiają do symulacji najpóźniej w następnej klatce.
+        simulationAccumulator += deltaTime * timeWarp;
+        simulationAccumulator = glm::min(simulationAccumulator, timeWarp * MAX_SIMULATION_BACKLOG_SECONDS);
+        // Przewijanie historii wstrzymuje symulację, by kolejne kroki nie porzuciły późniejszych migawek
+        if (guiRenderer.isScrubbingHistory()) simulationAccumulator = 0.0f;
+        const float simulationBudget = glm::max(TARGET_FRAME_SECONDS - presentationSeconds, MIN_SIMULATION_BUDGET_SECONDS);
+        const double simulationStart = glfwGetTime();
+        int substeps = 0;
+        bool simulationBehind = false;
+        {
+            TRACE_SCOPE("frame", "Simulation");
+            while (simulationAccumulator >= scenarioHeader.timeStep) {
+                if (!captureMode && substeps > 0 && glfwGetTime() - simulationStart >= simulationBudget) {
+                    simulationBehind = true;
+                    break;
+                }
+                TRACE_SCOPE("sim", "SimulationStep");
+                ScenarioCommand command;
+                while (scenarioPlayer.nextCommandForTick(simulationTick, command)) {
+                    executeCommand(command);
+                }
+                for (ScenarioCommand& pendingCommand : pendingCommands) {
+                    pendingCommand.tick = simulationTick;
+                    executeCommand(pendingCommand);
+                }
+                pendingCommands.clear();
 
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
-        ImGui::NewFrame();
+                colony.update(scenarioHeader.timeStep);
+                colonyHistory.afterTick(colony);
+                ++simulationTick;
+                ++substeps;
+                simulationAccumulator -= scenarioHeader.timeStep;
+            }
+        }
+        if (isTraceEnabled()) {
+            const ColonyStatsSnapshot& traceStats = colony.getStats();
+            TRACE_COUNTER("sim", "cells", traceStats.total);
+            TRACE_COUNTER("sim", "births", traceStats.totalBirths);
+            TRACE_COUNTER("sim", "deaths", traceStats.totalDeaths);
+            TRACE_COUNTER("sim", "substeps", substeps);
+        }
+        if (sharedStateExporter) {
+            sharedStateExporter->publish(colony);
+        }
+        renderer.updateAntibioticEffects(deltaTime);
 
-        guiRenderer.setBacteriaCount(allBacteria.size());
-        guiRenderer.render(camera.viewOffset, camera.currentZoomLevel, WINDOW_HEIGHT, camera.is3DView);
+        if (deltaTime > 0.0f) {
+            float frameTimeWarp = static_cast<float>(substeps) * scenarioHeader.timeStep / deltaTime;
+            achievedTimeWarp += FRAME_TIMING_SMOOTHING * (frameTimeWarp - achievedTimeWarp);
+        }
+        if (metricsServer) {
+            liveMetrics.publishColony(colony);
+            liveMetrics.ticksPerSecond.store(achievedTimeWarp / scenarioHeader.timeStep, std::memory_order_relaxed);
+            liveMetrics.timeWarp.store(timeWarp, std::memory_order_relaxed);
+            liveMetrics.telemetryQueueDepth.store(telemetryChannel.getDepth(), std::memory_order_relaxed);
+            liveMetrics.telemetryDropped.store(telemetryChannel.getDroppedCount(), std::memory_order_relaxed);
+            if (renderer.isCapturing()) {
+                FrameCaptureStats captureStats = renderer.getCaptureStats();
+                liveMetrics.captureQueueDepth.store(captureStats.capturedFrames - captureStats.writtenFrames, std::memory_order_relaxed);
+            }
+        }
+        // Przy zaległości przegląd kolonii do rysowania i statystyki tylko co kilka klatek
+        const bool refreshPresentation = !simulationBehind || frameIndex % BEHIND_REFRESH_INTERVAL == 0;
+        ++frameIndex;
+        const double presentationStart = glfwGetTime();
+
+        {
+            TRACE_SCOPE("frame", "BuildGui");
+            ImGui_ImplOpenGL3_NewFrame();
+            ImGui_ImplGlfw_NewFrame();
+            ImGui::NewFrame();
+
+            if (refreshPresentation) {
+                guiRenderer.setColonyStats(colony.getStats());
+                guiRenderer.setPopulationUsage(colony.size(), colony.getPopulationGovernor().getIndividualLimit());
+                guiRenderer.setMemoryReport(getMemoryReport());
+                guiRenderer.setClusterReport(colony.getClusterReport());
+                guiRenderer.setHistoryStatus(colonyHistory.isEnabled(), colonyHistory, scenarioHeader.timeStep);
+            }
+            guiRenderer.setTimeWarpStatus(achievedTimeWarp, simulationBehind);
+            if (telemetryExporter) {
+                guiRenderer.setTelemetryCounters(telemetryExporter->getWrittenCount(), telemetryChannel.getDroppedCount());
+            }
+            guiRenderer.setRenderStats(renderer.getFrameStats());
+            guiRenderer.render(camera.viewOffset, camera.currentZoomLevel, windowHeight, camera.is3DView);
+        }
+        if (metricsServer) liveMetrics.pendingCommands.store(pendingCommands.size(), std::memory_order_relaxed);
 
         renderer.beginFrame();
 
@@ -197,16 +487,84 @@ int main() {
         glm::mat4 viewMatrix = camera.getViewMatrix();
         glm::mat4 viewProjectionMatrix = projectionMatrix * viewMatrix;
 
-        renderer.renderPetriDish(viewProjectionMatrix, viewMatrix);
-        renderer.renderColony(allBacteria, camera.currentZoomLevel, viewProjectionMatrix); 
-        renderer.renderAntibioticEffects(viewProjectionMatrix);
+        // Kamera i oświetlenie trafiają raz na klatkę do wspólnego bloku uniformów
+        renderer.updateFrameUniforms(viewProjectionMatrix, viewMatrix);
+
+        // Zmiany populacji trafiają do siatki gęstości co klatkę (koszt zależy od liczby narodzin
+        // i zgonów), a kontury przeliczane są tylko wtedy, gdy są rysowane
+        const bool outlinesEnabled = renderer.areColonyOutlinesEnabled();
+        if (outlinesEnabled != populationChangesTracked) {
+            colony.setPopulationChangeTracking(outlinesEnabled);
+            populationChangesTracked = outlinesEnabled;
+        }
+        if (outlinesEnabled) {
+            TRACE_SCOPE("frame", "ColonyOutlines::update");
+            if (colony.takePopulationChanges(populationChanges)) {
+                colonyOutlines.rebuild(colony.getBacteria());
+            } else {
+                colonyOutlines.applyChanges(populationChanges);
+            }
+        }
+
+        renderer.renderPetriDish();
+        if (!camera.is3DView && renderer.usesColonyOutlines(camera.currentZoomLevel)) {
+            if (refreshPresentation) {
+                colonyOutlines.extract(colony.getWorkerPool());
+            }
+            renderer.renderColonyOutlines(colonyOutlines);
+        } else if (refreshPresentation) {
+            renderer.renderColony(colony.getBacteria(), camera.currentZoomLevel);
+        } else {
+            renderer.resubmitColony();
+        }
+        renderer.renderAntibioticEffects();
+        renderer.executeRenderQueue();
+        renderer.captureFrame();
 
         // Renderowanie klatki ImGui na wierzchu sceny
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        {
+            TRACE_SCOPE("frame", "RenderGui");
+            ImGui::Render();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
+
+        // Czas renderowania bez oczekiwania na zamianę buforów - inaczej budżet symulacji malałby razem z nim
+        float framePresentationSeconds = static_cast<float>(glfwGetTime() - presentationStart);
+        presentationSeconds += FRAME_TIMING_SMOOTHING * (framePresentationSeconds - presentationSeconds);
 
         renderer.endFrame();
+
+        if (captureMode && options.captureFrames > 0 && frameIndex >= options.captureFrames) {
+            glfwSetWindowShouldClose(window, GLFW_TRUE);
+        }
+    }
+
+    if (!options.tracePath.empty()) {
+        writeChromeTrace(options.tracePath, options.traceWindowSeconds);
+    }
+
+    if (renderer.isCapturing()) {
+        renderer.finishCapture();
+        FrameCaptureStats captureStats = renderer.getCaptureStats();
+        std::cout << "INFO::CAPTURE::FRAMES written=" << captureStats.writtenFrames
+                  << " failed=" << captureStats.failedWrites << std::endl;
+        std::cout << "INFO::CAPTURE::OVERHEAD avg_ms=" << captureStats.averageCaptureMs
+                  << " max_ms=" << captureStats.maxCaptureMs
+                  << " fence_stalls=" << captureStats.fenceStalls
+                  << " encoder_stalls=" << captureStats.encoderStalls << std::endl;
+    }
+
+    if (telemetryExporter) {
+        colony.setTelemetryChannel(nullptr);
+        telemetryExporter->stop();
+    }
+    if (sharedStateExporter) {
+        sharedStateExporter->stop();
+    }
+    if (metricsServer) {
+        metricsServer->stop();
     }
+    scenarioRecorder.close();
 
     cleanupGUI();
     glfwTerminate();
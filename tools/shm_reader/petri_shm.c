@@ -0,0 +1,88 @@
+/* shm_open i EPROTO przy kompilacji w ścisłym trybie C (-std=c99/c11) */
+#define _POSIX_C_SOURCE 200809L
+
+#include "petri_shm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int petri_shm_open(PetriShmReader* reader, const char* name) {
+    memset(reader, 0, sizeof(*reader));
+    int descriptor = shm_open(name, O_RDONLY, 0);
+    if (descriptor < 0) return -1;
+
+    struct stat info;
+    if (fstat(descriptor, &info) != 0) {
+        close(descriptor);
+        return -1;
+    }
+    if ((size_t)info.st_size < sizeof(PetriShmHeader)) {
+        close(descriptor);
+        errno = EPROTO;
+        return -1;
+    }
+    void* region = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if (region == MAP_FAILED) return -1;
+
+    const PetriShmHeader* header = (const PetriShmHeader*)region;
+    /* Sygnatura zapisywana jest ostatnia - po niej reszta nagłówka jest kompletna */
+    if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != PETRI_SHM_MAGIC ||
+        header->version != PETRI_SHM_VERSION || header->regionBytes != (uint64_t)info.st_size) {
+        munmap(region, (size_t)info.st_size);
+        errno = EPROTO;
+        return -1;
+    }
+    reader->region = region;
+    reader->regionBytes = (size_t)info.st_size;
+    reader->header = header;
+    return 0;
+}
+
+void petri_shm_close(PetriShmReader* reader) {
+    if (reader->region) munmap(reader->region, reader->regionBytes);
+    memset(reader, 0, sizeof(*reader));
+}
+
+int petri_shm_begin(const PetriShmReader* reader, PetriShmView* view) {
+    const PetriShmHeader* header = reader->header;
+    uint64_t latest = __atomic_load_n(&header->latestSlot, __ATOMIC_ACQUIRE);
+    if (latest >= PETRI_SHM_SLOT_COUNT) return 0;
+
+    const char* slotBase = (const char*)reader->region + header->slotOffsets[latest];
+    const PetriShmSlotHeader* slot = (const PetriShmSlotHeader*)slotBase;
+    uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+    if (sequence & 1) return 0;
+
+    view->slot = slot;
+    view->sequence = sequence;
+    view->tick = slot->tick;
+    view->simulationTime = slot->simulationTime;
+    view->cellCount = slot->cellCount;
+    view->totalCells = slot->totalCells;
+    view->colonyObjects = slot->colonyObjects;
+    view->multiplicity = (const uint64_t*)(slotBase + header->multiplicityOffset);
+    view->cellId = (const uint64_t*)(slotBase + header->cellIdOffset);
+    view->positionX = (const float*)(slotBase + header->positionXOffset);
+    view->positionY = (const float*)(slotBase + header->positionYOffset);
+    view->health = (const float*)(slotBase + header->healthOffset);
+    view->species = (const uint16_t*)(slotBase + header->speciesOffset);
+    /* Licznik mógł się zmienić przed odczytem pól nagłówka slotu */
+    if (view->cellCount > header->capacity) return 0;
+    return 1;
+}
+
+int petri_shm_validate(const PetriShmReader* reader, const PetriShmView* view) {
+    (void)reader;
+    /* Odczyty danych nie mogą zostać przeniesione za ponowne sprawdzenie licznika */
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&view->slot->sequence, __ATOMIC_RELAXED) == view->sequence;
+}
+
+uint64_t petri_shm_publish_count(const PetriShmReader* reader) {
+    return __atomic_load_n(&reader->header->publishCount, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,66 @@
+#ifndef PETRI_SHM_H
+#define PETRI_SHM_H
+
+/* Czytnik stanu kolonii publikowanego przez PetriDish --shm <nazwa>.
+   Dane czytane są bezpośrednio z pamięci współdzielonej, bez kopiowania:
+
+       PetriShmView view;
+       if (petri_shm_begin(&reader, &view)) {
+           ... odczyt view.positionX[i] itd. ...
+           if (!petri_shm_validate(&reader, &view)) ... migawka nadpisana w trakcie, ponowić ...
+       }
+
+   Symulacja nigdy nie czeka na czytelników - wynik obliczony na nadpisanej migawce trzeba
+   odrzucić. Kolejna publikacja trafia do drugiego slotu, więc przy odczycie krótszym niż
+   okres publikacji (zwykle klatka) walidacja praktycznie zawsze się udaje. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "App/SharedStateLayout.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct PetriShmReader {
+    void* region;
+    size_t regionBytes;
+    const PetriShmHeader* header;
+} PetriShmReader;
+
+typedef struct PetriShmView {
+    uint64_t tick;
+    double simulationTime;
+    uint64_t cellCount;
+    uint64_t totalCells;
+    uint64_t colonyObjects;
+    const uint64_t* multiplicity;
+    const uint64_t* cellId;
+    const float* positionX;
+    const float* positionY;
+    const float* health;
+    const uint16_t* species;
+
+    /* Do walidacji */
+    const PetriShmSlotHeader* slot;
+    uint64_t sequence;
+} PetriShmView;
+
+/* 0 - sukces; -1 - błąd (errno), region nie istnieje albo ma inną wersję */
+int petri_shm_open(PetriShmReader* reader, const char* name);
+void petri_shm_close(PetriShmReader* reader);
+
+/* 1 - widok najnowszej migawki gotowy; 0 - brak publikacji albo slot właśnie zapisywany */
+int petri_shm_begin(const PetriShmReader* reader, PetriShmView* view);
+/* 1 - migawka nie zmieniła się od petri_shm_begin, odczytane dane są spójne */
+int petri_shm_validate(const PetriShmReader* reader, const PetriShmView* view);
+
+/* Licznik publikacji - pozwala czekać na nową migawkę bez odczytu danych */
+uint64_t petri_shm_publish_count(const PetriShmReader* reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
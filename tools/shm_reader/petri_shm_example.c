@@ -0,0 +1,107 @@
+/* Przykładowy odbiorca: co publikację liczy liczebność gatunków, średnie zdrowie i zasięg
+   kolonii bezpośrednio na pamięci współdzielonej.
+   Użycie: petri_shm_example [nazwa] [liczba_probek]   (domyślnie /petridish, 100) */
+
+/* clock_gettime i nanosleep przy kompilacji w ścisłym trybie C (-std=c99/c11) */
+#define _POSIX_C_SOURCE 199309L
+
+#include "petri_shm.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SPECIES_SLOTS 65536
+/* Próby odczytu jednej migawki, zanim odbiorca poczeka na kolejną */
+#define MAX_READ_ATTEMPTS 4
+
+static double nowSeconds(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+static void sleepMilliseconds(long milliseconds) {
+    struct timespec pause = {0, milliseconds * 1000000L};
+    nanosleep(&pause, NULL);
+}
+
+typedef struct Summary {
+    uint64_t cells;
+    double healthSum;
+    float minX, minY, maxX, maxY;
+    uint16_t speciesSeen;
+} Summary;
+
+static void summarize(const PetriShmView* view, uint64_t* speciesCells, Summary* summary) {
+    memset(summary, 0, sizeof(*summary));
+    memset(speciesCells, 0, SPECIES_SLOTS * sizeof(uint64_t));
+    summary->minX = summary->minY = 1e30f;
+    summary->maxX = summary->maxY = -1e30f;
+    for (uint64_t i = 0; i < view->cellCount; ++i) {
+        uint64_t multiplicity = view->multiplicity[i];
+        speciesCells[view->species[i]] += multiplicity;
+        if (view->species[i] >= summary->speciesSeen) summary->speciesSeen = (uint16_t)(view->species[i] + 1);
+        summary->cells += multiplicity;
+        summary->healthSum += (double)view->health[i] * (double)multiplicity;
+        if (view->positionX[i] < summary->minX) summary->minX = view->positionX[i];
+        if (view->positionX[i] > summary->maxX) summary->maxX = view->positionX[i];
+        if (view->positionY[i] < summary->minY) summary->minY = view->positionY[i];
+        if (view->positionY[i] > summary->maxY) summary->maxY = view->positionY[i];
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* name = argc > 1 ? argv[1] : "/petridish";
+    const int samples = argc > 2 ? atoi(argv[2]) : 100;
+
+    PetriShmReader reader;
+    if (petri_shm_open(&reader, name) != 0) {
+        fprintf(stderr, "ERROR::SHM::Could not open %s: %s\n", name, strerror(errno));
+        return 1;
+    }
+    printf("INFO::SHM::Opened %s (%llu cells per slot)\n", name, (unsigned long long)reader.header->capacity);
+
+    uint64_t* speciesCells = malloc(SPECIES_SLOTS * sizeof(uint64_t));
+    uint64_t lastPublish = 0;
+    uint64_t tornReads = 0;
+    for (int sample = 0; sample < samples;) {
+        uint64_t publish = petri_shm_publish_count(&reader);
+        if (publish == lastPublish) {
+            sleepMilliseconds(1);
+            continue;
+        }
+        lastPublish = publish;
+
+        PetriShmView view;
+        Summary summary;
+        int consistent = 0;
+        double start = nowSeconds();
+        for (int attempt = 0; attempt < MAX_READ_ATTEMPTS && !consistent; ++attempt) {
+            if (!petri_shm_begin(&reader, &view)) continue;
+            summarize(&view, speciesCells, &summary);
+            consistent = petri_shm_validate(&reader, &view);
+            if (!consistent) ++tornReads;
+        }
+        double elapsed = nowSeconds() - start;
+        if (!consistent) continue;
+
+        printf("tick %llu t=%.2f s objects %llu cells %llu mean_health %.3f extent [%.1f, %.1f]x[%.1f, %.1f] read %.2f ms\n",
+               (unsigned long long)view.tick, view.simulationTime, (unsigned long long)view.cellCount,
+               (unsigned long long)summary.cells, summary.cells > 0 ? summary.healthSum / (double)summary.cells : 0.0,
+               summary.minX, summary.maxX, summary.minY, summary.maxY, elapsed * 1000.0);
+        for (uint16_t species = 0; species < summary.speciesSeen; ++species) {
+            if (speciesCells[species] > 0) {
+                printf("  species %u: %llu cells\n", species, (unsigned long long)speciesCells[species]);
+            }
+        }
+        ++sample;
+    }
+    printf("INFO::SHM::%d samples, %llu torn reads retried\n", samples, (unsigned long long)tornReads);
+
+    free(speciesCells);
+    petri_shm_close(&reader);
+    return 0;
+}